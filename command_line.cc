@@ -4,6 +4,8 @@
 
 #include "base/command_line.h"
 
+#include <algorithm>
+#include <iterator>
 #include <ostream>
 
 #include "base/containers/span.h"
@@ -62,7 +64,7 @@ constexpr CommandLine::CharType kSingleArgument[] =
 
 size_t GetSwitchPrefixLength(CommandLine::StringPieceType string) {
   for (size_t i = 0; i < switch_prefix_count; ++i) {
-    CommandLine::StringType prefix(kSwitchPrefixes[i]);
+    const CommandLine::StringPieceType prefix = kSwitchPrefixes[i];
     if (string.substr(0, prefix.length()) == prefix)
       return prefix.length();
   }
@@ -71,22 +73,46 @@ size_t GetSwitchPrefixLength(CommandLine::StringPieceType string) {
 
 // Fills in |switch_string| and |switch_value| if |string| is a switch.
 // This will preserve the input switch prefix in the output |switch_string|.
-bool IsSwitch(const CommandLine::StringType& string,
-              CommandLine::StringType* switch_string,
-              CommandLine::StringType* switch_value) {
-  switch_string->clear();
-  switch_value->clear();
+bool IsSwitch(CommandLine::StringPieceType string,
+              CommandLine::StringPieceType* switch_string,
+              CommandLine::StringPieceType* switch_value) {
+  *switch_string = CommandLine::StringPieceType();
+  *switch_value = CommandLine::StringPieceType();
   size_t prefix_length = GetSwitchPrefixLength(string);
   if (prefix_length == 0 || prefix_length == string.length())
     return false;
 
   const size_t equals_position = string.find(kSwitchValueSeparator);
   *switch_string = string.substr(0, equals_position);
-  if (equals_position != CommandLine::StringType::npos)
+  if (equals_position != CommandLine::StringPieceType::npos)
     *switch_value = string.substr(equals_position + 1);
   return true;
 }
 
+// Returns the key of |switch_string|, which may have a prefix, in the switch
+// map, and sets |switch_arg| to the |argv_| entry for the switch with |value|.
+std::string GetSwitchKeyAndArg(StringPiece switch_string,
+                               CommandLine::StringPieceType value,
+                               CommandLine::StringType* switch_arg) {
+#if defined(OS_WIN)
+  const std::string switch_key = ToLowerASCII(switch_string);
+  *switch_arg = UTF8ToWide(switch_key);
+#elif defined(OS_POSIX) || defined(OS_FUCHSIA)
+  const StringPiece switch_key = switch_string;
+  switch_arg->assign(switch_key.data(), switch_key.size());
+#endif
+  const size_t prefix_length = GetSwitchPrefixLength(*switch_arg);
+  // Preserve existing switch prefixes in |argv_|; only add one if necessary.
+  if (prefix_length == 0) {
+    switch_arg->insert(0, kSwitchPrefixes[0].data(),
+                       kSwitchPrefixes[0].size());
+  }
+  if (!value.empty())
+    StrAppend(switch_arg, {kSwitchValueSeparator, value});
+  return std::string(switch_key.data() + prefix_length,
+                     switch_key.size() - prefix_length);
+}
+
 // Returns true iff |string| represents a switch with key
 // |switch_key_without_prefix|, regardless of value.
 bool IsSwitchWithKey(CommandLine::StringPieceType string,
@@ -252,13 +278,18 @@ CommandLine CommandLine::FromString(StringPieceType command_line) {
 
 void CommandLine::InitFromArgv(int argc,
                                const CommandLine::CharType* const* argv) {
-  StringVector new_argv;
-  for (int i = 0; i < argc; ++i)
-    new_argv.push_back(argv[i]);
-  InitFromArgv(new_argv);
+  // Parse |argv| in place; only the resulting switches and arguments are
+  // copied.
+  const std::vector<StringPieceType> pieces(argv, argv + argc);
+  InitFromArgvPieces(pieces);
 }
 
 void CommandLine::InitFromArgv(const StringVector& argv) {
+  const std::vector<StringPieceType> pieces(argv.begin(), argv.end());
+  InitFromArgvPieces(pieces);
+}
+
+void CommandLine::InitFromArgvPieces(span<const StringPieceType> argv) {
   argv_ = StringVector(1);
   switches_.clear();
   begin_args_ = 1;
@@ -330,25 +361,12 @@ void CommandLine::AppendSwitchPath(const std::string& switch_string,
 
 void CommandLine::AppendSwitchNative(const std::string& switch_string,
                                      CommandLine::StringPieceType value) {
-#if defined(OS_WIN)
-  const std::string switch_key = ToLowerASCII(switch_string);
-  StringType combined_switch_string(UTF8ToWide(switch_key));
-#elif defined(OS_POSIX) || defined(OS_FUCHSIA)
-  const std::string& switch_key = switch_string;
-  StringType combined_switch_string(switch_key);
-#endif
-  size_t prefix_length = GetSwitchPrefixLength(combined_switch_string);
-  base::InsertOrAssign(switches_, switch_key.substr(prefix_length),
-                       StringType(value));
-  // Preserve existing switch prefixes in |argv_|; only append one if necessary.
-  if (prefix_length == 0) {
-    combined_switch_string.insert(0, kSwitchPrefixes[0].data(),
-                                  kSwitchPrefixes[0].size());
-  }
-  if (!value.empty())
-    base::StrAppend(&combined_switch_string, {kSwitchValueSeparator, value});
+  StringType switch_arg;
+  std::string switch_key =
+      GetSwitchKeyAndArg(switch_string, value, &switch_arg);
+  switches_.insert_or_assign(std::move(switch_key), StringType(value));
   // Append the switch and update the switches/arguments divider |begin_args_|.
-  argv_.insert(argv_.begin() + begin_args_++, combined_switch_string);
+  argv_.insert(argv_.begin() + begin_args_++, std::move(switch_arg));
 }
 
 void CommandLine::AppendSwitchASCII(const std::string& switch_string,
@@ -399,10 +417,22 @@ void CommandLine::RemoveSwitch(base::StringPiece switch_key_without_prefix) {
 void CommandLine::CopySwitchesFrom(const CommandLine& source,
                                    const char* const switches[],
                                    size_t count) {
+  // Add the switches all at once, since appending them one at a time would
+  // take quadratic time.
+  std::vector<std::pair<std::string, StringType>> copied_switches;
+  StringVector switch_args;
   for (size_t i = 0; i < count; ++i) {
-    if (source.HasSwitch(switches[i]))
-      AppendSwitchNative(switches[i], source.GetSwitchValueNative(switches[i]));
+    if (!source.HasSwitch(switches[i]))
+      continue;
+    StringType value = source.GetSwitchValueNative(switches[i]);
+    StringType switch_arg;
+    std::string switch_key =
+        GetSwitchKeyAndArg(switches[i], value, &switch_arg);
+    copied_switches.emplace_back(std::move(switch_key), std::move(value));
+    switch_args.push_back(std::move(switch_arg));
   }
+  AppendParsedSwitchesAndArguments(std::move(copied_switches),
+                                   std::move(switch_args), StringVector());
 }
 
 CommandLine::StringVector CommandLine::GetArgs() const {
@@ -438,7 +468,9 @@ void CommandLine::AppendArguments(const CommandLine& other,
                                   bool include_program) {
   if (include_program)
     SetProgram(other.GetProgram());
-  AppendSwitchesAndArguments(other.argv());
+  const std::vector<StringPieceType> pieces(other.argv().begin(),
+                                            other.argv().end());
+  AppendSwitchesAndArguments(pieces);
 }
 
 void CommandLine::PrependWrapper(const CommandLine::StringType& wrapper) {
@@ -497,39 +529,93 @@ void CommandLine::ParseFromString(StringPieceType command_line) {
 #endif  // defined(OS_WIN)
 
 void CommandLine::AppendSwitchesAndArguments(
-    const CommandLine::StringVector& argv) {
+    span<const CommandLine::StringPieceType> argv) {
+  std::vector<std::pair<std::string, StringType>> switches;
+  StringVector switch_args;
+  StringVector args;
+  switches.reserve(argv.size());
+  switch_args.reserve(argv.size());
   bool parse_switches = true;
 #if defined(OS_WIN)
   const bool is_parsed_from_string = !raw_command_line_string_.empty();
 #endif
   for (size_t i = 1; i < argv.size(); ++i) {
-    CommandLine::StringType arg = argv[i];
 #if defined(OS_WIN)
-    arg = CommandLine::StringType(TrimWhitespace(arg, TRIM_ALL));
+    const StringPieceType arg = TrimWhitespace(argv[i], TRIM_ALL);
 #elif defined(OS_POSIX) || defined(OS_FUCHSIA)
-    TrimWhitespaceASCII(arg, TRIM_ALL, &arg);
+    const StringPieceType arg = TrimWhitespaceASCII(argv[i], TRIM_ALL);
 #endif
 
-    CommandLine::StringType switch_string;
-    CommandLine::StringType switch_value;
+    StringPieceType switch_string;
+    StringPieceType switch_value;
     parse_switches &= (arg != kSwitchTerminator);
     if (parse_switches && IsSwitch(arg, &switch_string, &switch_value)) {
+      StringType switch_arg;
 #if defined(OS_WIN)
       if (is_parsed_from_string &&
           IsSwitchWithKey(switch_string, kSingleArgument)) {
-        ParseAsSingleArgument(switch_string);
+        AppendParsedSwitchesAndArguments(
+            std::move(switches), std::move(switch_args), std::move(args));
+        ParseAsSingleArgument(StringType(switch_string));
         return;
       }
-      AppendSwitchNative(WideToUTF8(switch_string), switch_value);
+      std::string switch_key = GetSwitchKeyAndArg(WideToUTF8(switch_string),
+                                                  switch_value, &switch_arg);
 #elif defined(OS_POSIX) || defined(OS_FUCHSIA)
-      AppendSwitchNative(switch_string, switch_value);
+      std::string switch_key =
+          GetSwitchKeyAndArg(switch_string, switch_value, &switch_arg);
 #else
 #error Unsupported platform
 #endif
+      switches.emplace_back(std::move(switch_key), StringType(switch_value));
+      switch_args.push_back(std::move(switch_arg));
     } else {
-      AppendArgNative(arg);
+      args.emplace_back(arg);
     }
   }
+  AppendParsedSwitchesAndArguments(std::move(switches), std::move(switch_args),
+                                   std::move(args));
+}
+
+void CommandLine::AppendParsedSwitchesAndArguments(
+    std::vector<std::pair<std::string, StringType>> switches,
+    StringVector switch_args,
+    StringVector args) {
+  if (!switches.empty()) {
+    // Inserting into |switches_| one at a time would take quadratic time.
+    // Sort all switches at once instead, and keep the last value of repeated
+    // ones, like AppendSwitchNative() does. Sorting indices rather than the
+    // switches avoids moving strings around.
+    std::vector<std::pair<std::string, StringType>> unsorted =
+        std::move(switches_).extract();
+    unsorted.insert(unsorted.end(), std::make_move_iterator(switches.begin()),
+                    std::make_move_iterator(switches.end()));
+    std::vector<size_t> order(unsorted.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&unsorted](size_t a, size_t b) {
+                       return unsorted[a].first < unsorted[b].first;
+                     });
+
+    std::vector<std::pair<std::string, StringType>> sorted;
+    sorted.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      if (i + 1 < order.size() &&
+          unsorted[order[i]].first == unsorted[order[i + 1]].first) {
+        continue;
+      }
+      sorted.push_back(std::move(unsorted[order[i]]));
+    }
+    switches_.replace(std::move(sorted));
+  }
+
+  argv_.insert(argv_.begin() + begin_args_,
+               std::make_move_iterator(switch_args.begin()),
+               std::make_move_iterator(switch_args.end()));
+  begin_args_ += switch_args.size();
+  argv_.insert(argv_.end(), std::make_move_iterator(args.begin()),
+               std::make_move_iterator(args.end()));
 }
 
 CommandLine::StringType CommandLine::GetCommandLineString() const {
@@ -567,25 +653,29 @@ CommandLine::StringType CommandLine::GetArgumentsString() const {
   // Append switches and arguments.
   bool parse_switches = true;
   for (size_t i = 1; i < argv_.size(); ++i) {
-    StringType arg = argv_[i];
-    StringType switch_string;
-    StringType switch_value;
+    const StringType& arg = argv_[i];
+    StringPieceType switch_string;
+    StringPieceType switch_value;
     parse_switches &= arg != kSwitchTerminator;
     if (i > 1)
       params.append(FILE_PATH_LITERAL(" "));
     if (parse_switches && IsSwitch(arg, &switch_string, &switch_value)) {
-      params.append(switch_string);
+      StrAppend(&params, {switch_string});
       if (!switch_value.empty()) {
 #if defined(OS_WIN)
-        switch_value = QuoteForCommandLineToArgvW(switch_value);
+        StrAppend(&params,
+                  {kSwitchValueSeparator,
+                   QuoteForCommandLineToArgvW(StringType(switch_value))});
+#else
+        StrAppend(&params, {kSwitchValueSeparator, switch_value});
 #endif
-        params.append(kSwitchValueSeparator + switch_value);
       }
     } else {
 #if defined(OS_WIN)
-      arg = QuoteForCommandLineToArgvW(arg);
-#endif
+      params.append(QuoteForCommandLineToArgvW(arg));
+#else
       params.append(arg);
+#endif
     }
   }
   return params;
@@ -17,11 +17,13 @@
 #define BASE_COMMAND_LINE_H_
 
 #include <stddef.h>
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/flat_map.h"
+#include "base/containers/span.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
 #include "build/build_config.h"
@@ -42,7 +44,9 @@ class BASE_EXPORT CommandLine {
   using StringPieceType = base::BasicStringPiece<StringType>;
   using CharType = StringType::value_type;
   using StringVector = std::vector<StringType>;
-  using SwitchMap = std::map<std::string, StringType, std::less<>>;
+  // Sorted by switch name, so lookups are a binary search over contiguous
+  // memory. Unlike with a std::map, adding a switch moves the ones after it.
+  using SwitchMap = flat_map<std::string, StringType, std::less<>>;
 
   // A constructor for CommandLines that only carry switches and arguments.
   enum NoProgram { NO_PROGRAM };
@@ -157,10 +161,14 @@ class BASE_EXPORT CommandLine {
   StringType GetSwitchValueNative(const StringPiece& switch_string) const;
 
   // Get a copy of all switches, along with their values.
+  // Note: References and iterators into the returned map are invalidated by
+  // any change to the switches, such as AppendSwitch() or RemoveSwitch().
   const SwitchMap& GetSwitches() const { return switches_; }
 
   // Append a switch [with optional value] to the command line.
   // Note: Switches will precede arguments regardless of appending order.
+  // Each call takes time linear in the number of switches; use
+  // CopySwitchesFrom() or AppendArguments() to add many switches at once.
   void AppendSwitch(const std::string& switch_string);
   void AppendSwitchPath(const std::string& switch_string,
                         const FilePath& path);
@@ -212,8 +220,19 @@ class BASE_EXPORT CommandLine {
   //   CommandLine cl(*CommandLine::ForCurrentProcess());
   //   cl.AppendSwitch(...);
 
+  // Initializes from |argv|, which must not point into |argv_|.
+  void InitFromArgvPieces(span<const StringPieceType> argv);
+
   // Append switches and arguments, keeping switches before arguments.
-  void AppendSwitchesAndArguments(const StringVector& argv);
+  void AppendSwitchesAndArguments(span<const StringPieceType> argv);
+
+  // Adds parsed |switches| to |switches_|, and their |switch_args| and |args|
+  // to |argv_|, with the same result as appending them one at a time but in
+  // O(N log N) time for N switches.
+  void AppendParsedSwitchesAndArguments(
+      std::vector<std::pair<std::string, StringType>> switches,
+      StringVector switch_args,
+      StringVector args);
 
 #if defined(OS_WIN)
   // Initializes by parsing |raw_command_line_string_|, treating everything
@@ -0,0 +1,129 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/command_line.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+#if defined(OS_WIN)
+#include "base/strings/utf_string_conversions.h"
+#endif
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixCommandLine[] = "CommandLine.";
+constexpr char kMetricTimePerParse[] = "time_per_parse";
+constexpr char kMetricTimePerLookup[] = "time_per_lookup";
+constexpr char kStoryParse[] = "10k_switches";
+constexpr char kStoryHasSwitch[] = "has_switch_10k_switches";
+constexpr char kStoryGetSwitchValue[] = "get_switch_value_10k_switches";
+
+constexpr int kSwitchCount = 10000;
+constexpr int kParseLaps = 20;
+constexpr int kLookupLaps = 1000000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixCommandLine,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerParse, "us");
+  reporter.RegisterImportantMetric(kMetricTimePerLookup, "ns");
+  return reporter;
+}
+
+std::string GetSwitchName(int i) {
+  return StringPrintf("switch-%d", i);
+}
+
+// Returns the argv of a command line with |kSwitchCount| switches, every
+// other one with a value, and a few arguments.
+CommandLine::StringVector MakeArgv() {
+  std::vector<std::string> argv = {"program"};
+  for (int i = 0; i < kSwitchCount; ++i) {
+    if (i % 2)
+      argv.push_back("--" + GetSwitchName(i));
+    else
+      argv.push_back("--" + GetSwitchName(i) + StringPrintf("=value-%d", i));
+  }
+  argv.push_back("arg1");
+  argv.push_back("arg2");
+#if defined(OS_WIN)
+  CommandLine::StringVector native_argv;
+  for (const std::string& arg : argv)
+    native_argv.push_back(UTF8ToWide(arg));
+  return native_argv;
+#else
+  return argv;
+#endif
+}
+
+}  // namespace
+
+TEST(CommandLinePerfTest, Parse) {
+  const CommandLine::StringVector argv = MakeArgv();
+  std::vector<const CommandLine::CharType*> raw_argv;
+  for (const auto& arg : argv)
+    raw_argv.push_back(arg.c_str());
+
+  TimeDelta elapsed;
+  for (int i = 0; i < kParseLaps; ++i) {
+    const TimeTicks start = TimeTicks::Now();
+    CommandLine command_line(static_cast<int>(raw_argv.size()),
+                             raw_argv.data());
+    elapsed += TimeTicks::Now() - start;
+    ASSERT_EQ(static_cast<size_t>(kSwitchCount),
+              command_line.GetSwitches().size());
+  }
+  SetUpReporter(kStoryParse)
+      .AddResult(kMetricTimePerParse, elapsed.InMicrosecondsF() / kParseLaps);
+}
+
+TEST(CommandLinePerfTest, HasSwitch) {
+  const CommandLine command_line(MakeArgv());
+  std::vector<std::string> names;
+  for (int i = 0; i < 64; ++i)
+    names.push_back(GetSwitchName(i * kSwitchCount / 64));
+  names.push_back("not-a-switch");
+
+  size_t found = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLookupLaps; ++i)
+    found += command_line.HasSwitch(names[i % names.size()]);
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+  EXPECT_GT(found, 0u);
+
+  SetUpReporter(kStoryHasSwitch)
+      .AddResult(kMetricTimePerLookup,
+                 elapsed.InNanoseconds() / static_cast<double>(kLookupLaps));
+}
+
+TEST(CommandLinePerfTest, GetSwitchValue) {
+  const CommandLine command_line(MakeArgv());
+  std::vector<std::string> names;
+  for (int i = 0; i < 64; ++i)
+    names.push_back(GetSwitchName(i * kSwitchCount / 64));
+
+  size_t total_length = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLookupLaps; ++i) {
+    total_length +=
+        command_line.GetSwitchValueNative(names[i % names.size()]).size();
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+  EXPECT_GT(total_length, 0u);
+
+  SetUpReporter(kStoryGetSwitchValue)
+      .AddResult(kMetricTimePerLookup,
+                 elapsed.InNanoseconds() / static_cast<double>(kLookupLaps));
+}
+
+}  // namespace base
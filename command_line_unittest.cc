@@ -346,6 +346,61 @@ TEST(CommandLineTest, AppendArguments) {
   EXPECT_TRUE(c1.HasSwitch("switch2"));
 }
 
+// Switches appended in bulk keep their order in argv(), stay before the
+// arguments, and override earlier values.
+TEST(CommandLineTest, AppendArgumentsMergesSwitches) {
+  CommandLine cl1(FilePath(FILE_PATH_LITERAL("Program")));
+  cl1.AppendSwitchASCII("b", "1");
+  cl1.AppendSwitchASCII("d", "1");
+  cl1.AppendArg("arg1");
+
+  const CommandLine::CharType* argv[] = {
+      FILE_PATH_LITERAL("program"), FILE_PATH_LITERAL("--d=2"),
+      FILE_PATH_LITERAL("arg2"),    FILE_PATH_LITERAL("--a"),
+      FILE_PATH_LITERAL("--c=2"),   FILE_PATH_LITERAL("--a=3")};
+  CommandLine cl2(size(argv), argv);
+  cl1.AppendArguments(cl2, false);
+
+  EXPECT_THAT(cl1.argv(),
+              testing::ElementsAre(
+                  FILE_PATH_LITERAL("Program"), FILE_PATH_LITERAL("--b=1"),
+                  FILE_PATH_LITERAL("--d=1"), FILE_PATH_LITERAL("--d=2"),
+                  FILE_PATH_LITERAL("--a"), FILE_PATH_LITERAL("--c=2"),
+                  FILE_PATH_LITERAL("--a=3"), FILE_PATH_LITERAL("arg1"),
+                  FILE_PATH_LITERAL("arg2")));
+  EXPECT_EQ(4u, cl1.GetSwitches().size());
+  EXPECT_EQ("3", cl1.GetSwitchValueASCII("a"));
+  EXPECT_EQ("1", cl1.GetSwitchValueASCII("b"));
+  EXPECT_EQ("2", cl1.GetSwitchValueASCII("c"));
+  EXPECT_EQ("2", cl1.GetSwitchValueASCII("d"));
+}
+
+// Copied switches are appended in the order asked for, and override earlier
+// values; missing ones are skipped.
+TEST(CommandLineTest, CopySwitchesFrom) {
+  CommandLine source(FilePath(FILE_PATH_LITERAL("Source")));
+  source.AppendSwitchASCII("a", "2");
+  source.AppendSwitch("c");
+  source.AppendSwitchASCII("b", "2");
+
+  CommandLine cl(FilePath(FILE_PATH_LITERAL("Program")));
+  cl.AppendSwitchASCII("b", "1");
+  cl.AppendArg("arg");
+  const char* const kSwitches[] = {"c", "missing", "b", "a"};
+  cl.CopySwitchesFrom(source, kSwitches, size(kSwitches));
+
+  EXPECT_THAT(cl.argv(),
+              testing::ElementsAre(
+                  FILE_PATH_LITERAL("Program"), FILE_PATH_LITERAL("--b=1"),
+                  FILE_PATH_LITERAL("--c"), FILE_PATH_LITERAL("--b=2"),
+                  FILE_PATH_LITERAL("--a=2"), FILE_PATH_LITERAL("arg")));
+  EXPECT_EQ(3u, cl.GetSwitches().size());
+  EXPECT_EQ("2", cl.GetSwitchValueASCII("a"));
+  EXPECT_EQ("2", cl.GetSwitchValueASCII("b"));
+  EXPECT_TRUE(cl.HasSwitch("c"));
+  EXPECT_FALSE(cl.HasSwitch("missing"));
+}
+
 #if defined(OS_WIN)
 // Make sure that the command line string program paths are quoted as necessary.
 // This only makes sense on Windows and the test is basically here to guard
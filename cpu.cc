@@ -288,6 +288,7 @@ void CPU::Initialize() {
         (xgetbv(0) & 6) == 6 /* XSAVE enabled by kernel */;
     has_aesni_ = (cpu_info[2] & 0x02000000) != 0;
     has_avx2_ = has_avx_ && (cpu_info7[1] & 0x00000020) != 0;
+    has_sha_ = (cpu_info7[1] & 0x20000000) != 0;
   }
 
   // Get the brand string of the cpu.
@@ -346,12 +347,16 @@ void CPU::Initialize() {
   unsigned long hwcap2 = getauxval(AT_HWCAP2);
   has_mte_ = hwcap2 & HWCAP2_MTE;
   has_bti_ = hwcap2 & HWCAP2_BTI;
+  has_sha_ = getauxval(AT_HWCAP) & HWCAP_SHA1;
 #endif
 
 #elif defined(OS_WIN)
   // Windows makes high-resolution thread timing information available in
   // user-space.
   has_non_stop_time_stamp_counter_ = true;
+#elif defined(OS_MAC) && defined(ARCH_CPU_ARM64)
+  // All Apple Silicon has the cryptographic extension.
+  has_sha_ = true;
 #endif
 #endif
 }
@@ -65,6 +65,9 @@ class BASE_EXPORT CPU final {
   bool has_avx() const { return has_avx_; }
   bool has_avx2() const { return has_avx2_; }
   bool has_aesni() const { return has_aesni_; }
+  // SHA-1 and SHA-256 instructions: the SHA extensions on x86, or the Armv8
+  // cryptographic extension on ARM64.
+  bool has_sha() const { return has_sha_; }
   bool has_non_stop_time_stamp_counter() const {
     return has_non_stop_time_stamp_counter_;
   }
@@ -162,6 +165,7 @@ class BASE_EXPORT CPU final {
   bool has_avx_ = false;
   bool has_avx2_ = false;
   bool has_aesni_ = false;
+  bool has_sha_ = false;
   bool has_mte_ = false;  // Armv8.5-A MTE (Memory Taggging Extension)
   bool has_bti_ = false;  // Armv8.5-A BTI (Branch Target Identification)
   bool has_non_stop_time_stamp_counter_ = false;
@@ -36,6 +36,10 @@ FeatureList* g_feature_list_instance = nullptr;
 // which Feature that accessor was for, if so.
 const Feature* g_initialized_from_accessor = nullptr;
 
+// The caching context of the next FeatureList. Starts at 1, since a cached
+// state of 0 means that nothing was cached.
+std::atomic<uint32_t> g_next_caching_context{1};
+
 #if DCHECK_IS_ON()
 // Tracks whether the use of base::Feature is allowed for this module.
 // See ForbidUseForCurrentModule().
@@ -180,7 +184,12 @@ const Feature kDCheckIsFatalFeature{"DcheckIsFatal",
                                     FEATURE_DISABLED_BY_DEFAULT};
 #endif  // defined(DCHECK_IS_CONFIGURABLE)
 
-FeatureList::FeatureList() = default;
+FeatureList::FeatureList()
+    : caching_context_(
+          g_next_caching_context.fetch_add(1, std::memory_order_relaxed)) {
+  // The caching context is stored above the enabled bit of the cached state.
+  CHECK_LT(caching_context_, 1u << 31);
+}
 
 FeatureList::~FeatureList() = default;
 
@@ -504,6 +513,21 @@ bool FeatureList::IsFeatureEnabled(const Feature& feature) {
   DCHECK(IsValidFeatureOrFieldTrialName(feature.name)) << feature.name;
   DCHECK(CheckFeatureIdentity(feature)) << feature.name;
 
+  // Overrides can't change once initialized, so the state only needs to be
+  // resolved once per FeatureList. Racing threads resolve the same state, and
+  // activating the field trial is idempotent, so relaxed ordering suffices.
+  const uint32_t cached_state =
+      feature.cached_state_.load(std::memory_order_relaxed);
+  if ((cached_state >> 1) == caching_context_)
+    return cached_state & 1;
+
+  const bool enabled = ResolveFeatureState(feature);
+  feature.cached_state_.store((caching_context_ << 1) | enabled,
+                              std::memory_order_relaxed);
+  return enabled;
+}
+
+bool FeatureList::ResolveFeatureState(const Feature& feature) {
   auto it = overrides_.find(feature.name);
   if (it != overrides_.end()) {
     const OverrideEntry& entry = it->second;
@@ -5,6 +5,9 @@
 #ifndef BASE_FEATURE_LIST_H_
 #define BASE_FEATURE_LIST_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -39,6 +42,15 @@ enum FeatureState {
 // file static. It should never be used as a constexpr as it breaks
 // pointer-based identity lookup.
 struct BASE_EXPORT Feature {
+  constexpr Feature(const char* name, FeatureState default_state)
+      : name(name), default_state(default_state) {}
+
+  // Copies don't share the original's cached state. They're only meant for
+  // passing features by name, e.g. to ScopedFeatureList.
+  Feature(const Feature& other)
+      : name(other.name), default_state(other.default_state) {}
+  Feature& operator=(const Feature&) = delete;
+
   // The name of the feature. This should be unique to each feature and is used
   // for enabling/disabling features via command line flags and experiments.
   // It is strongly recommended to use CamelCase style for feature names, e.g.
@@ -49,6 +61,15 @@ struct BASE_EXPORT Feature {
   // NOTE: The actual runtime state may be different, due to a field trial or a
   // command line switch.
   const FeatureState default_state;
+
+ private:
+  friend class FeatureList;
+
+  // The state of this feature, as resolved by FeatureList::IsEnabled(). The
+  // low bit is whether the feature is enabled; the other bits are the
+  // caching context of the FeatureList which resolved it, so that the value
+  // is ignored once another FeatureList is set. Zero means no state is cached.
+  mutable std::atomic<uint32_t> cached_state_{0};
 };
 
 #if defined(DCHECK_IS_CONFIGURABLE)
@@ -321,8 +342,15 @@ class BASE_EXPORT FeatureList {
   // Returns whether the given |feature| is enabled. This is invoked by the
   // public FeatureList::IsEnabled() static function on the global singleton.
   // Requires the FeatureList to have already been fully initialized.
+  // After the first call for a given |feature|, this is a single relaxed load
+  // of the state cached in it.
   bool IsFeatureEnabled(const Feature& feature);
 
+  // Looks up the state of |feature| in |overrides_|, activating the field
+  // trial which overrides it, if any. Used by IsFeatureEnabled() when no state
+  // is cached in |feature|.
+  bool ResolveFeatureState(const Feature& feature);
+
   // Returns the field trial associated with the given |feature|. This is
   // invoked by the public FeatureList::GetFieldTrial() static function on the
   // global singleton. Requires the FeatureList to have already been fully
@@ -384,6 +412,11 @@ class BASE_EXPORT FeatureList {
 
   // Whether this object has been initialized from command line.
   bool initialized_from_command_line_ = false;
+
+  // Identifies this instance in the state cached in Feature structs. Each
+  // FeatureList gets a new one, so that states cached by a previous instance,
+  // e.g. one replaced by a ScopedFeatureList, aren't used.
+  const uint32_t caching_context_;
 };
 
 }  // namespace base
@@ -0,0 +1,87 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/feature_list.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/dcheck_is_on.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixFeatureList[] = "FeatureList.";
+constexpr char kMetricTimePerCheck[] = "time_per_check";
+constexpr char kStoryDefaultState[] = "default_state";
+constexpr char kStoryOverridden[] = "overridden";
+
+#if DCHECK_IS_ON()
+// Feature identity checks make IsEnabled() much slower with DCHECKs on.
+constexpr int kLaps = 100000;
+#else
+constexpr int kLaps = 10000000;
+#endif
+
+// The number of features overridden from the command line, roughly what a
+// browser process with a field trial config has.
+constexpr int kOverrideCount = 1000;
+
+const Feature kDefaultFeature{"FeatureListPerfTestDefault",
+                              FEATURE_DISABLED_BY_DEFAULT};
+const Feature kOverriddenFeature{"FeatureListPerfTestOverridden",
+                                 FEATURE_DISABLED_BY_DEFAULT};
+
+class FeatureListPerfTest : public testing::Test {
+ public:
+  FeatureListPerfTest() {
+    std::vector<std::string> enabled_features = {kOverriddenFeature.name};
+    for (int i = 0; i < kOverrideCount; ++i)
+      enabled_features.push_back(StringPrintf("FeatureListPerfTest%d", i));
+    auto feature_list = std::make_unique<FeatureList>();
+    feature_list->InitializeFromCommandLine(JoinString(enabled_features, ","),
+                                            "");
+    scoped_feature_list_.InitWithFeatureList(std::move(feature_list));
+  }
+
+  // Checks |feature| kLaps times and reports the average cost of a check.
+  void MeasureIsEnabled(const Feature& feature, const std::string& story) {
+    int enabled_count = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < kLaps; ++i) {
+      if (FeatureList::IsEnabled(feature))
+        ++enabled_count;
+    }
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+
+    perf_test::PerfResultReporter reporter(kMetricPrefixFeatureList, story);
+    reporter.RegisterImportantMetric(kMetricTimePerCheck, "ns");
+    reporter.AddResult(kMetricTimePerCheck,
+                       elapsed.InNanoseconds() / static_cast<double>(kLaps));
+    EXPECT_EQ(FeatureList::IsEnabled(feature) ? kLaps : 0, enabled_count);
+  }
+
+ private:
+  test::ScopedFeatureList scoped_feature_list_;
+};
+
+}  // namespace
+
+TEST_F(FeatureListPerfTest, IsEnabledDefaultState) {
+  MeasureIsEnabled(kDefaultFeature, kStoryDefaultState);
+}
+
+TEST_F(FeatureListPerfTest, IsEnabledOverridden) {
+  MeasureIsEnabled(kOverriddenFeature, kStoryOverridden);
+}
+
+}  // namespace base
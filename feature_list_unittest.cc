@@ -593,6 +593,31 @@ TEST_F(FeatureListTest, InitializeInstance) {
   EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
 }
 
+// The state cached in a Feature doesn't outlive the FeatureList which
+// resolved it.
+TEST_F(FeatureListTest, CachedStateIsPerInstance) {
+  EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  {
+    test::ScopedFeatureList scoped_feature_list;
+    scoped_feature_list.InitAndEnableFeature(kFeatureOffByDefault);
+    EXPECT_TRUE(FeatureList::IsEnabled(kFeatureOffByDefault));
+    EXPECT_TRUE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  }
+  EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
+
+  // Cached states are also ignored while the original instance is swapped out.
+  std::unique_ptr<FeatureList> original_feature_list =
+      FeatureList::ClearInstanceForTesting();
+  auto feature_list = std::make_unique<FeatureList>();
+  feature_list->InitializeFromCommandLine(kFeatureOffByDefaultName, "");
+  FeatureList::SetInstance(std::move(feature_list));
+  EXPECT_TRUE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  FeatureList::ClearInstanceForTesting();
+  FeatureList::RestoreInstanceForTesting(std::move(original_feature_list));
+  EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOffByDefault));
+}
+
 TEST_F(FeatureListTest, UninitializedInstance_IsEnabledReturnsFalse) {
   std::unique_ptr<FeatureList> original_feature_list =
       FeatureList::ClearInstanceForTesting();
@@ -0,0 +1,334 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/frozen_value.h"
+
+#include <new>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/memory/ref_counted.h"
+#include "base/notreached.h"
+#include "base/optional.h"
+
+namespace base {
+
+// The shared contents of a non-scalar FrozenValue. Nodes are never changed
+// after construction, so they can be read from any sequence.
+class FrozenValue::Node : public RefCountedThreadSafe<Node> {
+ public:
+  using BlobStorage = Value::BlobStorage;
+
+  explicit Node(std::string string_value) : type_(Value::Type::STRING) {
+    new (&string_value_) std::string(std::move(string_value));
+  }
+  explicit Node(BlobStorage blob_value) : type_(Value::Type::BINARY) {
+    new (&blob_value_) BlobStorage(std::move(blob_value));
+  }
+  explicit Node(DictStorage dict) : type_(Value::Type::DICTIONARY) {
+    new (&dict_) DictStorage(std::move(dict));
+  }
+  explicit Node(ListStorage list) : type_(Value::Type::LIST) {
+    new (&list_) ListStorage(std::move(list));
+  }
+  Node(const Node&) = delete;
+  Node& operator=(const Node&) = delete;
+
+  const std::string& string_value() const {
+    DCHECK_EQ(Value::Type::STRING, type_);
+    return string_value_;
+  }
+  const BlobStorage& blob_value() const {
+    DCHECK_EQ(Value::Type::BINARY, type_);
+    return blob_value_;
+  }
+  const DictStorage& dict() const {
+    DCHECK_EQ(Value::Type::DICTIONARY, type_);
+    return dict_;
+  }
+  const ListStorage& list() const {
+    DCHECK_EQ(Value::Type::LIST, type_);
+    return list_;
+  }
+
+ private:
+  friend class RefCountedThreadSafe<Node>;
+
+  ~Node() {
+    switch (type_) {
+      case Value::Type::STRING:
+        string_value_.~basic_string();
+        return;
+      case Value::Type::BINARY:
+        blob_value_.~BlobStorage();
+        return;
+      case Value::Type::DICTIONARY:
+        dict_.~DictStorage();
+        return;
+      case Value::Type::LIST:
+        list_.~ListStorage();
+        return;
+      default:
+        NOTREACHED();
+    }
+  }
+
+  const Value::Type type_;
+  union {
+    std::string string_value_;
+    BlobStorage blob_value_;
+    DictStorage dict_;
+    ListStorage list_;
+  };
+};
+
+FrozenValue::FrozenValue() : double_value_(0.0) {}
+
+FrozenValue::FrozenValue(Value value) : type_(value.type()) {
+  // Initialize the whole union, so that copying it is always defined.
+  double_value_ = 0.0;
+  switch (type_) {
+    case Value::Type::NONE:
+      return;
+    case Value::Type::BOOLEAN:
+      bool_value_ = value.GetBool();
+      return;
+    case Value::Type::INTEGER:
+      int_value_ = value.GetInt();
+      return;
+    case Value::Type::DOUBLE:
+      double_value_ = value.GetDouble();
+      return;
+    case Value::Type::STRING:
+      node_ = MakeRefCounted<Node>(std::move(value.GetString()));
+      return;
+    case Value::Type::BINARY:
+      node_ = MakeRefCounted<Node>(value.GetBlob());
+      return;
+    case Value::Type::DICTIONARY: {
+      // TakeDict() returns the entries in key order, so they can be adopted
+      // without sorting again.
+      Value::DictStorage dict = value.TakeDict();
+      DictStorage::container_type entries;
+      entries.reserve(dict.size());
+      for (auto& entry : dict) {
+        entries.emplace_back(entry.first,
+                             FrozenValue(std::move(entry.second)));
+      }
+      node_ = MakeRefCounted<Node>(
+          DictStorage(sorted_unique, std::move(entries)));
+      return;
+    }
+    case Value::Type::LIST: {
+      Value::ListStorage list = value.TakeList();
+      ListStorage frozen_list;
+      frozen_list.reserve(list.size());
+      for (auto& item : list)
+        frozen_list.emplace_back(std::move(item));
+      node_ = MakeRefCounted<Node>(std::move(frozen_list));
+      return;
+    }
+    // TODO(crbug.com/859477): Remove after root cause is found.
+    case Value::Type::DEAD:
+      CHECK(false);
+      return;
+  }
+  NOTREACHED();
+}
+
+FrozenValue::FrozenValue(DictStorage dict)
+    : type_(Value::Type::DICTIONARY),
+      double_value_(0.0),
+      node_(MakeRefCounted<Node>(std::move(dict))) {}
+
+FrozenValue::FrozenValue(const FrozenValue& other) = default;
+FrozenValue::FrozenValue(FrozenValue&& other) noexcept = default;
+FrozenValue& FrozenValue::operator=(const FrozenValue& other) = default;
+FrozenValue& FrozenValue::operator=(FrozenValue&& other) noexcept = default;
+FrozenValue::~FrozenValue() = default;
+
+Value FrozenValue::ToValue() const {
+  switch (type_) {
+    case Value::Type::NONE:
+      return Value();
+    case Value::Type::BOOLEAN:
+      return Value(bool_value_);
+    case Value::Type::INTEGER:
+      return Value(int_value_);
+    case Value::Type::DOUBLE:
+      return Value(double_value_);
+    case Value::Type::STRING:
+      return Value(node_->string_value());
+    case Value::Type::BINARY:
+      return Value(node_->blob_value());
+    case Value::Type::DICTIONARY: {
+      Value::DictStorage::container_type entries;
+      entries.reserve(node_->dict().size());
+      for (const auto& entry : node_->dict())
+        entries.emplace_back(entry.first, entry.second.ToValue());
+      return Value(Value::DictStorage(sorted_unique, std::move(entries)));
+    }
+    case Value::Type::LIST: {
+      Value::ListStorage list;
+      list.reserve(node_->list().size());
+      for (const auto& item : node_->list())
+        list.push_back(item.ToValue());
+      return Value(std::move(list));
+    }
+    // TODO(crbug.com/859477): Remove after root cause is found.
+    case Value::Type::DEAD:
+      CHECK(false);
+      return Value();
+  }
+  NOTREACHED();
+  return Value();
+}
+
+bool FrozenValue::GetBool() const {
+  CHECK(is_bool());
+  return bool_value_;
+}
+
+int FrozenValue::GetInt() const {
+  CHECK(is_int());
+  return int_value_;
+}
+
+double FrozenValue::GetDouble() const {
+  if (is_double())
+    return double_value_;
+  if (is_int())
+    return int_value_;
+  CHECK(false);
+  return 0.0;
+}
+
+const std::string& FrozenValue::GetString() const {
+  CHECK(is_string());
+  return node_->string_value();
+}
+
+const Value::BlobStorage& FrozenValue::GetBlob() const {
+  CHECK(is_blob());
+  return node_->blob_value();
+}
+
+const FrozenValue::ListStorage& FrozenValue::GetList() const {
+  CHECK(is_list());
+  return node_->list();
+}
+
+const FrozenValue::DictStorage& FrozenValue::DictItems() const {
+  CHECK(is_dict());
+  return node_->dict();
+}
+
+const FrozenValue* FrozenValue::FindKey(StringPiece key) const {
+  const DictStorage& dict = DictItems();
+  auto found = dict.find(key);
+  return found != dict.end() ? &found->second : nullptr;
+}
+
+const FrozenValue* FrozenValue::FindPath(StringPiece path) const {
+  const FrozenValue* current = this;
+  while (current->is_dict()) {
+    const size_t pos = path.find('.');
+    current = current->FindKey(path.substr(0, pos));
+    if (!current || pos == StringPiece::npos)
+      return current;
+    path = path.substr(pos + 1);
+  }
+  return nullptr;
+}
+
+FrozenValue FrozenValue::SetPath(StringPiece path, FrozenValue value) const {
+  return ReplacePath(path, &value);
+}
+
+FrozenValue FrozenValue::RemovePath(StringPiece path) const {
+  return ReplacePath(path, nullptr);
+}
+
+FrozenValue FrozenValue::ReplacePath(StringPiece path,
+                                     const FrozenValue* value) const {
+  const DictStorage& dict = DictItems();
+  const size_t pos = path.find('.');
+  const StringPiece key = path.substr(0, pos);
+  auto found = dict.find(key);
+
+  // Work out the new value of |key| before copying this node, so that removing
+  // a path which doesn't exist copies nothing. A null |child| means that |key|
+  // is removed.
+  Optional<FrozenValue> child;
+  if (pos == StringPiece::npos) {
+    if (value)
+      child = *value;
+    else if (found == dict.end())
+      return *this;
+  } else if (value) {
+    const StringPiece rest = path.substr(pos + 1);
+    child = found != dict.end() && found->second.is_dict()
+                ? found->second.ReplacePath(rest, value)
+                : FrozenValue(DictStorage()).ReplacePath(rest, value);
+  } else {
+    if (found == dict.end() || !found->second.is_dict())
+      return *this;
+    child = found->second.ReplacePath(path.substr(pos + 1), nullptr);
+    if (child->node_ == found->second.node_)
+      return *this;
+    if (child->node_->dict().empty())
+      child.reset();
+  }
+
+  // Only this node is copied; the entries themselves are shared.
+  DictStorage new_dict = dict;
+  if (child)
+    new_dict.insert_or_assign(std::string(key), std::move(*child));
+  else
+    new_dict.erase(key);
+  return FrozenValue(std::move(new_dict));
+}
+
+bool operator==(const FrozenValue& lhs, const FrozenValue& rhs) {
+  if (lhs.type_ != rhs.type_)
+    return false;
+
+  switch (lhs.type_) {
+    case Value::Type::NONE:
+      return true;
+    case Value::Type::BOOLEAN:
+      return lhs.bool_value_ == rhs.bool_value_;
+    case Value::Type::INTEGER:
+      return lhs.int_value_ == rhs.int_value_;
+    case Value::Type::DOUBLE:
+      return lhs.double_value_ == rhs.double_value_;
+    default:
+      break;
+  }
+
+  // Snapshots of the same tree usually share most of their nodes, which are
+  // equal without looking at their contents.
+  if (lhs.node_ == rhs.node_)
+    return true;
+
+  switch (lhs.type_) {
+    case Value::Type::STRING:
+      return lhs.node_->string_value() == rhs.node_->string_value();
+    case Value::Type::BINARY:
+      return lhs.node_->blob_value() == rhs.node_->blob_value();
+    case Value::Type::DICTIONARY:
+      return lhs.node_->dict() == rhs.node_->dict();
+    case Value::Type::LIST:
+      return lhs.node_->list() == rhs.node_->list();
+    default:
+      NOTREACHED();
+      return false;
+  }
+}
+
+bool operator!=(const FrozenValue& lhs, const FrozenValue& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace base
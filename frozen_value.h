@@ -0,0 +1,120 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FROZEN_VALUE_H_
+#define BASE_FROZEN_VALUE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/flat_map.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+
+namespace base {
+
+// An immutable base::Value whose strings, blobs, dictionaries and lists are
+// reference counted and shared between copies. Copying a FrozenValue is
+// cheap, so it is suited to handing snapshots of a large tree to other
+// sequences, where Value::Clone() would copy all of it.
+//
+// A FrozenValue can be read from any number of sequences at once. The
+// "mutators" don't change it, but return a new FrozenValue which only has new
+// nodes along the path to the change, and shares the rest of the tree:
+//
+//   FrozenValue config(std::move(value));
+//   FrozenValue updated = config.SetPath("net.proxy", FrozenValue(Value("x")));
+//   // |config| is unchanged, and |updated| shares all of it but the "net"
+//   // and "net.proxy" nodes and the root.
+//
+// Like Value, dictionaries are sorted by key, and paths are dot-separated
+// keys of nested dictionaries.
+class BASE_EXPORT FrozenValue {
+ public:
+  using DictStorage = flat_map<std::string, FrozenValue>;
+  using ListStorage = std::vector<FrozenValue>;
+
+  // A NONE value.
+  FrozenValue();
+  // Freezes |value|, moving its contents.
+  explicit FrozenValue(Value value);
+  FrozenValue(const FrozenValue& other);
+  FrozenValue(FrozenValue&& other) noexcept;
+  FrozenValue& operator=(const FrozenValue& other);
+  FrozenValue& operator=(FrozenValue&& other) noexcept;
+  ~FrozenValue();
+
+  // Returns a deep copy as a mutable Value.
+  Value ToValue() const;
+
+  Value::Type type() const { return type_; }
+  bool is_none() const { return type_ == Value::Type::NONE; }
+  bool is_bool() const { return type_ == Value::Type::BOOLEAN; }
+  bool is_int() const { return type_ == Value::Type::INTEGER; }
+  bool is_double() const { return type_ == Value::Type::DOUBLE; }
+  bool is_string() const { return type_ == Value::Type::STRING; }
+  bool is_blob() const { return type_ == Value::Type::BINARY; }
+  bool is_dict() const { return type_ == Value::Type::DICTIONARY; }
+  bool is_list() const { return type_ == Value::Type::LIST; }
+
+  // These CHECK that the value has the right type, like Value's accessors.
+  bool GetBool() const;
+  int GetInt() const;
+  double GetDouble() const;  // Implicitly converts from int if necessary.
+  const std::string& GetString() const;
+  const Value::BlobStorage& GetBlob() const;
+  const ListStorage& GetList() const;
+  const DictStorage& DictItems() const;
+
+  // Returns the value of |key| in this dictionary, or nullptr if there is
+  // none. CHECKs that this is a dictionary.
+  const FrozenValue* FindKey(StringPiece key) const;
+
+  // Returns the value at |path|, or nullptr if there is none. Doesn't CHECK,
+  // so that it can be used to probe any value.
+  const FrozenValue* FindPath(StringPiece path) const;
+
+  // Returns a copy of this dictionary with |value| at |path|. Missing or
+  // non-dictionary intermediate nodes are replaced with dictionaries. CHECKs
+  // that this is a dictionary.
+  FrozenValue SetPath(StringPiece path, FrozenValue value) const;
+
+  // Returns a copy of this dictionary without the value at |path|, or an
+  // unchanged copy if there is none. Like Value::RemovePath(), intermediate
+  // dictionaries which become empty are removed as well. CHECKs that this is
+  // a dictionary.
+  FrozenValue RemovePath(StringPiece path) const;
+
+  BASE_EXPORT friend bool operator==(const FrozenValue& lhs,
+                                     const FrozenValue& rhs);
+  BASE_EXPORT friend bool operator!=(const FrozenValue& lhs,
+                                     const FrozenValue& rhs);
+
+ private:
+  class Node;
+
+  explicit FrozenValue(DictStorage dict);
+
+  // Returns a copy of this dictionary with |path| changed to |value|, or
+  // removed if |value| is null.
+  FrozenValue ReplacePath(StringPiece path, const FrozenValue* value) const;
+
+  Value::Type type_ = Value::Type::NONE;
+  union {
+    bool bool_value_;
+    int int_value_;
+    double double_value_;
+  };
+  // Holds the contents of strings, blobs, dictionaries and lists.
+  scoped_refptr<const Node> node_;
+};
+
+}  // namespace base
+
+#endif  // BASE_FROZEN_VALUE_H_
@@ -0,0 +1,191 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/frozen_value.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Returns {"a": {"b": "text", "c": [1, 2.5]}, "d": {"e": true}, "f": blob}.
+Value MakeTree() {
+  Value tree(Value::Type::DICTIONARY);
+  tree.SetStringPath("a.b", "text");
+  Value list(Value::Type::LIST);
+  list.Append(1);
+  list.Append(2.5);
+  tree.SetPath("a.c", std::move(list));
+  tree.SetBoolPath("d.e", true);
+  tree.SetKey("f", Value(Value::BlobStorage({1, 2, 3})));
+  return tree;
+}
+
+class ReaderDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  ReaderDelegate(const FrozenValue& snapshot, const Value& expected)
+      : snapshot_(snapshot), expected_(expected) {}
+  ReaderDelegate(const ReaderDelegate&) = delete;
+  ReaderDelegate& operator=(const ReaderDelegate&) = delete;
+
+  void Run() override {
+    for (int i = 0; i < 100; ++i) {
+      FrozenValue copy = snapshot_;
+      EXPECT_EQ(expected_, copy.ToValue());
+      EXPECT_EQ(i % 7,
+                copy.FindPath("section_" + NumberToString(i % 7) + ".index")
+                    ->GetInt());
+    }
+  }
+
+ private:
+  const FrozenValue snapshot_;
+  const Value& expected_;
+};
+
+}  // namespace
+
+TEST(FrozenValueTest, Scalars) {
+  EXPECT_TRUE(FrozenValue().is_none());
+  EXPECT_TRUE(FrozenValue(Value(true)).GetBool());
+  EXPECT_EQ(42, FrozenValue(Value(42)).GetInt());
+  EXPECT_EQ(42.0, FrozenValue(Value(42)).GetDouble());
+  EXPECT_EQ(2.5, FrozenValue(Value(2.5)).GetDouble());
+  EXPECT_EQ("text", FrozenValue(Value("text")).GetString());
+  EXPECT_EQ(Value(2.5), FrozenValue(Value(2.5)).ToValue());
+}
+
+TEST(FrozenValueTest, RoundTrip) {
+  const FrozenValue frozen(MakeTree());
+  ASSERT_TRUE(frozen.is_dict());
+  EXPECT_EQ(3u, frozen.DictItems().size());
+  EXPECT_EQ("text", frozen.FindPath("a.b")->GetString());
+  EXPECT_TRUE(frozen.FindPath("d.e")->GetBool());
+  EXPECT_EQ(Value::BlobStorage({1, 2, 3}), frozen.FindKey("f")->GetBlob());
+
+  const FrozenValue::ListStorage& list = frozen.FindPath("a.c")->GetList();
+  ASSERT_EQ(2u, list.size());
+  EXPECT_EQ(1, list[0].GetInt());
+  EXPECT_EQ(2.5, list[1].GetDouble());
+
+  EXPECT_EQ(nullptr, frozen.FindKey("b"));
+  EXPECT_EQ(nullptr, frozen.FindPath("a.x"));
+  EXPECT_EQ(nullptr, frozen.FindPath("a.b.c"));
+  EXPECT_EQ(nullptr, frozen.FindPath("f.a"));
+
+  EXPECT_EQ(MakeTree(), frozen.ToValue());
+}
+
+TEST(FrozenValueTest, CopiesShareNodes) {
+  const FrozenValue frozen(MakeTree());
+  const FrozenValue copy = frozen;
+  EXPECT_EQ(&frozen.DictItems(), &copy.DictItems());
+  EXPECT_EQ(frozen, copy);
+}
+
+TEST(FrozenValueTest, SetPath) {
+  const FrozenValue frozen(MakeTree());
+  const FrozenValue updated =
+      frozen.SetPath("a.b", FrozenValue(Value("changed")));
+
+  EXPECT_EQ("text", frozen.FindPath("a.b")->GetString());
+  EXPECT_EQ("changed", updated.FindPath("a.b")->GetString());
+
+  // The nodes along the path are new, and all of the others are shared.
+  EXPECT_NE(&frozen.DictItems(), &updated.DictItems());
+  EXPECT_NE(&frozen.FindKey("a")->DictItems(),
+            &updated.FindKey("a")->DictItems());
+  EXPECT_EQ(&frozen.FindPath("a.c")->GetList(),
+            &updated.FindPath("a.c")->GetList());
+  EXPECT_EQ(&frozen.FindKey("d")->DictItems(),
+            &updated.FindKey("d")->DictItems());
+  EXPECT_EQ(&frozen.FindKey("f")->GetBlob(), &updated.FindKey("f")->GetBlob());
+
+  Value expected = MakeTree();
+  expected.SetStringPath("a.b", "changed");
+  EXPECT_EQ(expected, updated.ToValue());
+  EXPECT_NE(frozen, updated);
+}
+
+TEST(FrozenValueTest, SetPathCreatesDictionaries) {
+  const FrozenValue frozen(MakeTree());
+  const FrozenValue updated =
+      frozen.SetPath("f.g.h", FrozenValue(Value(7))).SetPath("i", frozen);
+
+  // Unlike Value::SetPath(), the blob at "f" is replaced.
+  Value expected = MakeTree();
+  expected.RemoveKey("f");
+  expected.SetIntPath("f.g.h", 7);
+  expected.SetKey("i", MakeTree());
+  EXPECT_EQ(expected, updated.ToValue());
+  EXPECT_EQ(&frozen.DictItems(), &updated.FindKey("i")->DictItems());
+}
+
+TEST(FrozenValueTest, RemovePath) {
+  const FrozenValue frozen(MakeTree());
+
+  // Intermediate dictionaries which become empty are removed too.
+  const FrozenValue removed = frozen.RemovePath("d.e");
+  Value expected = MakeTree();
+  expected.RemovePath("d.e");
+  EXPECT_EQ(expected, removed.ToValue());
+  EXPECT_EQ(nullptr, removed.FindKey("d"));
+  EXPECT_EQ(&frozen.FindKey("a")->DictItems(),
+            &removed.FindKey("a")->DictItems());
+  EXPECT_TRUE(frozen.FindPath("d.e"));
+
+  const FrozenValue removed_key = frozen.RemovePath("a.b");
+  EXPECT_EQ(nullptr, removed_key.FindPath("a.b"));
+  EXPECT_TRUE(removed_key.FindPath("a.c"));
+
+  // Removing a path which doesn't exist copies nothing.
+  EXPECT_EQ(&frozen.DictItems(), &frozen.RemovePath("a.x").DictItems());
+  EXPECT_EQ(&frozen.DictItems(), &frozen.RemovePath("f.x").DictItems());
+  EXPECT_EQ(&frozen.DictItems(), &frozen.RemovePath("x").DictItems());
+}
+
+TEST(FrozenValueTest, Equality) {
+  EXPECT_EQ(FrozenValue(MakeTree()), FrozenValue(MakeTree()));
+  EXPECT_NE(FrozenValue(Value(1)), FrozenValue(Value(1.0)));
+  EXPECT_NE(FrozenValue(Value("a")), FrozenValue(Value("b")));
+  EXPECT_EQ(FrozenValue(), FrozenValue(Value()));
+}
+
+TEST(FrozenValueTest, ConcurrentReads) {
+  Value tree(Value::Type::DICTIONARY);
+  for (int i = 0; i < 7; ++i) {
+    const std::string section = "section_" + NumberToString(i);
+    tree.SetIntPath(section + ".index", i);
+    tree.SetStringPath(section + ".name", section);
+  }
+  const FrozenValue snapshot(tree.Clone());
+
+  std::vector<std::unique_ptr<ReaderDelegate>> delegates;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < 4; ++i) {
+    delegates.push_back(std::make_unique<ReaderDelegate>(snapshot, tree));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        delegates.back().get(), "FrozenValueReader"));
+    threads.back()->Start();
+  }
+  // Keep making new snapshots from this sequence while the readers run.
+  FrozenValue updated = snapshot;
+  for (int i = 0; i < 100; ++i)
+    updated = updated.SetPath("extra.value", FrozenValue(Value(i)));
+  for (auto& thread : threads)
+    thread->Join();
+
+  EXPECT_EQ(tree, snapshot.ToValue());
+  EXPECT_EQ(99, updated.FindPath("extra.value")->GetInt());
+}
+
+}  // namespace base
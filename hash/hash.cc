@@ -4,6 +4,10 @@
 
 #include "base/hash/hash.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/check_op.h"
 #include "base/notreached.h"
 #include "base/rand_util.h"
@@ -119,6 +123,48 @@ size_t FastHash(base::span<const uint8_t> data) {
   return Scramble(FastHashImpl(data));
 }
 
+FastHasher::FastHasher() = default;
+
+FastHasher::~FastHasher() = default;
+
+void FastHasher::Update(span<const uint8_t> data) {
+  length_ += data.size();
+  if (buffered_) {
+    const size_t count = std::min(data.size(), kBlockSize - buffered_);
+    memcpy(buffer_ + buffered_, data.data(), count);
+    buffered_ += count;
+    data = data.subspan(count);
+    if (buffered_ < kBlockSize)
+      return;
+    HashBlock(buffer_);
+    buffered_ = 0;
+  }
+  // Whole blocks are hashed in place.
+  while (data.size() >= kBlockSize) {
+    HashBlock(data.data());
+    data = data.subspan(kBlockSize);
+  }
+  if (!data.empty()) {
+    memcpy(buffer_, data.data(), data.size());
+    buffered_ = data.size();
+  }
+}
+
+size_t FastHasher::Finish() {
+  const uint64_t last = base::internal::cityhash_v111::CityHash64WithSeed(
+      reinterpret_cast<const char*>(buffer_), buffered_, state_);
+  const size_t hash = HashInts64Impl(last, length_);
+  state_ = 0;
+  length_ = 0;
+  buffered_ = 0;
+  return Scramble(hash);
+}
+
+void FastHasher::HashBlock(const uint8_t* block) {
+  state_ = base::internal::cityhash_v111::CityHash64WithSeed(
+      reinterpret_cast<const char*>(block), kBlockSize, state_);
+}
+
 uint32_t Hash(const void* data, size_t length) {
   // Currently our in-memory hash is the same as the persistent hash. The
   // split between in-memory and persistent hash functions is maintained to
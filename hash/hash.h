@@ -41,6 +41,37 @@ inline size_t FastHash(StringPiece str) {
   return FastHash(as_bytes(make_span(str)));
 }
 
+// Computes a hash of the same quality as FastHash() incrementally, for data
+// which is passed in pieces. The result only depends on the concatenation of
+// the pieces, but isn't the same as FastHash() of it. May change without
+// warning, do not expect stability of outputs.
+class BASE_EXPORT FastHasher {
+ public:
+  FastHasher();
+  FastHasher(const FastHasher&) = delete;
+  FastHasher& operator=(const FastHasher&) = delete;
+  ~FastHasher();
+
+  void Update(span<const uint8_t> data);
+  void Update(StringPiece data) { Update(as_bytes(make_span(data))); }
+
+  // Returns the hash of all the data passed to Update(), and starts over.
+  size_t Finish();
+
+ private:
+  // The data is hashed in blocks of this size, each one seeded with the hash
+  // of the previous ones.
+  static constexpr size_t kBlockSize = 1024;
+
+  void HashBlock(const uint8_t* block);
+
+  uint64_t state_ = 0;
+  uint64_t length_ = 0;
+  // The start of a partial block.
+  uint8_t buffer_[kBlockSize];
+  size_t buffered_ = 0;
+};
+
 // Computes a hash of a memory buffer. This hash function must not change so
 // that code can use the hashed values for persistent storage purposes or
 // sending across the network. If a new persistent hash function is desired, a
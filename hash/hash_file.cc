@@ -0,0 +1,96 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/hash/hash_file.h"
+
+#include <memory>
+
+#include "base/barrier_closure.h"
+#include "base/files/file.h"
+#include "base/location.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "build/build_config.h"
+
+#if defined(OS_POSIX) || defined(OS_FUCHSIA)
+#include <fcntl.h>
+#endif
+
+namespace base {
+
+namespace {
+
+// Large enough to amortize the cost of each read, small enough that hashing a
+// chunk takes about as long as reading the next one from disk.
+constexpr int kChunkSize = 1 << 20;
+
+// Asks the kernel to start reading |length| bytes at |offset| into the page
+// cache, so that the next read doesn't wait for the disk while the current
+// chunk is being hashed. Failures only cost performance, so they're ignored.
+void ReadAhead(File* file, int64_t offset, int length) {
+  // posix_fadvise() is only available in the Android NDK in API 21+.
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || \
+    (defined(OS_ANDROID) && __ANDROID_API__ >= 21)
+  posix_fadvise(file->GetPlatformFile(), static_cast<off_t>(offset),
+                static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+#elif defined(OS_APPLE)
+  ::radvisory read_advise_data = {.ra_offset = static_cast<off_t>(offset),
+                                  .ra_count = length};
+  fcntl(file->GetPlatformFile(), F_RDADVISE, &read_advise_data);
+#endif
+}
+
+}  // namespace
+
+namespace internal {
+
+bool ReadFileForHashing(
+    const FilePath& path,
+    const RepeatingCallback<void(span<const uint8_t>)>& update) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  // On Windows, FLAG_SEQUENTIAL_SCAN makes the cache manager read ahead
+  // instead of ReadAhead().
+  File file(path,
+            File::FLAG_OPEN | File::FLAG_READ | File::FLAG_SEQUENTIAL_SCAN);
+  if (!file.IsValid())
+    return false;
+
+  std::unique_ptr<char[]> buffer(new char[kChunkSize]);
+  int64_t offset = 0;
+  while (true) {
+    const int bytes_read = file.Read(offset, buffer.get(), kChunkSize);
+    if (bytes_read < 0)
+      return false;
+    if (bytes_read == 0)
+      return true;
+    offset += bytes_read;
+    ReadAhead(&file, offset, kChunkSize);
+    update.Run(make_span(reinterpret_cast<const uint8_t*>(buffer.get()),
+                         static_cast<size_t>(bytes_read)));
+  }
+}
+
+void HashFilesInParallel(
+    std::vector<FilePath> paths,
+    RepeatingCallback<void(size_t, const FilePath&)> hash_file,
+    OnceClosure done) {
+  if (paths.empty()) {
+    SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE, std::move(done));
+    return;
+  }
+  RepeatingClosure barrier = BarrierClosure(paths.size(), std::move(done));
+  for (size_t i = 0; i < paths.size(); ++i) {
+    ThreadPool::PostTaskAndReply(
+        FROM_HERE,
+        {MayBlock(), TaskPriority::USER_VISIBLE,
+         TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        BindOnce(hash_file, i, std::move(paths[i])), barrier);
+  }
+}
+
+}  // namespace internal
+
+}  // namespace base
@@ -0,0 +1,98 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_HASH_HASH_FILE_H_
+#define BASE_HASH_HASH_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/optional.h"
+
+namespace base {
+
+// Helpers to hash the contents of files without reading them into memory
+// first. They work with any hasher which has Update(span<const uint8_t>) and
+// Finish() methods, such as MD5Hasher, SHA1Hasher, Crc32Hasher and FastHasher:
+//
+//   Optional<SHA1Digest> digest = HashFile<SHA1Hasher>(path);
+
+// The result of HashFile<Hasher>().
+template <typename Hasher>
+using HashFileResult = decltype(std::declval<Hasher&>().Finish());
+
+namespace internal {
+
+// Passes the contents of the file at |path| to |update| in order, in large
+// chunks. The kernel is asked to read the next chunk ahead while |update|
+// runs. Returns false if the file couldn't be read, possibly after
+// passing part of it to |update|.
+BASE_EXPORT bool ReadFileForHashing(
+    const FilePath& path,
+    const RepeatingCallback<void(span<const uint8_t>)>& update);
+
+// Runs |hash_file| with the index and path of each of |paths| on the thread
+// pool, then runs |done| on the current sequence.
+BASE_EXPORT void HashFilesInParallel(
+    std::vector<FilePath> paths,
+    RepeatingCallback<void(size_t, const FilePath&)> hash_file,
+    OnceClosure done);
+
+}  // namespace internal
+
+// Returns the hash of the contents of the file at |path|, or nullopt if it
+// couldn't be read. Must be called where blocking is allowed.
+template <typename Hasher>
+Optional<HashFileResult<Hasher>> HashFile(const FilePath& path) {
+  Hasher hasher;
+  const bool success = internal::ReadFileForHashing(
+      path,
+      BindRepeating(
+          [](Hasher* hasher, span<const uint8_t> data) {
+            hasher->Update(data);
+          },
+          Unretained(&hasher)));
+  if (!success)
+    return nullopt;
+  return hasher.Finish();
+}
+
+// Hashes the files at |paths| with HashFile<Hasher>() in parallel on the
+// thread pool, then runs |callback| on the current sequence with the results
+// in the same order.
+template <typename Hasher>
+void HashFiles(
+    std::vector<FilePath> paths,
+    OnceCallback<void(std::vector<Optional<HashFileResult<Hasher>>>)>
+        callback) {
+  using Results = std::vector<Optional<HashFileResult<Hasher>>>;
+  auto results = MakeRefCounted<RefCountedData<Results>>(Results(paths.size()));
+  internal::HashFilesInParallel(
+      std::move(paths),
+      BindRepeating(
+          [](const scoped_refptr<RefCountedData<Results>>& results,
+             size_t index, const FilePath& path) {
+            results->data[index] = HashFile<Hasher>(path);
+          },
+          results),
+      BindOnce(
+          [](scoped_refptr<RefCountedData<Results>> results,
+             OnceCallback<void(Results)> callback) {
+            std::move(callback).Run(std::move(results->data));
+          },
+          results, std::move(callback)));
+}
+
+}  // namespace base
+
+#endif  // BASE_HASH_HASH_FILE_H_
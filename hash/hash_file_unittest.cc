@@ -0,0 +1,119 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/hash/hash_file.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/hash/hash.h"
+#include "base/hash/md5.h"
+#include "base/hash/sha1.h"
+#include "base/metrics/crc32.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class HashFileTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  // Writes |size| bytes of varied data to a new file, and returns its path.
+  FilePath WriteFile(size_t size, std::string* contents) {
+    contents->resize(size);
+    for (size_t i = 0; i < size; ++i)
+      (*contents)[i] = static_cast<char>(i * 31 + i / 4099);
+    FilePath path = temp_dir_.GetPath().AppendASCII(
+        "file" + std::to_string(file_count_++));
+    EXPECT_TRUE(base::WriteFile(path, *contents));
+    return path;
+  }
+
+  test::TaskEnvironment task_environment_;
+  ScopedTempDir temp_dir_;
+  int file_count_ = 0;
+};
+
+}  // namespace
+
+TEST_F(HashFileTest, MatchesInMemoryHashes) {
+  // Empty, smaller than a chunk, and several chunks which don't end on a
+  // chunk boundary.
+  for (size_t size : {0, 100, (1 << 20) + 3, 5 * (1 << 20) - 7}) {
+    std::string contents;
+    const FilePath path = WriteFile(size, &contents);
+
+    Optional<SHA1Digest> sha1 = HashFile<SHA1Hasher>(path);
+    ASSERT_TRUE(sha1) << size;
+    EXPECT_EQ(SHA1HashSpan(as_bytes(make_span(contents))), *sha1) << size;
+
+    Optional<MD5Digest> md5 = HashFile<MD5Hasher>(path);
+    ASSERT_TRUE(md5) << size;
+    EXPECT_EQ(MD5String(contents), MD5DigestToBase16(*md5)) << size;
+
+    EXPECT_EQ(Crc32(0, contents.data(), contents.size()),
+              HashFile<Crc32Hasher>(path))
+        << size;
+
+    FastHasher fast_hasher;
+    fast_hasher.Update(contents);
+    EXPECT_EQ(fast_hasher.Finish(), HashFile<FastHasher>(path)) << size;
+  }
+}
+
+TEST_F(HashFileTest, MissingFile) {
+  EXPECT_FALSE(HashFile<SHA1Hasher>(temp_dir_.GetPath().AppendASCII("none")));
+}
+
+TEST_F(HashFileTest, HashFiles) {
+  std::vector<FilePath> paths;
+  std::vector<std::string> contents(4);
+  paths.push_back(WriteFile(10, &contents[0]));
+  paths.push_back(temp_dir_.GetPath().AppendASCII("none"));
+  paths.push_back(WriteFile(3 << 20, &contents[2]));
+  paths.push_back(WriteFile(0, &contents[3]));
+
+  std::vector<Optional<SHA1Digest>> results;
+  RunLoop run_loop;
+  HashFiles<SHA1Hasher>(
+      paths, BindOnce(
+                 [](std::vector<Optional<SHA1Digest>>* results,
+                    OnceClosure quit, std::vector<Optional<SHA1Digest>> r) {
+                   *results = std::move(r);
+                   std::move(quit).Run();
+                 },
+                 &results, run_loop.QuitClosure()));
+  run_loop.Run();
+
+  ASSERT_EQ(paths.size(), results.size());
+  EXPECT_FALSE(results[1]);
+  for (size_t i : {0, 2, 3}) {
+    ASSERT_TRUE(results[i]) << i;
+    EXPECT_EQ(SHA1HashSpan(as_bytes(make_span(contents[i]))), *results[i])
+        << i;
+  }
+
+  // An empty list still runs the callback.
+  bool ran = false;
+  RunLoop empty_run_loop;
+  HashFiles<SHA1Hasher>(
+      {}, BindOnce(
+              [](bool* ran, OnceClosure quit,
+                 std::vector<Optional<SHA1Digest>> results) {
+                EXPECT_TRUE(results.empty());
+                *ran = true;
+                std::move(quit).Run();
+              },
+              &ran, empty_run_loop.QuitClosure()));
+  empty_run_loop.Run();
+  EXPECT_TRUE(ran);
+}
+
+}  // namespace base
@@ -85,4 +85,28 @@ TEST(HashTest, FastHash) {
   EXPECT_EQ(FastHash(s), FastHash(kEmptyString));
 }
 
+TEST(HashTest, FastHasher) {
+  std::string data;
+  for (size_t i = 0; i < 5000; ++i)
+    data.push_back(static_cast<char>(i * 7));
+
+  FastHasher hasher;
+  hasher.Update(data);
+  const size_t expected = hasher.Finish();
+
+  // The result doesn't depend on how the data is split.
+  for (size_t piece : {1, 3, 1023, 1024, 1025, 4999}) {
+    for (size_t i = 0; i < data.size(); i += piece)
+      hasher.Update(StringPiece(data).substr(i, piece));
+    EXPECT_EQ(expected, hasher.Finish()) << piece;
+  }
+
+  // But it does depend on the data, including its length.
+  hasher.Update(StringPiece(data).substr(0, data.size() - 1));
+  EXPECT_NE(expected, hasher.Finish());
+  hasher.Update(data);
+  hasher.Update(StringPiece("\0", 1));
+  EXPECT_NE(expected, hasher.Finish());
+}
+
 }  // namespace base
@@ -297,4 +297,26 @@ std::string MD5String(const StringPiece& str) {
   return MD5DigestToBase16(digest);
 }
 
+MD5Hasher::MD5Hasher() {
+  MD5Init(&context_);
+}
+
+MD5Hasher::~MD5Hasher() = default;
+
+void MD5Hasher::Update(span<const uint8_t> data) {
+  MD5Update(&context_, StringPiece(reinterpret_cast<const char*>(data.data()),
+                                   data.size()));
+}
+
+void MD5Hasher::Update(StringPiece data) {
+  MD5Update(&context_, data);
+}
+
+MD5Digest MD5Hasher::Finish() {
+  MD5Digest digest;
+  MD5Final(&digest, &context_);
+  MD5Init(&context_);
+  return digest;
+}
+
 }  // namespace base
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 #include "base/strings/string_piece.h"
 
 namespace base {
@@ -73,6 +74,28 @@ BASE_EXPORT void MD5Sum(const void* data, size_t length, MD5Digest* digest);
 // Returns the MD5 (in hexadecimal) of a string.
 BASE_EXPORT std::string MD5String(const StringPiece& str);
 
+// Computes an MD5 sum incrementally, like the MD5Context functions above:
+//   MD5Hasher hasher;
+//   hasher.Update(data1);
+//   hasher.Update(data2);
+//   MD5Digest digest = hasher.Finish();
+class BASE_EXPORT MD5Hasher {
+ public:
+  MD5Hasher();
+  MD5Hasher(const MD5Hasher&) = delete;
+  MD5Hasher& operator=(const MD5Hasher&) = delete;
+  ~MD5Hasher();
+
+  void Update(span<const uint8_t> data);
+  void Update(StringPiece data);
+
+  // Returns the sum of all the data passed to Update(), and starts over.
+  MD5Digest Finish();
+
+ private:
+  MD5Context context_;
+};
+
 }  // namespace base
 
 #endif  // BASE_HASH_MD5_H_
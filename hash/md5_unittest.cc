@@ -228,4 +228,16 @@ TEST(MD5, IntermediateFinal) {
   EXPECT_TRUE(memcmp(&digest, &header_digest, sizeof(digest)));
 }
 
+TEST(MD5, Hasher) {
+  MD5Hasher hasher;
+  hasher.Update("The quick brown fox ");
+  hasher.Update(as_bytes(make_span(StringPiece("jumps over the lazy dog"))));
+  EXPECT_EQ("9e107d9d372bb6826bd81d3542a419d6",
+            MD5DigestToBase16(hasher.Finish()));
+
+  // Finish() starts over.
+  EXPECT_EQ("d41d8cd98f00b204e9800998ecf8427e",
+            MD5DigestToBase16(hasher.Finish()));
+}
+
 }  // namespace base
@@ -8,16 +8,472 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#include "base/check_op.h"
+#include "base/cpu.h"
 #include "base/sys_byteorder.h"
+#include "build/build_config.h"
+
+// The accelerated kernels are compiled with function-level target attributes,
+// so that the rest of the file still runs on CPUs without the extensions.
+// NaCl builds have no base::CPU, and NaCl validation rejects the instructions.
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL) && \
+    (defined(COMPILER_GCC) || defined(__clang__))
+#define SHA1_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 namespace base {
 
-// Implementation of SHA-1. Only handles data in byte-sized blocks,
-// which simplifies the code a fair bit.
+namespace {
+
+constexpr size_t kBlockSize = 64;
+
+constexpr uint32_t kInitialState[5] = {0x67452301, 0xefcdab89, 0x98badcfe,
+                                       0x10325476, 0xc3d2e1f0};
+
+// Round constants, one per 20 rounds.
+constexpr uint32_t kK0 = 0x5a827999;
+constexpr uint32_t kK1 = 0x6ed9eba1;
+constexpr uint32_t kK2 = 0x8f1bbcdc;
+constexpr uint32_t kK3 = 0xca62c1d6;
+
+// Updates |state| with |num_blocks| consecutive 64-byte blocks.
+using ProcessBlocksFunction = void (*)(uint32_t* state,
+                                       const uint8_t* blocks,
+                                       size_t num_blocks);
+
+// The kernel set by SetSHA1KernelForTesting().
+SHA1Kernel g_kernel_for_testing = SHA1Kernel::kDefault;
+
+inline uint32_t S(uint32_t n, uint32_t X) {
+  return (X << n) | (X >> (32 - n));
+}
+
+inline uint32_t LoadBigEndian(const uint8_t* in) {
+  uint32_t value;
+  memcpy(&value, in, sizeof(value));
+  return NetToHost32(value);
+}
 
 // Identifier names follow notation in FIPS PUB 180-3, where you'll
 // also find a description of the algorithm:
 // http://csrc.nist.gov/publications/fips/fips180-3/fips180-3_final.pdf
+void ProcessBlocksPortable(uint32_t* H,
+                           const uint8_t* blocks,
+                           size_t num_blocks) {
+  for (; num_blocks; --num_blocks, blocks += kBlockSize) {
+    uint32_t W[80];
+    for (int t = 0; t < 16; ++t)
+      W[t] = LoadBigEndian(blocks + 4 * t);
+    for (int t = 16; t < 80; ++t)
+      W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+
+    uint32_t A = H[0], B = H[1], C = H[2], D = H[3], E = H[4];
+    auto round = [&](uint32_t f, uint32_t K, uint32_t w) {
+      const uint32_t TEMP = S(5, A) + f + E + w + K;
+      E = D;
+      D = C;
+      C = S(30, B);
+      B = A;
+      A = TEMP;
+    };
+    int t = 0;
+    for (; t < 20; ++t)
+      round((B & C) | (~B & D), kK0, W[t]);
+    for (; t < 40; ++t)
+      round(B ^ C ^ D, kK1, W[t]);
+    for (; t < 60; ++t)
+      round((B & C) | (B & D) | (C & D), kK2, W[t]);
+    for (; t < 80; ++t)
+      round(B ^ C ^ D, kK3, W[t]);
+
+    H[0] += A;
+    H[1] += B;
+    H[2] += C;
+    H[3] += D;
+    H[4] += E;
+  }
+}
+
+#if defined(SHA1_HAS_X86_KERNELS)
+
+// Processes group |kGroup| of four rounds with the SHA extensions.
+// |msg[kGroup % 4]| holds the message words W[4 * kGroup..4 * kGroup + 3],
+// and is computed from the previous four groups' words in place.
+template <int kGroup>
+__attribute__((target("sha,sse4.1"), always_inline)) inline void ShaNiRounds4(
+    const uint8_t* block,
+    __m128i* msg,
+    __m128i* abcd,
+    __m128i* previous_abcd,
+    __m128i e0) {
+  const __m128i kByteSwap =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+  __m128i& w = msg[kGroup % 4];
+  if (kGroup < 4) {
+    w = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * kGroup)),
+        kByteSwap);
+  } else {
+    w = _mm_sha1msg2_epu32(
+        _mm_xor_si128(_mm_sha1msg1_epu32(w, msg[(kGroup + 1) % 4]),
+                      msg[(kGroup + 2) % 4]),
+        msg[(kGroup + 3) % 4]);
+  }
+  // E for these rounds is derived from A four rounds earlier.
+  const __m128i e = kGroup == 0 ? _mm_add_epi32(e0, w)
+                                : _mm_sha1nexte_epu32(*previous_abcd, w);
+  *previous_abcd = *abcd;
+  *abcd = _mm_sha1rnds4_epu32(*abcd, e, kGroup / 5);
+}
+
+__attribute__((target("sha,sse4.1"))) void ProcessBlocksShaNi(
+    uint32_t* state,
+    const uint8_t* blocks,
+    size_t num_blocks) {
+  // The instructions keep A in the highest lane, and E in the highest lane of
+  // a separate register.
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+  __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+  for (; num_blocks; --num_blocks, blocks += kBlockSize) {
+    const __m128i saved_abcd = abcd;
+    __m128i msg[4];
+    __m128i previous_abcd;
+    ShaNiRounds4<0>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<1>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<2>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<3>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<4>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<5>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<6>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<7>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<8>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<9>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<10>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<11>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<12>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<13>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<14>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<15>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<16>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<17>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<18>(blocks, msg, &abcd, &previous_abcd, e0);
+    ShaNiRounds4<19>(blocks, msg, &abcd, &previous_abcd, e0);
+    e0 = _mm_sha1nexte_epu32(previous_abcd, e0);
+    abcd = _mm_add_epi32(abcd, saved_abcd);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, 0x1b));
+  state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+#endif  // defined(SHA1_HAS_X86_KERNELS)
+
+ProcessBlocksFunction GetProcessBlocksFunction() {
+  if (g_kernel_for_testing != SHA1Kernel::kDefault) {
+#if defined(SHA1_HAS_X86_KERNELS)
+    if (g_kernel_for_testing == SHA1Kernel::kShaNi)
+      return &ProcessBlocksShaNi;
+#endif
+    return &ProcessBlocksPortable;
+  }
+  static const ProcessBlocksFunction function = [] {
+#if defined(SHA1_HAS_X86_KERNELS)
+    const CPU cpu;
+    if (cpu.has_sha() && cpu.has_sse41())
+      return &ProcessBlocksShaNi;
+#endif
+    return &ProcessBlocksPortable;
+  }();
+  return function;
+}
+
+// Writes the padding and length which follow the last |tail_size| bytes of a
+// |length| byte message, which are copied to |tail| first. Returns the number
+// of blocks written, 1 or 2. |tail| must have room for two blocks.
+size_t PadTail(const uint8_t* message_tail,
+               size_t tail_size,
+               uint64_t length,
+               uint8_t* tail) {
+  DCHECK_LT(tail_size, kBlockSize);
+  memset(tail, 0, 2 * kBlockSize);
+  if (tail_size)
+    memcpy(tail, message_tail, tail_size);
+  tail[tail_size] = 0x80;
+  const size_t num_blocks = tail_size + 1 + 8 > kBlockSize ? 2 : 1;
+  const uint64_t bit_length = HostToNet64(length * 8);
+  memcpy(tail + num_blocks * kBlockSize - 8, &bit_length, 8);
+  return num_blocks;
+}
+
+void StoreDigest(const uint32_t* state, unsigned char* hash) {
+  for (int i = 0; i < 5; ++i) {
+    const uint32_t word = HostToNet32(state[i]);
+    memcpy(hash + 4 * i, &word, sizeof(word));
+  }
+}
+
+#if defined(SHA1_HAS_X86_KERNELS)
+
+// Multi-buffer hashing with AVX2: each 32-bit lane of the vectors works on a
+// different message. The lanes are refilled with the next message as soon as
+// their current one is done, so that messages of different lengths keep all
+// of them busy.
+constexpr int kLanes = 8;
+
+struct Lane {
+  // The message being hashed, or -1 if the lane is idle.
+  ptrdiff_t index = -1;
+  // The next block to process, and the number of blocks left where it is.
+  const uint8_t* next = nullptr;
+  size_t blocks_left = 0;
+  // Whether |next| points to |tail| yet.
+  bool in_tail = false;
+  size_t tail_blocks = 0;
+  alignas(32) uint8_t tail[2 * kBlockSize];
+};
+
+__attribute__((target("avx2"), always_inline)) inline __m256i Rotate(
+    __m256i x,
+    int n) {
+  return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+// Round |t|, with round function value |f| and constant |K|. |W| holds the
+// last 16 message words, and is updated in place.
+__attribute__((target("avx2"), always_inline)) inline void Avx2Round(
+    int t,
+    __m256i f,
+    __m256i K,
+    __m256i* W,
+    __m256i* A,
+    __m256i* B,
+    __m256i* C,
+    __m256i* D,
+    __m256i* E) {
+  if (t >= 16) {
+    W[t % 16] = Rotate(
+        _mm256_xor_si256(_mm256_xor_si256(W[(t - 3) % 16], W[(t - 8) % 16]),
+                         _mm256_xor_si256(W[(t - 14) % 16], W[t % 16])),
+        1);
+  }
+  const __m256i TEMP =
+      _mm256_add_epi32(_mm256_add_epi32(Rotate(*A, 5), f),
+                       _mm256_add_epi32(_mm256_add_epi32(*E, W[t % 16]), K));
+  *E = *D;
+  *D = *C;
+  *C = Rotate(*B, 30);
+  *B = *A;
+  *A = TEMP;
+}
+
+// Transposes |rows| so that word |i| of every row ends up in |rows[i]|.
+__attribute__((target("avx2"), always_inline)) inline void Transpose8x8(
+    __m256i* rows) {
+  __m256i t[8];
+  for (int i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+    t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+  }
+  __m256i u[8];
+  for (int i = 0; i < 8; i += 4) {
+    u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+    u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+    u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+    u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+  }
+  for (int i = 0; i < 4; ++i) {
+    rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+    rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+  }
+}
+
+// Processes |num_blocks| blocks of each lane. |state[i]| holds word |i| of the
+// state of all lanes.
+__attribute__((target("avx2"))) void ProcessBlocksAvx2x8(
+    __m256i* state,
+    const uint8_t* const* blocks,
+    size_t num_blocks) {
+  const __m256i kByteSwap = _mm256_setr_epi8(
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6,
+      5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  __m256i H[5];
+  for (int i = 0; i < 5; ++i)
+    H[i] = state[i];
+
+  for (size_t block = 0; block < num_blocks; ++block) {
+    __m256i W[16];
+    for (int half = 0; half < 2; ++half) {
+      for (int lane = 0; lane < kLanes; ++lane) {
+        const uint8_t* words = blocks[lane] + block * kBlockSize + 32 * half;
+        W[8 * half + lane] =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+      }
+      Transpose8x8(W + 8 * half);
+    }
+    for (__m256i& w : W)
+      w = _mm256_shuffle_epi8(w, kByteSwap);
+
+    __m256i A = H[0], B = H[1], C = H[2], D = H[3], E = H[4];
+    const __m256i K0 = _mm256_set1_epi32(static_cast<int>(kK0));
+    const __m256i K1 = _mm256_set1_epi32(static_cast<int>(kK1));
+    const __m256i K2 = _mm256_set1_epi32(static_cast<int>(kK2));
+    const __m256i K3 = _mm256_set1_epi32(static_cast<int>(kK3));
+    int t = 0;
+    for (; t < 20; ++t) {
+      // (B & C) | (~B & D), as D ^ (B & (C ^ D)).
+      const __m256i f =
+          _mm256_xor_si256(D, _mm256_and_si256(B, _mm256_xor_si256(C, D)));
+      Avx2Round(t, f, K0, W, &A, &B, &C, &D, &E);
+    }
+    for (; t < 40; ++t) {
+      const __m256i f = _mm256_xor_si256(_mm256_xor_si256(B, C), D);
+      Avx2Round(t, f, K1, W, &A, &B, &C, &D, &E);
+    }
+    for (; t < 60; ++t) {
+      // The majority of B, C and D, as (B & C) | (D & (B | C)).
+      const __m256i f =
+          _mm256_or_si256(_mm256_and_si256(B, C),
+                          _mm256_and_si256(D, _mm256_or_si256(B, C)));
+      Avx2Round(t, f, K2, W, &A, &B, &C, &D, &E);
+    }
+    for (; t < 80; ++t) {
+      const __m256i f = _mm256_xor_si256(_mm256_xor_si256(B, C), D);
+      Avx2Round(t, f, K3, W, &A, &B, &C, &D, &E);
+    }
+
+    H[0] = _mm256_add_epi32(H[0], A);
+    H[1] = _mm256_add_epi32(H[1], B);
+    H[2] = _mm256_add_epi32(H[2], C);
+    H[3] = _mm256_add_epi32(H[3], D);
+    H[4] = _mm256_add_epi32(H[4], E);
+  }
+
+  for (int i = 0; i < 5; ++i)
+    state[i] = H[i];
+}
+
+// Starts hashing |inputs[index]| in |lane|.
+void StartLane(span<const span<const uint8_t>> inputs,
+               ptrdiff_t index,
+               Lane* lane) {
+  const span<const uint8_t> input = inputs[index];
+  lane->index = index;
+  lane->tail_blocks =
+      PadTail(input.data() + input.size() / kBlockSize * kBlockSize,
+              input.size() % kBlockSize, input.size(), lane->tail);
+  lane->blocks_left = input.size() / kBlockSize;
+  lane->in_tail = !lane->blocks_left;
+  lane->next = lane->in_tail ? lane->tail : input.data();
+  if (lane->in_tail)
+    lane->blocks_left = lane->tail_blocks;
+}
+
+__attribute__((target("avx2"))) void HashSpansAvx2(
+    span<const span<const uint8_t>> inputs,
+    span<SHA1Digest> digests) {
+  Lane lanes[kLanes];
+  __m256i state[5] = {};
+  ptrdiff_t next_input = 0;
+  const ptrdiff_t num_inputs = static_cast<ptrdiff_t>(inputs.size());
+
+  while (true) {
+    // Refill the idle lanes, and stop once the inputs run out: the few
+    // messages left are faster to finish one at a time.
+    alignas(32) uint32_t words[5][kLanes];
+    bool refilled = false;
+    bool all_busy = true;
+    for (int i = 0; i < kLanes && all_busy; ++i) {
+      Lane& lane = lanes[i];
+      if (lane.index >= 0)
+        continue;
+      if (next_input == num_inputs) {
+        all_busy = false;
+        break;
+      }
+      if (!refilled) {
+        for (int word = 0; word < 5; ++word) {
+          _mm256_store_si256(reinterpret_cast<__m256i*>(words[word]),
+                             state[word]);
+        }
+        refilled = true;
+      }
+      StartLane(inputs, next_input++, &lane);
+      for (int word = 0; word < 5; ++word)
+        words[word][i] = kInitialState[word];
+    }
+    if (refilled) {
+      for (int word = 0; word < 5; ++word) {
+        state[word] =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(words[word]));
+      }
+    }
+    if (!all_busy)
+      break;
+
+    const uint8_t* blocks[kLanes];
+    size_t num_blocks = SIZE_MAX;
+    for (int i = 0; i < kLanes; ++i) {
+      blocks[i] = lanes[i].next;
+      num_blocks = std::min(num_blocks, lanes[i].blocks_left);
+    }
+    ProcessBlocksAvx2x8(state, blocks, num_blocks);
+
+    bool stored = false;
+    for (int i = 0; i < kLanes; ++i) {
+      Lane& lane = lanes[i];
+      lane.next += num_blocks * kBlockSize;
+      lane.blocks_left -= num_blocks;
+      if (lane.blocks_left)
+        continue;
+      if (!lane.in_tail) {
+        lane.in_tail = true;
+        lane.next = lane.tail;
+        lane.blocks_left = lane.tail_blocks;
+        continue;
+      }
+      if (!stored) {
+        for (int word = 0; word < 5; ++word) {
+          _mm256_store_si256(reinterpret_cast<__m256i*>(words[word]),
+                             state[word]);
+        }
+        stored = true;
+      }
+      const uint32_t lane_state[5] = {words[0][i], words[1][i], words[2][i],
+                                      words[3][i], words[4][i]};
+      StoreDigest(lane_state, digests[lane.index].data());
+      lane.index = -1;
+    }
+  }
+
+  // Finish the lanes which are still busy on their own.
+  alignas(32) uint32_t words[5][kLanes];
+  for (int word = 0; word < 5; ++word)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(words[word]), state[word]);
+  const ProcessBlocksFunction process_blocks = GetProcessBlocksFunction();
+  for (int i = 0; i < kLanes; ++i) {
+    const Lane& lane = lanes[i];
+    if (lane.index < 0)
+      continue;
+    uint32_t lane_state[5] = {words[0][i], words[1][i], words[2][i],
+                              words[3][i], words[4][i]};
+    process_blocks(lane_state, lane.next, lane.blocks_left);
+    if (!lane.in_tail)
+      process_blocks(lane_state, lane.tail, lane.tail_blocks);
+    StoreDigest(lane_state, digests[lane.index].data());
+  }
+}
+
+#endif  // defined(SHA1_HAS_X86_KERNELS)
+
+}  // namespace
 
 // Usage example:
 //
@@ -31,7 +487,9 @@ namespace base {
 
 class SecureHashAlgorithm {
  public:
-  SecureHashAlgorithm() { Init(); }
+  SecureHashAlgorithm() : process_blocks_(GetProcessBlocksFunction()) {
+    Init();
+  }
 
   static const int kDigestSizeBytes;
 
@@ -40,151 +498,56 @@ class SecureHashAlgorithm {
   void Final();
 
   // 20 bytes of message digest.
-  const unsigned char* Digest() const {
-    return reinterpret_cast<const unsigned char*>(H);
-  }
+  const unsigned char* Digest() const { return digest_; }
 
  private:
-  void Pad();
-  void Process();
-
-  uint32_t A, B, C, D, E;
+  const ProcessBlocksFunction process_blocks_;
 
   uint32_t H[5];
+  unsigned char digest_[20];
 
-  union {
-    uint32_t W[80];
-    uint8_t M[64];
-  };
-
-  uint32_t cursor;
+  // Bytes of a partial block.
+  uint8_t M[kBlockSize];
+  size_t cursor;
+  // The length of the message so far, in bytes.
   uint64_t l;
 };
 
-static inline uint32_t f(uint32_t t, uint32_t B, uint32_t C, uint32_t D) {
-  if (t < 20)
-    return (B & C) | ((~B) & D);
-  if (t < 40)
-    return B ^ C ^ D;
-  if (t < 60)
-    return (B & C) | (B & D) | (C & D);
-  return B ^ C ^ D;
-}
-
-static inline uint32_t S(uint32_t n, uint32_t X) {
-  return (X << n) | (X >> (32 - n));
-}
-
-static inline uint32_t K(uint32_t t) {
-  if (t < 20)
-    return 0x5a827999;
-  if (t < 40)
-    return 0x6ed9eba1;
-  if (t < 60)
-    return 0x8f1bbcdc;
-  return 0xca62c1d6;
-}
-
 const int SecureHashAlgorithm::kDigestSizeBytes = 20;
 
 void SecureHashAlgorithm::Init() {
-  A = 0;
-  B = 0;
-  C = 0;
-  D = 0;
-  E = 0;
+  memcpy(H, kInitialState, sizeof(H));
   cursor = 0;
   l = 0;
-  H[0] = 0x67452301;
-  H[1] = 0xefcdab89;
-  H[2] = 0x98badcfe;
-  H[3] = 0x10325476;
-  H[4] = 0xc3d2e1f0;
 }
 
 void SecureHashAlgorithm::Final() {
-  Pad();
-  Process();
-
-  for (auto& t : H)
-    t = ByteSwap(t);
+  uint8_t tail[2 * kBlockSize];
+  process_blocks_(H, tail, PadTail(M, cursor, l, tail));
+  StoreDigest(H, digest_);
 }
 
 void SecureHashAlgorithm::Update(const void* data, size_t nbytes) {
   const uint8_t* d = reinterpret_cast<const uint8_t*>(data);
-  while (nbytes--) {
-    M[cursor++] = *d++;
-    if (cursor >= 64)
-      Process();
-    l += 8;
-  }
-}
-
-void SecureHashAlgorithm::Pad() {
-  M[cursor++] = 0x80;
-
-  if (cursor > 64 - 8) {
-    // pad out to next block
-    while (cursor < 64)
-      M[cursor++] = 0;
-
-    Process();
-  }
-
-  while (cursor < 64 - 8)
-    M[cursor++] = 0;
-
-  M[cursor++] = (l >> 56) & 0xff;
-  M[cursor++] = (l >> 48) & 0xff;
-  M[cursor++] = (l >> 40) & 0xff;
-  M[cursor++] = (l >> 32) & 0xff;
-  M[cursor++] = (l >> 24) & 0xff;
-  M[cursor++] = (l >> 16) & 0xff;
-  M[cursor++] = (l >> 8) & 0xff;
-  M[cursor++] = l & 0xff;
-}
-
-void SecureHashAlgorithm::Process() {
-  uint32_t t;
-
-  // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
-
-  // a.
-  //
-  // W and M are in a union, so no need to memcpy.
-  // memcpy(W, M, sizeof(M));
-  for (t = 0; t < 16; ++t)
-    W[t] = ByteSwap(W[t]);
-
-  // b.
-  for (t = 16; t < 80; ++t)
-    W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-
-  // c.
-  A = H[0];
-  B = H[1];
-  C = H[2];
-  D = H[3];
-  E = H[4];
-
-  // d.
-  for (t = 0; t < 80; ++t) {
-    uint32_t TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
-    E = D;
-    D = C;
-    C = S(30, B);
-    B = A;
-    A = TEMP;
+  l += nbytes;
+  if (cursor) {
+    const size_t count = std::min(nbytes, kBlockSize - cursor);
+    memcpy(M + cursor, d, count);
+    cursor += count;
+    d += count;
+    nbytes -= count;
+    if (cursor < kBlockSize)
+      return;
+    process_blocks_(H, M, 1);
+    cursor = 0;
   }
-
-  // e.
-  H[0] += A;
-  H[1] += B;
-  H[2] += C;
-  H[3] += D;
-  H[4] += E;
-
-  cursor = 0;
+  // Full blocks are processed straight from |data|.
+  const size_t num_blocks = nbytes / kBlockSize;
+  if (num_blocks)
+    process_blocks_(H, d, num_blocks);
+  cursor = nbytes % kBlockSize;
+  if (cursor)
+    memcpy(M, d + num_blocks * kBlockSize, cursor);
 }
 
 SHA1Digest SHA1HashSpan(span<const uint8_t> data) {
@@ -208,4 +571,70 @@ void SHA1HashBytes(const unsigned char* data, size_t len, unsigned char* hash) {
   memcpy(hash, sha.Digest(), SecureHashAlgorithm::kDigestSizeBytes);
 }
 
+SHA1Hasher::SHA1Hasher() {
+  static_assert(sizeof(SecureHashAlgorithm) <= sizeof(context_),
+                "SHA1Hasher::context_ is too small");
+  static_assert(alignof(SecureHashAlgorithm) <= alignof(SHA1Hasher),
+                "SHA1Hasher::context_ is not aligned enough");
+  static_assert(std::is_trivially_destructible<SecureHashAlgorithm>::value,
+                "SHA1Hasher doesn't destroy the SecureHashAlgorithm");
+  new (context_) SecureHashAlgorithm();
+}
+
+SHA1Hasher::~SHA1Hasher() = default;
+
+void SHA1Hasher::Update(span<const uint8_t> data) {
+  reinterpret_cast<SecureHashAlgorithm*>(context_)->Update(data.data(),
+                                                           data.size());
+}
+
+SHA1Digest SHA1Hasher::Finish() {
+  SecureHashAlgorithm* sha = reinterpret_cast<SecureHashAlgorithm*>(context_);
+  sha->Final();
+  SHA1Digest digest;
+  memcpy(digest.data(), sha->Digest(), digest.size());
+  sha->Init();
+  return digest;
+}
+
+void SHA1HashSpans(span<const span<const uint8_t>> inputs,
+                   span<SHA1Digest> digests) {
+  CHECK_EQ(inputs.size(), digests.size());
+#if defined(SHA1_HAS_X86_KERNELS)
+  static const bool has_avx2 = CPU().has_avx2();
+  const bool use_avx2 = g_kernel_for_testing == SHA1Kernel::kDefault
+                            ? has_avx2
+                            : g_kernel_for_testing == SHA1Kernel::kAvx2;
+  if (use_avx2 && inputs.size() >= kLanes) {
+    HashSpansAvx2(inputs, digests);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < inputs.size(); ++i)
+    digests[i] = SHA1HashSpan(inputs[i]);
+}
+
+bool SetSHA1KernelForTesting(SHA1Kernel kernel) {
+  bool supported = false;
+  switch (kernel) {
+    case SHA1Kernel::kDefault:
+    case SHA1Kernel::kPortable:
+      supported = true;
+      break;
+    case SHA1Kernel::kShaNi:
+#if defined(SHA1_HAS_X86_KERNELS)
+      supported = CPU().has_sha() && CPU().has_sse41();
+#endif
+      break;
+    case SHA1Kernel::kAvx2:
+#if defined(SHA1_HAS_X86_KERNELS)
+      supported = CPU().has_avx2();
+#endif
+      break;
+  }
+  if (supported)
+    g_kernel_for_testing = kernel;
+  return supported;
+}
+
 }  // namespace base
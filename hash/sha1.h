@@ -12,6 +12,7 @@
 
 #include "base/base_export.h"
 #include "base/containers/span.h"
+#include "base/strings/string_piece.h"
 
 namespace base {
 
@@ -35,6 +36,55 @@ BASE_EXPORT void SHA1HashBytes(const unsigned char* data,
                                size_t len,
                                unsigned char* hash);
 
+// Computes a SHA-1 hash incrementally:
+//   SHA1Hasher hasher;
+//   hasher.Update(data1);
+//   hasher.Update(data2);
+//   SHA1Digest digest = hasher.Finish();
+class BASE_EXPORT SHA1Hasher {
+ public:
+  SHA1Hasher();
+  SHA1Hasher(const SHA1Hasher&) = delete;
+  SHA1Hasher& operator=(const SHA1Hasher&) = delete;
+  ~SHA1Hasher();
+
+  void Update(span<const uint8_t> data);
+  void Update(StringPiece data) { Update(as_bytes(make_span(data))); }
+
+  // Returns the hash of all the data passed to Update(), and starts over.
+  SHA1Digest Finish();
+
+ private:
+  // The implementation's state. Callers should not access it.
+  alignas(8) char context_[160];
+};
+
+// Computes the SHA-1 hash of each of |inputs| into the corresponding element
+// of |digests|, which must have the same size. When there are many small
+// inputs, this is faster than hashing them one at a time, as several of them
+// are hashed in parallel on CPUs with AVX2.
+BASE_EXPORT void SHA1HashSpans(span<const span<const uint8_t>> inputs,
+                               span<SHA1Digest> digests);
+
+// The implementations of SHA-1 hashing, which are picked according to the CPU
+// unless a test forces one.
+enum class SHA1Kernel {
+  // The best one that the CPU supports.
+  kDefault,
+  // Plain C++, which runs everywhere.
+  kPortable,
+  // The x86 SHA extensions.
+  kShaNi,
+  // AVX2 for SHA1HashSpans(), which hashes 8 inputs at a time, and the
+  // portable kernel otherwise.
+  kAvx2,
+};
+
+// Makes the SHA-1 functions above use |kernel|, so that tests can check each
+// one. Returns false, and changes nothing, if |kernel| isn't built in or the
+// CPU doesn't support it. Not thread-safe.
+BASE_EXPORT bool SetSHA1KernelForTesting(SHA1Kernel kernel);
+
 }  // namespace base
 
 #endif  // BASE_HASH_SHA1_H_
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include "base/check_op.h"
 #include "base/strings/string_util.h"
 #include "third_party/boringssl/src/include/openssl/crypto.h"
 #include "third_party/boringssl/src/include/openssl/sha.h"
@@ -32,4 +33,40 @@ void SHA1HashBytes(const unsigned char* data, size_t len, unsigned char* hash) {
   SHA1(data, len, hash);
 }
 
+SHA1Hasher::SHA1Hasher() {
+  static_assert(sizeof(SHA_CTX) <= sizeof(context_),
+                "SHA1Hasher::context_ is too small");
+  static_assert(alignof(SHA_CTX) <= alignof(SHA1Hasher),
+                "SHA1Hasher::context_ is not aligned enough");
+  CRYPTO_library_init();
+  SHA1_Init(reinterpret_cast<SHA_CTX*>(context_));
+}
+
+SHA1Hasher::~SHA1Hasher() = default;
+
+void SHA1Hasher::Update(span<const uint8_t> data) {
+  SHA1_Update(reinterpret_cast<SHA_CTX*>(context_), data.data(), data.size());
+}
+
+SHA1Digest SHA1Hasher::Finish() {
+  SHA_CTX* context = reinterpret_cast<SHA_CTX*>(context_);
+  SHA1Digest digest;
+  SHA1_Final(digest.data(), context);
+  SHA1_Init(context);
+  return digest;
+}
+
+void SHA1HashSpans(span<const span<const uint8_t>> inputs,
+                   span<SHA1Digest> digests) {
+  CHECK_EQ(inputs.size(), digests.size());
+  CRYPTO_library_init();
+  for (size_t i = 0; i < inputs.size(); ++i)
+    SHA1(inputs[i].data(), inputs[i].size(), digests[i].data());
+}
+
+// BoringSSL picks its own implementation.
+bool SetSHA1KernelForTesting(SHA1Kernel kernel) {
+  return kernel == SHA1Kernel::kDefault;
+}
+
 }  // namespace base
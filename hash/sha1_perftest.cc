@@ -6,6 +6,8 @@
 
 #include <stddef.h>
 #include <stdint.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -72,6 +74,47 @@ void Timing(const size_t len) {
   reporter.AddResultList(kMetricThroughput, JoinString(rate_strings, ","));
 }
 
+// Hashes |count| random inputs of |len| bytes each, one at a time and with
+// SHA1HashSpans().
+void BatchTiming(const size_t len, const size_t count) {
+  constexpr char kMetricSingleThroughput[] = "single_throughput";
+  constexpr char kMetricBatchThroughput[] = "batch_throughput";
+
+  perf_test::PerfResultReporter reporter(
+      "SHA1.", NumberToString(count) + "x" + NumberToString(len) + "_bytes");
+  reporter.RegisterImportantMetric(kMetricSingleThroughput, "bytesPerSecond");
+  reporter.RegisterImportantMetric(kMetricBatchThroughput, "bytesPerSecond");
+
+  std::vector<uint8_t> buf(len * count);
+  RandBytes(buf.data(), buf.size());
+  std::vector<span<const uint8_t>> inputs;
+  for (size_t i = 0; i < count; ++i)
+    inputs.push_back(make_span(buf).subspan(i * len, len));
+  std::vector<SHA1Digest> single_digests(count);
+  std::vector<SHA1Digest> batch_digests(count);
+
+  constexpr int kNumRuns = 21;
+  TimeDelta single_time = TimeDelta::Max();
+  TimeDelta batch_time = TimeDelta::Max();
+  for (int run = 0; run < kNumRuns; ++run) {
+    auto start = TimeTicks::Now();
+    for (size_t i = 0; i < count; ++i)
+      single_digests[i] = SHA1HashSpan(inputs[i]);
+    single_time = std::min(single_time, TimeTicks::Now() - start);
+
+    start = TimeTicks::Now();
+    SHA1HashSpans(inputs, batch_digests);
+    batch_time = std::min(batch_time, TimeTicks::Now() - start);
+  }
+  EXPECT_EQ(single_digests, batch_digests);
+
+  const auto rate = [&buf](TimeDelta t) {
+    return buf.size() / t.InSecondsF();
+  };
+  reporter.AddResult(kMetricSingleThroughput, rate(single_time));
+  reporter.AddResult(kMetricBatchThroughput, rate(batch_time));
+}
+
 }  // namespace
 
 TEST(SHA1PerfTest, Speed) {
@@ -81,4 +124,11 @@ TEST(SHA1PerfTest, Speed) {
   Timing(1024 * 1024U >> 7);
 }
 
+TEST(SHA1PerfTest, BatchSpeed) {
+  BatchTiming(64, 4096);
+  BatchTiming(256, 4096);
+  BatchTiming(1024, 4096);
+  BatchTiming(16 * 1024, 256);
+}
+
 }  // namespace base
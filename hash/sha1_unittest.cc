@@ -7,7 +7,10 @@
 #include <stddef.h>
 
 #include <string>
+#include <vector>
 
+#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(SHA1Test, Test1) {
@@ -113,3 +116,136 @@ TEST(SHA1Test, Test3BytesAndSpan) {
   for (size_t i = 0; i < base::kSHA1Length; i++)
     EXPECT_EQ(kExpected[i], output_array[i]);
 }
+
+TEST(SHA1Test, HashSpans) {
+  // Inputs of all lengths up to a few blocks, so that messages end at every
+  // offset in their last block, and many of them, so that they are hashed in
+  // parallel.
+  std::vector<std::string> inputs;
+  for (size_t length = 0; length < 300; ++length) {
+    std::string input(length, 0);
+    for (size_t i = 0; i < length; ++i)
+      input[i] = static_cast<char>(i * 31 + length);
+    inputs.push_back(std::move(input));
+  }
+  inputs.push_back(std::string(1000000, 'a'));
+  inputs.push_back("abc");
+
+  for (size_t count : {0, 1, 7, 8, 9, 100, 302}) {
+    std::vector<base::span<const uint8_t>> spans;
+    for (size_t i = 0; i < count; ++i)
+      spans.push_back(base::as_bytes(base::make_span(inputs[i % 302])));
+    std::vector<base::SHA1Digest> digests(count);
+    base::SHA1HashSpans(spans, digests);
+    for (size_t i = 0; i < count; ++i)
+      EXPECT_EQ(base::SHA1HashSpan(spans[i]), digests[i]) << i;
+  }
+
+  // The empty message, and the examples from FIPS 180-2.
+  const base::span<const uint8_t> spans[] = {
+      base::as_bytes(base::make_span(inputs[0])),
+      base::as_bytes(base::make_span(inputs[300])),
+      base::as_bytes(base::make_span(inputs[301]))};
+  base::SHA1Digest digests[base::size(spans)];
+  base::SHA1HashSpans(spans, digests);
+  EXPECT_EQ("DA39A3EE5E6B4B0D3255BFEF95601890AFD80709",
+            base::HexEncode(digests[0]));
+  EXPECT_EQ("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F",
+            base::HexEncode(digests[1]));
+  EXPECT_EQ("A9993E364706816ABA3E25717850C26C9CD0D89D",
+            base::HexEncode(digests[2]));
+}
+
+TEST(SHA1Test, Hasher) {
+  const std::string input(1000000, 'a');
+  base::SHA1Hasher hasher;
+  // Odd-sized pieces, so that most of them straddle a block boundary.
+  for (size_t i = 0; i < input.size(); i += 999)
+    hasher.Update(base::StringPiece(input).substr(i, 999));
+  EXPECT_EQ("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F",
+            base::HexEncode(hasher.Finish()));
+
+  // Finish() starts over.
+  hasher.Update("abc");
+  EXPECT_EQ("A9993E364706816ABA3E25717850C26C9CD0D89D",
+            base::HexEncode(hasher.Finish()));
+  EXPECT_EQ("DA39A3EE5E6B4B0D3255BFEF95601890AFD80709",
+            base::HexEncode(hasher.Finish()));
+}
+
+// Checks one kernel, if the CPU supports it, then goes back to the default.
+class SHA1KernelTest : public testing::TestWithParam<base::SHA1Kernel> {
+ protected:
+  void SetUp() override {
+    if (!base::SetSHA1KernelForTesting(GetParam()))
+      GTEST_SKIP() << "Kernel not supported";
+  }
+
+  void TearDown() override {
+    base::SetSHA1KernelForTesting(base::SHA1Kernel::kDefault);
+  }
+};
+
+TEST_P(SHA1KernelTest, FipsExamples) {
+  // The examples from FIPS 180-2, hashed one at a time and in a batch large
+  // enough to be hashed in parallel.
+  const std::string inputs[] = {
+      "abc", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      std::string(1000000, 'a')};
+  const char* const kExpected[] = {"A9993E364706816ABA3E25717850C26C9CD0D89D",
+                                   "84983E441C3BD26EBAAE4AA1F95129E5E54670F1",
+                                   "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"};
+
+  std::vector<base::span<const uint8_t>> spans;
+  for (size_t i = 0; i < base::size(inputs); ++i) {
+    EXPECT_EQ(kExpected[i],
+              base::HexEncode(base::SHA1HashSpan(
+                  base::as_bytes(base::make_span(inputs[i])))));
+    for (int copy = 0; copy < 3; ++copy)
+      spans.push_back(base::as_bytes(base::make_span(inputs[i])));
+  }
+  std::vector<base::SHA1Digest> digests(spans.size());
+  base::SHA1HashSpans(spans, digests);
+  for (size_t i = 0; i < digests.size(); ++i)
+    EXPECT_EQ(kExpected[i / 3], base::HexEncode(digests[i])) << i;
+}
+
+TEST_P(SHA1KernelTest, MatchesPortableAtBlockBoundaries) {
+  // Lengths around the end of the first and second blocks, where the padding
+  // may or may not fit in the last block.
+  std::vector<std::string> inputs;
+  for (size_t length : {0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129}) {
+    std::string input(length, 0);
+    for (size_t i = 0; i < length; ++i)
+      input[i] = static_cast<char>(i * 7 + length);
+    inputs.push_back(std::move(input));
+  }
+  std::vector<base::span<const uint8_t>> spans;
+  for (const std::string& input : inputs)
+    spans.push_back(base::as_bytes(base::make_span(input)));
+
+  ASSERT_TRUE(base::SetSHA1KernelForTesting(base::SHA1Kernel::kPortable));
+  std::vector<base::SHA1Digest> expected;
+  for (base::span<const uint8_t> input : spans)
+    expected.push_back(base::SHA1HashSpan(input));
+  ASSERT_TRUE(base::SetSHA1KernelForTesting(GetParam()));
+
+  std::vector<base::SHA1Digest> digests(spans.size());
+  base::SHA1HashSpans(spans, digests);
+  for (size_t i = 0; i < spans.size(); ++i) {
+    EXPECT_EQ(expected[i], base::SHA1HashSpan(spans[i])) << inputs[i].size();
+    EXPECT_EQ(expected[i], digests[i]) << inputs[i].size();
+
+    // Fed in two pieces, so that the first one leaves a partial block.
+    base::SHA1Hasher hasher;
+    hasher.Update(spans[i].first(spans[i].size() / 2));
+    hasher.Update(spans[i].subspan(spans[i].size() / 2));
+    EXPECT_EQ(expected[i], hasher.Finish()) << inputs[i].size();
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         SHA1KernelTest,
+                         testing::Values(base::SHA1Kernel::kPortable,
+                                         base::SHA1Kernel::kShaNi,
+                                         base::SHA1Kernel::kAvx2));
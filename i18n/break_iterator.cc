@@ -6,13 +6,17 @@
 
 #include <stdint.h>
 
+#include <memory>
+#include <string>
+
 #include "base/check.h"
+#include "base/i18n/icu_object_pool.h"
 #include "base/i18n/uchar.h"
-#include "base/lazy_instance.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
-#include "base/synchronization/lock.h"
 #include "third_party/icu/source/common/unicode/ubrk.h"
 #include "third_party/icu/source/common/unicode/uchar.h"
+#include "third_party/icu/source/common/unicode/uloc.h"
 #include "third_party/icu/source/common/unicode/ustring.h"
 
 namespace base {
@@ -37,113 +41,85 @@ BreakIterator::BreakIterator(const StringPiece16& str, const string16& rules)
 
 namespace {
 
-// We found the usage pattern of break iterator is to create, use and destroy.
-// The following cache support multiple break iterator in the same thread and
-// also optimize to not create break iterator many time. For each kind of break
-// iterator (character, word, line and sentence, but NOT rule), we keep one of
-// them in the main_ and lease it out. If some other code request a lease
-// before |main_| is returned, we create a new instance of the iterator.
-// This will keep at most 4 break iterators (one for each kind) unreleased until
-// the program destruction time.
-template <UBreakIteratorType break_type>
-class DefaultLocaleBreakIteratorCache {
- public:
-  DefaultLocaleBreakIteratorCache()
-      : main_status_(U_ZERO_ERROR),
-        main_(nullptr),
-        main_could_be_leased_(true) {
-    main_ = ubrk_open(break_type, nullptr, nullptr, 0, &main_status_);
-    if (U_FAILURE(main_status_)) {
-      NOTREACHED() << "ubrk_open failed for type " << break_type
-                   << " with error " << main_status_;
-    }
-  }
+// Closes a UBreakIterator.
+struct UBreakIteratorCloser {
+  void operator()(UBreakIterator* iter) const { ubrk_close(iter); }
+};
 
-  virtual ~DefaultLocaleBreakIteratorCache() { ubrk_close(main_); }
+using ScopedUBreakIterator =
+    std::unique_ptr<UBreakIterator, UBreakIteratorCloser>;
+
+// We found the usage pattern of break iterator is to create, use and destroy,
+// often in loops. Opening an ICU break iterator is expensive, so instead of
+// closing them, the iterators of each kind (character, word, line and
+// sentence, but NOT rule) are kept in a per-thread pool for each locale and
+// leased out again. Iterators are leased from and returned to the pool of the
+// current thread without locking, and any number of them can be leased at
+// once.
+internal::IcuObjectPool<ScopedUBreakIterator>& GetBreakIteratorPool() {
+  static NoDestructor<internal::IcuObjectPool<ScopedUBreakIterator>> pool;
+  return *pool;
+}
 
-  UBreakIterator* Lease(UErrorCode& status) {
-    if (U_FAILURE(status)) {
-      return nullptr;
-    }
-    if (U_FAILURE(main_status_)) {
-      status = main_status_;
-      return nullptr;
-    }
-    {
-      AutoLock scoped_lock(lock_);
-      if (main_could_be_leased_) {
-        // Just lease the main_ out.
-        main_could_be_leased_ = false;
-        return main_;
-      }
-    }
-    // The main_ is already leased out to some other places, return a new
-    // object instead.
-    UBreakIterator* result =
-        ubrk_open(break_type, nullptr, nullptr, 0, &status);
-    if (U_FAILURE(status)) {
-      NOTREACHED() << "ubrk_open failed for type " << break_type
-                   << " with error " << status;
-    }
-    return result;
+UBreakIteratorType ToUBreakIteratorType(BreakIterator::BreakType break_type) {
+  switch (break_type) {
+    case BreakIterator::BREAK_CHARACTER:
+      return UBRK_CHARACTER;
+    case BreakIterator::BREAK_WORD:
+      return UBRK_WORD;
+    case BreakIterator::BREAK_SENTENCE:
+      return UBRK_SENTENCE;
+    case BreakIterator::BREAK_LINE:
+    case BreakIterator::BREAK_NEWLINE:
+      return UBRK_LINE;
+    default:
+      NOTREACHED() << "invalid break_type";
+      return UBRK_CHARACTER;
   }
+}
 
-  void Return(UBreakIterator* item) {
-    // If the return item is the main_, just remember we can lease it out
-    // next time.
-    if (item == main_) {
-      AutoLock scoped_lock(lock_);
-      main_could_be_leased_ = true;
-    } else {
-      // Close the item if it is not main_.
-      ubrk_close(item);
-    }
+UBreakIterator* LeaseBreakIterator(UBreakIteratorType type,
+                                   const std::string& locale,
+                                   UErrorCode& status) {
+  ScopedUBreakIterator iter =
+      GetBreakIteratorPool().Take(locale.c_str(), type);
+  if (iter)
+    return iter.release();
+  UBreakIterator* result =
+      ubrk_open(type, locale.c_str(), nullptr, 0, &status);
+  if (U_FAILURE(status)) {
+    NOTREACHED() << "ubrk_open failed for type " << type << " with error "
+                 << status;
   }
+  return result;
+}
 
- private:
-  UErrorCode main_status_;
-  UBreakIterator* main_;
-  bool main_could_be_leased_ GUARDED_BY(lock_);
-  Lock lock_;
-};
-
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_CHARACTER>>::Leaky
-    char_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_WORD>>::Leaky
-    word_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_SENTENCE>>::Leaky
-    sentence_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_LINE>>::Leaky
-    line_break_cache = LAZY_INSTANCE_INITIALIZER;
+void ReturnBreakIterator(UBreakIteratorType type,
+                         const std::string& locale,
+                         UBreakIterator* iter) {
+  // Let go of the text, which may be freed before the iterator is leased out
+  // again.
+  static const UChar kEmptyText[] = {0};
+  UErrorCode status = U_ZERO_ERROR;
+  ubrk_setText(iter, kEmptyText, 0, &status);
+  if (U_FAILURE(status)) {
+    ubrk_close(iter);
+    return;
+  }
+  GetBreakIteratorPool().Put(locale.c_str(), type, ScopedUBreakIterator(iter));
+}
 
 }  // namespace
 
 BreakIterator::~BreakIterator() {
   if (iter_) {
     UBreakIterator* iter = static_cast<UBreakIterator*>(iter_);
-    switch (break_type_) {
-      // Free the iter if it is RULE_BASED
-      case RULE_BASED:
-        ubrk_close(iter);
-        break;
-      // Otherwise, return the iter to the cache it leased from.`
-      case BREAK_CHARACTER:
-        char_break_cache.Pointer()->Return(iter);
-        break;
-      case BREAK_WORD:
-        word_break_cache.Pointer()->Return(iter);
-        break;
-      case BREAK_SENTENCE:
-        sentence_break_cache.Pointer()->Return(iter);
-        break;
-      case BREAK_LINE:
-      case BREAK_NEWLINE:
-        line_break_cache.Pointer()->Return(iter);
-        break;
-      default:
-        NOTREACHED() << "invalid break_type_";
-        break;
-    }
+    // Free the iter if it is RULE_BASED. Otherwise, return the iter to the pool
+    // it was leased from.
+    if (break_type_ == RULE_BASED)
+      ubrk_close(iter);
+    else
+      ReturnBreakIterator(ToUBreakIteratorType(break_type_), locale_, iter);
   }
 }
 
@@ -152,17 +128,13 @@ bool BreakIterator::Init() {
   UParseError parse_error;
   switch (break_type_) {
     case BREAK_CHARACTER:
-      iter_ = char_break_cache.Pointer()->Lease(status);
-      break;
     case BREAK_WORD:
-      iter_ = word_break_cache.Pointer()->Lease(status);
-      break;
     case BREAK_SENTENCE:
-      iter_ = sentence_break_cache.Pointer()->Lease(status);
-      break;
     case BREAK_LINE:
     case BREAK_NEWLINE:
-      iter_ = line_break_cache.Pointer()->Lease(status);
+      locale_ = uloc_getDefault();
+      iter_ = LeaseBreakIterator(ToUBreakIteratorType(break_type_), locale_,
+                                 status);
       break;
     case RULE_BASED:
       iter_ = ubrk_openRules(ToUCharPtr(rules_.c_str()),
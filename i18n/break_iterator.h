@@ -7,6 +7,8 @@
 
 #include <stddef.h>
 
+#include <string>
+
 #include "base/i18n/base_i18n_export.h"
 #include "base/macros.h"
 #include "base/strings/string16.h"
@@ -183,6 +185,9 @@ class BASE_I18N_EXPORT BreakIterator {
   // The breaking style (word/space/newline). Mutually exclusive with rules_
   BreakType break_type_;
 
+  // The locale which |iter_| was leased for, unless it is RULE_BASED.
+  std::string locale_;
+
   // Previous and current iterator positions.
   size_t prev_, pos_;
 
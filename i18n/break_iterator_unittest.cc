@@ -541,6 +541,40 @@ TEST(BreakIteratorTest, GetStringAfterSetText) {
   EXPECT_EQ(ASCIIToUTF16(","), iter.GetString());
 }
 
+// Break iterators are reused once destroyed, but never while still in use.
+TEST(BreakIteratorTest, ReusedIterators) {
+  const string16 outer_string(ASCIIToUTF16("foo bar"));
+  BreakIterator outer(outer_string, BreakIterator::BREAK_WORD);
+  ASSERT_TRUE(outer.Init());
+  EXPECT_TRUE(outer.Advance());
+  EXPECT_EQ(ASCIIToUTF16("foo"), outer.GetString());
+
+  for (int i = 0; i < 3; ++i) {
+    // Destroy each inner iterator part way through its text, so that the next
+    // one gets it back with the iteration state of the last one.
+    const string16 inner_string(ASCIIToUTF16("baz qux"));
+    BreakIterator inner(inner_string, BreakIterator::BREAK_WORD);
+    ASSERT_TRUE(inner.Init());
+    EXPECT_TRUE(inner.Advance());
+    EXPECT_EQ(ASCIIToUTF16("baz"), inner.GetString());
+    EXPECT_TRUE(inner.IsWord());
+  }
+
+  // |outer| carries on from where it was.
+  EXPECT_TRUE(outer.Advance());
+  EXPECT_EQ(ASCIIToUTF16(" "), outer.GetString());
+  EXPECT_TRUE(outer.Advance());
+  EXPECT_EQ(ASCIIToUTF16("bar"), outer.GetString());
+  EXPECT_FALSE(outer.Advance());
+
+  // Iterators of different types aren't mixed up.
+  const string16 line_string(ASCIIToUTF16("foo bar"));
+  BreakIterator line(line_string, BreakIterator::BREAK_LINE);
+  ASSERT_TRUE(line.Init());
+  EXPECT_TRUE(line.Advance());
+  EXPECT_EQ(ASCIIToUTF16("foo "), line.GetString());
+}
+
 TEST(BreakIteratorTest, GetStringPiece) {
   const string16 initial_string(ASCIIToUTF16("some string"));
   BreakIterator iter(initial_string, BreakIterator::BREAK_WORD);
@@ -0,0 +1,106 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_I18N_ICU_OBJECT_POOL_H_
+#define BASE_I18N_ICU_OBJECT_POOL_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/threading/thread_local.h"
+
+namespace base {
+namespace i18n {
+namespace internal {
+
+// A per-thread pool of ICU objects which are expensive to create, such as
+// collators, break iterators and string searches. Objects are keyed by a
+// locale and by a type-specific |variant|, e.g. a collation strength, and
+// objects which are Put() back are handed out again by later Take()s on the
+// same thread, instead of being destroyed. Callers reset the state of an
+// object before putting it back.
+//
+// At most kMaxObjectsPerKey objects are kept for each of the kMaxKeys most
+// recently used keys on each thread; the pooled objects are destroyed when the
+// thread exits. |Object| is a std::unique_ptr with a deleter which closes the
+// ICU object.
+//
+// Pools are meant to be held in static storage:
+//   static NoDestructor<IcuObjectPool<ScopedFoo>> pool;
+template <typename Object>
+class IcuObjectPool {
+ public:
+  static constexpr size_t kMaxKeys = 8;
+  static constexpr size_t kMaxObjectsPerKey = 4;
+
+  IcuObjectPool() = default;
+  IcuObjectPool(const IcuObjectPool&) = delete;
+  IcuObjectPool& operator=(const IcuObjectPool&) = delete;
+
+  // Returns an object for |locale| and |variant| which was put back on this
+  // thread, or null if there is none.
+  Object Take(const char* locale, int variant) {
+    std::vector<Entry>* entries = entries_.Get();
+    if (!entries)
+      return nullptr;
+    for (Entry& entry : *entries) {
+      if (entry.variant != variant || entry.locale != locale)
+        continue;
+      if (entry.objects.empty())
+        return nullptr;
+      Object object = std::move(entry.objects.back());
+      entry.objects.pop_back();
+      return object;
+    }
+    return nullptr;
+  }
+
+  // Keeps |object| for a later Take() on this thread, or destroys it if
+  // enough objects are already kept for |locale| and |variant|.
+  void Put(const char* locale, int variant, Object object) {
+    std::vector<Entry>* entries = entries_.Get();
+    if (!entries) {
+      entries_.Set(std::make_unique<std::vector<Entry>>());
+      entries = entries_.Get();
+    }
+
+    auto it = entries->begin();
+    while (it != entries->end() &&
+           (it->variant != variant || it->locale != locale)) {
+      ++it;
+    }
+    if (it == entries->end()) {
+      // Make room by dropping the objects for the least recently used key.
+      if (entries->size() == kMaxKeys)
+        entries->pop_back();
+      it = entries->insert(entries->begin(), Entry{locale, variant, {}});
+    } else if (it != entries->begin()) {
+      // Keep the entries in most recently used order.
+      std::rotate(entries->begin(), it, it + 1);
+      it = entries->begin();
+    }
+    if (it->objects.size() < kMaxObjectsPerKey)
+      it->objects.push_back(std::move(object));
+  }
+
+ private:
+  struct Entry {
+    std::string locale;
+    int variant;
+    std::vector<Object> objects;
+  };
+
+  ThreadLocalOwnedPointer<std::vector<Entry>> entries_;
+};
+
+}  // namespace internal
+}  // namespace i18n
+}  // namespace base
+
+#endif  // BASE_I18N_ICU_OBJECT_POOL_H_
@@ -8,7 +8,15 @@
 #include <windows.h>
 #endif
 
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#endif
+
+#include <string.h>
+
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/debug/alias.h"
 #include "base/environment.h"
@@ -19,8 +27,11 @@
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/metrics_hashes.h"
 #include "base/path_service.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string_util.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/time/time.h"
+#include "base/trace_event/base_tracing.h"
 #include "build/build_config.h"
 #include "build/chromecast_buildflags.h"
 #include "third_party/icu/source/common/unicode/putil.h"
@@ -126,6 +137,153 @@ MemoryMappedFile::Region g_icudtl_extra_region;
 const char* g_icu_time_zone_data_dir = kIcuTimeZoneDataDir;
 #endif  // defined(OS_FUCHSIA)
 
+IcuDataPaging g_icu_data_paging = IcuDataPaging::kDefault;
+
+#if defined(OS_POSIX)
+// The tables in the ICU data package which nearly every process touches soon
+// after startup, by name within the package.
+const char* const kPrefetchedIcuTables[] = {
+    "brkitr/char.brk",   "brkitr/line.brk",    "brkitr/root.res",
+    "brkitr/word.brk",   "cnvalias.icu",       "coll/root.res",
+    "coll/ucadata.icu",  "metaZones.res",      "pool.res",
+    "res_index.res",     "root.res",           "timezoneTypes.res",
+    "zoneinfo64.res",
+};
+#endif  // defined(OS_POSIX)
+
+// The layout of an ICU common data package, as in ICU's udatamem.h and
+// ucmndata.h: a header, then a table of contents sorted by name, whose
+// offsets are relative to the start of the table of contents.
+struct IcuDataHeader {
+  uint16_t header_size;
+  uint8_t magic1;
+  uint8_t magic2;
+  UDataInfo info;
+};
+
+struct IcuDataTocEntry {
+  uint32_t name_offset;
+  uint32_t data_offset;
+};
+
+// Returns the name of the table of |entry| within the package, without the
+// package name prefix, e.g. "coll/root.res" for "icudt68l/coll/root.res".
+const char* GetIcuTableName(const uint8_t* toc,
+                            size_t toc_length,
+                            const IcuDataTocEntry& entry) {
+  if (entry.name_offset >= toc_length)
+    return nullptr;
+  const char* name = reinterpret_cast<const char*>(toc + entry.name_offset);
+  const size_t max_length = toc_length - entry.name_offset;
+  const char* end = static_cast<const char*>(memchr(name, '\0', max_length));
+  if (!end)
+    return nullptr;
+  const char* slash = static_cast<const char*>(memchr(name, '/', end - name));
+  return slash ? slash + 1 : name;
+}
+
+// Returns the range of |data|, an ICU common data package of |length| bytes,
+// which holds the table named |table_name|. Returns an empty range if |data|
+// has no such table, or isn't a package.
+std::pair<size_t, size_t> FindIcuTable(const uint8_t* data,
+                                       size_t length,
+                                       const char* table_name) {
+  const std::pair<size_t, size_t> not_found(0, 0);
+  if (length < sizeof(IcuDataHeader))
+    return not_found;
+  const auto* header = reinterpret_cast<const IcuDataHeader*>(data);
+  if (header->magic1 != 0xda || header->magic2 != 0x27 ||
+      header->info.isBigEndian != U_IS_BIG_ENDIAN ||
+      memcmp(header->info.dataFormat, "CmnD", 4) != 0 ||
+      header->header_size + sizeof(uint32_t) > length) {
+    return not_found;
+  }
+
+  const uint8_t* toc = data + header->header_size;
+  const size_t toc_length = length - header->header_size;
+  const uint32_t count = *reinterpret_cast<const uint32_t*>(toc);
+  if (count > (toc_length - sizeof(uint32_t)) / sizeof(IcuDataTocEntry))
+    return not_found;
+  const auto* entries =
+      reinterpret_cast<const IcuDataTocEntry*>(toc + sizeof(uint32_t));
+
+  // Binary search for the table, as ICU does. The tables are laid out in the
+  // order of the table of contents, so each ends where the next begins.
+  uint32_t begin = 0;
+  uint32_t end = count;
+  while (begin < end) {
+    const uint32_t middle = begin + (end - begin) / 2;
+    const char* name = GetIcuTableName(toc, toc_length, entries[middle]);
+    if (!name)
+      return not_found;
+    const int compare = strcmp(table_name, name);
+    if (compare == 0) {
+      const size_t table_begin = entries[middle].data_offset;
+      const size_t table_end = middle + 1 < count
+                                   ? entries[middle + 1].data_offset
+                                   : toc_length;
+      if (table_begin >= table_end || table_end > toc_length)
+        return not_found;
+      return {header->header_size + table_begin,
+              header->header_size + table_end};
+    }
+    if (compare < 0)
+      end = middle;
+    else
+      begin = middle + 1;
+  }
+  return not_found;
+}
+
+#if defined(OS_POSIX)
+// Returns the ranges of |data|, an ICU common data package of |length| bytes,
+// which hold the tables in kPrefetchedIcuTables.
+std::vector<std::pair<size_t, size_t>> FindPrefetchedIcuTables(
+    const uint8_t* data,
+    size_t length) {
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (const char* table : kPrefetchedIcuTables) {
+    const std::pair<size_t, size_t> range = FindIcuTable(data, length, table);
+    if (range.first < range.second)
+      ranges.push_back(range);
+  }
+  return ranges;
+}
+#endif  // defined(OS_POSIX)
+
+// Applies |g_icu_data_paging| to |mapped_file|, which is an ICU data file.
+void AdviseIcuData(MemoryMappedFile* mapped_file) {
+  if (g_icu_data_paging == IcuDataPaging::kDefault)
+    return;
+  DCHECK_EQ(IcuDataPaging::kRandomWithPrefetch, g_icu_data_paging);
+  TRACE_EVENT0("startup", "AdviseIcuData");
+#if defined(OS_POSIX)
+  // The data may start part way into a page if the file was mapped from a
+  // region of another file.
+  const uintptr_t page_size = GetPageSize();
+  auto advise = [page_size](const uint8_t* begin, const uint8_t* end,
+                            int advice) {
+    const uintptr_t page_begin =
+        reinterpret_cast<uintptr_t>(begin) & ~(page_size - 1);
+    const uintptr_t page_end = reinterpret_cast<uintptr_t>(end);
+    if (madvise(reinterpret_cast<void*>(page_begin), page_end - page_begin,
+                advice) != 0) {
+      DPLOG(ERROR) << "madvise() failed";
+    }
+  };
+
+  const uint8_t* data = mapped_file->data();
+  advise(data, data + mapped_file->length(), MADV_RANDOM);
+  size_t prefetched_bytes = 0;
+  for (const auto& range :
+       FindPrefetchedIcuTables(data, mapped_file->length())) {
+    advise(data + range.first, data + range.second, MADV_WILLNEED);
+    prefetched_bytes += range.second - range.first;
+  }
+  TRACE_COUNTER1("startup", "ICU.DataPrefetchedKB", prefetched_bytes / 1024);
+#endif  // defined(OS_POSIX)
+}
+
 struct PfRegion {
  public:
   PlatformFile pf;
@@ -236,6 +394,7 @@ int LoadIcuData(PlatformFile data_fd,
                 const MemoryMappedFile::Region& data_region,
                 std::unique_ptr<MemoryMappedFile>* out_mapped_data_file,
                 UErrorCode* out_error_code) {
+  TRACE_EVENT0("startup", "LoadIcuData");
   InitializeExternalTimeZoneData();
 
   if (data_fd == kInvalidPlatformFile) {
@@ -248,6 +407,9 @@ int LoadIcuData(PlatformFile data_fd,
     LOG(ERROR) << "Couldn't mmap icu data file";
     return 2;  // To debug http://crbug.com/445616.
   }
+  TRACE_COUNTER1("startup", "ICU.DataMappedKB",
+                 (*out_mapped_data_file)->length() / 1024);
+  AdviseIcuData(out_mapped_data_file->get());
 
   (*out_error_code) = U_ZERO_ERROR;
   udata_setCommonData(const_cast<uint8_t*>((*out_mapped_data_file)->data()),
@@ -319,6 +481,7 @@ bool InitializeICUFromDataFile() {
 // On some platforms, the time zone must be explicitly initialized zone rather
 // than relying on ICU's internal initialization.
 void InitializeIcuTimeZone() {
+  TRACE_EVENT0("startup", "InitializeIcuTimeZone");
 #if defined(OS_ANDROID)
   // On Android, we can't leave it up to ICU to set the default time zone
   // because ICU's time zone detection does not work in many time zones (e.g.
@@ -482,6 +645,22 @@ static void U_CALLCONV TraceICUData(const void* context,
   }
 }
 
+// Counts how long an InitializeICU*() call takes, for startup traces. The call
+// itself is traced as a TRACE_EVENT.
+class ScopedInitializeTimer {
+ public:
+  ScopedInitializeTimer() : start_(TimeTicks::Now()) {}
+  ScopedInitializeTimer(const ScopedInitializeTimer&) = delete;
+  ScopedInitializeTimer& operator=(const ScopedInitializeTimer&) = delete;
+  ~ScopedInitializeTimer() {
+    TRACE_COUNTER1("startup", "ICU.InitializeTimeUs",
+                   (TimeTicks::Now() - start_).InMicroseconds());
+  }
+
+ private:
+  const TimeTicks start_;
+};
+
 // Common initialization to run regardless of how ICU is initialized.
 // There are multiple exposed InitializeIcu* functions. This should be called
 // as at the end of (the last functions in the sequence of) these functions.
@@ -520,6 +699,8 @@ bool InitializeExtraICUWithFileDescriptor(
 bool InitializeICUWithFileDescriptor(
     PlatformFile data_fd,
     const MemoryMappedFile::Region& data_region) {
+  TRACE_EVENT0("startup", "InitializeICUWithFileDescriptor");
+  ScopedInitializeTimer timer;
 #if DCHECK_IS_ON()
   DCHECK(!g_check_called_once || !g_called_once);
   g_called_once = true;
@@ -565,11 +746,22 @@ bool InitializeExtraICU(const std::string& split_name) {
   return true;
 }
 
+void SetIcuDataPaging(IcuDataPaging paging) {
+  g_icu_data_paging = paging;
+}
+
+std::pair<size_t, size_t> FindIcuDataTableForTesting(const char* table_name) {
+  CHECK(g_icudtl_mapped_file);
+  return FindIcuTable(g_icudtl_mapped_file->data(),
+                      g_icudtl_mapped_file->length(), table_name);
+}
+
 void ResetGlobalsForTesting() {
   g_icudtl_pf = kInvalidPlatformFile;
   g_icudtl_mapped_file = nullptr;
   g_icudtl_extra_pf = kInvalidPlatformFile;
   g_icudtl_extra_mapped_file = nullptr;
+  g_icu_data_paging = IcuDataPaging::kDefault;
 #if defined(OS_FUCHSIA)
   g_icu_time_zone_data_dir = kIcuTimeZoneDataDir;
 #endif  // defined(OS_FUCHSIA)
@@ -584,6 +776,8 @@ void SetIcuTimeZoneDataDirForTesting(const char* dir) {
 #endif  // (ICU_UTIL_DATA_IMPL == ICU_UTIL_DATA_FILE)
 
 bool InitializeICU() {
+  TRACE_EVENT0("startup", "InitializeICU");
+  ScopedInitializeTimer timer;
 #if DCHECK_IS_ON()
   DCHECK(!g_check_called_once || !g_called_once);
   g_called_once = true;
@@ -5,8 +5,11 @@
 #ifndef BASE_I18N_ICU_UTIL_H_
 #define BASE_I18N_ICU_UTIL_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <utility>
+
 #include "base/files/memory_mapped_file.h"
 #include "base/i18n/base_i18n_export.h"
 #include "build/build_config.h"
@@ -28,6 +31,22 @@ BASE_I18N_EXPORT bool InitializeICU();
 // asset file.
 BASE_I18N_EXPORT bool InitializeExtraICU(const std::string& split_name);
 
+// How the mapped ICU data files are paged in.
+enum class IcuDataPaging {
+  // Leave it to the OS, which reads ahead around each page fault.
+  kDefault,
+  // Advise the OS that the data is read at random, so that short-lived
+  // processes only fault in the pages which they touch, and prefetch the
+  // tables which nearly every process touches, such as the root resource
+  // bundles, the root collation and the break iterator rules. Only POSIX
+  // platforms take the advice.
+  kRandomWithPrefetch,
+};
+
+// Sets how the data files mapped by later InitializeICU*() calls are paged in.
+// Defaults to IcuDataPaging::kDefault.
+BASE_I18N_EXPORT void SetIcuDataPaging(IcuDataPaging paging);
+
 // Returns the PlatformFile and Region that was initialized by InitializeICU()
 // or InitializeExtraICU(). Use with InitializeICUWithFileDescriptor() or
 // InitializeExtraICUWithFileDescriptor().
@@ -49,6 +68,12 @@ BASE_I18N_EXPORT bool InitializeExtraICUWithFileDescriptor(
     PlatformFile data_fd,
     const MemoryMappedFile::Region& data_region);
 
+// Returns the range of the table named |table_name|, such as "coll/root.res",
+// in the ICU data file mapped by InitializeICU(), as offsets into its region.
+// Returns an empty range if there is no such table.
+BASE_I18N_EXPORT std::pair<size_t, size_t> FindIcuDataTableForTesting(
+    const char* table_name);
+
 BASE_I18N_EXPORT void ResetGlobalsForTesting();
 
 #if defined(OS_FUCHSIA)
@@ -0,0 +1,164 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/i18n/icu_util.h"
+
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+#include <fcntl.h>
+#endif
+
+#include <memory>
+#include <string>
+
+#include "base/base_switches.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/i18n/break_iterator.h"
+#include "base/path_service.h"
+#include "base/process/process.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/multiprocess_test.h"
+#include "base/test/test_timeouts.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/multiprocess_func_list.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/icu/source/i18n/unicode/coll.h"
+
+#if !defined(OS_NACL)
+#if ICU_UTIL_DATA_IMPL == ICU_UTIL_DATA_FILE
+
+namespace base {
+namespace i18n {
+
+namespace {
+
+constexpr char kMetricPrefixIcuUtil[] = "IcuUtil.";
+constexpr char kMetricInitializeTime[] = "initialize_time";
+constexpr char kMetricFirstUseTime[] = "first_use_time";
+
+// Switches passed to the child processes which initialize ICU.
+constexpr char kDataFileSwitch[] = "icu-data-file";
+constexpr char kPagingSwitch[] = "icu-data-paging";
+constexpr char kStorySwitch[] = "story";
+
+constexpr char kDefaultPaging[] = "default_paging";
+constexpr char kRandomPaging[] = "random_paging";
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixIcuUtil, story_name);
+  reporter.RegisterImportantMetric(kMetricInitializeTime, "ms");
+  reporter.RegisterImportantMetric(kMetricFirstUseTime, "ms");
+  return reporter;
+}
+
+// Drops the pages of |path| from the page cache, so that the next process to
+// map it reads it from disk. Returns false where that isn't supported.
+bool EvictFromPageCache(const FilePath& path) {
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+  File file(path, File::FLAG_OPEN | File::FLAG_READ | File::FLAG_WRITE);
+  return file.IsValid() && file.Flush() &&
+         posix_fadvise(file.GetPlatformFile(), 0, 0, POSIX_FADV_DONTNEED) == 0;
+#else
+  return false;
+#endif
+}
+
+// Measures InitializeICU*() in child processes, which don't initialize ICU
+// before the measurement, on a copy of the ICU data file which no other
+// process has mapped.
+class IcuUtilPerfTest : public MultiProcessTest {
+ protected:
+  void SetUp() override {
+    FilePath assets_dir;
+    ASSERT_TRUE(PathService::Get(DIR_ASSETS, &assets_dir));
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    data_file_ = temp_dir_.GetPath().AppendASCII("icudtl.dat");
+    ASSERT_TRUE(CopyFile(assets_dir.AppendASCII("icudtl.dat"), data_file_));
+  }
+
+  void RunChild(const char* paging, const std::string& story) {
+    CommandLine command_line = GetMultiProcessTestChildBaseCommandLine();
+    command_line.AppendSwitch(switches::kTestDoNotInitializeIcu);
+    command_line.AppendSwitchPath(kDataFileSwitch, data_file_);
+    command_line.AppendSwitchASCII(kPagingSwitch, paging);
+    command_line.AppendSwitchASCII(kStorySwitch, story);
+    Process child = SpawnMultiProcessTestChild("InitializeIcuAndReport",
+                                               command_line, LaunchOptions());
+    int exit_code = -1;
+    ASSERT_TRUE(WaitForMultiprocessTestChildExit(
+        child, TestTimeouts::action_max_timeout(), &exit_code));
+    EXPECT_EQ(0, exit_code);
+  }
+
+  // Reports cold numbers, with none of the data file in the page cache, and
+  // then warm numbers, with the pages which the cold run read still cached.
+  void RunColdAndWarm(const char* paging) {
+    if (EvictFromPageCache(data_file_))
+      RunChild(paging, std::string(paging) + "_cold");
+    RunChild(paging, std::string(paging) + "_warm");
+  }
+
+ private:
+  ScopedTempDir temp_dir_;
+  FilePath data_file_;
+};
+
+}  // namespace
+
+MULTIPROCESS_TEST_MAIN(InitializeIcuAndReport) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.GetSwitchValueASCII(kPagingSwitch) == kRandomPaging)
+    SetIcuDataPaging(IcuDataPaging::kRandomWithPrefetch);
+  File file(command_line.GetSwitchValuePath(kDataFileSwitch),
+            File::FLAG_OPEN | File::FLAG_READ);
+  if (!file.IsValid())
+    return 1;
+
+  const TimeTicks start = TimeTicks::Now();
+  if (!InitializeICUWithFileDescriptor(file.TakePlatformFile(),
+                                       MemoryMappedFile::Region::kWholeFile)) {
+    return 2;
+  }
+  const TimeTicks initialized = TimeTicks::Now();
+
+  // Use ICU as most processes first do, which faults in the data it needs.
+  UErrorCode status = U_ZERO_ERROR;
+  std::unique_ptr<icu::Collator> collator(
+      icu::Collator::createInstance(icu::Locale("en_US"), status));
+  if (U_FAILURE(status))
+    return 3;
+  const string16 text = ASCIIToUTF16("Hello, world.");
+  BreakIterator words(text, BreakIterator::BREAK_WORD);
+  BreakIterator lines(text, BreakIterator::BREAK_LINE);
+  if (!words.Init() || !lines.Init())
+    return 4;
+  const TimeTicks used = TimeTicks::Now();
+
+  perf_test::PerfResultReporter reporter =
+      SetUpReporter(command_line.GetSwitchValueASCII(kStorySwitch));
+  reporter.AddResult(kMetricInitializeTime,
+                     (initialized - start).InMillisecondsF());
+  reporter.AddResult(kMetricFirstUseTime,
+                     (used - initialized).InMillisecondsF());
+  return 0;
+}
+
+TEST_F(IcuUtilPerfTest, InitializeWithDefaultPaging) {
+  RunColdAndWarm(kDefaultPaging);
+}
+
+TEST_F(IcuUtilPerfTest, InitializeWithRandomPaging) {
+  RunColdAndWarm(kRandomPaging);
+}
+
+}  // namespace i18n
+}  // namespace base
+
+#endif  // ICU_UTIL_DATA_IMPL == ICU_UTIL_DATA_FILE
+#endif  // !defined(OS_NACL)
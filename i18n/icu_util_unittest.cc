@@ -4,8 +4,12 @@
 
 #include "base/i18n/icu_util.h"
 
+#include <memory>
+#include <utility>
+
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/icu/source/i18n/unicode/coll.h"
 
 #if !defined(OS_NACL)
 #if ICU_UTIL_DATA_IMPL == ICU_UTIL_DATA_FILE
@@ -18,6 +22,31 @@ class IcuUtilTest : public testing::Test {
   void SetUp() override { ResetGlobalsForTesting(); }
 };
 
+TEST_F(IcuUtilTest, InitializeIcuWithRandomPaging) {
+  SetIcuDataPaging(IcuDataPaging::kRandomWithPrefetch);
+  ASSERT_TRUE(InitializeICU());
+
+  UErrorCode status = U_ZERO_ERROR;
+  std::unique_ptr<icu::Collator> collator(
+      icu::Collator::createInstance(icu::Locale("en_US"), status));
+  EXPECT_TRUE(U_SUCCESS(status));
+}
+
+// The tables to prefetch are found in the real data file, so that a change to
+// its layout doesn't silently turn prefetching off.
+TEST_F(IcuUtilTest, FindIcuDataTables) {
+  ASSERT_TRUE(InitializeICU());
+
+  for (const char* table_name : {"root.res", "coll/ucadata.icu"}) {
+    const std::pair<size_t, size_t> range =
+        FindIcuDataTableForTesting(table_name);
+    EXPECT_LT(range.first, range.second) << table_name;
+  }
+  const std::pair<size_t, size_t> missing =
+      FindIcuDataTableForTesting("missing.res");
+  EXPECT_EQ(missing.first, missing.second);
+}
+
 #if defined(OS_ANDROID)
 
 TEST_F(IcuUtilTest, InitializeIcuSucceeds) {
@@ -4,12 +4,15 @@
 
 // This implementation doesn't use ICU. The ICU macros are oriented towards
 // character-at-a-time processing, whereas byte-at-a-time processing is easier
-// with streaming input.
+// with streaming input. Only the bytes at the edges of each chunk are
+// processed a byte at a time, though; complete characters in between are
+// validated many bytes at a time by base::internal::ValidateUTF8().
 
 #include "base/i18n/streaming_utf8_validator.h"
 
 #include "base/check_op.h"
 #include "base/i18n/utf8_validator_tables.h"
+#include "base/strings/utf8_validation.h"
 
 namespace base {
 namespace {
@@ -19,6 +22,31 @@ uint8_t StateTableLookup(uint8_t offset) {
   return internal::kUtf8ValidatorTables[offset];
 }
 
+// Returns the state after |c|, given that the state before it was |state|.
+uint8_t NextState(uint8_t state, char c) {
+  if ((c & 0x80) == 0) {
+    return state == 0 ? 0u
+                      : static_cast<uint8_t>(
+                            internal::I18N_UTF8_VALIDATOR_INVALID_INDEX);
+  }
+  const uint8_t shift_amount = StateTableLookup(state);
+  const uint8_t shifted_char = (c & 0x7F) >> shift_amount;
+  return StateTableLookup(state + shifted_char + 1);
+}
+
+// Returns the start of the character at the end of [begin, end) if it is
+// incomplete, or |end| if it isn't. Nothing is validated.
+const char* FindIncompleteTail(const char* begin, const char* end) {
+  for (ptrdiff_t back = 1; back <= 3 && back <= end - begin; ++back) {
+    const uint8_t c = static_cast<uint8_t>(end[-back]);
+    if ((c & 0xC0) == 0x80)
+      continue;
+    const ptrdiff_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    return length > back ? end - back : end;
+  }
+  return end;
+}
+
 }  // namespace
 
 StreamingUtf8Validator::State StreamingUtf8Validator::AddBytes(const char* data,
@@ -26,20 +54,31 @@ StreamingUtf8Validator::State StreamingUtf8Validator::AddBytes(const char* data,
   // Copy |state_| into a local variable so that the compiler doesn't have to be
   // careful of aliasing.
   uint8_t state = state_;
-  for (const char* p = data; p != data + size; ++p) {
-    if ((*p & 0x80) == 0) {
-      if (state == 0)
-        continue;
+  const char* p = data;
+  const char* const end = data + size;
+
+  // Finish the character which the last call ended in the middle of, if any.
+  for (; p != end && state != 0 &&
+         state != internal::I18N_UTF8_VALIDATOR_INVALID_INDEX;
+       ++p) {
+    state = NextState(state, *p);
+  }
+
+  // The complete characters which follow are validated with the vectorized
+  // kernel shared with IsStringUTF8(), and only a character which is still
+  // incomplete at the end goes through the state machine, to carry it over to
+  // the next call.
+  if (state == 0 && p != end) {
+    const char* const tail = FindIncompleteTail(p, end);
+    if (!internal::ValidateUTF8(p, tail - p,
+                                internal::UTF8Noncharacters::kAllow)) {
       state = internal::I18N_UTF8_VALIDATOR_INVALID_INDEX;
-      break;
+    } else {
+      for (p = tail; p != end; ++p)
+        state = NextState(state, *p);
     }
-    const uint8_t shift_amount = StateTableLookup(state);
-    const uint8_t shifted_char = (*p & 0x7F) >> shift_amount;
-    state = StateTableLookup(state + shifted_char + 1);
-    // State may be INVALID here, but this code is optimised for the case of
-    // valid UTF-8 and it is more efficient (by about 2%) to not attempt an
-    // early loop exit unless we hit an ASCII character.
   }
+
   state_ = state;
   return state == 0 ? VALID_ENDPOINT
       : state == internal::I18N_UTF8_VALIDATOR_INVALID_INDEX
@@ -52,8 +91,8 @@ void StreamingUtf8Validator::Reset() {
 }
 
 bool StreamingUtf8Validator::Validate(const std::string& string) {
-  return StreamingUtf8Validator().AddBytes(string.data(), string.size()) ==
-         VALID_ENDPOINT;
+  return internal::ValidateUTF8(string.data(), string.size(),
+                                internal::UTF8Noncharacters::kAllow);
 }
 
 }  // namespace base
@@ -318,6 +318,38 @@ TEST(StreamingUtf8ValidatorTest, ResetWorks) {
   EXPECT_EQ(VALID_ENDPOINT, validator.AddBytes("a", 1));
 }
 
+// Long chunks are validated many bytes at a time, so check that characters
+// which are split between chunks at every position are carried over.
+TEST(StreamingUtf8ValidatorTest, LongChunks) {
+  std::string text;
+  for (int i = 0; i < 8; ++i) {
+    text += "\xc2\x81\xe1\x80\xbf\xf1\x80\xa0\xbf\xef\xbb\xbf";
+    text += 'a';
+  }
+
+  for (size_t split = 0; split <= text.size(); ++split) {
+    const bool at_boundary =
+        split == text.size() || (text[split] & 0xC0) != 0x80;
+    StreamingUtf8Validator validator;
+    EXPECT_EQ(at_boundary ? VALID_ENDPOINT : VALID_MIDPOINT,
+              validator.AddBytes(text.data(), split))
+        << "Failed at " << split;
+    EXPECT_EQ(VALID_ENDPOINT,
+              validator.AddBytes(text.data() + split, text.size() - split))
+        << "Failed at " << split;
+
+    // Dropping a byte at |split| leaves a truncated character, or a stray
+    // continuation byte.
+    if (split != text.size() && (text[split] & 0x80)) {
+      validator.Reset();
+      validator.AddBytes(text.data(), split);
+      EXPECT_EQ(INVALID, validator.AddBytes(text.data() + split + 1,
+                                            text.size() - split - 1))
+          << "Failed at " << split;
+    }
+  }
+}
+
 TEST_F(StreamingUtf8ValidatorSingleSequenceTest, Valid) {
   CheckRange(valid, valid_end, VALID_ENDPOINT);
 }
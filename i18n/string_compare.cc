@@ -4,7 +4,11 @@
 
 #include "base/i18n/string_compare.h"
 
+#include <utility>
+
 #include "base/check.h"
+#include "base/i18n/icu_object_pool.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 
@@ -25,5 +29,45 @@ UCollationResult CompareString16WithCollator(const icu::Collator& collator,
   return result;
 }
 
+namespace {
+
+using CollatorPool = internal::IcuObjectPool<std::unique_ptr<icu::Collator>>;
+
+CollatorPool& GetCollatorPool() {
+  static NoDestructor<CollatorPool> pool;
+  return *pool;
+}
+
+}  // namespace
+
+ScopedCollator::ScopedCollator(icu::Collator::ECollationStrength strength,
+                               const icu::Locale& locale)
+    : locale_(locale.getName()),
+      strength_(strength),
+      collator_(GetCollatorPool().Take(locale_.c_str(), strength_)) {
+  if (collator_)
+    return;
+  UErrorCode error = U_ZERO_ERROR;
+  collator_.reset(icu::Collator::createInstance(locale, error));
+  if (U_FAILURE(error)) {
+    collator_.reset();
+    return;
+  }
+  collator_->setStrength(strength_);
+}
+
+ScopedCollator::~ScopedCollator() {
+  if (collator_)
+    GetCollatorPool().Put(locale_.c_str(), strength_, std::move(collator_));
+}
+
+UCollationResult ScopedCollator::Compare(StringPiece16 lhs,
+                                         StringPiece16 rhs) const {
+  if (collator_)
+    return CompareString16WithCollator(*collator_, lhs, rhs);
+  const int result = lhs.compare(rhs);
+  return result < 0 ? UCOL_LESS : result > 0 ? UCOL_GREATER : UCOL_EQUAL;
+}
+
 }  // namespace i18n
 }  // namespace base
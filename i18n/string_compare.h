@@ -6,6 +6,7 @@
 #define BASE_I18N_STRING_COMPARE_H_
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,41 @@ CompareString16WithCollator(const icu::Collator& collator,
                             const StringPiece16 lhs,
                             const StringPiece16 rhs);
 
+// Creating an ICU collator is expensive, so rather than creating one for each
+// comparison or sort, lease one with a ScopedCollator:
+//
+//   ScopedCollator collator(icu::Collator::PRIMARY);
+//   std::sort(names.begin(), names.end(),
+//             [&collator](const string16& lhs, const string16& rhs) {
+//               return collator.Compare(lhs, rhs) == UCOL_LESS;
+//             });
+//
+// Collators are leased from a pool for the current thread, and returned to it
+// on destruction, so only the first ScopedCollator for a locale and strength
+// on each thread creates a collator. The collator is const, so that the next
+// lease gets it in the same state.
+class BASE_I18N_EXPORT ScopedCollator {
+ public:
+  explicit ScopedCollator(
+      icu::Collator::ECollationStrength strength = icu::Collator::TERTIARY,
+      const icu::Locale& locale = icu::Locale::getDefault());
+  ScopedCollator(const ScopedCollator&) = delete;
+  ScopedCollator& operator=(const ScopedCollator&) = delete;
+  ~ScopedCollator();
+
+  // Returns null if ICU failed to create a collator for the locale.
+  const icu::Collator* get() const { return collator_.get(); }
+
+  // Like CompareString16WithCollator(). Compares code units if there is no
+  // collator.
+  UCollationResult Compare(StringPiece16 lhs, StringPiece16 rhs) const;
+
+ private:
+  const std::string locale_;
+  const icu::Collator::ECollationStrength strength_;
+  std::unique_ptr<icu::Collator> collator_;
+};
+
 }  // namespace i18n
 }  // namespace base
 
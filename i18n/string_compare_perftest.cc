@@ -0,0 +1,99 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/i18n/string_compare.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/rand_util.h"
+#include "base/stl_util.h"
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace i18n {
+
+namespace {
+
+constexpr char kMetricPrefixStringCompare[] = "StringCompare.";
+constexpr char kMetricTimePerSort[] = "time_per_sort";
+
+constexpr size_t kStringCount = 100000;
+// Creating a collator for every comparison is slow enough that it sorts fewer
+// strings.
+constexpr size_t kUnpooledStringCount = 1000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixStringCompare,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerSort, "ms");
+  return reporter;
+}
+
+// Returns |count| random strings of lower and upper case letters, some of them
+// accented.
+std::vector<string16> MakeStrings(size_t count) {
+  static const char16 kLetters[] = {'a',    'B',    'c',    'D',    'e',
+                                    'F',    'g',    'H',    0x00E9, 0x00C9,
+                                    0x00F1, 0x00E0, 0x00FC, 0x00C7};
+  std::vector<string16> strings(count);
+  for (string16& string : strings) {
+    const size_t length = RandInt(4, 16);
+    for (size_t i = 0; i < length; ++i)
+      string.push_back(kLetters[RandGenerator(base::size(kLetters))]);
+  }
+  return strings;
+}
+
+template <typename Less>
+void SortAndReport(size_t count, const char* story_name, Less less) {
+  std::vector<string16> strings = MakeStrings(count);
+  const TimeTicks start = TimeTicks::Now();
+  std::sort(strings.begin(), strings.end(), less);
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+  SetUpReporter(story_name)
+      .AddResult(kMetricTimePerSort, elapsed.InMillisecondsF());
+}
+
+}  // namespace
+
+// One collator for the whole sort.
+TEST(StringComparePerfTest, SortWithOneScopedCollator) {
+  ScopedCollator collator;
+  SortAndReport(kStringCount, "one_scoped_collator",
+                [&collator](const string16& lhs, const string16& rhs) {
+                  return collator.Compare(lhs, rhs) == UCOL_LESS;
+                });
+}
+
+// A collator leased from the pool for each comparison.
+TEST(StringComparePerfTest, SortWithScopedCollatorPerCompare) {
+  SortAndReport(kStringCount, "scoped_collator_per_compare",
+                [](const string16& lhs, const string16& rhs) {
+                  return ScopedCollator().Compare(lhs, rhs) == UCOL_LESS;
+                });
+}
+
+// A collator created for each comparison, as callers of
+// CompareString16WithCollator() used to.
+TEST(StringComparePerfTest, SortWithNewCollatorPerCompare) {
+  SortAndReport(kUnpooledStringCount, "new_collator_per_compare_1000_strings",
+                [](const string16& lhs, const string16& rhs) {
+                  UErrorCode error = U_ZERO_ERROR;
+                  std::unique_ptr<icu::Collator> collator(
+                      icu::Collator::createInstance(error));
+                  CHECK(U_SUCCESS(error));
+                  return CompareString16WithCollator(*collator, lhs, rhs) ==
+                         UCOL_LESS;
+                });
+}
+
+}  // namespace i18n
+}  // namespace base
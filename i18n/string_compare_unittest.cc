@@ -0,0 +1,75 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/i18n/string_compare.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/strings/string16.h"
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace i18n {
+
+TEST(StringCompareTest, ScopedCollatorStrength) {
+  const icu::Locale locale("en_US");
+  const string16 lower = ASCIIToUTF16("a");
+  const string16 upper = ASCIIToUTF16("A");
+
+  // Alternate strengths, so that each lease gets a collator from the pool
+  // which was set up for its own strength.
+  for (int i = 0; i < 3; ++i) {
+    {
+      ScopedCollator collator(icu::Collator::PRIMARY, locale);
+      ASSERT_TRUE(collator.get());
+      EXPECT_EQ(icu::Collator::PRIMARY, collator.get()->getStrength());
+      EXPECT_EQ(UCOL_EQUAL, collator.Compare(lower, upper));
+      EXPECT_EQ(UCOL_LESS, collator.Compare(lower, ASCIIToUTF16("b")));
+    }
+    {
+      ScopedCollator collator(icu::Collator::TERTIARY, locale);
+      ASSERT_TRUE(collator.get());
+      EXPECT_EQ(icu::Collator::TERTIARY, collator.get()->getStrength());
+      EXPECT_EQ(UCOL_LESS, collator.Compare(lower, upper));
+      EXPECT_EQ(UCOL_GREATER, collator.Compare(upper, lower));
+    }
+  }
+}
+
+TEST(StringCompareTest, ScopedCollatorNested) {
+  const icu::Locale locale("en_US");
+  ScopedCollator outer(icu::Collator::PRIMARY, locale);
+  const icu::Collator* outer_collator = outer.get();
+  {
+    // A collator in use isn't leased again.
+    ScopedCollator inner(icu::Collator::PRIMARY, locale);
+    EXPECT_NE(outer_collator, inner.get());
+  }
+  EXPECT_EQ(outer_collator, outer.get());
+
+  // The collator of |inner| was returned to the pool.
+  ScopedCollator reused(icu::Collator::PRIMARY, locale);
+  EXPECT_NE(outer_collator, reused.get());
+  EXPECT_TRUE(reused.get());
+}
+
+TEST(StringCompareTest, ScopedCollatorSort) {
+  std::vector<string16> strings = {
+      ASCIIToUTF16("banana"), ASCIIToUTF16("Apple"), ASCIIToUTF16("cherry"),
+      UTF8ToUTF16("\xC3\xA9clair"), ASCIIToUTF16("apple")};
+  ScopedCollator collator(icu::Collator::TERTIARY, icu::Locale("en_US"));
+  std::sort(strings.begin(), strings.end(),
+            [&collator](const string16& lhs, const string16& rhs) {
+              return collator.Compare(lhs, rhs) == UCOL_LESS;
+            });
+  const std::vector<string16> expected = {
+      ASCIIToUTF16("apple"), ASCIIToUTF16("Apple"), ASCIIToUTF16("banana"),
+      ASCIIToUTF16("cherry"), UTF8ToUTF16("\xC3\xA9clair")};
+  EXPECT_EQ(expected, strings);
+}
+
+}  // namespace i18n
+}  // namespace base
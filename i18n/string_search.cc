@@ -4,45 +4,110 @@
 
 #include <stdint.h>
 
+#include <memory>
+#include <utility>
+
+#include "base/i18n/icu_object_pool.h"
 #include "base/i18n/string_search.h"
 #include "base/i18n/uchar.h"
-
+#include "base/no_destructor.h"
+#include "third_party/icu/source/common/unicode/uloc.h"
+#include "third_party/icu/source/i18n/unicode/ucol.h"
 #include "third_party/icu/source/i18n/unicode/usearch.h"
 
 namespace base {
 namespace i18n {
 
+namespace {
+
+// Closes a UStringSearch, and the collator which it was opened with.
+struct UStringSearchCloser {
+  void operator()(UStringSearch* search) const {
+    UCollator* collator = usearch_getCollator(search);
+    usearch_close(search);
+    ucol_close(collator);
+  }
+};
+
+using ScopedUStringSearch = std::unique_ptr<UStringSearch, UStringSearchCloser>;
+
+// Opening a string search opens a collator, which is expensive, so searches
+// are pooled for each locale and collation strength rather than closed.
+internal::IcuObjectPool<ScopedUStringSearch>& GetStringSearchPool() {
+  static NoDestructor<internal::IcuObjectPool<ScopedUStringSearch>> pool;
+  return *pool;
+}
+
+// http://icu-project.org/apiref/icu4c40/ucol_8h.html#6a967f36248b0a1bc7654f538ee8ba96
+// Set comparison level to UCOL_PRIMARY to ignore secondary and tertiary
+// differences. Set comparison level to UCOL_TERTIARY to include all
+// comparison differences.
+// Diacritical differences on the same base letter represent a
+// secondary difference.
+// Uppercase and lowercase versions of the same character represents a
+// tertiary difference.
+UCollationStrength GetStrength(bool case_sensitive) {
+  return case_sensitive ? UCOL_TERTIARY : UCOL_PRIMARY;
+}
+
+}  // namespace
+
 FixedPatternStringSearch::FixedPatternStringSearch(const string16& find_this,
                                                    bool case_sensitive)
-    : find_this_(find_this) {
-  // usearch_open requires a valid string argument to be searched, even if we
-  // want to set it by usearch_setText afterwards. So, supplying a dummy text.
-  const string16& dummy = find_this_;
-
+    : find_this_(find_this),
+      case_sensitive_(case_sensitive),
+      locale_(uloc_getDefault()),
+      search_(nullptr) {
+  const UCollationStrength strength = GetStrength(case_sensitive_);
   UErrorCode status = U_ZERO_ERROR;
-  search_ =
-      usearch_open(ToUCharPtr(find_this_.data()), find_this_.size(),
-                   ToUCharPtr(dummy.data()), dummy.size(), uloc_getDefault(),
-                   nullptr,  // breakiter
-                   &status);
-  if (U_SUCCESS(status)) {
-    // http://icu-project.org/apiref/icu4c40/ucol_8h.html#6a967f36248b0a1bc7654f538ee8ba96
-    // Set comparison level to UCOL_PRIMARY to ignore secondary and tertiary
-    // differences. Set comparison level to UCOL_TERTIARY to include all
-    // comparison differences.
-    // Diacritical differences on the same base letter represent a
-    // secondary difference.
-    // Uppercase and lowercase versions of the same character represents a
-    // tertiary difference.
-    UCollator* collator = usearch_getCollator(search_);
-    ucol_setStrength(collator, case_sensitive ? UCOL_TERTIARY : UCOL_PRIMARY);
-    usearch_reset(search_);
+  ScopedUStringSearch search =
+      GetStringSearchPool().Take(locale_.c_str(), strength);
+  if (search) {
+    usearch_setPattern(search.get(), ToUCharPtr(find_this_.data()),
+                       find_this_.size(), &status);
+    if (U_SUCCESS(status))
+      search_ = search.release();
+    else
+      GetStringSearchPool().Put(locale_.c_str(), strength, std::move(search));
+    return;
+  }
+
+  UCollator* collator = ucol_open(locale_.c_str(), &status);
+  if (U_FAILURE(status)) {
+    ucol_close(collator);
+    return;
+  }
+  ucol_setStrength(collator, strength);
+
+  // usearch_openFromCollator requires a valid string argument to be searched,
+  // even if we want to set it by usearch_setText afterwards. So, supplying a
+  // dummy text.
+  const string16& dummy = find_this_;
+  search_ = usearch_openFromCollator(
+      ToUCharPtr(find_this_.data()), find_this_.size(),
+      ToUCharPtr(dummy.data()), dummy.size(), collator,
+      nullptr,  // breakiter
+      &status);
+  if (U_FAILURE(status)) {
+    usearch_close(search_);
+    ucol_close(collator);
+    search_ = nullptr;
   }
 }
 
 FixedPatternStringSearch::~FixedPatternStringSearch() {
-  if (search_)
-    usearch_close(search_);
+  if (!search_)
+    return;
+  // Let go of the text, which may be freed before the search is leased out
+  // again. The pattern is replaced by the next lease.
+  static const UChar kDummyText[] = {' '};
+  UErrorCode status = U_ZERO_ERROR;
+  ScopedUStringSearch search(search_);
+  usearch_setText(search.get(), kDummyText, 1, &status);
+  if (U_SUCCESS(status)) {
+    GetStringSearchPool().Put(locale_.c_str(), GetStrength(case_sensitive_),
+                              std::move(search));
+  }
 }
 
 bool FixedPatternStringSearch::Search(const string16& in_this,
@@ -7,6 +7,8 @@
 
 #include <stddef.h>
 
+#include <string>
+
 #include "base/i18n/base_i18n_export.h"
 #include "base/strings/string16.h"
 
@@ -49,10 +51,19 @@ bool StringSearch(const string16& find_this,
 // This class is for speeding up multiple StringSearch()
 // with the same |find_this| argument. |find_this| is passed as the constructor
 // argument, and precomputation for searching is done only at that time.
+//
+// The ICU string search, and the collator which it uses, are leased from a
+// pool for the current thread and returned to it on destruction, so that
+// searching for different patterns in a loop, or calling StringSearch() and
+// StringSearchIgnoringCaseAndAccents() repeatedly, only needs to recompute the
+// pattern.
 class BASE_I18N_EXPORT FixedPatternStringSearch {
  public:
   explicit FixedPatternStringSearch(const string16& find_this,
                                     bool case_sensitive);
+  FixedPatternStringSearch(const FixedPatternStringSearch&) = delete;
+  FixedPatternStringSearch& operator=(const FixedPatternStringSearch&) =
+      delete;
   ~FixedPatternStringSearch();
 
   // Returns true if |in_this| contains |find_this|. If |match_index| or
@@ -65,6 +76,9 @@ class BASE_I18N_EXPORT FixedPatternStringSearch {
 
  private:
   string16 find_this_;
+  const bool case_sensitive_;
+  // The ICU default locale when |search_| was leased.
+  const std::string locale_;
   UStringSearch* search_;
 };
 
@@ -305,6 +305,42 @@ TEST(StringSearchTest, SearchBackwards) {
     SetICUDefaultLocale(default_locale.data());
 }
 
+TEST(StringSearchTest, ReusedSearches) {
+  std::string default_locale(uloc_getDefault());
+  bool locale_is_posix = (default_locale == "en_US_POSIX");
+  if (locale_is_posix)
+    SetICUDefaultLocale("en_US");
+
+  // Searches are reused once destroyed, with the new pattern, and are kept
+  // apart for case sensitive and insensitive searches.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_MATCH_IGNORE_CASE(ASCIIToUTF16("foo"), ASCIIToUTF16("a FOO"), 2U,
+                             3U);
+    EXPECT_MISS_SENSITIVE(ASCIIToUTF16("foo"), ASCIIToUTF16("a FOO"));
+    EXPECT_MATCH_IGNORE_CASE(ASCIIToUTF16("bar"), ASCIIToUTF16("BAR"), 0U, 3U);
+    EXPECT_MATCH_SENSITIVE(ASCIIToUTF16("bar"), ASCIIToUTF16("a bar"), 2U,
+                           3U);
+    // An empty pattern after a reused search falls back to a substring search.
+    EXPECT_MATCH_IGNORE_CASE(string16(), ASCIIToUTF16("foo"), 0U, 0U);
+  }
+
+  // A search in use isn't handed out again.
+  size_t index = 0;
+  size_t length = 0;
+  FixedPatternStringSearch outer(ASCIIToUTF16("foo"), true);
+  {
+    FixedPatternStringSearch inner(ASCIIToUTF16("bar"), true);
+    EXPECT_TRUE(inner.Search(ASCIIToUTF16("a bar"), &index, &length, true));
+    EXPECT_EQ(2U, index);
+  }
+  EXPECT_TRUE(outer.Search(ASCIIToUTF16("bar foo"), &index, &length, true));
+  EXPECT_EQ(4U, index);
+  EXPECT_EQ(3U, length);
+
+  if (locale_is_posix)
+    SetICUDefaultLocale(default_locale.data());
+}
+
 TEST(StringSearchTest, FixedPatternMultipleSearch) {
   std::string default_locale(uloc_getDefault());
   bool locale_is_posix = (default_locale == "en_US_POSIX");
@@ -104,6 +104,7 @@ JSONParser::JSONParser(int options, size_t max_depth)
       stack_depth_(0),
       line_number_(0),
       index_last_line_(0),
+      at_first_item_(false),
       error_code_(JSON_NO_ERROR),
       error_line_(0),
       error_column_(0) {
@@ -113,6 +114,35 @@ JSONParser::JSONParser(int options, size_t max_depth)
 JSONParser::~JSONParser() = default;
 
 Optional<Value> JSONParser::Parse(StringPiece input) {
+  if (!BeginReading(input))
+    return nullopt;
+
+  // Parse the first and any nested tokens.
+  Optional<Value> root(ParseNextToken());
+  if (!root || !FinishReading())
+    return nullopt;
+
+  return root;
+}
+
+JSONParser::JsonParseError JSONParser::error_code() const {
+  return error_code_;
+}
+
+std::string JSONParser::GetErrorMessage() const {
+  return FormatErrorMessage(error_line_, error_column_,
+                            ErrorCodeToString(error_code_));
+}
+
+int JSONParser::error_line() const {
+  return error_line_;
+}
+
+int JSONParser::error_column() const {
+  return error_column_;
+}
+
+bool JSONParser::BeginReading(StringPiece input) {
   input_ = input;
   index_ = 0;
   // Line and column counting is 1-based, but |index_| is 0-based. For example,
@@ -137,43 +167,218 @@ Optional<Value> JSONParser::Parse(StringPiece input) {
   // that the index_ will not overflow when parsing.
   if (!base::IsValueInRangeForNumericType<int32_t>(input.length())) {
     ReportError(JSON_TOO_LARGE, -1);
-    return nullopt;
+    return false;
   }
 
+  stack_depth_ = 0;
+  at_first_item_ = false;
+
   // When the input JSON string starts with a UTF-8 Byte-Order-Mark,
   // advance the start position to avoid the ParseNextToken function mis-
   // treating a Unicode BOM as an invalid character and returning NULL.
   ConsumeIfMatch("\xEF\xBB\xBF");
+  return true;
+}
 
-  // Parse the first and any nested tokens.
-  Optional<Value> root(ParseNextToken());
-  if (!root)
-    return nullopt;
-
+bool JSONParser::FinishReading() {
   // Make sure the input stream is at an end.
   if (GetNextToken() != T_END_OF_INPUT) {
     ReportError(JSON_UNEXPECTED_DATA_AFTER_ROOT, 0);
-    return nullopt;
+    return false;
   }
+  return true;
+}
 
-  return root;
+bool JSONParser::ReadBool(bool* out) {
+  const Token token = GetNextToken();
+  if (token != T_BOOL_TRUE && token != T_BOOL_FALSE) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  Optional<Value> value = ConsumeLiteral();
+  if (!value)
+    return false;
+  *out = value->GetBool();
+  return true;
 }
 
-JSONParser::JsonParseError JSONParser::error_code() const {
-  return error_code_;
+bool JSONParser::ReadInteger(int* out) {
+  if (GetNextToken() != T_NUMBER) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return false;
+  if (!StringToInt(num_string, out)) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  return true;
 }
 
-std::string JSONParser::GetErrorMessage() const {
-  return FormatErrorMessage(error_line_, error_column_,
-                            ErrorCodeToString(error_code_));
+bool JSONParser::ReadDouble(double* out) {
+  if (GetNextToken() != T_NUMBER) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return false;
+  int num_int;
+  if (StringToInt(num_string, &num_int)) {
+    *out = num_int;
+    return true;
+  }
+  return ConvertNumberToDouble(num_string, out);
 }
 
-int JSONParser::error_line() const {
-  return error_line_;
+bool JSONParser::ReadString(std::string* out) {
+  if (GetNextToken() != T_STRING) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  StringBuilder string;
+  if (!ConsumeStringRaw(&string))
+    return false;
+  *out = string.DestructiveAsString();
+  return true;
 }
 
-int JSONParser::error_column() const {
-  return error_column_;
+bool JSONParser::SkipValue() {
+  switch (GetNextToken()) {
+    case T_OBJECT_BEGIN: {
+      if (!BeginDictionary())
+        return false;
+      StringPiece key;
+      while (NextDictionaryKey(&key)) {
+        if (!SkipValue())
+          return false;
+      }
+      return error_code_ == JSON_NO_ERROR;
+    }
+    case T_ARRAY_BEGIN:
+      if (!BeginList())
+        return false;
+      while (NextListItem()) {
+        if (!SkipValue())
+          return false;
+      }
+      return error_code_ == JSON_NO_ERROR;
+    case T_STRING: {
+      // Unlike ConsumeString(), this doesn't copy strings without escapes.
+      StringBuilder string;
+      return ConsumeStringRaw(&string);
+    }
+    case T_NUMBER:
+      return ConsumeNumber().has_value();
+    case T_BOOL_TRUE:
+    case T_BOOL_FALSE:
+    case T_NULL:
+      return ConsumeLiteral().has_value();
+    default:
+      ReportError(JSON_UNEXPECTED_TOKEN, 0);
+      return false;
+  }
+}
+
+bool JSONParser::BeginDictionary() {
+  if (GetNextToken() != T_OBJECT_BEGIN) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  ConsumeChar();
+
+  // Like StackMarker, but the depth is only restored when the closing '}' is
+  // read, since reading stops at the first error.
+  if (++stack_depth_ >= max_depth_) {
+    ReportError(JSON_TOO_MUCH_NESTING, -1);
+    return false;
+  }
+
+  at_first_item_ = true;
+  return true;
+}
+
+bool JSONParser::NextDictionaryKey(StringPiece* key) {
+  Token token = GetNextToken();
+  if (!at_first_item_) {
+    if (token == T_LIST_SEPARATOR) {
+      ConsumeChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSON_TRAILING_COMMA, 0);
+        return false;
+      }
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSON_SYNTAX_ERROR, 0);
+      return false;
+    }
+  }
+  at_first_item_ = false;
+
+  if (token == T_OBJECT_END) {
+    ConsumeChar();
+    --stack_depth_;
+    return false;
+  }
+
+  if (token != T_STRING) {
+    ReportError(JSON_UNQUOTED_DICTIONARY_KEY, 0);
+    return false;
+  }
+  if (!ConsumeStringRaw(&key_))
+    return false;
+
+  if (GetNextToken() != T_OBJECT_PAIR_SEPARATOR) {
+    ReportError(JSON_SYNTAX_ERROR, 0);
+    return false;
+  }
+  ConsumeChar();
+
+  *key = key_.AsStringPiece();
+  return true;
+}
+
+bool JSONParser::BeginList() {
+  if (GetNextToken() != T_ARRAY_BEGIN) {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return false;
+  }
+  ConsumeChar();
+
+  if (++stack_depth_ >= max_depth_) {
+    ReportError(JSON_TOO_MUCH_NESTING, -1);
+    return false;
+  }
+
+  at_first_item_ = true;
+  return true;
+}
+
+bool JSONParser::NextListItem() {
+  Token token = GetNextToken();
+  if (!at_first_item_) {
+    if (token == T_LIST_SEPARATOR) {
+      ConsumeChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSON_TRAILING_COMMA, 0);
+        return false;
+      }
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSON_SYNTAX_ERROR, 0);
+      return false;
+    }
+  }
+  at_first_item_ = false;
+
+  if (token == T_ARRAY_END) {
+    ConsumeChar();
+    --stack_depth_;
+    return false;
+  }
+  return true;
 }
 
 // StringBuilder ///////////////////////////////////////////////////////////////
@@ -216,6 +421,12 @@ std::string JSONParser::StringBuilder::DestructiveAsString() {
   return std::string(pos_, length_);
 }
 
+StringPiece JSONParser::StringBuilder::AsStringPiece() const {
+  if (string_)
+    return *string_;
+  return StringPiece(pos_, length_);
+}
+
 // JSONParser private //////////////////////////////////////////////////////////
 
 Optional<StringPiece> JSONParser::PeekChars(size_t count) {
@@ -687,6 +898,21 @@ bool JSONParser::DecodeUTF16(uint32_t* out_code_point) {
 }
 
 Optional<Value> JSONParser::ConsumeNumber() {
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return nullopt;
+
+  int num_int;
+  if (StringToInt(num_string, &num_int))
+    return Value(num_int);
+
+  double num_double;
+  if (!ConvertNumberToDouble(num_string, &num_double))
+    return nullopt;
+  return Value(num_double);
+}
+
+bool JSONParser::ConsumeNumberRaw(StringPiece* out) {
   const char* num_start = pos();
   const int start_index = index_;
   int end_index = start_index;
@@ -696,7 +922,7 @@ Optional<Value> JSONParser::ConsumeNumber() {
 
   if (!ReadInt(false)) {
     ReportError(JSON_SYNTAX_ERROR, 0);
-    return nullopt;
+    return false;
   }
   end_index = index_;
 
@@ -705,7 +931,7 @@ Optional<Value> JSONParser::ConsumeNumber() {
     ConsumeChar();
     if (!ReadInt(true)) {
       ReportError(JSON_SYNTAX_ERROR, 0);
-      return nullopt;
+      return false;
     }
     end_index = index_;
   }
@@ -719,7 +945,7 @@ Optional<Value> JSONParser::ConsumeNumber() {
     }
     if (!ReadInt(true)) {
       ReportError(JSON_SYNTAX_ERROR, 0);
-      return nullopt;
+      return false;
     }
     end_index = index_;
   }
@@ -738,25 +964,21 @@ Optional<Value> JSONParser::ConsumeNumber() {
       break;
     default:
       ReportError(JSON_SYNTAX_ERROR, 0);
-      return nullopt;
+      return false;
   }
 
   index_ = exit_index;
 
-  StringPiece num_string(num_start, end_index - start_index);
-
-  int num_int;
-  if (StringToInt(num_string, &num_int))
-    return Value(num_int);
+  *out = StringPiece(num_start, end_index - start_index);
+  return true;
+}
 
-  double num_double;
-  if (StringToDouble(num_string.as_string(), &num_double) &&
-      std::isfinite(num_double)) {
-    return Value(num_double);
-  }
+bool JSONParser::ConvertNumberToDouble(StringPiece num_string, double* out) {
+  if (StringToDouble(num_string.as_string(), out) && std::isfinite(*out))
+    return true;
 
   ReportError(JSON_UNREPRESENTABLE_NUMBER, 0);
-  return nullopt;
+  return false;
 }
 
 bool JSONParser::ReadInt(bool allow_leading_zeros) {
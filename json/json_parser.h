@@ -95,6 +95,37 @@ class BASE_EXPORT JSONParser {
   // returns 0.
   int error_column() const;
 
+  // An incremental interface, for reading a JSON value directly into other
+  // types without building a Value; see JSONStructConverter. Call
+  // BeginReading(), read exactly one value with the methods below, then call
+  // FinishReading() to check that nothing follows it. All of them return false
+  // on failure, with the error information set. Reading a value of another
+  // type than the one asked for is a JSON_UNEXPECTED_TOKEN error.
+  bool BeginReading(StringPiece input);
+  bool FinishReading();
+
+  bool ReadBool(bool* out);
+  // Like Value, only accepts numbers which can be represented as an int.
+  bool ReadInteger(int* out);
+  // Accepts integers as well.
+  bool ReadDouble(double* out);
+  bool ReadString(std::string* out);
+  // Reads a value of any type, and discards it.
+  bool SkipValue();
+
+  // Reads the '{' which starts a dictionary. NextDictionaryKey() then returns
+  // each key in turn, after which the caller must read its value. It returns
+  // false after reading the closing '}', or on error, which error_code() tells
+  // apart. |*key| is only valid until the next call.
+  bool BeginDictionary();
+  bool NextDictionaryKey(StringPiece* key);
+
+  // Reads the '[' which starts a list. NextListItem() then returns true before
+  // each item, which the caller must read. Like NextDictionaryKey(), it
+  // returns false after reading the closing ']', or on error.
+  bool BeginList();
+  bool NextListItem();
+
  private:
   enum Token {
     T_OBJECT_BEGIN,           // {
@@ -144,6 +175,10 @@ class BASE_EXPORT JSONParser {
     // in cases where the builder will not be needed any more.
     std::string DestructiveAsString();
 
+    // Returns the string built so far, which is valid until the builder is
+    // changed or destroyed.
+    StringPiece AsStringPiece() const;
+
    private:
     // The beginning of the input string.
     const char* pos_;
@@ -216,6 +251,14 @@ class BASE_EXPORT JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Optional<Value> ConsumeNumber();
+  // Helper function for ConsumeNumber() that consumes the number and places
+  // its text into |out|, without converting it. Returns false on failure with
+  // error information set.
+  bool ConsumeNumberRaw(StringPiece* out);
+  // Converts the text of a number to a double, like ConsumeNumber() does for
+  // numbers which aren't ints. Returns false on failure with error
+  // information set.
+  bool ConvertNumberToDouble(StringPiece num_string, double* out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -261,6 +304,13 @@ class BASE_EXPORT JSONParser {
   // The last value of |index_| on the previous line.
   int index_last_line_;
 
+  // Whether the incremental interface is positioned right after the start of
+  // a dictionary or list, where no ',' is expected before the next item.
+  bool at_first_item_;
+
+  // The last key returned by NextDictionaryKey().
+  StringBuilder key_;
+
   // Error information.
   JsonParseError error_code_;
   int error_line_;
@@ -0,0 +1,406 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_JSON_JSON_STRUCT_CONVERTER_H_
+#define BASE_JSON_JSON_STRUCT_CONVERTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/json/json_parser.h"
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/utf_string_conversions.h"
+
+// JSONStructConverter parses JSON directly into a C++ struct. Unlike
+// JSONValueConverter, it doesn't build a base::Value first, and its fields are
+// registered at compile time, with the keys matched by a perfect hash.
+//
+// Usage:
+// Give your struct a constexpr GetJSONFields() method returning a tuple of its
+// fields:
+//   struct Message {
+//     int foo = 0;
+//     std::string bar;
+//     std::vector<int> values;
+//     Nested nested;
+//
+//     static constexpr auto GetJSONFields() {
+//       return std::make_tuple(JSONField("foo", &Message::foo),
+//                              JSONField("bar", &Message::bar),
+//                              JSONField("values", &Message::values),
+//                              JSONField("nested", &Message::nested));
+//     }
+//   };
+//
+// Then call Convert():
+//   Message message;
+//   bool success = JSONStructConverter<Message>::Convert(json, &message);
+//
+// Fields can be bools, ints, doubles, std::strings, string16s, structs with
+// their own GetJSONFields(), and std::vectors or
+// std::vector<std::unique_ptr<>>s of any of those. Fields of other types can
+// be converted from strings with a function, like RegisterCustomField() of
+// JSONValueConverter:
+//   JSONField("your_enum", &Message::your_enum, &ConvertFunc)
+//
+// Like JSONValueConverter, Convert() returns false if the JSON is invalid or
+// structurally different from the struct, such as a string for an int field,
+// but not for missing fields. Unknown keys are skipped. It may modify
+// |output| even when it fails. Unlike JSONValueConverter, field names are
+// single keys rather than paths; use nested structs for nested dictionaries.
+
+namespace base {
+
+template <typename StructType>
+class JSONStructConverter;
+
+namespace internal {
+
+// The FNV-1a hash of |key|, which is simple to compute at compile time.
+constexpr uint32_t HashJSONKey(StringPiece key) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < key.size(); ++i) {
+    hash ^= static_cast<uint8_t>(key.data()[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Mixes |seed| into |hash|, to pick a slot of a JSONKeyTable.
+constexpr uint32_t MixJSONKeyHash(uint32_t hash, uint32_t seed) {
+  hash ^= seed * 0x9e3779b9u;
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+constexpr size_t RoundUpToPowerOfTwo(size_t size) {
+  size_t power = 1;
+  while (power < size)
+    power <<= 1;
+  return power;
+}
+
+// A perfect hash table from |N| keys to their indices, built at compile time
+// with the "hash, displace" method: the keys are split into buckets by their
+// hash, and each bucket gets a seed which maps its keys to free slots. A
+// lookup costs one hash of the key and one comparison. FieldTrialIndex builds
+// the same kind of table at runtime; this one has to be built in a constant
+// expression, so it uses fixed-size arrays instead of sharing that code.
+template <size_t N>
+class JSONKeyTable {
+ public:
+  static_assert(N > 0, "JSONKeyTable needs at least one key");
+
+  constexpr explicit JSONKeyTable(const StringPiece (&keys)[N])
+      : JSONKeyTable(keys, std::make_index_sequence<N>()) {}
+
+  // Whether a table could be built. This fails if two keys are equal, or if
+  // two different keys have the same hash.
+  constexpr bool valid() const { return valid_; }
+
+  StringPiece key(size_t index) const { return keys_[index]; }
+
+  // Returns the index of |key|, or N if it isn't in the table.
+  size_t Find(StringPiece key) const {
+    const uint32_t hash = HashJSONKey(key);
+    const size_t index =
+        slots_[MixJSONKeyHash(hash, seeds_[hash & (kBuckets - 1)]) &
+               (kSlots - 1)];
+    if (index == N || keys_[index] != key)
+      return N;
+    return index;
+  }
+
+ private:
+  static constexpr size_t kBuckets = RoundUpToPowerOfTwo(N);
+  static constexpr size_t kSlots = 2 * kBuckets;
+  // Buckets hold one key on average, and at least half of the slots are
+  // always free, so running out of seeds doesn't happen in practice.
+  static constexpr uint32_t kMaxSeeds = 1 << 12;
+  using SlotType = std::conditional_t<(N < UINT8_MAX), uint8_t, uint16_t>;
+  static_assert(N < UINT16_MAX, "Too many keys");
+
+  template <size_t... I>
+  constexpr JSONKeyTable(const StringPiece (&keys)[N],
+                         std::index_sequence<I...>)
+      : keys_{keys[I]...}, seeds_(), slots_(), valid_(false) {
+    uint32_t hashes[N] = {};
+    // The keys sorted by bucket, and the start of each bucket in it.
+    size_t bucket_keys[N] = {};
+    size_t bucket_starts[kBuckets + 1] = {};
+    for (size_t i = 0; i < N; ++i) {
+      hashes[i] = HashJSONKey(keys_[i]);
+      // Keys with equal hashes can't be told apart by any seed.
+      for (size_t j = 0; j < i; ++j) {
+        if (hashes[j] == hashes[i])
+          return;
+      }
+      ++bucket_starts[(hashes[i] & (kBuckets - 1)) + 1];
+    }
+    size_t max_bucket_size = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      if (bucket_starts[bucket + 1] > max_bucket_size)
+        max_bucket_size = bucket_starts[bucket + 1];
+      bucket_starts[bucket + 1] += bucket_starts[bucket];
+    }
+    size_t bucket_ends[kBuckets] = {};
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket)
+      bucket_ends[bucket] = bucket_starts[bucket];
+    for (size_t i = 0; i < N; ++i)
+      bucket_keys[bucket_ends[hashes[i] & (kBuckets - 1)]++] = i;
+
+    for (size_t slot = 0; slot < kSlots; ++slot)
+      slots_[slot] = N;
+
+    // Place the largest buckets first, while most slots are free.
+    for (size_t size = max_bucket_size; size > 0; --size) {
+      for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        const size_t begin = bucket_starts[bucket];
+        if (bucket_starts[bucket + 1] - begin == size &&
+            !PlaceBucket(bucket, hashes, bucket_keys + begin, size)) {
+          return;
+        }
+      }
+    }
+    valid_ = true;
+  }
+
+  // Finds a seed which maps the |size| keys of |bucket| to free slots, and
+  // fills them.
+  constexpr bool PlaceBucket(size_t bucket,
+                             const uint32_t* hashes,
+                             const size_t* keys,
+                             size_t size) {
+    for (uint32_t seed = 0; seed < kMaxSeeds; ++seed) {
+      size_t slots[N] = {};
+      bool free = true;
+      for (size_t i = 0; free && i < size; ++i) {
+        slots[i] = MixJSONKeyHash(hashes[keys[i]], seed) & (kSlots - 1);
+        free = slots_[slots[i]] == N;
+        for (size_t j = 0; free && j < i; ++j)
+          free = slots[j] != slots[i];
+      }
+      if (!free)
+        continue;
+      for (size_t i = 0; i < size; ++i)
+        slots_[slots[i]] = static_cast<SlotType>(keys[i]);
+      seeds_[bucket] = seed;
+      return true;
+    }
+    return false;
+  }
+
+  StringPiece keys_[N];
+  uint32_t seeds_[kBuckets];
+  // The index of the key in each slot, or N if it's free.
+  SlotType slots_[kSlots];
+  bool valid_;
+};
+
+template <typename StructType, typename FieldType>
+struct JSONFieldInfo;
+
+template <typename StructType, typename FieldType>
+struct JSONCustomFieldInfo;
+
+inline bool ReadJSONValue(JSONParser* parser, bool* value) {
+  return parser->ReadBool(value);
+}
+
+inline bool ReadJSONValue(JSONParser* parser, int* value) {
+  return parser->ReadInteger(value);
+}
+
+inline bool ReadJSONValue(JSONParser* parser, double* value) {
+  return parser->ReadDouble(value);
+}
+
+inline bool ReadJSONValue(JSONParser* parser, std::string* value) {
+  return parser->ReadString(value);
+}
+
+inline bool ReadJSONValue(JSONParser* parser, string16* value) {
+  std::string utf8_value;
+  if (!parser->ReadString(&utf8_value))
+    return false;
+  *value = UTF8ToUTF16(utf8_value);
+  return true;
+}
+
+template <typename Element>
+bool ReadJSONValue(JSONParser* parser, std::vector<Element>* value) {
+  if (!parser->BeginList())
+    return false;
+  value->clear();
+  while (parser->NextListItem()) {
+    value->emplace_back();
+    if (!ReadJSONValue(parser, &value->back())) {
+      DVLOG(1) << "failure at " << value->size() - 1 << "-th element";
+      return false;
+    }
+  }
+  return parser->error_code() == JSONParser::JSON_NO_ERROR;
+}
+
+template <typename Element>
+bool ReadJSONValue(JSONParser* parser,
+                   std::vector<std::unique_ptr<Element>>* value) {
+  if (!parser->BeginList())
+    return false;
+  value->clear();
+  while (parser->NextListItem()) {
+    value->push_back(std::make_unique<Element>());
+    if (!ReadJSONValue(parser, value->back().get())) {
+      DVLOG(1) << "failure at " << value->size() - 1 << "-th element";
+      return false;
+    }
+  }
+  return parser->error_code() == JSONParser::JSON_NO_ERROR;
+}
+
+// Nested structs.
+template <typename StructType>
+bool ReadJSONValue(JSONParser* parser, StructType* value) {
+  return JSONStructConverter<StructType>::Read(parser, value);
+}
+
+template <typename StructType, typename FieldType>
+struct JSONFieldInfo {
+  bool Read(JSONParser* parser, StructType* output) const {
+    return ReadJSONValue(parser, &(output->*member));
+  }
+
+  StringPiece name;
+  FieldType StructType::*member;
+};
+
+template <typename StructType, typename FieldType>
+struct JSONCustomFieldInfo {
+  bool Read(JSONParser* parser, StructType* output) const {
+    std::string value;
+    return parser->ReadString(&value) && convert(value, &(output->*member));
+  }
+
+  StringPiece name;
+  FieldType StructType::*member;
+  bool (*convert)(StringPiece value, FieldType* field);
+};
+
+template <typename StructType>
+using JSONFieldReader = bool (*)(JSONParser* parser, StructType* output);
+
+template <typename StructType, size_t I>
+bool ReadJSONField(JSONParser* parser, StructType* output) {
+  constexpr auto field = std::get<I>(StructType::GetJSONFields());
+  return field.Read(parser, output);
+}
+
+template <typename StructType, size_t... I>
+constexpr JSONKeyTable<sizeof...(I)> MakeJSONKeyTable(
+    std::index_sequence<I...>) {
+  return JSONKeyTable<sizeof...(I)>(
+      {std::get<I>(StructType::GetJSONFields()).name...});
+}
+
+template <typename StructType, size_t... I>
+constexpr std::array<JSONFieldReader<StructType>, sizeof...(I)>
+MakeJSONFieldReaders(std::index_sequence<I...>) {
+  return {{&ReadJSONField<StructType, I>...}};
+}
+
+}  // namespace internal
+
+// Returns the description of a field for GetJSONFields(), read from the value
+// of |name|.
+template <typename StructType, typename FieldType, size_t kNameSize>
+constexpr internal::JSONFieldInfo<StructType, FieldType> JSONField(
+    const char (&name)[kNameSize],
+    FieldType StructType::*member) {
+  return {StringPiece(name, kNameSize - 1), member};
+}
+
+// Like above, but for a field which is converted from a string by
+// |convert_func|.
+template <typename StructType, typename FieldType, size_t kNameSize>
+constexpr internal::JSONCustomFieldInfo<StructType, FieldType> JSONField(
+    const char (&name)[kNameSize],
+    FieldType StructType::*member,
+    bool (*convert_func)(StringPiece, FieldType*)) {
+  return {StringPiece(name, kNameSize - 1), member, convert_func};
+}
+
+template <typename StructType>
+class JSONStructConverter {
+ public:
+  // Parses |json| into |output|. |options| are JSONParserOptions.
+  static bool Convert(StringPiece json,
+                      StructType* output,
+                      int options = JSON_PARSE_RFC) {
+    internal::JSONParser parser(options);
+    return parser.BeginReading(json) && Read(&parser, output) &&
+           parser.FinishReading();
+  }
+
+  // Reads the dictionary at the position of |parser| into |output|.
+  static bool Read(internal::JSONParser* parser, StructType* output) {
+    if (!parser->BeginDictionary())
+      return false;
+    StringPiece key;
+    while (parser->NextDictionaryKey(&key)) {
+      const size_t field = kKeyTable.Find(key);
+      if (field == kFieldCount) {
+        if (!parser->SkipValue())
+          return false;
+      } else if (!kFieldReaders[field](parser, output)) {
+        DVLOG(1) << "failure at field " << kKeyTable.key(field);
+        return false;
+      }
+    }
+    return parser->error_code() == internal::JSONParser::JSON_NO_ERROR;
+  }
+
+ private:
+  static constexpr size_t kFieldCount =
+      std::tuple_size<decltype(StructType::GetJSONFields())>::value;
+
+  static constexpr internal::JSONKeyTable<kFieldCount> kKeyTable =
+      internal::MakeJSONKeyTable<StructType>(
+          std::make_index_sequence<kFieldCount>());
+  static_assert(kKeyTable.valid(),
+                "JSON field names must be unique, with distinct hashes");
+
+  static constexpr std::array<internal::JSONFieldReader<StructType>,
+                              kFieldCount>
+      kFieldReaders = internal::MakeJSONFieldReaders<StructType>(
+          std::make_index_sequence<kFieldCount>());
+};
+
+template <typename StructType>
+constexpr size_t JSONStructConverter<StructType>::kFieldCount;
+
+template <typename StructType>
+constexpr internal::JSONKeyTable<JSONStructConverter<StructType>::kFieldCount>
+    JSONStructConverter<StructType>::kKeyTable;
+
+template <typename StructType>
+constexpr std::array<internal::JSONFieldReader<StructType>,
+                     JSONStructConverter<StructType>::kFieldCount>
+    JSONStructConverter<StructType>::kFieldReaders;
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_STRUCT_CONVERTER_H_
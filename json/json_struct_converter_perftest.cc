@@ -0,0 +1,149 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_struct_converter.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_value_converter.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixJSONConverter[] = "JSONConverter.";
+constexpr char kMetricTimePerConvert[] = "time_per_convert";
+
+constexpr int kEntryCounts[] = {1, 100, 10000};
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixJSONConverter,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerConvert, "us");
+  return reporter;
+}
+
+// Both converters are registered, so that they parse the same documents into
+// the same structs.
+struct Entry {
+  int id = 0;
+  std::string name;
+  double score = 0.0;
+  bool enabled = false;
+  std::vector<std::unique_ptr<int>> tags;
+
+  static void RegisterJSONConverter(JSONValueConverter<Entry>* converter) {
+    converter->RegisterIntField("id", &Entry::id);
+    converter->RegisterStringField("name", &Entry::name);
+    converter->RegisterDoubleField("score", &Entry::score);
+    converter->RegisterBoolField("enabled", &Entry::enabled);
+    converter->RegisterRepeatedInt("tags", &Entry::tags);
+  }
+
+  static constexpr auto GetJSONFields() {
+    return std::make_tuple(JSONField("id", &Entry::id),
+                           JSONField("name", &Entry::name),
+                           JSONField("score", &Entry::score),
+                           JSONField("enabled", &Entry::enabled),
+                           JSONField("tags", &Entry::tags));
+  }
+};
+
+struct Document {
+  std::string version;
+  std::vector<std::unique_ptr<Entry>> entries;
+
+  static void RegisterJSONConverter(JSONValueConverter<Document>* converter) {
+    converter->RegisterStringField("version", &Document::version);
+    converter->RegisterRepeatedMessage("entries", &Document::entries);
+  }
+
+  static constexpr auto GetJSONFields() {
+    return std::make_tuple(JSONField("version", &Document::version),
+                           JSONField("entries", &Document::entries));
+  }
+};
+
+// Returns a document of |count| entries, with an unknown key in each which
+// both converters skip.
+std::string MakeDocument(int count) {
+  Value entries(Value::Type::LIST);
+  for (int i = 0; i < count; ++i) {
+    Value entry(Value::Type::DICTIONARY);
+    entry.SetIntKey("id", i);
+    entry.SetStringKey("name", "entry " + NumberToString(i));
+    entry.SetDoubleKey("score", i / 7.0);
+    entry.SetBoolKey("enabled", i % 2 == 0);
+    Value tags(Value::Type::LIST);
+    for (int j = 0; j < 4; ++j)
+      tags.Append(i + j);
+    entry.SetKey("tags", std::move(tags));
+    entry.SetStringKey("comment", "not converted");
+    entries.Append(std::move(entry));
+  }
+  Value document(Value::Type::DICTIONARY);
+  document.SetStringKey("version", "1.0");
+  document.SetKey("entries", std::move(entries));
+
+  std::string json;
+  CHECK(JSONWriter::Write(document, &json));
+  return json;
+}
+
+int GetLaps(int count) {
+  return std::max(10, 100000 / count);
+}
+
+std::string GetStory(const char* converter, int count) {
+  return converter + NumberToString(count) + "_entries";
+}
+
+}  // namespace
+
+TEST(JSONConverterPerfTest, ValueConverter) {
+  const JSONValueConverter<Document> converter;
+  for (int count : kEntryCounts) {
+    const std::string json = MakeDocument(count);
+    const int laps = GetLaps(count);
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < laps; ++i) {
+      Optional<Value> value = JSONReader::Read(json);
+      ASSERT_TRUE(value);
+      Document document;
+      ASSERT_TRUE(converter.Convert(*value, &document));
+      ASSERT_EQ(static_cast<size_t>(count), document.entries.size());
+    }
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+    SetUpReporter(GetStory("value_converter_", count))
+        .AddResult(kMetricTimePerConvert, elapsed.InMicrosecondsF() / laps);
+  }
+}
+
+TEST(JSONConverterPerfTest, StructConverter) {
+  for (int count : kEntryCounts) {
+    const std::string json = MakeDocument(count);
+    const int laps = GetLaps(count);
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < laps; ++i) {
+      Document document;
+      ASSERT_TRUE(JSONStructConverter<Document>::Convert(json, &document));
+      ASSERT_EQ(static_cast<size_t>(count), document.entries.size());
+    }
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+    SetUpReporter(GetStory("struct_converter_", count))
+        .AddResult(kMetricTimePerConvert, elapsed.InMicrosecondsF() / laps);
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,273 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_struct_converter.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/stl_util.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+struct SimpleMessage {
+  enum SimpleEnum {
+    FOO,
+    BAR,
+  };
+  int foo = 0;
+  std::string bar;
+  bool baz = false;
+  double qux = 0.0;
+  string16 utf16;
+  SimpleEnum simple_enum = FOO;
+  std::vector<int> ints;
+
+  static bool ParseSimpleEnum(StringPiece value, SimpleEnum* field) {
+    if (value == "foo") {
+      *field = FOO;
+      return true;
+    }
+    if (value == "bar") {
+      *field = BAR;
+      return true;
+    }
+    return false;
+  }
+
+  static constexpr auto GetJSONFields() {
+    return std::make_tuple(
+        JSONField("foo", &SimpleMessage::foo),
+        JSONField("bar", &SimpleMessage::bar),
+        JSONField("baz", &SimpleMessage::baz),
+        JSONField("qux", &SimpleMessage::qux),
+        JSONField("utf16", &SimpleMessage::utf16),
+        JSONField("simple_enum", &SimpleMessage::simple_enum,
+                  &ParseSimpleEnum),
+        JSONField("ints", &SimpleMessage::ints));
+  }
+};
+
+struct NestedMessage {
+  double foo = 0.0;
+  SimpleMessage child;
+  std::vector<std::unique_ptr<SimpleMessage>> children;
+  std::vector<std::vector<std::string>> table;
+
+  static constexpr auto GetJSONFields() {
+    return std::make_tuple(JSONField("foo", &NestedMessage::foo),
+                           JSONField("child", &NestedMessage::child),
+                           JSONField("children", &NestedMessage::children),
+                           JSONField("table", &NestedMessage::table));
+  }
+};
+
+// A recursive message.
+struct TreeMessage {
+  int value = 0;
+  std::vector<TreeMessage> children;
+
+  static constexpr auto GetJSONFields() {
+    return std::make_tuple(JSONField("value", &TreeMessage::value),
+                           JSONField("children", &TreeMessage::children));
+  }
+};
+
+}  // namespace
+
+TEST(JSONKeyTableTest, FindsAllKeys) {
+  // Enough keys that many buckets hold more than one.
+  static constexpr StringPiece kKeys[] = {
+      StringPiece("a", 1),         StringPiece("b", 1),
+      StringPiece("ab", 2),        StringPiece("ba", 2),
+      StringPiece("key", 3),       StringPiece("keys", 4),
+      StringPiece("value", 5),     StringPiece("values", 6),
+      StringPiece("", 0),          StringPiece("enabled", 7),
+      StringPiece("disabled", 8),  StringPiece("timeout_ms", 10),
+      StringPiece("retries", 7),   StringPiece("url", 3),
+      StringPiece("urls", 4),      StringPiece("name", 4),
+      StringPiece("names", 5),     StringPiece("id", 2),
+      StringPiece("ids", 3),       StringPiece("type", 4),
+      StringPiece("types", 5),     StringPiece("x", 1),
+      StringPiece("y", 1),         StringPiece("z", 1),
+  };
+  static constexpr internal::JSONKeyTable<base::size(kKeys)> kTable(kKeys);
+  static_assert(kTable.valid(), "");
+
+  for (size_t i = 0; i < base::size(kKeys); ++i)
+    EXPECT_EQ(i, kTable.Find(kKeys[i])) << kKeys[i];
+  for (StringPiece key : {"c", "aa", "key ", "Value", "keyss", "timeout"})
+    EXPECT_EQ(base::size(kKeys), kTable.Find(key)) << key;
+
+  static constexpr StringPiece kDuplicateKeys[] = {StringPiece("a", 1),
+                                                   StringPiece("a", 1)};
+  static_assert(
+      !internal::JSONKeyTable<base::size(kDuplicateKeys)>(kDuplicateKeys)
+           .valid(),
+      "");
+}
+
+TEST(JSONStructConverterTest, ParseSimpleMessage) {
+  const char normal_data[] =
+      "{\n"
+      "  \"foo\": 1,\n"
+      "  \"bar\": \"bar\",\n"
+      "  \"baz\": true,\n"
+      "  \"qux\": 2.5,\n"
+      "  \"utf16\": \"\\u00e9t\\u00e9\",\n"
+      "  \"unknown\": {\"a\": [1, \"b\", null, {}], \"c\": false},\n"
+      "  \"simple_enum\": \"bar\","
+      "  \"ints\": [1, 2]"
+      "}\n";
+
+  SimpleMessage message;
+  EXPECT_TRUE(JSONStructConverter<SimpleMessage>::Convert(normal_data,
+                                                          &message));
+
+  EXPECT_EQ(1, message.foo);
+  EXPECT_EQ("bar", message.bar);
+  EXPECT_TRUE(message.baz);
+  EXPECT_EQ(2.5, message.qux);
+  EXPECT_EQ(UTF8ToUTF16("\xC3\xA9t\xC3\xA9"), message.utf16);
+  EXPECT_EQ(SimpleMessage::BAR, message.simple_enum);
+  EXPECT_EQ(std::vector<int>({1, 2}), message.ints);
+}
+
+TEST(JSONStructConverterTest, ParseNestedMessage) {
+  const char normal_data[] =
+      "{\n"
+      "  \"foo\": 1,\n"
+      "  \"child\": {\n"
+      "    \"foo\": 1,\n"
+      "    \"bar\": \"bar\",\n"
+      "    \"baz\": true\n"
+      "  },\n"
+      "  \"children\": [{\n"
+      "    \"foo\": 2,\n"
+      "    \"bar\": \"foobar\",\n"
+      "    \"ints\": []\n"
+      "  },\n"
+      "  {\n"
+      "    \"foo\": 3,\n"
+      "    \"bar\": \"barbaz\",\n"
+      "    \"baz\": false\n"
+      "  }],\n"
+      "  \"table\": [[\"a\", \"b\"], [], [\"c\"]]\n"
+      "}\n";
+
+  NestedMessage message;
+  EXPECT_TRUE(JSONStructConverter<NestedMessage>::Convert(normal_data,
+                                                          &message));
+
+  // Integers are accepted for doubles.
+  EXPECT_EQ(1.0, message.foo);
+  EXPECT_EQ(1, message.child.foo);
+  EXPECT_EQ("bar", message.child.bar);
+  EXPECT_TRUE(message.child.baz);
+
+  ASSERT_EQ(2u, message.children.size());
+  EXPECT_EQ(2, message.children[0]->foo);
+  EXPECT_EQ("foobar", message.children[0]->bar);
+  EXPECT_TRUE(message.children[0]->ints.empty());
+  EXPECT_EQ(3, message.children[1]->foo);
+  EXPECT_EQ("barbaz", message.children[1]->bar);
+  EXPECT_FALSE(message.children[1]->baz);
+
+  EXPECT_EQ(std::vector<std::vector<std::string>>({{"a", "b"}, {}, {"c"}}),
+            message.table);
+}
+
+TEST(JSONStructConverterTest, ParseRecursiveMessage) {
+  TreeMessage message;
+  EXPECT_TRUE(JSONStructConverter<TreeMessage>::Convert(
+      R"({"value": 1, "children": [{"value": 2}, )"
+      R"({"value": 3, "children": [{"value": 4, "children": []}]}]})",
+      &message));
+
+  EXPECT_EQ(1, message.value);
+  ASSERT_EQ(2u, message.children.size());
+  EXPECT_EQ(2, message.children[0].value);
+  EXPECT_TRUE(message.children[0].children.empty());
+  EXPECT_EQ(3, message.children[1].value);
+  ASSERT_EQ(1u, message.children[1].children.size());
+  EXPECT_EQ(4, message.children[1].children[0].value);
+}
+
+TEST(JSONStructConverterTest, ParseWithMissingFields) {
+  SimpleMessage message;
+  // Convert() still succeeds even if the input doesn't have "bar" field.
+  EXPECT_TRUE(JSONStructConverter<SimpleMessage>::Convert(
+      R"({"foo": 1, "baz": true, "ints": [1, 2]})", &message));
+
+  EXPECT_EQ(1, message.foo);
+  EXPECT_EQ("", message.bar);
+  EXPECT_TRUE(message.baz);
+  EXPECT_EQ(std::vector<int>({1, 2}), message.ints);
+}
+
+TEST(JSONStructConverterTest, ParseFailures) {
+  const char* const kFailures[] = {
+      // Fields of the wrong type.
+      R"({"foo": 1, "bar": 2})",
+      R"({"foo": 1.5})",
+      R"({"foo": 4294967296})",
+      R"({"foo": "1"})",
+      R"({"baz": 1})",
+      R"({"qux": null})",
+      R"({"ints": [1, false]})",
+      R"({"ints": 1})",
+      R"({"simple_enum": "baz"})",
+      R"([])",
+      // Invalid JSON, including in skipped values.
+      R"({"foo": 1,})",
+      R"({"foo": 1} 2)",
+      R"({"foo" 1})",
+      R"({foo: 1})",
+      R"({"ints": [1 2]})",
+      R"({"unknown": [1,]})",
+      R"({"unknown": 1e999})",
+      R"({"unknown": {"a" 1}})",
+      R"({"foo": 1)",
+      "",
+  };
+  for (const char* json : kFailures) {
+    SimpleMessage message;
+    EXPECT_FALSE(JSONStructConverter<SimpleMessage>::Convert(json, &message))
+        << json;
+  }
+
+  // Options are passed to the parser.
+  SimpleMessage message;
+  EXPECT_TRUE(JSONStructConverter<SimpleMessage>::Convert(
+      R"({"ints": [1, 2,], "foo": 1,})", &message,
+      JSON_ALLOW_TRAILING_COMMAS));
+  EXPECT_EQ(std::vector<int>({1, 2}), message.ints);
+}
+
+TEST(JSONStructConverterTest, TooMuchNesting) {
+  std::string json;
+  for (int i = 0; i < 300; ++i)
+    json += R"({"children": [)";
+  for (int i = 0; i < 300; ++i)
+    json += "]}";
+
+  TreeMessage message;
+  EXPECT_FALSE(JSONStructConverter<TreeMessage>::Convert(json, &message));
+}
+
+TEST(JSONStructConverterTest, LastDuplicateKeyWins) {
+  // Like JSONReader.
+  SimpleMessage message;
+  EXPECT_TRUE(JSONStructConverter<SimpleMessage>::Convert(
+      R"({"foo": 1, "ints": [1, 2], "foo": 2, "ints": [3]})", &message));
+  EXPECT_EQ(2, message.foo);
+  EXPECT_EQ(std::vector<int>({3}), message.ints);
+}
+
+}  // namespace base
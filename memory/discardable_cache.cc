@@ -0,0 +1,313 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/discardable_cache.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/bits.h"
+#include "base/memory/discardable_shared_memory.h"
+#include "base/process/process_metrics.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/time/time.h"
+#include "base/tracing_buildflags.h"
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+#include "base/trace_event/memory_allocator_dump.h"  // no-presubmit-check
+#include "base/trace_event/memory_dump_manager.h"    // no-presubmit-check
+#include "base/trace_event/process_memory_dump.h"    // no-presubmit-check
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Size classes go from one page up to this; larger values get a segment of
+// their own.
+constexpr size_t kMaxSlotSize = 256 * 1024;
+
+// Segments of smaller size classes hold as many slots as fit in this.
+constexpr size_t kSegmentSize = 256 * 1024;
+
+// Returns the slot size for a value of |size| bytes: the next power of two
+// multiple of the page size, or |size| rounded up to a page if that's larger
+// than |kMaxSlotSize|. Empty values take the smallest slot.
+size_t GetSlotSize(size_t size) {
+  const size_t page_size = GetPageSize();
+  if (size > kMaxSlotSize)
+    return bits::AlignUp(size, page_size);
+  const uint32_t nonzero_size =
+      static_cast<uint32_t>(std::max(size, size_t{1}));
+  return std::max(page_size, size_t{1} << bits::Log2Ceiling(nonzero_size));
+}
+
+// DiscardableSharedMemory keeps its lock state in a header page ahead of
+// memory(). Lock() and Unlock() offsets are relative to memory(), but
+// ReleaseMemoryIfPossible() offsets are relative to the start of the mapping.
+size_t GetReleaseOffset(size_t offset) {
+  return GetPageSize() + offset;
+}
+
+}  // namespace
+
+struct DiscardableCacheBase::Segment {
+  DiscardableSharedMemory shared_memory;
+  size_t slot_size = 0;
+  // Offsets of the slots which don't hold an entry.
+  std::vector<size_t> free_slots;
+  size_t entry_count = 0;
+  size_t locked_count = 0;
+  // Set once the segment failed to lock because it was purged. Its slots can't
+  // be reused, and it's released with its last entry.
+  bool purged = false;
+};
+
+DiscardableCacheBase::DiscardableCacheBase(const char* name, size_t max_bytes)
+    : name_(name),
+      max_bytes_(max_bytes),
+      memory_pressure_listener_(
+          FROM_HERE,
+          BindRepeating(&DiscardableCacheBase::OnMemoryPressure,
+                        Unretained(this))) {
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  // Don't register dump provider if SequencedTaskRunnerHandle is not set, such
+  // as in tests.
+  if (SequencedTaskRunnerHandle::IsSet()) {
+    trace_event::MemoryDumpManager::GetInstance()
+        ->RegisterDumpProviderWithSequencedTaskRunner(
+            this, "DiscardableCache", SequencedTaskRunnerHandle::Get(),
+            trace_event::MemoryDumpProvider::Options());
+  }
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+DiscardableCacheBase::~DiscardableCacheBase() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // All values must be unlocked before the cache is destroyed.
+  DCHECK(orphaned_entries_.empty());
+  DCHECK_EQ(0u, locked_bytes_);
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(this);
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+std::unique_ptr<DiscardableCacheBase::Entry>
+DiscardableCacheBase::AllocateEntry(size_t size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const size_t slot_size = GetSlotSize(size);
+  if (slot_size > max_bytes_)
+    return nullptr;
+  if (bytes_used_ + slot_size > max_bytes_) {
+    EvictUnlockedEntries(max_bytes_ - slot_size);
+    if (bytes_used_ + slot_size > max_bytes_)
+      return nullptr;
+  }
+
+  auto entry = std::make_unique<Entry>();
+  entry->size = size;
+  for (const auto& segment : segments_) {
+    if (segment->slot_size != slot_size || segment->purged ||
+        segment->free_slots.empty()) {
+      continue;
+    }
+    const size_t offset = segment->free_slots.back();
+    // A PURGED result still locks the slot, and its contents are about to be
+    // overwritten anyway. FAILED means the whole segment was purged.
+    if (segment->shared_memory.Lock(offset, slot_size) ==
+        DiscardableSharedMemory::FAILED) {
+      segment->purged = true;
+      continue;
+    }
+    segment->free_slots.pop_back();
+    entry->segment = segment.get();
+    entry->offset = offset;
+    break;
+  }
+
+  if (!entry->segment) {
+    // Segments of a size class hold as many slots as fit in |kSegmentSize|.
+    // New segments are created locked; unlock all but the first slot.
+    const size_t slot_count = std::max<size_t>(1, kSegmentSize / slot_size);
+    auto segment = std::make_unique<Segment>();
+    if (!segment->shared_memory.CreateAndMap(slot_size * slot_count))
+      return nullptr;
+    segment->slot_size = slot_size;
+    for (size_t i = slot_count - 1; i > 0; --i)
+      segment->free_slots.push_back(i * slot_size);
+    if (slot_count > 1)
+      segment->shared_memory.Unlock(slot_size, 0);
+    entry->segment = segment.get();
+    entry->offset = 0;
+    segments_.push_back(std::move(segment));
+  }
+
+  ++entry->segment->entry_count;
+  ++entry->segment->locked_count;
+  entry->lock_count = 1;
+  bytes_used_ += slot_size;
+  locked_bytes_ += slot_size;
+  ++entry_count_;
+  return entry;
+}
+
+bool DiscardableCacheBase::LockEntry(Entry* entry) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (entry->lock_count++)
+    return true;
+
+  Segment* segment = entry->segment;
+  DiscardableSharedMemory::LockResult result =
+      segment->purged ? DiscardableSharedMemory::FAILED
+                      : segment->shared_memory.Lock(entry->offset,
+                                                    segment->slot_size);
+  if (result == DiscardableSharedMemory::SUCCESS) {
+    ++segment->locked_count;
+    locked_bytes_ += segment->slot_size;
+    return true;
+  }
+
+  entry->lock_count = 0;
+  if (result == DiscardableSharedMemory::PURGED)
+    segment->shared_memory.Unlock(entry->offset, segment->slot_size);
+  else
+    segment->purged = true;
+  purged_bytes_ += entry->size;
+  return false;
+}
+
+void DiscardableCacheBase::UnlockEntry(Entry* entry) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_GT(entry->lock_count, 0);
+  if (--entry->lock_count)
+    return;
+
+  Segment* segment = entry->segment;
+  segment->shared_memory.Unlock(entry->offset, segment->slot_size);
+  --segment->locked_count;
+  locked_bytes_ -= segment->slot_size;
+
+  if (entry->orphaned) {
+    auto it = orphaned_entries_.find(entry);
+    DCHECK(it != orphaned_entries_.end());
+    ReleaseSlot(entry);
+    orphaned_entries_.erase(it);
+  }
+}
+
+void DiscardableCacheBase::FreeEntry(std::unique_ptr<Entry> entry) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (entry->lock_count) {
+    entry->orphaned = true;
+    orphaned_entries_.insert(std::move(entry));
+    return;
+  }
+  ReleaseSlot(entry.get());
+}
+
+void* DiscardableCacheBase::GetEntryMemory(const Entry* entry) const {
+  DCHECK_GT(entry->lock_count, 0);
+  return static_cast<uint8_t*>(entry->segment->shared_memory.memory()) +
+         entry->offset;
+}
+
+void DiscardableCacheBase::PurgeUnlockedSegmentsForTesting() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (const auto& segment : segments_) {
+    if (!segment->locked_count)
+      segment->shared_memory.Purge(Time::Now());
+  }
+}
+
+bool DiscardableCacheBase::OnMemoryDump(
+    const trace_event::MemoryDumpArgs& args,
+    trace_event::ProcessMemoryDump* pmd) {
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  using trace_event::MemoryAllocatorDump;
+
+  const std::string dump_name =
+      StringPrintf("discardable_cache/%s/0x%" PRIXPTR, name_,
+                   reinterpret_cast<uintptr_t>(this));
+  size_t segments_size = 0;
+  for (const auto& segment : segments_)
+    segments_size += segment->shared_memory.mapped_size();
+  MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(dump_name);
+  dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes, segments_size);
+  dump->AddScalar("used_size", MemoryAllocatorDump::kUnitsBytes, bytes_used_);
+  dump->AddScalar(MemoryAllocatorDump::kNameObjectCount,
+                  MemoryAllocatorDump::kUnitsObjects, entry_count_);
+  dump->AddScalar("locked_size", MemoryAllocatorDump::kUnitsBytes,
+                  locked_bytes_);
+  dump->AddScalar("purged_size", MemoryAllocatorDump::kUnitsBytes,
+                  purged_bytes_);
+  dump->AddScalar("hit_count", MemoryAllocatorDump::kUnitsObjects, hit_count_);
+  dump->AddScalar("miss_count", MemoryAllocatorDump::kUnitsObjects,
+                  miss_count_);
+
+  if (args.level_of_detail ==
+      trace_event::MemoryDumpLevelOfDetail::DETAILED) {
+    for (const auto& segment : segments_) {
+      MemoryAllocatorDump* segment_dump = pmd->CreateAllocatorDump(
+          StringPrintf("%s/segment_0x%" PRIXPTR, dump_name.c_str(),
+                       reinterpret_cast<uintptr_t>(segment.get())));
+      segment_dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                              MemoryAllocatorDump::kUnitsBytes,
+                              segment->shared_memory.mapped_size());
+      segment_dump->AddScalar("slot_size", MemoryAllocatorDump::kUnitsBytes,
+                              segment->slot_size);
+      segment->shared_memory.CreateSharedMemoryOwnershipEdge(
+          segment_dump, pmd, /*is_owned=*/true);
+    }
+  }
+  return true;
+#else   // BUILDFLAG(ENABLE_BASE_TRACING)
+  return false;
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+void DiscardableCacheBase::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  switch (level) {
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      EvictUnlockedEntries(bytes_used_ / 2);
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      EvictUnlockedEntries(0);
+      break;
+  }
+}
+
+void DiscardableCacheBase::ReleaseSlot(Entry* entry) {
+  DCHECK(!entry->lock_count);
+  Segment* segment = entry->segment;
+  bytes_used_ -= segment->slot_size;
+  --entry_count_;
+
+  if (!--segment->entry_count) {
+    DCHECK(!segment->locked_count);
+    EraseIf(segments_, [segment](const std::unique_ptr<Segment>& s) {
+      return s.get() == segment;
+    });
+    return;
+  }
+
+  segment->free_slots.push_back(entry->offset);
+  // Return the slot's pages to the system until it's reused.
+  if (!segment->purged)
+    segment->shared_memory.ReleaseMemoryIfPossible(
+        GetReleaseOffset(entry->offset), segment->slot_size);
+}
+
+}  // namespace internal
+}  // namespace base
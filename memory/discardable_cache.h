@@ -0,0 +1,268 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_DISCARDABLE_CACHE_H_
+#define BASE_MEMORY_DISCARDABLE_CACHE_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/flat_set.h"
+#include "base/containers/mru_cache.h"
+#include "base/containers/span.h"
+#include "base/containers/unique_ptr_adapters.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/sequence_checker.h"
+#include "base/trace_event/base_tracing.h"
+
+namespace base {
+
+namespace internal {
+
+// Storage, eviction policy and instrumentation shared by all DiscardableCache
+// instantiations. Values live in DiscardableSharedMemory segments, each of
+// which is carved into equally sized, page aligned slots ("size classes"), so
+// that values of similar sizes share a segment and can be locked and unlocked
+// independently.
+class BASE_EXPORT DiscardableCacheBase
+    : public trace_event::MemoryDumpProvider {
+ public:
+  DiscardableCacheBase(const DiscardableCacheBase&) = delete;
+  DiscardableCacheBase& operator=(const DiscardableCacheBase&) = delete;
+
+  // Total size of the slots which hold values, in bytes. This is what is
+  // checked against |max_bytes|.
+  size_t bytes_used() const { return bytes_used_; }
+
+  // Statistics, also reported to memory-infra.
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+  size_t purged_bytes() const { return purged_bytes_; }
+
+  size_t GetSegmentCountForTesting() const { return segments_.size(); }
+
+  // Purges all segments which have no locked slot, as the system or a
+  // discardable memory manager might do at any time.
+  void PurgeUnlockedSegmentsForTesting();
+
+  // MemoryDumpProvider implementation:
+  bool OnMemoryDump(const trace_event::MemoryDumpArgs& args,
+                    trace_event::ProcessMemoryDump* pmd) override;
+
+ protected:
+  struct Segment;
+
+  // A value of |size| bytes stored in the slot at |offset| in |segment|.
+  struct Entry {
+    Segment* segment = nullptr;
+    size_t offset = 0;
+    size_t size = 0;
+    int lock_count = 0;
+    // Set once the entry was removed from the cache while locked. It's freed
+    // when its last lock is released.
+    bool orphaned = false;
+  };
+
+  // |name| is used for memory dumps and must outlive the cache.
+  DiscardableCacheBase(const char* name, size_t max_bytes);
+  ~DiscardableCacheBase() override;
+
+  // Returns a new, locked entry of |size| bytes, evicting unlocked entries if
+  // needed to stay under |max_bytes|. Returns null if that's not possible or
+  // if discardable memory can't be allocated.
+  std::unique_ptr<Entry> AllocateEntry(size_t size);
+
+  // Locks |entry|. Returns false if its memory was purged, in which case the
+  // entry is left unlocked and should be freed.
+  bool LockEntry(Entry* entry);
+  void UnlockEntry(Entry* entry);
+
+  // Frees |entry|. A locked entry is kept alive until it's unlocked.
+  void FreeEntry(std::unique_ptr<Entry> entry);
+
+  // Returns the memory of a locked |entry|.
+  void* GetEntryMemory(const Entry* entry) const;
+
+  void RecordHit() { ++hit_count_; }
+  void RecordMiss() { ++miss_count_; }
+
+  // Frees the least recently used unlocked entries until no more than
+  // |target_bytes| are used, or no unlocked entry is left.
+  virtual void EvictUnlockedEntries(size_t target_bytes) = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+ private:
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+  void ReleaseSlot(Entry* entry);
+
+  const char* const name_;
+  const size_t max_bytes_;
+
+  std::vector<std::unique_ptr<Segment>> segments_;
+  flat_set<std::unique_ptr<Entry>, UniquePtrComparator> orphaned_entries_;
+
+  size_t bytes_used_ = 0;
+  size_t locked_bytes_ = 0;
+  size_t entry_count_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t purged_bytes_ = 0;
+
+  MemoryPressureListener memory_pressure_listener_;
+};
+
+}  // namespace internal
+
+// A cache of values which can be reconstructed if lost, e.g. decoded assets or
+// parsed configuration, kept in discardable memory. Values are arrays of a
+// trivially copyable type |V|; they're copied into the cache by Put() and
+// stay locked, i.e. resident, while a ScopedValue returned by Get() is alive.
+// Unlocked values may be purged at any time, which Get() reports as a miss.
+//
+// Unlocked values are evicted in least recently used order when space is
+// needed for a new value, and under memory pressure: a moderate signal halves
+// the cache, a critical one evicts all unlocked values.
+//
+// This class is not thread-safe and must be used on a single sequence.
+//
+// Example:
+//   DiscardableCache<std::string, uint8_t> cache("DecodedImages", 16 << 20);
+//   cache.Put(url, decoded_bytes);
+//   if (auto value = cache.Get(url))
+//     Draw(value.value());
+//   else
+//     DecodeAgain(url);
+template <typename K, typename V>
+class DiscardableCache : public internal::DiscardableCacheBase {
+ public:
+  static_assert(std::is_trivially_copyable<V>::value,
+                "Values are stored as raw bytes and must be trivially "
+                "copyable.");
+
+  // Keeps a cached value locked while in scope. Must not outlive the cache.
+  class ScopedValue {
+   public:
+    ScopedValue() = default;
+    ScopedValue(ScopedValue&& other)
+        : cache_(std::exchange(other.cache_, nullptr)),
+          entry_(std::exchange(other.entry_, nullptr)) {}
+    ScopedValue& operator=(ScopedValue&& other) {
+      reset();
+      cache_ = std::exchange(other.cache_, nullptr);
+      entry_ = std::exchange(other.entry_, nullptr);
+      return *this;
+    }
+    ~ScopedValue() { reset(); }
+
+    explicit operator bool() const { return !!entry_; }
+
+    span<const V> value() const {
+      DCHECK(entry_);
+      return make_span(static_cast<const V*>(cache_->GetEntryMemory(entry_)),
+                       entry_->size / sizeof(V));
+    }
+
+    void reset() {
+      if (entry_)
+        cache_->UnlockEntry(std::exchange(entry_, nullptr));
+      cache_ = nullptr;
+    }
+
+   private:
+    friend class DiscardableCache;
+
+    ScopedValue(DiscardableCache* cache, Entry* entry)
+        : cache_(cache), entry_(entry) {}
+
+    DiscardableCache* cache_ = nullptr;
+    Entry* entry_ = nullptr;
+  };
+
+  // |name| is used for memory dumps and must outlive the cache. The slots
+  // holding values never add up to more than |max_bytes|.
+  DiscardableCache(const char* name, size_t max_bytes)
+      : DiscardableCacheBase(name, max_bytes) {}
+  DiscardableCache(const DiscardableCache&) = delete;
+  DiscardableCache& operator=(const DiscardableCache&) = delete;
+  ~DiscardableCache() override {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    for (auto& key_and_entry : entries_)
+      FreeEntry(std::move(key_and_entry.second));
+  }
+
+  // Copies |value| into the cache, replacing any value for |key|. Returns
+  // false if it doesn't fit.
+  bool Put(const K& key, span<const V> value) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    Erase(key);
+    std::unique_ptr<Entry> entry = AllocateEntry(value.size_bytes());
+    if (!entry)
+      return false;
+    if (!value.empty())
+      memcpy(GetEntryMemory(entry.get()), value.data(), value.size_bytes());
+    UnlockEntry(entry.get());
+    entries_.Put(key, std::move(entry));
+    return true;
+  }
+
+  // Returns the value for |key|, locked for as long as the result is alive,
+  // or a null ScopedValue if it isn't cached or was purged.
+  ScopedValue Get(const K& key) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    auto it = entries_.Get(key);
+    if (it == entries_.end()) {
+      RecordMiss();
+      return ScopedValue();
+    }
+    if (!LockEntry(it->second.get())) {
+      FreeEntry(std::move(it->second));
+      entries_.Erase(it);
+      RecordMiss();
+      return ScopedValue();
+    }
+    RecordHit();
+    return ScopedValue(this, it->second.get());
+  }
+
+  // Removes the value for |key|, if any. Locked values stay valid until
+  // they're unlocked.
+  void Erase(const K& key) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    auto it = entries_.Peek(key);
+    if (it == entries_.end())
+      return;
+    FreeEntry(std::move(it->second));
+    entries_.Erase(it);
+  }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+ private:
+  void EvictUnlockedEntries(size_t target_bytes) override {
+    for (auto it = entries_.rbegin();
+         it != entries_.rend() && bytes_used() > target_bytes;) {
+      if (it->second->lock_count) {
+        ++it;
+        continue;
+      }
+      FreeEntry(std::move(it->second));
+      it = entries_.Erase(it);
+    }
+  }
+
+  MRUCache<K, std::unique_ptr<Entry>> entries_{
+      MRUCache<K, std::unique_ptr<Entry>>::NO_AUTO_EVICT};
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_DISCARDABLE_CACHE_H_
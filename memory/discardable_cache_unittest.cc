@@ -0,0 +1,264 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/discardable_cache.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/tracing_buildflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+#include "base/trace_event/memory_allocator_dump.h"  // no-presubmit-check
+#include "base/trace_event/process_memory_dump.h"    // no-presubmit-check
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
+namespace base {
+
+namespace {
+
+using TestCache = DiscardableCache<std::string, uint8_t>;
+
+std::vector<uint8_t> MakeValue(size_t size, uint8_t seed) {
+  std::vector<uint8_t> value(size);
+  for (size_t i = 0; i < size; ++i)
+    value[i] = static_cast<uint8_t>(seed + i);
+  return value;
+}
+
+bool HasValue(TestCache& cache,
+              const std::string& key,
+              const std::vector<uint8_t>& expected) {
+  TestCache::ScopedValue value = cache.Get(key);
+  if (!value)
+    return false;
+  return std::vector<uint8_t>(value.value().begin(), value.value().end()) ==
+         expected;
+}
+
+class DiscardableCacheTest : public testing::Test {
+ protected:
+  const size_t page_size_ = GetPageSize();
+  test::TaskEnvironment task_environment_;
+};
+
+}  // namespace
+
+TEST_F(DiscardableCacheTest, PutGet) {
+  TestCache cache("Test", 16 * page_size_);
+  const std::vector<uint8_t> a = MakeValue(100, 1);
+  const std::vector<uint8_t> b = MakeValue(3 * page_size_ + 1, 2);
+  EXPECT_TRUE(cache.Put("a", a));
+  EXPECT_TRUE(cache.Put("b", b));
+  EXPECT_EQ(2u, cache.size());
+
+  EXPECT_TRUE(HasValue(cache, "a", a));
+  EXPECT_TRUE(HasValue(cache, "b", b));
+  EXPECT_FALSE(cache.Get("c"));
+  EXPECT_EQ(2u, cache.hit_count());
+  EXPECT_EQ(1u, cache.miss_count());
+
+  // Putting a value again replaces it.
+  const std::vector<uint8_t> a2 = MakeValue(200, 3);
+  EXPECT_TRUE(cache.Put("a", a2));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(HasValue(cache, "a", a2));
+
+  cache.Erase("a");
+  EXPECT_FALSE(cache.Get("a"));
+  EXPECT_EQ(1u, cache.size());
+}
+
+TEST_F(DiscardableCacheTest, Arrays) {
+  DiscardableCache<int, int64_t> cache("Test", 16 * page_size_);
+  const std::vector<int64_t> value = {1, -2, 3, -4};
+  EXPECT_TRUE(cache.Put(1, value));
+  auto scoped_value = cache.Get(1);
+  ASSERT_TRUE(scoped_value);
+  EXPECT_EQ(value, std::vector<int64_t>(scoped_value.value().begin(),
+                                        scoped_value.value().end()));
+}
+
+TEST_F(DiscardableCacheTest, EmptyValue) {
+  TestCache cache("Test", 16 * page_size_);
+  EXPECT_TRUE(cache.Put("a", std::vector<uint8_t>()));
+  EXPECT_EQ(page_size_, cache.bytes_used());
+  auto scoped_value = cache.Get("a");
+  ASSERT_TRUE(scoped_value);
+  EXPECT_TRUE(scoped_value.value().empty());
+}
+
+// Values of a size class share segments; other sizes get their own.
+TEST_F(DiscardableCacheTest, SizeClasses) {
+  TestCache cache("Test", 1024 * page_size_);
+  EXPECT_TRUE(cache.Put("a", MakeValue(1, 0)));
+  EXPECT_TRUE(cache.Put("b", MakeValue(page_size_, 0)));
+  EXPECT_EQ(1u, cache.GetSegmentCountForTesting());
+  EXPECT_EQ(2 * page_size_, cache.bytes_used());
+
+  // Rounded up to 4 pages.
+  EXPECT_TRUE(cache.Put("c", MakeValue(3 * page_size_, 0)));
+  EXPECT_TRUE(cache.Put("d", MakeValue(4 * page_size_, 0)));
+  EXPECT_EQ(2u, cache.GetSegmentCountForTesting());
+  EXPECT_EQ(10 * page_size_, cache.bytes_used());
+
+  // Segments are released along with their last value.
+  cache.Erase("a");
+  cache.Erase("b");
+  EXPECT_EQ(1u, cache.GetSegmentCountForTesting());
+  EXPECT_EQ(8 * page_size_, cache.bytes_used());
+}
+
+TEST_F(DiscardableCacheTest, EvictsLeastRecentlyUsed) {
+  TestCache cache("Test", 3 * page_size_);
+  const std::vector<uint8_t> value = MakeValue(page_size_, 0);
+  EXPECT_TRUE(cache.Put("a", value));
+  EXPECT_TRUE(cache.Put("b", value));
+  EXPECT_TRUE(cache.Put("c", value));
+  EXPECT_TRUE(HasValue(cache, "a", value));
+
+  EXPECT_TRUE(cache.Put("d", value));
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_TRUE(HasValue(cache, "a", value));
+  EXPECT_FALSE(cache.Get("b"));
+  EXPECT_TRUE(HasValue(cache, "c", value));
+  EXPECT_TRUE(HasValue(cache, "d", value));
+
+  // A value which can't fit is rejected.
+  EXPECT_FALSE(cache.Put("e", MakeValue(4 * page_size_, 0)));
+}
+
+TEST_F(DiscardableCacheTest, LockedValuesAreNotEvicted) {
+  TestCache cache("Test", 2 * page_size_);
+  const std::vector<uint8_t> value = MakeValue(page_size_, 0);
+  EXPECT_TRUE(cache.Put("a", value));
+  EXPECT_TRUE(cache.Put("b", value));
+
+  TestCache::ScopedValue a = cache.Get("a");
+  TestCache::ScopedValue b = cache.Get("b");
+  EXPECT_FALSE(cache.Put("c", value));
+
+  b.reset();
+  EXPECT_TRUE(cache.Put("c", value));
+  EXPECT_FALSE(cache.Get("b"));
+  EXPECT_TRUE(a);
+  EXPECT_EQ(value, std::vector<uint8_t>(a.value().begin(), a.value().end()));
+}
+
+TEST_F(DiscardableCacheTest, EraseLockedValue) {
+  TestCache cache("Test", 4 * page_size_);
+  const std::vector<uint8_t> value = MakeValue(page_size_, 7);
+  EXPECT_TRUE(cache.Put("a", value));
+
+  TestCache::ScopedValue a = cache.Get("a");
+  TestCache::ScopedValue a2 = cache.Get("a");
+  cache.Erase("a");
+  EXPECT_FALSE(cache.Get("a"));
+
+  // The value stays valid until it's unlocked.
+  EXPECT_EQ(page_size_, cache.bytes_used());
+  EXPECT_EQ(value, std::vector<uint8_t>(a.value().begin(), a.value().end()));
+  a.reset();
+  EXPECT_EQ(value,
+            std::vector<uint8_t>(a2.value().begin(), a2.value().end()));
+  a2.reset();
+  EXPECT_EQ(0u, cache.bytes_used());
+  EXPECT_EQ(0u, cache.GetSegmentCountForTesting());
+}
+
+TEST_F(DiscardableCacheTest, PurgedValuesAreMisses) {
+  TestCache cache("Test", 16 * page_size_);
+  EXPECT_TRUE(cache.Put("a", MakeValue(100, 0)));
+  EXPECT_TRUE(cache.Put("b", MakeValue(200, 0)));
+  EXPECT_TRUE(cache.Put("c", MakeValue(2 * page_size_, 0)));
+
+  // Segments with a locked value can't be purged.
+  TestCache::ScopedValue c = cache.Get("c");
+  cache.PurgeUnlockedSegmentsForTesting();
+
+  EXPECT_FALSE(cache.Get("a"));
+  EXPECT_FALSE(cache.Get("b"));
+  EXPECT_EQ(300u, cache.purged_bytes());
+  EXPECT_EQ(2u, cache.miss_count());
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1u, cache.GetSegmentCountForTesting());
+
+  // The cache recovers once the values are put again.
+  const std::vector<uint8_t> a = MakeValue(100, 1);
+  EXPECT_TRUE(cache.Put("a", a));
+  EXPECT_TRUE(HasValue(cache, "a", a));
+  EXPECT_TRUE(c);
+}
+
+TEST_F(DiscardableCacheTest, MemoryPressure) {
+  TestCache cache("Test", 16 * page_size_);
+  const std::vector<uint8_t> value = MakeValue(page_size_, 0);
+  for (const char* key : {"a", "b", "c", "d"})
+    EXPECT_TRUE(cache.Put(key, value));
+  TestCache::ScopedValue a = cache.Get("a");
+
+  // Moderate pressure evicts the least recently used half.
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_FALSE(cache.Get("b"));
+  EXPECT_FALSE(cache.Get("c"));
+
+  // Critical pressure evicts everything but locked values.
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_FALSE(cache.Get("d"));
+  EXPECT_TRUE(a);
+}
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+TEST_F(DiscardableCacheTest, MemoryDump) {
+  TestCache cache("Test", 16 * page_size_);
+  EXPECT_TRUE(cache.Put("a", MakeValue(100, 0)));
+  EXPECT_TRUE(cache.Get("a"));
+  EXPECT_FALSE(cache.Get("b"));
+
+  trace_event::MemoryDumpArgs args = {
+      trace_event::MemoryDumpLevelOfDetail::DETAILED};
+  trace_event::ProcessMemoryDump pmd(args);
+  EXPECT_TRUE(cache.OnMemoryDump(args, &pmd));
+
+  const trace_event::MemoryAllocatorDump* dump = nullptr;
+  size_t segment_dumps = 0;
+  for (const auto& name_and_dump : pmd.allocator_dumps()) {
+    if (name_and_dump.first.find("discardable_cache/Test/") != 0)
+      continue;
+    if (name_and_dump.first.find("/segment_") != std::string::npos)
+      ++segment_dumps;
+    else
+      dump = name_and_dump.second.get();
+  }
+  ASSERT_TRUE(dump);
+  EXPECT_EQ(1u, segment_dumps);
+
+  auto get_scalar = [dump](const char* name) -> uint64_t {
+    for (const auto& entry : dump->entries()) {
+      if (entry.name == name)
+        return entry.value_uint64;
+    }
+    ADD_FAILURE() << name;
+    return 0;
+  };
+  EXPECT_EQ(page_size_, get_scalar("used_size"));
+  EXPECT_EQ(1u, get_scalar("hit_count"));
+  EXPECT_EQ(1u, get_scalar("miss_count"));
+  EXPECT_EQ(0u, get_scalar("purged_size"));
+}
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
+}  // namespace base
@@ -4,11 +4,13 @@
 
 #include "base/memory/platform_shared_memory_region.h"
 
+#include "base/logging.h"
 #include "base/memory/aligned_memory.h"
 #include "base/memory/shared_memory_mapping.h"
 #include "base/memory/shared_memory_security_policy.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/numerics/checked_math.h"
+#include "build/build_config.h"
 
 namespace base {
 namespace subtle {
@@ -33,6 +35,22 @@ PlatformSharedMemoryRegion PlatformSharedMemoryRegion::CreateUnsafe(
   return Create(Mode::kUnsafe, size);
 }
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// static
+PlatformSharedMemoryRegion PlatformSharedMemoryRegion::CreateWritable(
+    size_t size,
+    const CreateOptions& options) {
+  return Create(Mode::kWritable, size, /*executable=*/false, options);
+}
+
+// static
+PlatformSharedMemoryRegion PlatformSharedMemoryRegion::CreateUnsafe(
+    size_t size,
+    const CreateOptions& options) {
+  return Create(Mode::kUnsafe, size, /*executable=*/false, options);
+}
+#endif
+
 PlatformSharedMemoryRegion::PlatformSharedMemoryRegion() = default;
 PlatformSharedMemoryRegion::PlatformSharedMemoryRegion(
     PlatformSharedMemoryRegion&& other) = default;
@@ -49,6 +67,14 @@ bool PlatformSharedMemoryRegion::MapAt(off_t offset,
                                        size_t size,
                                        void** memory,
                                        size_t* mapped_size) const {
+  return MapAt(offset, size, MapOptions(), memory, mapped_size);
+}
+
+bool PlatformSharedMemoryRegion::MapAt(off_t offset,
+                                       size_t size,
+                                       const MapOptions& options,
+                                       void** memory,
+                                       size_t* mapped_size) const {
   if (!IsValid())
     return false;
 
@@ -60,6 +86,15 @@ bool PlatformSharedMemoryRegion::MapAt(off_t offset,
     return false;
   }
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // hugetlbfs can't map or unmap part of a huge page.
+  if (huge_page_size_ &&
+      (offset % huge_page_size_ != 0 || size % huge_page_size_ != 0)) {
+    DLOG(ERROR) << "Mapping of a huge page region isn't huge page aligned";
+    return false;
+  }
+#endif
+
   if (!SharedMemorySecurityPolicy::AcquireReservationForMapping(size)) {
     RecordMappingWasBlockedHistogram(/*blocked=*/true);
     return false;
@@ -67,7 +102,7 @@ bool PlatformSharedMemoryRegion::MapAt(off_t offset,
 
   RecordMappingWasBlockedHistogram(/*blocked=*/false);
 
-  bool success = MapAtInternal(offset, size, memory, mapped_size);
+  bool success = MapAtInternal(offset, size, options, memory, mapped_size);
   if (success) {
     DCHECK(IsAligned(*memory, kMapMinimumAlignment));
   } else {
@@ -77,5 +112,22 @@ bool PlatformSharedMemoryRegion::MapAt(off_t offset,
   return success;
 }
 
+bool PlatformSharedMemoryRegion::UsesHugePages() const {
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  return huge_page_size_ != 0;
+#else
+  return false;
+#endif
+}
+
+// static
+bool PlatformSharedMemoryRegion::PopulatesMappings(const MapOptions& options) {
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  return options.populate;
+#else
+  return false;
+#endif
+}
+
 }  // namespace subtle
 }  // namespace base
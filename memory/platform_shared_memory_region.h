@@ -62,6 +62,34 @@ struct BASE_EXPORT ScopedFDPair {
 };
 #endif
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// Options for the memory backing a new PlatformSharedMemoryRegion.
+struct SharedMemoryCreateOptions {
+  // Backs the region with explicit huge pages from hugetlbfs, rather than
+  // with a file in /dev/shm. This reduces TLB pressure for large regions.
+  // The size of the region is rounded up to a multiple of the huge page
+  // size, and mappings must start and end on huge page boundaries, or they
+  // fail. Creation fails if not enough huge pages are reserved.
+  bool huge_pages = false;
+  // The NUMA node which the region's pages are preferably allocated on, or
+  // -1 for the creating thread's policy. The pages are allocated when the
+  // region is created.
+  int numa_node = -1;
+};
+#endif
+
+// Options for mapping a PlatformSharedMemoryRegion. They are only honored on
+// Linux and ChromeOS.
+struct SharedMemoryMapOptions {
+  // Faults in all the pages of the mapping up front (MAP_POPULATE), so that
+  // first accesses don't take page faults.
+  bool populate = false;
+  // Advises the kernel to back the mapping with transparent huge pages
+  // (MADV_HUGEPAGE). Only effective if the kernel enables them for shared
+  // memory, in /sys/kernel/mm/transparent_hugepage/shmem_enabled.
+  bool transparent_huge_pages = false;
+};
+
 // Implementation class for shared memory regions.
 //
 // This class does the following:
@@ -162,11 +190,23 @@ class BASE_EXPORT PlatformSharedMemoryRegion {
   // and MapAt() is guaranteed to have.
   enum { kMapMinimumAlignment = 32 };
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  using CreateOptions = SharedMemoryCreateOptions;
+#endif
+  using MapOptions = SharedMemoryMapOptions;
+
   // Creates a new PlatformSharedMemoryRegion with corresponding mode and size.
   // Creating in kReadOnly mode isn't supported because then there will be no
   // way to modify memory content.
   static PlatformSharedMemoryRegion CreateWritable(size_t size);
   static PlatformSharedMemoryRegion CreateUnsafe(size_t size);
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  static PlatformSharedMemoryRegion CreateWritable(
+      size_t size,
+      const CreateOptions& options);
+  static PlatformSharedMemoryRegion CreateUnsafe(size_t size,
+                                                 const CreateOptions& options);
+#endif
 
   // Returns a new PlatformSharedMemoryRegion that takes ownership of the
   // |handle|. All parameters must be taken from another valid
@@ -251,6 +291,23 @@ class BASE_EXPORT PlatformSharedMemoryRegion {
              void** memory,
              size_t* mapped_size) const;
 
+  // Same as above, with |options|.
+  bool MapAt(off_t offset,
+             size_t size,
+             const MapOptions& options,
+             void** memory,
+             size_t* mapped_size) const;
+
+  // Returns whether the region is backed by explicit huge pages, i.e. it was
+  // created with SharedMemoryCreateOptions::huge_pages. Mappings of such
+  // regions must start and end on huge page boundaries; MapAt() fails
+  // otherwise.
+  bool UsesHugePages() const;
+
+  // Returns whether mappings made with |options| are pre-faulted. Only Linux
+  // and ChromeOS honor SharedMemoryMapOptions::populate.
+  static bool PopulatesMappings(const MapOptions& options);
+
   const UnguessableToken& GetGUID() const { return guid_; }
 
   size_t GetSize() const { return size_; }
@@ -266,7 +323,8 @@ class BASE_EXPORT PlatformSharedMemoryRegion {
                                            size_t size
 #if defined(OS_LINUX) || defined(OS_CHROMEOS)
                                            ,
-                                           bool executable = false
+                                           bool executable = false,
+                                           const CreateOptions& options = {}
 #endif
   );
 
@@ -282,6 +340,7 @@ class BASE_EXPORT PlatformSharedMemoryRegion {
 
   bool MapAtInternal(off_t offset,
                      size_t size,
+                     const MapOptions& options,
                      void** memory,
                      size_t* mapped_size) const;
 
@@ -289,6 +348,11 @@ class BASE_EXPORT PlatformSharedMemoryRegion {
   Mode mode_ = Mode::kReadOnly;
   size_t size_ = 0;
   UnguessableToken guid_;
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // The huge page size if the region is backed by hugetlbfs, or 0. Set when
+  // the region is created or taken from a handle.
+  size_t huge_page_size_ = 0;
+#endif
 
   DISALLOW_COPY_AND_ASSIGN(PlatformSharedMemoryRegion);
 };
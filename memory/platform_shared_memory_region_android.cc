@@ -118,6 +118,7 @@ bool PlatformSharedMemoryRegion::ConvertToUnsafe() {
 
 bool PlatformSharedMemoryRegion::MapAtInternal(off_t offset,
                                                size_t size,
+                                               const MapOptions& options,
                                                void** memory,
                                                size_t* mapped_size) const {
   // IMPORTANT: Even if the mapping is readonly and the mapped data is not
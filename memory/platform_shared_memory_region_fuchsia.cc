@@ -96,6 +96,7 @@ bool PlatformSharedMemoryRegion::ConvertToUnsafe() {
 
 bool PlatformSharedMemoryRegion::MapAtInternal(off_t offset,
                                                size_t size,
+                                               const MapOptions& options,
                                                void** memory,
                                                size_t* mapped_size) const {
   uintptr_t addr;
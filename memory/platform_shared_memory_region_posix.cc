@@ -14,6 +14,25 @@
 #include "base/threading/thread_restrictions.h"
 #include "build/build_config.h"
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+#include <linux/magic.h>
+#include <linux/mempolicy.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/vfs.h>
+
+#include "base/bits.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+#endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
+
 namespace base {
 namespace subtle {
 
@@ -53,6 +72,100 @@ bool CheckFDAccessMode(int fd, int expected_mode) {
 }
 #endif  // !defined(OS_NACL)
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// Makes the calling thread prefer allocating memory on a NUMA node, for as
+// long as it's in scope.
+class ScopedPreferredNumaNode {
+ public:
+  explicit ScopedPreferredNumaNode(int node) {
+    if (node < 0)
+      return;
+    if (node >= kMaxNodes) {
+      DLOG(ERROR) << "Invalid NUMA node " << node;
+      return;
+    }
+    if (syscall(__NR_get_mempolicy, &old_mode_, old_nodes_, kMaxNodes, nullptr,
+                0) != 0) {
+      DPLOG(ERROR) << "get_mempolicy";
+      return;
+    }
+    unsigned long nodes[kMaskSize] = {};
+    nodes[node / kBitsPerWord] = 1UL << (node % kBitsPerWord);
+    // The kernel ignores the last bit of |maxnode|.
+    if (syscall(__NR_set_mempolicy, MPOL_PREFERRED, nodes, kMaxNodes + 1) !=
+        0) {
+      DPLOG(ERROR) << "set_mempolicy";
+      return;
+    }
+    restore_ = true;
+  }
+
+  ScopedPreferredNumaNode(const ScopedPreferredNumaNode&) = delete;
+  ScopedPreferredNumaNode& operator=(const ScopedPreferredNumaNode&) = delete;
+
+  ~ScopedPreferredNumaNode() {
+    if (!restore_)
+      return;
+    if (syscall(__NR_set_mempolicy, old_mode_, old_nodes_, kMaxNodes + 1) != 0)
+      DPLOG(ERROR) << "set_mempolicy";
+  }
+
+ private:
+  // The largest number of nodes the kernel can be configured with.
+  static constexpr int kMaxNodes = 1024;
+  static constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  static constexpr int kMaskSize = kMaxNodes / kBitsPerWord;
+
+  bool restore_ = false;
+  int old_mode_ = MPOL_DEFAULT;
+  unsigned long old_nodes_[kMaskSize] = {};
+};
+
+// Returns the huge page size if |fd| is a hugetlbfs file, or 0.
+size_t GetHugeTlbPageSize(int fd) {
+  struct statfs statfs_buf;
+  if (fstatfs(fd, &statfs_buf) != 0 || statfs_buf.f_type != HUGETLBFS_MAGIC)
+    return 0;
+  return static_cast<size_t>(statfs_buf.f_bsize);
+}
+
+// Creates an anonymous file backed by huge pages of |*huge_page_size| bytes,
+// and rounds |size| up to a multiple of the huge page size. Also opens the
+// file read-only into |readonly_fd| if it's not null.
+File CreateHugePageFile(size_t* size,
+                        size_t* huge_page_size,
+                        ScopedFD* readonly_fd) {
+#if defined(__NR_memfd_create)
+  ScopedFD fd(syscall(__NR_memfd_create, "shared_memory",
+                      MFD_CLOEXEC | MFD_HUGETLB));
+  if (!fd.is_valid()) {
+    DPLOG(ERROR) << "memfd_create";
+    return File();
+  }
+  // hugetlbfs reports the huge page size as its block size.
+  struct stat st;
+  if (fstat(fd.get(), &st) != 0) {
+    DPLOG(ERROR) << "fstat";
+    return File();
+  }
+  *huge_page_size = static_cast<size_t>(st.st_blksize);
+  *size = bits::AlignUp(*size, *huge_page_size);
+  if (readonly_fd) {
+    // memfds have no path, but can be reopened through /proc.
+    readonly_fd->reset(HANDLE_EINTR(
+        open(StringPrintf("/proc/self/fd/%d", fd.get()).c_str(), O_RDONLY)));
+    if (!readonly_fd->is_valid()) {
+      DPLOG(ERROR) << "open(/proc/self/fd/" << fd.get() << ") failed";
+      return File();
+    }
+  }
+  return File(fd.release());
+#else
+  return File();
+#endif  // defined(__NR_memfd_create)
+}
+#endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
+
 }  // namespace
 
 ScopedFDPair::ScopedFDPair() = default;
@@ -120,7 +233,12 @@ PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Take(
       return {};
   }
 
-  return PlatformSharedMemoryRegion(std::move(handle), mode, size, guid);
+  PlatformSharedMemoryRegion region(std::move(handle), mode, size, guid);
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // The region may have been created with huge pages by another process.
+  region.huge_page_size_ = GetHugeTlbPageSize(region.handle_.fd.get());
+#endif
+  return region;
 }
 
 // static
@@ -155,8 +273,12 @@ PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Duplicate() const {
     return {};
   }
 
-  return PlatformSharedMemoryRegion({std::move(duped_fd), ScopedFD()}, mode_,
+  PlatformSharedMemoryRegion region({std::move(duped_fd), ScopedFD()}, mode_,
                                     size_, guid_);
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  region.huge_page_size_ = huge_page_size_;
+#endif
+  return region;
 }
 
 bool PlatformSharedMemoryRegion::ConvertToReadOnly() {
@@ -185,11 +307,17 @@ bool PlatformSharedMemoryRegion::ConvertToUnsafe() {
 
 bool PlatformSharedMemoryRegion::MapAtInternal(off_t offset,
                                                size_t size,
+                                               const MapOptions& options,
                                                void** memory,
                                                size_t* mapped_size) const {
   bool write_allowed = mode_ != Mode::kReadOnly;
+  int flags = MAP_SHARED;
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  if (options.populate)
+    flags |= MAP_POPULATE;
+#endif
   *memory = mmap(nullptr, size, PROT_READ | (write_allowed ? PROT_WRITE : 0),
-                 MAP_SHARED, handle_.fd.get(), offset);
+                 flags, handle_.fd.get(), offset);
 
   bool mmap_succeeded = *memory && *memory != MAP_FAILED;
   if (!mmap_succeeded) {
@@ -197,16 +325,27 @@ bool PlatformSharedMemoryRegion::MapAtInternal(off_t offset,
     return false;
   }
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // This only fails if the kernel doesn't support transparent huge pages, in
+  // which case the mapping is still usable.
+  if (options.transparent_huge_pages &&
+      madvise(*memory, size, MADV_HUGEPAGE) != 0) {
+    DPLOG(WARNING) << "madvise(MADV_HUGEPAGE)";
+  }
+#endif
+
   *mapped_size = size;
   return true;
 }
 
 // static
-PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Create(Mode mode,
-                                                              size_t size
+PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Create(
+    Mode mode,
+    size_t size
 #if defined(OS_LINUX) || defined(OS_CHROMEOS)
-                                                              ,
-                                                              bool executable
+    ,
+    bool executable,
+    const CreateOptions& options
 #endif
 ) {
 #if defined(OS_NACL)
@@ -229,6 +368,30 @@ PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Create(Mode mode,
   // and be deleted before they ever make it out to disk.
   ThreadRestrictions::ScopedAllowIO allow_io;
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // The pages are allocated by AllocateFileRegion(), below.
+  ScopedPreferredNumaNode preferred_numa_node(options.numa_node);
+
+  if (options.huge_pages) {
+    DCHECK(!executable);
+    ScopedFD readonly_fd;
+    size_t huge_page_size = 0;
+    File file = CreateHugePageFile(
+        &size, &huge_page_size,
+        mode == Mode::kWritable ? &readonly_fd : nullptr);
+    if (!file.IsValid() ||
+        size > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        !AllocateFileRegion(&file, 0, size)) {
+      return {};
+    }
+    PlatformSharedMemoryRegion region(
+        {ScopedFD(file.TakePlatformFile()), std::move(readonly_fd)}, mode,
+        size, UnguessableToken::Create());
+    region.huge_page_size_ = huge_page_size;
+    return region;
+  }
+#endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
+
   // We don't use shm_open() API in order to support the --disable-dev-shm-usage
   // flag.
   FilePath directory;
@@ -4,6 +4,8 @@
 
 #include "base/memory/platform_shared_memory_region.h"
 
+#include <string.h>
+
 #include "base/check.h"
 #include "base/memory/shared_memory_mapping.h"
 #include "base/process/process_metrics.h"
@@ -235,6 +237,70 @@ TEST_F(PlatformSharedMemoryRegionTest, ConvertToUnsafeInvalidatesSecondHandle) {
 }
 #endif
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// Tests that populated and huge page advised mappings are usable.
+TEST_F(PlatformSharedMemoryRegionTest, MapWithOptions) {
+  PlatformSharedMemoryRegion region =
+      PlatformSharedMemoryRegion::CreateWritable(kRegionSize);
+  ASSERT_TRUE(region.IsValid());
+  PlatformSharedMemoryRegion::MapOptions options;
+  options.populate = true;
+  options.transparent_huge_pages = true;
+  void* memory = nullptr;
+  size_t mapped_size = 0;
+  ASSERT_TRUE(region.MapAt(0, kRegionSize, options, &memory, &mapped_size));
+  // Transparent huge pages are only advice.
+  EXPECT_FALSE(region.UsesHugePages());
+  memset(memory, 'G', kRegionSize);
+  EXPECT_EQ(0, munmap(memory, mapped_size));
+}
+
+// Tests that a region backed by huge pages is created with a size rounded up
+// to the huge page size, and can only be mapped on huge page boundaries.
+TEST_F(PlatformSharedMemoryRegionTest, CreateWithHugePages) {
+  PlatformSharedMemoryRegion::CreateOptions options;
+  options.huge_pages = true;
+  PlatformSharedMemoryRegion region =
+      PlatformSharedMemoryRegion::CreateWritable(kRegionSize, options);
+  if (!region.IsValid())
+    GTEST_SKIP() << "No huge pages available";
+  EXPECT_GE(region.GetSize(), kRegionSize);
+  EXPECT_TRUE(region.UsesHugePages());
+  WritableSharedMemoryMapping mapping =
+      MapAtForTesting(&region, 0, region.GetSize());
+  ASSERT_TRUE(mapping.IsValid());
+  memset(mapping.memory(), 'G', mapping.size());
+
+  // Huge pages are larger than regular pages.
+  void* memory = nullptr;
+  size_t mapped_size = 0;
+  EXPECT_FALSE(region.MapAt(0, GetPageSize(), &memory, &mapped_size));
+
+  // Regions taken from a handle, e.g. from another process, are detected.
+  ASSERT_TRUE(region.ConvertToReadOnly());
+  const size_t size = region.GetSize();
+  const UnguessableToken guid = region.GetGUID();
+  PlatformSharedMemoryRegion taken = PlatformSharedMemoryRegion::Take(
+      region.PassPlatformHandle(), PlatformSharedMemoryRegion::Mode::kReadOnly,
+      size, guid);
+  ASSERT_TRUE(taken.IsValid());
+  EXPECT_TRUE(taken.UsesHugePages());
+}
+
+// Tests that a region can be placed on NUMA node 0, which always exists.
+TEST_F(PlatformSharedMemoryRegionTest, CreateOnNumaNode) {
+  PlatformSharedMemoryRegion::CreateOptions options;
+  options.numa_node = 0;
+  PlatformSharedMemoryRegion region =
+      PlatformSharedMemoryRegion::CreateUnsafe(kRegionSize, options);
+  ASSERT_TRUE(region.IsValid());
+  EXPECT_EQ(kRegionSize, region.GetSize());
+  WritableSharedMemoryMapping mapping =
+      MapAtForTesting(&region, 0, kRegionSize);
+  EXPECT_TRUE(mapping.IsValid());
+}
+#endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
+
 void CheckReadOnlyMapProtection(void* addr) {
 #if defined(OS_MAC)
   vm_region_basic_info_64 basic_info;
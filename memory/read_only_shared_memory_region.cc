@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "base/memory/shared_memory_tracker.h"
 #include "build/build_config.h"
 
 namespace base {
@@ -74,16 +75,27 @@ ReadOnlySharedMemoryMapping ReadOnlySharedMemoryRegion::Map() const {
 ReadOnlySharedMemoryMapping ReadOnlySharedMemoryRegion::MapAt(
     off_t offset,
     size_t size) const {
+  return MapAt(offset, size, MapOptions());
+}
+
+ReadOnlySharedMemoryMapping ReadOnlySharedMemoryRegion::MapAt(
+    off_t offset,
+    size_t size,
+    const MapOptions& options) const {
   if (!IsValid())
     return {};
 
   void* memory = nullptr;
   size_t mapped_size = 0;
-  if (!handle_.MapAt(offset, size, &memory, &mapped_size))
+  if (!handle_.MapAt(offset, size, options, &memory, &mapped_size))
     return {};
 
-  return ReadOnlySharedMemoryMapping(memory, size, mapped_size,
-                                     handle_.GetGUID());
+  ReadOnlySharedMemoryMapping mapping(memory, size, mapped_size,
+                                      handle_.GetGUID());
+  SharedMemoryTracker::GetInstance()->RecordMappingOptions(
+      mapping, handle_.UsesHugePages(),
+      subtle::PlatformSharedMemoryRegion::PopulatesMappings(options));
+  return mapping;
 }
 
 bool ReadOnlySharedMemoryRegion::IsValid() const {
@@ -81,6 +81,13 @@ class BASE_EXPORT ReadOnlySharedMemoryRegion {
   // requested bytes are out of the region limits.
   ReadOnlySharedMemoryMapping MapAt(off_t offset, size_t size) const;
 
+  // Same as above, but with |options| for how the pages are mapped. See
+  // SharedMemoryMapOptions.
+  using MapOptions = subtle::PlatformSharedMemoryRegion::MapOptions;
+  ReadOnlySharedMemoryMapping MapAt(off_t offset,
+                                    size_t size,
+                                    const MapOptions& options) const;
+
   // Whether the underlying platform handle is valid.
   bool IsValid() const;
 
@@ -4,6 +4,8 @@
 
 #include "base/memory/shared_memory_tracker.h"
 
+#include <utility>
+
 #include "base/check.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
@@ -56,6 +58,19 @@ void SharedMemoryTracker::IncrementMemoryUsage(
                   UsageInfo(mapping.mapped_size(), mapping.guid()));
 }
 
+void SharedMemoryTracker::RecordMappingOptions(
+    const SharedMemoryMapping& mapping,
+    bool huge_pages,
+    bool populated) {
+  if (!huge_pages && !populated)
+    return;
+  AutoLock hold(usages_lock_);
+  auto it = usages_.find(mapping.raw_memory_ptr());
+  DCHECK(it != usages_.end());
+  it->second.huge_pages = huge_pages;
+  it->second.populated = populated;
+}
+
 void SharedMemoryTracker::DecrementMemoryUsage(
     const SharedMemoryMapping& mapping) {
   AutoLock hold(usages_lock_);
@@ -75,12 +90,35 @@ SharedMemoryTracker::~SharedMemoryTracker() = default;
 bool SharedMemoryTracker::OnMemoryDump(const trace_event::MemoryDumpArgs& args,
                                        trace_event::ProcessMemoryDump* pmd) {
   AutoLock hold(usages_lock_);
+  // Bytes mapped with huge pages and pre-faulted, summed over the mappings of
+  // each region.
+  std::map<UnguessableToken, std::pair<size_t, size_t>> option_sizes;
   for (const auto& usage : usages_) {
     const trace_event::MemoryAllocatorDump* dump =
         GetOrCreateSharedMemoryDumpInternal(
             usage.first, usage.second.mapped_size, usage.second.mapped_id, pmd);
     DCHECK(dump);
+    if (usage.second.huge_pages || usage.second.populated) {
+      auto& sizes = option_sizes[usage.second.mapped_id];
+      if (usage.second.huge_pages)
+        sizes.first += usage.second.mapped_size;
+      if (usage.second.populated)
+        sizes.second += usage.second.mapped_size;
+    }
   }
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  for (const auto& id_and_sizes : option_sizes) {
+    trace_event::MemoryAllocatorDump* dump =
+        pmd->GetAllocatorDump(GetDumpNameForTracing(id_and_sizes.first));
+    DCHECK(dump);
+    dump->AddScalar("huge_page_size",
+                    trace_event::MemoryAllocatorDump::kUnitsBytes,
+                    id_and_sizes.second.first);
+    dump->AddScalar("populated_size",
+                    trace_event::MemoryAllocatorDump::kUnitsBytes,
+                    id_and_sizes.second.second);
+  }
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
   return true;
 }
 
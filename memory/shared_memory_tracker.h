@@ -41,6 +41,13 @@ class BASE_EXPORT SharedMemoryTracker : public trace_event::MemoryDumpProvider {
   // Records shared memory usage on valid mapping.
   void IncrementMemoryUsage(const SharedMemoryMapping& mapping);
 
+  // Records how a valid |mapping| was mapped, which is reported in its
+  // memory dump as "huge_page_size" and "populated_size". Must be called after
+  // IncrementMemoryUsage().
+  void RecordMappingOptions(const SharedMemoryMapping& mapping,
+                            bool huge_pages,
+                            bool populated);
+
   // Records shared memory usage on unmapping.
   void DecrementMemoryUsage(const SharedMemoryMapping& mapping);
 
@@ -68,6 +75,8 @@ class BASE_EXPORT SharedMemoryTracker : public trace_event::MemoryDumpProvider {
 
     size_t mapped_size;
     UnguessableToken mapped_id;
+    bool huge_pages = false;
+    bool populated = false;
   };
 
   Lock usages_lock_;
@@ -6,6 +6,10 @@
 
 #include <utility>
 
+#include "base/check.h"
+#include "base/memory/shared_memory_tracker.h"
+#include "build/build_config.h"
+
 namespace base {
 
 UnsafeSharedMemoryRegion::CreateFunction*
@@ -22,6 +26,24 @@ UnsafeSharedMemoryRegion UnsafeSharedMemoryRegion::Create(size_t size) {
   return UnsafeSharedMemoryRegion(std::move(handle));
 }
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// static
+UnsafeSharedMemoryRegion UnsafeSharedMemoryRegion::CreateWithOptions(
+    size_t size,
+    const CreateOptions& options) {
+  if (create_hook_) {
+    // Hooks only take a size, so they can't honor non-default options.
+    DCHECK(!options.huge_pages && options.numa_node == -1);
+    return create_hook_(size);
+  }
+
+  subtle::PlatformSharedMemoryRegion handle =
+      subtle::PlatformSharedMemoryRegion::CreateUnsafe(size, options);
+
+  return UnsafeSharedMemoryRegion(std::move(handle));
+}
+#endif
+
 // static
 UnsafeSharedMemoryRegion UnsafeSharedMemoryRegion::Deserialize(
     subtle::PlatformSharedMemoryRegion handle) {
@@ -52,16 +74,27 @@ WritableSharedMemoryMapping UnsafeSharedMemoryRegion::Map() const {
 
 WritableSharedMemoryMapping UnsafeSharedMemoryRegion::MapAt(off_t offset,
                                                             size_t size) const {
+  return MapAt(offset, size, MapOptions());
+}
+
+WritableSharedMemoryMapping UnsafeSharedMemoryRegion::MapAt(
+    off_t offset,
+    size_t size,
+    const MapOptions& options) const {
   if (!IsValid())
     return {};
 
   void* memory = nullptr;
   size_t mapped_size = 0;
-  if (!handle_.MapAt(offset, size, &memory, &mapped_size))
+  if (!handle_.MapAt(offset, size, options, &memory, &mapped_size))
     return {};
 
-  return WritableSharedMemoryMapping(memory, size, mapped_size,
-                                     handle_.GetGUID());
+  WritableSharedMemoryMapping mapping(memory, size, mapped_size,
+                                      handle_.GetGUID());
+  SharedMemoryTracker::GetInstance()->RecordMappingOptions(
+      mapping, handle_.UsesHugePages(),
+      subtle::PlatformSharedMemoryRegion::PopulatesMappings(options));
+  return mapping;
 }
 
 bool UnsafeSharedMemoryRegion::IsValid() const {
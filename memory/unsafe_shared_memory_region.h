@@ -9,6 +9,7 @@
 #include "base/macros.h"
 #include "base/memory/platform_shared_memory_region.h"
 #include "base/memory/shared_memory_mapping.h"
+#include "build/build_config.h"
 
 namespace base {
 
@@ -34,6 +35,15 @@ class BASE_EXPORT UnsafeSharedMemoryRegion {
   static UnsafeSharedMemoryRegion Create(size_t size);
   using CreateFunction = decltype(Create);
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // Same as Create(), but with control over the page size and NUMA placement
+  // of the region's memory. See SharedMemoryCreateOptions.
+  using CreateOptions = subtle::PlatformSharedMemoryRegion::CreateOptions;
+  static UnsafeSharedMemoryRegion CreateWithOptions(
+      size_t size,
+      const CreateOptions& options);
+#endif
+
   // Returns an UnsafeSharedMemoryRegion built from a platform-specific handle
   // that was taken from another UnsafeSharedMemoryRegion instance. Returns an
   // invalid region iff the |handle| is invalid. CHECK-fails if the |handle|
@@ -80,6 +90,13 @@ class BASE_EXPORT UnsafeSharedMemoryRegion {
   // requested bytes are out of the region limits.
   WritableSharedMemoryMapping MapAt(off_t offset, size_t size) const;
 
+  // Same as above, but with |options| for how the pages are mapped. See
+  // SharedMemoryMapOptions.
+  using MapOptions = subtle::PlatformSharedMemoryRegion::MapOptions;
+  WritableSharedMemoryMapping MapAt(off_t offset,
+                                    size_t size,
+                                    const MapOptions& options) const;
+
   // Whether the underlying platform handle is valid.
   bool IsValid() const;
 
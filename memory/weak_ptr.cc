@@ -4,6 +4,8 @@
 
 #include "base/memory/weak_ptr.h"
 
+#include <utility>
+
 #if DCHECK_IS_ON()
 #include "base/debug/stack_trace.h"
 #endif
@@ -32,16 +34,6 @@ void WeakReference::Flag::Invalidate() {
   invalidated_.Set();
 }
 
-bool WeakReference::Flag::IsValid() const {
-  // WeakPtrs must be checked on the same sequenced thread.
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  return !invalidated_.IsSet();
-}
-
-bool WeakReference::Flag::MaybeValid() const {
-  return !invalidated_.IsSet();
-}
-
 void WeakReference::Flag::DetachFromSequence() {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
@@ -58,14 +50,6 @@ WeakReference::WeakReference(WeakReference&& other) noexcept = default;
 
 WeakReference::WeakReference(const WeakReference& other) = default;
 
-bool WeakReference::IsValid() const {
-  return flag_ && flag_->IsValid();
-}
-
-bool WeakReference::MaybeValid() const {
-  return flag_ && flag_->MaybeValid();
-}
-
 WeakReferenceOwner::WeakReferenceOwner()
     : flag_(MakeRefCounted<WeakReference::Flag>()) {}
 
@@ -90,8 +74,8 @@ WeakPtrBase::WeakPtrBase() : ptr_(0) {}
 
 WeakPtrBase::~WeakPtrBase() = default;
 
-WeakPtrBase::WeakPtrBase(const WeakReference& ref, uintptr_t ptr)
-    : ref_(ref), ptr_(ptr) {
+WeakPtrBase::WeakPtrBase(WeakReference ref, uintptr_t ptr)
+    : ref_(std::move(ref)), ptr_(ptr) {
   DCHECK(ptr_);
 }
 
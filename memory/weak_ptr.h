@@ -71,6 +71,7 @@
 
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 
 #include "base/base_export.h"
 #include "base/check.h"
@@ -97,9 +98,15 @@ class BASE_EXPORT WeakReference {
     Flag();
 
     void Invalidate();
-    bool IsValid() const;
 
-    bool MaybeValid() const;
+    // Inline: these are on the path of every WeakPtr dereference.
+    bool IsValid() const {
+      // WeakPtrs must be checked on the same sequenced thread.
+      DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+      return !invalidated_.IsSet();
+    }
+
+    bool MaybeValid() const { return !invalidated_.IsSet(); }
 
     void DetachFromSequence();
 
@@ -121,8 +128,8 @@ class BASE_EXPORT WeakReference {
   WeakReference& operator=(WeakReference&& other) noexcept = default;
   WeakReference& operator=(const WeakReference& other) = default;
 
-  bool IsValid() const;
-  bool MaybeValid() const;
+  bool IsValid() const { return flag_ && flag_->IsValid(); }
+  bool MaybeValid() const { return flag_ && flag_->MaybeValid(); }
 
  private:
   scoped_refptr<const Flag> flag_;
@@ -163,7 +170,7 @@ class BASE_EXPORT WeakPtrBase {
   }
 
  protected:
-  WeakPtrBase(const WeakReference& ref, uintptr_t ptr);
+  WeakPtrBase(WeakReference ref, uintptr_t ptr);
 
   WeakReference ref_;
 
@@ -199,7 +206,8 @@ class SupportsWeakPtrBase {
   static WeakPtr<Derived> AsWeakPtrImpl(SupportsWeakPtr<Base>* t) {
     WeakPtr<Base> ptr = t->AsWeakPtr();
     return WeakPtr<Derived>(
-        ptr.ref_, static_cast<Derived*>(reinterpret_cast<Base*>(ptr.ptr_)));
+        std::move(ptr.ref_),
+        static_cast<Derived*>(reinterpret_cast<Base*>(ptr.ptr_)));
   }
 };
 
@@ -279,8 +287,8 @@ class WeakPtr : public internal::WeakPtrBase {
   friend class SupportsWeakPtr<T>;
   friend class WeakPtrFactory<T>;
 
-  WeakPtr(const internal::WeakReference& ref, T* ptr)
-      : WeakPtrBase(ref, reinterpret_cast<uintptr_t>(ptr)) {}
+  WeakPtr(internal::WeakReference ref, T* ptr)
+      : WeakPtrBase(std::move(ref), reinterpret_cast<uintptr_t>(ptr)) {}
 };
 
 // Allow callers to compare WeakPtrs against nullptr to test validity.
@@ -0,0 +1,119 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/weak_ptr.h"
+
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// Ask the compiler not to use a register for this counter, so that the
+// validity checks can't be optimized away.
+volatile int g_weak_ptr_perf_test_counter;
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixWeakPtr[] = "WeakPtr.";
+constexpr char kMetricTimePerOperation[] = "time_per_operation";
+constexpr char kStoryCreateFactory[] = "create_factory";
+constexpr char kStoryGetWeakPtr[] = "get_weak_ptr";
+constexpr char kStoryCopy[] = "copy";
+constexpr char kStoryCheck[] = "check";
+constexpr char kStoryInvalidate[] = "invalidate";
+
+#if DCHECK_IS_ON()
+// Sequence checks make WeakPtr operations much slower with DCHECKs on.
+constexpr int kLaps = 100000;
+#else
+constexpr int kLaps = 10000000;
+#endif
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixWeakPtr, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerOperation, "ns");
+  return reporter;
+}
+
+void ReportTimePerOperation(const std::string& story_name,
+                            TimeDelta duration) {
+  SetUpReporter(story_name)
+      .AddResult(kMetricTimePerOperation,
+                 duration.InNanoseconds() / static_cast<double>(kLaps));
+}
+
+struct Target {
+  int value = 0;
+};
+
+}  // namespace
+
+// Constructs and destroys factories, including the allocation and release of
+// their flag.
+TEST(WeakPtrPerfTest, CreateFactory) {
+  Target target;
+  g_weak_ptr_perf_test_counter = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    WeakPtrFactory<Target> factory(&target);
+    g_weak_ptr_perf_test_counter += factory.HasWeakPtrs();
+  }
+  ReportTimePerOperation(kStoryCreateFactory, TimeTicks::Now() - start);
+  EXPECT_EQ(0, g_weak_ptr_perf_test_counter);
+}
+
+TEST(WeakPtrPerfTest, GetWeakPtr) {
+  Target target;
+  WeakPtrFactory<Target> factory(&target);
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    WeakPtr<Target> ptr = factory.GetWeakPtr();
+    g_weak_ptr_perf_test_counter = ptr.MaybeValid();
+  }
+  ReportTimePerOperation(kStoryGetWeakPtr, TimeTicks::Now() - start);
+  EXPECT_FALSE(factory.HasWeakPtrs());
+}
+
+TEST(WeakPtrPerfTest, Copy) {
+  Target target;
+  WeakPtrFactory<Target> factory(&target);
+  const WeakPtr<Target> ptr = factory.GetWeakPtr();
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    WeakPtr<Target> copy = ptr;
+    g_weak_ptr_perf_test_counter = copy.MaybeValid();
+  }
+  ReportTimePerOperation(kStoryCopy, TimeTicks::Now() - start);
+}
+
+TEST(WeakPtrPerfTest, Check) {
+  Target target;
+  WeakPtrFactory<Target> factory(&target);
+  const WeakPtr<Target> ptr = factory.GetWeakPtr();
+  g_weak_ptr_perf_test_counter = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    if (ptr)
+      ++g_weak_ptr_perf_test_counter;
+  }
+  ReportTimePerOperation(kStoryCheck, TimeTicks::Now() - start);
+  EXPECT_EQ(kLaps, g_weak_ptr_perf_test_counter);
+}
+
+// Invalidates a factory with one outstanding WeakPtr, then hands out a new one.
+TEST(WeakPtrPerfTest, Invalidate) {
+  Target target;
+  WeakPtrFactory<Target> factory(&target);
+  WeakPtr<Target> ptr;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    ptr = factory.GetWeakPtr();
+    factory.InvalidateWeakPtrs();
+  }
+  ReportTimePerOperation(kStoryInvalidate, TimeTicks::Now() - start);
+  EXPECT_TRUE(ptr.WasInvalidated());
+}
+
+}  // namespace base
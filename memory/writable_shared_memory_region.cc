@@ -6,6 +6,8 @@
 
 #include <utility>
 
+#include "base/check.h"
+#include "base/memory/shared_memory_tracker.h"
 #include "build/build_config.h"
 
 namespace base {
@@ -24,6 +26,24 @@ WritableSharedMemoryRegion WritableSharedMemoryRegion::Create(size_t size) {
   return WritableSharedMemoryRegion(std::move(handle));
 }
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// static
+WritableSharedMemoryRegion WritableSharedMemoryRegion::CreateWithOptions(
+    size_t size,
+    const CreateOptions& options) {
+  if (create_hook_) {
+    // Hooks only take a size, so they can't honor non-default options.
+    DCHECK(!options.huge_pages && options.numa_node == -1);
+    return create_hook_(size);
+  }
+
+  subtle::PlatformSharedMemoryRegion handle =
+      subtle::PlatformSharedMemoryRegion::CreateWritable(size, options);
+
+  return WritableSharedMemoryRegion(std::move(handle));
+}
+#endif
+
 // static
 WritableSharedMemoryRegion WritableSharedMemoryRegion::Deserialize(
     subtle::PlatformSharedMemoryRegion handle) {
@@ -70,16 +90,27 @@ WritableSharedMemoryMapping WritableSharedMemoryRegion::Map() const {
 WritableSharedMemoryMapping WritableSharedMemoryRegion::MapAt(
     off_t offset,
     size_t size) const {
+  return MapAt(offset, size, MapOptions());
+}
+
+WritableSharedMemoryMapping WritableSharedMemoryRegion::MapAt(
+    off_t offset,
+    size_t size,
+    const MapOptions& options) const {
   if (!IsValid())
     return {};
 
   void* memory = nullptr;
   size_t mapped_size = 0;
-  if (!handle_.MapAt(offset, size, &memory, &mapped_size))
+  if (!handle_.MapAt(offset, size, options, &memory, &mapped_size))
     return {};
 
-  return WritableSharedMemoryMapping(memory, size, mapped_size,
-                                     handle_.GetGUID());
+  WritableSharedMemoryMapping mapping(memory, size, mapped_size,
+                                      handle_.GetGUID());
+  SharedMemoryTracker::GetInstance()->RecordMappingOptions(
+      mapping, handle_.UsesHugePages(),
+      subtle::PlatformSharedMemoryRegion::PopulatesMappings(options));
+  return mapping;
 }
 
 bool WritableSharedMemoryRegion::IsValid() const {
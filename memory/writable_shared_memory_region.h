@@ -36,6 +36,15 @@ class BASE_EXPORT WritableSharedMemoryRegion {
   static WritableSharedMemoryRegion Create(size_t size);
   using CreateFunction = decltype(Create);
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  // Same as Create(), but with control over the page size and NUMA placement
+  // of the region's memory. See SharedMemoryCreateOptions.
+  using CreateOptions = subtle::PlatformSharedMemoryRegion::CreateOptions;
+  static WritableSharedMemoryRegion CreateWithOptions(
+      size_t size,
+      const CreateOptions& options);
+#endif
+
   // Returns a WritableSharedMemoryRegion built from a platform handle that was
   // taken from another WritableSharedMemoryRegion instance. Returns an invalid
   // region iff the |handle| is invalid. CHECK-fails if the |handle| isn't
@@ -86,6 +95,13 @@ class BASE_EXPORT WritableSharedMemoryRegion {
   // requested bytes are out of the region limits.
   WritableSharedMemoryMapping MapAt(off_t offset, size_t size) const;
 
+  // Same as above, but with |options| for how the pages are mapped. See
+  // SharedMemoryMapOptions.
+  using MapOptions = subtle::PlatformSharedMemoryRegion::MapOptions;
+  WritableSharedMemoryMapping MapAt(off_t offset,
+                                    size_t size,
+                                    const MapOptions& options) const;
+
   // Whether underlying platform handles are valid.
   bool IsValid() const;
 
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 
 namespace base {
 
@@ -19,6 +20,29 @@ BASE_EXPORT extern const uint32_t kCrcTable[256];
 // with any seed or be used to continue an operation began with previous data.
 BASE_EXPORT uint32_t Crc32(uint32_t sum, const void* data, size_t size);
 
+// Computes Crc32() incrementally, starting from |seed|.
+class Crc32Hasher {
+ public:
+  explicit Crc32Hasher(uint32_t seed = 0) : seed_(seed), sum_(seed) {}
+  Crc32Hasher(const Crc32Hasher&) = delete;
+  Crc32Hasher& operator=(const Crc32Hasher&) = delete;
+
+  void Update(span<const uint8_t> data) {
+    sum_ = Crc32(sum_, data.data(), data.size());
+  }
+
+  // Returns the CRC of all the data passed to Update(), and starts over.
+  uint32_t Finish() {
+    const uint32_t sum = sum_;
+    sum_ = seed_;
+    return sum;
+  }
+
+ private:
+  const uint32_t seed_;
+  uint32_t sum_;
+};
+
 }  // namespace base
 
 #endif  // BASE_METRICS_CRC32_H_
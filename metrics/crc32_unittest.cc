@@ -31,4 +31,14 @@ TEST(Crc32Test, ZeroTest) {
   EXPECT_EQ(0U, Crc32(0, nullptr, 0));
 }
 
+TEST(Crc32Test, Hasher) {
+  const uint8_t kData[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+  Crc32Hasher hasher(42);
+  hasher.Update(make_span(kData, 3));
+  hasher.Update(make_span(kData + 3, 5));
+  EXPECT_EQ(Crc32(42, kData, sizeof(kData)), hasher.Finish());
+  // Finish() starts over from the seed.
+  EXPECT_EQ(42U, hasher.Finish());
+}
+
 }  // namespace base
@@ -11,6 +11,7 @@
 #include "base/command_line.h"
 #include "base/debug/activity_tracker.h"
 #include "base/logging.h"
+#include "base/metrics/field_trial_index.h"
 #include "base/metrics/field_trial_param_associator.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/process/memory.h"
@@ -592,6 +593,7 @@ void FieldTrialList::AllStatesToString(std::string* output,
   if (!global_)
     return;
   AutoLock auto_lock(global_->lock_);
+  global_->RegisterAllIndexedTrialsWhileLocked();
 
   for (const auto& registered : global_->registered_) {
     FieldTrial::State trial;
@@ -870,6 +872,7 @@ void FieldTrialList::CopyFieldTrialStateToFlags(
     return;
   }
 
+  UpdateFieldTrialIndexIfNeeded();
   global_->field_trial_allocator_->UpdateTrackingHistograms();
   std::string switch_value =
       SerializeSharedMemoryRegionMetadata(global_->readonly_allocator_region_);
@@ -989,6 +992,7 @@ size_t FieldTrialList::GetFieldTrialCount() {
   if (!global_)
     return 0;
   AutoLock auto_lock(global_->lock_);
+  global_->RegisterAllIndexedTrialsWhileLocked();
   return global_->registered_.size();
 }
 
@@ -1092,6 +1096,9 @@ void FieldTrialList::ClearParamsFromSharedMemoryForTesting() {
   for (const auto& ref : new_refs) {
     allocator->MakeIterable(ref);
   }
+  // The index refers to the old entries.
+  global_->indexed_trial_count_ = 0;
+  global_->unindexed_trial_count_ = new_refs.size();
 }
 
 // static
@@ -1100,6 +1107,7 @@ void FieldTrialList::DumpAllFieldTrialsToPersistentAllocator(
   if (!global_)
     return;
   AutoLock auto_lock(global_->lock_);
+  global_->RegisterAllIndexedTrialsWhileLocked();
   for (const auto& registered : global_->registered_) {
     AddToAllocatorWhileLocked(allocator, registered.second);
   }
@@ -1313,12 +1321,68 @@ bool FieldTrialList::CreateTrialsFromSharedMemoryMapping(
   FieldTrialAllocator* shalloc = global_->field_trial_allocator_.get();
   FieldTrialAllocator::Iterator mem_iter(shalloc);
 
-  const FieldTrial::FieldTrialEntry* entry;
-  while ((entry = mem_iter.GetNextOfObject<FieldTrial::FieldTrialEntry>()) !=
-         nullptr) {
+  // Only look at the headers of the allocations for now. Entries which precede
+  // the newest index are covered by it.
+  std::vector<FieldTrial::FieldTrialRef> entry_refs;
+  FieldTrialAllocator::Reference index_ref =
+      FieldTrialAllocator::kReferenceNull;
+  size_t indexed_entry_count = 0;
+  FieldTrialAllocator::Reference ref;
+  uint32_t type;
+  while ((ref = mem_iter.GetNext(&type)) !=
+         FieldTrialAllocator::kReferenceNull) {
+    if (type == FieldTrial::FieldTrialEntry::kPersistentTypeId) {
+      entry_refs.push_back(ref);
+    } else if (type == FieldTrialIndex::kPersistentTypeId) {
+      index_ref = ref;
+      indexed_entry_count = entry_refs.size();
+    }
+  }
+
+  std::unique_ptr<FieldTrialIndex> index;
+  if (index_ref != FieldTrialAllocator::kReferenceNull) {
+    const size_t index_size =
+        shalloc->GetAllocSize(index_ref) / sizeof(uint32_t);
+    const uint32_t* index_data = shalloc->GetAsArray<uint32_t>(
+        index_ref, FieldTrialIndex::kPersistentTypeId, index_size);
+    if (index_data)
+      index = FieldTrialIndex::Parse(make_span(index_data, index_size));
+  }
+  if (!index)
+    indexed_entry_count = 0;
+
+  std::vector<std::string> activated_trial_names;
+  if (index) {
+    for (FieldTrial::FieldTrialRef indexed_ref : index->references()) {
+      const FieldTrial::FieldTrialEntry* entry =
+          shalloc->GetAsObject<FieldTrial::FieldTrialEntry>(indexed_ref);
+      StringPiece trial_name;
+      StringPiece group_name;
+      if (entry && subtle::NoBarrier_Load(&entry->activated) &&
+          entry->GetTrialAndGroupName(&trial_name, &group_name)) {
+        activated_trial_names.push_back(trial_name.as_string());
+      }
+    }
+    AutoLock auto_lock(global_->lock_);
+    global_->field_trial_index_ = std::move(index);
+    global_->all_indexed_trials_registered_ = false;
+  }
+
+  for (const std::string& trial_name : activated_trial_names) {
+    // Find() registers the trial. Call |group()| to mark it as "used" and
+    // notify observers, if any. This is useful to ensure that field trials
+    // created in child processes are properly reported in crash reports.
+    FieldTrial* trial = Find(trial_name);
+    if (trial)
+      trial->group();
+  }
+
+  for (size_t i = indexed_entry_count; i < entry_refs.size(); ++i) {
+    const FieldTrial::FieldTrialEntry* entry =
+        shalloc->GetAsObject<FieldTrial::FieldTrialEntry>(entry_refs[i]);
     StringPiece trial_name;
     StringPiece group_name;
-    if (!entry->GetTrialAndGroupName(&trial_name, &group_name))
+    if (!entry || !entry->GetTrialAndGroupName(&trial_name, &group_name))
       return false;
 
     // TODO(lawrencewu): Convert the API for CreateFieldTrial to take
@@ -1326,17 +1390,118 @@ bool FieldTrialList::CreateTrialsFromSharedMemoryMapping(
     FieldTrial* trial =
         CreateFieldTrial(trial_name.as_string(), group_name.as_string());
 
-    trial->ref_ = mem_iter.GetAsReference(entry);
+    trial->ref_ = entry_refs[i];
     if (subtle::NoBarrier_Load(&entry->activated)) {
-      // Call |group()| to mark the trial as "used" and notify observers, if
-      // any. This is useful to ensure that field trials created in child
-      // processes are properly reported in crash reports.
+      // See above.
       trial->group();
     }
   }
   return true;
 }
 
+// static
+void FieldTrialList::UpdateFieldTrialIndexIfNeeded() {
+  if (!global_)
+    return;
+
+  AutoLock auto_lock(global_->lock_);
+  FieldTrialAllocator* allocator = global_->field_trial_allocator_.get();
+  if (!allocator || allocator->IsReadonly())
+    return;
+
+  // Children register the trials added after the newest index on startup, as
+  // if there was no index. Only write a new one once that's a sizable share of
+  // all trials, so that indices don't take much of the allocator's space.
+  if (global_->unindexed_trial_count_ <= global_->indexed_trial_count_ / 4)
+    return;
+
+  std::vector<FieldTrialIndex::Entry> index_entries;
+  FieldTrialAllocator::Iterator mem_iter(allocator);
+  FieldTrial::FieldTrialRef ref;
+  while ((ref = mem_iter.GetNextOfType<FieldTrial::FieldTrialEntry>()) !=
+         FieldTrialAllocator::kReferenceNull) {
+    const FieldTrial::FieldTrialEntry* entry =
+        allocator->GetAsObject<FieldTrial::FieldTrialEntry>(ref);
+    StringPiece trial_name;
+    StringPiece group_name;
+    if (entry && entry->GetTrialAndGroupName(&trial_name, &group_name))
+      index_entries.push_back({trial_name, ref});
+  }
+
+  const std::vector<uint32_t> index = FieldTrialIndex::Build(index_entries);
+  const size_t index_size = index.size() * sizeof(uint32_t);
+  // Leave most of the free space to trials.
+  if (index.empty() ||
+      index_size > (allocator->size() - allocator->used()) / 4) {
+    return;
+  }
+  FieldTrialAllocator::Reference index_ref =
+      allocator->Allocate(index_size, FieldTrialIndex::kPersistentTypeId);
+  uint32_t* index_data = allocator->GetAsArray<uint32_t>(
+      index_ref, FieldTrialIndex::kPersistentTypeId, index.size());
+  if (!index_data)
+    return;
+  std::copy(index.begin(), index.end(), index_data);
+  allocator->MakeIterable(index_ref);
+
+  global_->indexed_trial_count_ = index_entries.size();
+  global_->unindexed_trial_count_ = 0;
+}
+
+FieldTrial* FieldTrialList::RegisterTrialFromAllocatorWhileLocked(
+    FieldTrial::FieldTrialRef ref,
+    StringPiece trial_name,
+    StringPiece group_name) {
+  if (trial_name.empty() || group_name.empty())
+    return nullptr;
+
+  // Equivalent to CreateFieldTrial(), but doesn't need the lock.
+  const int kTotalProbability = 100;
+  FieldTrial* field_trial = new FieldTrial(
+      trial_name.as_string(), kTotalProbability, group_name.as_string(), 0);
+  field_trial->AddRef();
+  field_trial->SetTrialRegistered();
+  registered_[field_trial->trial_name()] = field_trial;
+  field_trial->ref_ = ref;
+  field_trial->FinalizeGroupChoiceImpl(/*is_locked=*/true);
+  field_trial->forced_ = true;
+  return field_trial;
+}
+
+FieldTrial* FieldTrialList::RegisterIndexedTrialWhileLocked(StringPiece name) {
+  if (!field_trial_index_ || all_indexed_trials_registered_)
+    return nullptr;
+
+  const FieldTrial::FieldTrialRef ref = field_trial_index_->GetCandidate(name);
+  const FieldTrial::FieldTrialEntry* entry =
+      field_trial_allocator_->GetAsObject<FieldTrial::FieldTrialEntry>(ref);
+  StringPiece trial_name;
+  StringPiece group_name;
+  if (!entry || !entry->GetTrialAndGroupName(&trial_name, &group_name) ||
+      trial_name != name) {
+    return nullptr;
+  }
+  return RegisterTrialFromAllocatorWhileLocked(ref, trial_name, group_name);
+}
+
+void FieldTrialList::RegisterAllIndexedTrialsWhileLocked() {
+  if (!field_trial_index_ || all_indexed_trials_registered_)
+    return;
+
+  for (FieldTrial::FieldTrialRef ref : field_trial_index_->references()) {
+    const FieldTrial::FieldTrialEntry* entry =
+        field_trial_allocator_->GetAsObject<FieldTrial::FieldTrialEntry>(ref);
+    StringPiece trial_name;
+    StringPiece group_name;
+    if (!entry || !entry->GetTrialAndGroupName(&trial_name, &group_name) ||
+        registered_.count(trial_name.as_string())) {
+      continue;
+    }
+    RegisterTrialFromAllocatorWhileLocked(ref, trial_name, group_name);
+  }
+  all_indexed_trials_registered_ = true;
+}
+
 // static
 void FieldTrialList::InstantiateFieldTrialAllocatorIfNeeded() {
   if (!global_)
@@ -1419,6 +1584,8 @@ void FieldTrialList::AddToAllocatorWhileLocked(
 
   allocator->MakeIterable(ref);
   field_trial->ref_ = ref;
+  if (global_ && allocator == global_->field_trial_allocator_.get())
+    ++global_->unindexed_trial_count_;
 }
 
 // static
@@ -1448,7 +1615,7 @@ void FieldTrialList::ActivateFieldTrialEntryWhileLocked(
 FieldTrial* FieldTrialList::PreLockedFind(const std::string& name) {
   auto it = registered_.find(name);
   if (registered_.end() == it)
-    return nullptr;
+    return RegisterIndexedTrialWhileLocked(name);
   return it->second;
 }
 
@@ -1470,6 +1637,7 @@ FieldTrialList::RegistrationMap FieldTrialList::GetRegisteredTrials() {
   RegistrationMap output;
   if (global_) {
     AutoLock auto_lock(global_->lock_);
+    global_->RegisterAllIndexedTrialsWhileLocked();
     output = global_->registered_;
   }
   return output;
@@ -84,6 +84,7 @@
 
 namespace base {
 
+class FieldTrialIndex;
 class FieldTrialList;
 
 class BASE_EXPORT FieldTrial : public RefCounted<FieldTrial> {
@@ -690,6 +691,9 @@ class BASE_EXPORT FieldTrialList {
                            SerializeSharedMemoryRegionMetadata);
   friend int SerializeSharedMemoryRegionMetadata(void);
   FRIEND_TEST_ALL_PREFIXES(FieldTrialListTest, CheckReadOnlySharedMemoryRegion);
+  FRIEND_TEST_ALL_PREFIXES(FieldTrialListTest,
+                           IndexedTrialsAreRegisteredLazily);
+  FRIEND_TEST_ALL_PREFIXES(FieldTrialListTest, TrialsAddedAfterIndex);
 
   // Serialization is used to pass information about the handle to child
   // processes. It passes a reference to the relevant OS resource, and it passes
@@ -729,12 +733,34 @@ class BASE_EXPORT FieldTrialList {
 
   // Expects a mapped piece of shared memory |shm_mapping| that was created from
   // the browser process's field_trial_allocator and shared via the command
-  // line. This function recreates the allocator, iterates through all the field
-  // trials in it, and creates them via CreateFieldTrial(). Returns true if
-  // successful and false otherwise.
+  // line. This function recreates the allocator and iterates through all the
+  // field trials in it. Trials covered by the allocator's FieldTrialIndex are
+  // only registered when they're first looked up, or right away if they were
+  // activated in the browser process; the others are created via
+  // CreateFieldTrial(). Returns true if successful and false otherwise.
   static bool CreateTrialsFromSharedMemoryMapping(
       ReadOnlySharedMemoryMapping shm_mapping);
 
+  // Writes a new FieldTrialIndex of all the trials in the allocator, if a
+  // significant number of trials were added since the last one. Called before
+  // the allocator is shared with a child process.
+  static void UpdateFieldTrialIndexIfNeeded();
+
+  // Registers the trial in the entry at |ref| of the read-only allocator,
+  // forced to |group_name|, without activating it. Caller must hold a lock.
+  FieldTrial* RegisterTrialFromAllocatorWhileLocked(
+      FieldTrial::FieldTrialRef ref,
+      StringPiece trial_name,
+      StringPiece group_name);
+
+  // Registers the trial named |name| if it's in |field_trial_index_| and
+  // wasn't registered yet. Caller must hold a lock.
+  FieldTrial* RegisterIndexedTrialWhileLocked(StringPiece name);
+
+  // Registers all trials in |field_trial_index_|, before enumerating
+  // |registered_|. Caller must hold a lock.
+  void RegisterAllIndexedTrialsWhileLocked();
+
   // Instantiate the field trial allocator, add all existing field trials to it,
   // and duplicates its handle to a read-only handle, which gets stored in
   // |readonly_allocator_handle|.
@@ -751,7 +777,8 @@ class BASE_EXPORT FieldTrialList {
   // A map from FieldTrial names to the actual instances.
   typedef std::map<std::string, FieldTrial*> RegistrationMap;
 
-  // Helper function should be called only while holding lock_.
+  // Helper function should be called only while holding lock_. In a child
+  // process, this registers the trial from shared memory if needed.
   FieldTrial* PreLockedFind(const std::string& name);
 
   // Register() stores a pointer to the given trial in a global map.
@@ -792,6 +819,17 @@ class BASE_EXPORT FieldTrialList {
   // to start passing more data other than field trials.
   std::unique_ptr<FieldTrialAllocator> field_trial_allocator_ = nullptr;
 
+  // In the browser process, the number of trials in |field_trial_allocator_|
+  // which are covered by its newest FieldTrialIndex, and the number of trials
+  // added since.
+  size_t indexed_trial_count_ = 0;
+  size_t unindexed_trial_count_ = 0;
+
+  // In a child process, the newest index in |field_trial_allocator_|, if any.
+  // Trials in it are registered when they're first looked up.
+  std::unique_ptr<FieldTrialIndex> field_trial_index_;
+  bool all_indexed_trials_registered_ = false;
+
   // Readonly copy of the region to the allocator. Needs to be a member variable
   // because it's needed from both CopyFieldTrialStateToFlags() and
   // AppendFieldTrialHandleIfNeeded().
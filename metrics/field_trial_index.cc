@@ -0,0 +1,138 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/field_trial_index.h"
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "base/memory/ptr_util.h"
+
+namespace base {
+
+namespace {
+
+// The average number of names per bucket, and the percentage of slots which
+// hold a name. Denser tables need many more attempts to find the seeds of the
+// last buckets.
+constexpr size_t kNamesPerBucket = 4;
+constexpr size_t kLoadFactorPercent = 80;
+
+// The number of seeds tried per bucket before giving up.
+constexpr uint32_t kMaxSeed = 1 << 20;
+
+// The index is only used within a version of Chrome, so the hash doesn't need
+// to be stable across versions. This is FNV-1a with the seed folded into the
+// offset basis, followed by MurmurHash3's finalizer so that every seed spreads
+// names over all slots.
+uint32_t HashName(StringPiece name, uint32_t seed) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325) ^
+                  (seed * UINT64_C(0x9e3779b97f4a7c15));
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(0x100000001b3);
+  }
+  hash ^= hash >> 33;
+  hash *= UINT64_C(0xff51afd7ed558ccd);
+  hash ^= hash >> 33;
+  hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+}  // namespace
+
+FieldTrialIndex::FieldTrialIndex(span<const uint32_t> seeds,
+                                 span<const uint32_t> slots)
+    : seeds_(seeds), slots_(slots) {}
+
+FieldTrialIndex::~FieldTrialIndex() = default;
+
+// base::internal::JSONKeyTable uses the same seed search at compile time, but
+// its sizes are template parameters, so the two can't share an implementation.
+// static
+std::vector<uint32_t> FieldTrialIndex::Build(
+    const std::vector<Entry>& entries) {
+  const size_t bucket_count =
+      std::max<size_t>(1, (entries.size() + kNamesPerBucket - 1) /
+                              kNamesPerBucket);
+  const size_t slot_count =
+      std::max<size_t>(1, entries.size() * 100 / kLoadFactorPercent);
+
+  std::vector<std::vector<const Entry*>> buckets(bucket_count);
+  for (const Entry& entry : entries) {
+    DCHECK(entry.ref);
+    buckets[HashName(entry.name, 0) % bucket_count].push_back(&entry);
+  }
+
+  // Place the largest buckets first, while most slots are free.
+  std::vector<size_t> bucket_order(bucket_count);
+  for (size_t i = 0; i < bucket_count; ++i)
+    bucket_order[i] = i;
+  std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                   [&buckets](size_t a, size_t b) {
+                     return buckets[a].size() > buckets[b].size();
+                   });
+
+  std::vector<uint32_t> seeds(bucket_count, 0);
+  std::vector<uint32_t> slots(slot_count, 0);
+  std::vector<size_t> bucket_slots;
+  for (size_t bucket : bucket_order) {
+    if (buckets[bucket].empty())
+      break;
+    uint32_t seed = 1;
+    for (; seed < kMaxSeed; ++seed) {
+      bucket_slots.clear();
+      for (const Entry* entry : buckets[bucket]) {
+        const size_t slot = HashName(entry->name, seed) % slot_count;
+        if (slots[slot] || std::find(bucket_slots.begin(), bucket_slots.end(),
+                                     slot) != bucket_slots.end()) {
+          break;
+        }
+        bucket_slots.push_back(slot);
+      }
+      if (bucket_slots.size() == buckets[bucket].size())
+        break;
+    }
+    if (seed == kMaxSeed)
+      return std::vector<uint32_t>();
+
+    seeds[bucket] = seed;
+    for (size_t i = 0; i < bucket_slots.size(); ++i)
+      slots[bucket_slots[i]] = buckets[bucket][i]->ref;
+  }
+
+  std::vector<uint32_t> data;
+  data.reserve(2 + bucket_count + slot_count);
+  data.push_back(static_cast<uint32_t>(bucket_count));
+  data.push_back(static_cast<uint32_t>(slot_count));
+  data.insert(data.end(), seeds.begin(), seeds.end());
+  data.insert(data.end(), slots.begin(), slots.end());
+  return data;
+}
+
+// static
+std::unique_ptr<FieldTrialIndex> FieldTrialIndex::Parse(
+    span<const uint32_t> data) {
+  if (data.size() < 2)
+    return nullptr;
+  const size_t bucket_count = data[0];
+  const size_t slot_count = data[1];
+  if (!bucket_count || !slot_count || bucket_count > data.size() - 2 ||
+      slot_count > data.size() - 2 - bucket_count) {
+    return nullptr;
+  }
+  return WrapUnique(
+      new FieldTrialIndex(data.subspan(2, bucket_count),
+                          data.subspan(2 + bucket_count, slot_count)));
+}
+
+uint32_t FieldTrialIndex::GetCandidate(StringPiece name) const {
+  const uint32_t seed = seeds_[HashName(name, 0) % seeds_.size()];
+  if (!seed)
+    return 0;
+  return slots_[HashName(name, seed) % slots_.size()];
+}
+
+}  // namespace base
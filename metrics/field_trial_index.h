@@ -0,0 +1,70 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_METRICS_FIELD_TRIAL_INDEX_H_
+#define BASE_METRICS_FIELD_TRIAL_INDEX_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+
+// A perfect hash index from field trial names to the references of their
+// FieldTrialEntry in the field trial allocator. The browser process writes one
+// to the field trial shared memory, so that child processes can look trials up
+// by name instead of registering all of them on startup.
+//
+// The index is serialized as an array of uint32_t: the bucket count, the slot
+// count, a seed for each bucket, then the reference in each slot, or 0 for
+// empty slots. A name is hashed to a bucket, then hashed with that bucket's
+// seed to a slot. Build() picks the seeds so that no two names share a slot
+// ("hash and displace"), so a lookup only has a single candidate to compare
+// the name with.
+class BASE_EXPORT FieldTrialIndex {
+ public:
+  // The type of the allocation holding a serialized index. Increment this if
+  // the format changes!
+  static constexpr uint32_t kPersistentTypeId = 0x1DE7A1B5 + 1;
+
+  struct Entry {
+    StringPiece name;
+    uint32_t ref;
+  };
+
+  FieldTrialIndex(const FieldTrialIndex&) = delete;
+  FieldTrialIndex& operator=(const FieldTrialIndex&) = delete;
+  ~FieldTrialIndex();
+
+  // Returns the serialized index of |entries|, whose names must be unique and
+  // whose references must not be 0. Returns an empty vector in the very
+  // unlikely case that no seed separates the names of a bucket.
+  static std::vector<uint32_t> Build(const std::vector<Entry>& entries);
+
+  // Returns an index reading from |data|, which must outlive it, or null if
+  // |data| isn't a serialized index.
+  static std::unique_ptr<FieldTrialIndex> Parse(span<const uint32_t> data);
+
+  // Returns the only reference which may belong to |name|, or 0 if there's
+  // none. The caller must check that the entry's name matches.
+  uint32_t GetCandidate(StringPiece name) const;
+
+  // Returns the references in all slots, including empty ones.
+  span<const uint32_t> references() const { return slots_; }
+
+ private:
+  FieldTrialIndex(span<const uint32_t> seeds, span<const uint32_t> slots);
+
+  const span<const uint32_t> seeds_;
+  const span<const uint32_t> slots_;
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_FIELD_TRIAL_INDEX_H_
@@ -0,0 +1,88 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/field_trial_index.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+std::vector<std::string> MakeNames(size_t count) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; ++i)
+    names.push_back(StringPrintf("Trial%zu", i));
+  return names;
+}
+
+std::vector<FieldTrialIndex::Entry> MakeEntries(
+    const std::vector<std::string>& names) {
+  std::vector<FieldTrialIndex::Entry> entries;
+  for (size_t i = 0; i < names.size(); ++i)
+    entries.push_back({names[i], static_cast<uint32_t>(i + 1)});
+  return entries;
+}
+
+}  // namespace
+
+TEST(FieldTrialIndexTest, FindsAllNames) {
+  for (size_t count : {1, 2, 7, 100, 2000}) {
+    const std::vector<std::string> names = MakeNames(count);
+    const std::vector<uint32_t> data =
+        FieldTrialIndex::Build(MakeEntries(names));
+    ASSERT_FALSE(data.empty());
+    std::unique_ptr<FieldTrialIndex> index = FieldTrialIndex::Parse(data);
+    ASSERT_TRUE(index);
+
+    for (size_t i = 0; i < count; ++i)
+      EXPECT_EQ(i + 1, index->GetCandidate(names[i])) << names[i];
+
+    size_t reference_count = 0;
+    for (uint32_t ref : index->references())
+      reference_count += !!ref;
+    EXPECT_EQ(count, reference_count);
+  }
+}
+
+// Names which aren't in the index have at most one candidate, which a lookup
+// has to rule out by comparing names.
+TEST(FieldTrialIndexTest, OtherNames) {
+  const std::vector<std::string> names = MakeNames(100);
+  const std::vector<uint32_t> data = FieldTrialIndex::Build(MakeEntries(names));
+  std::unique_ptr<FieldTrialIndex> index = FieldTrialIndex::Parse(data);
+  ASSERT_TRUE(index);
+
+  for (const char* name : {"", "Trial", "Trial100", "trial1", "Other"}) {
+    const uint32_t ref = index->GetCandidate(name);
+    if (ref) {
+      EXPECT_NE(name, names[ref - 1]);
+    }
+  }
+}
+
+TEST(FieldTrialIndexTest, Empty) {
+  const std::vector<uint32_t> data = FieldTrialIndex::Build({});
+  std::unique_ptr<FieldTrialIndex> index = FieldTrialIndex::Parse(data);
+  ASSERT_TRUE(index);
+  EXPECT_EQ(0u, index->GetCandidate("Trial"));
+}
+
+TEST(FieldTrialIndexTest, Malformed) {
+  EXPECT_FALSE(FieldTrialIndex::Parse({}));
+  const std::vector<uint32_t> counts_only = {1, 1};
+  EXPECT_FALSE(FieldTrialIndex::Parse(counts_only));
+  const std::vector<uint32_t> no_buckets = {0, 1, 0};
+  EXPECT_FALSE(FieldTrialIndex::Parse(no_buckets));
+  const std::vector<uint32_t> truncated = {2, 4, 0, 0, 1, 2};
+  EXPECT_FALSE(FieldTrialIndex::Parse(truncated));
+  const std::vector<uint32_t> huge_counts = {0xFFFFFFFF, 0xFFFFFFFF, 0, 0};
+  EXPECT_FALSE(FieldTrialIndex::Parse(huge_counts));
+}
+
+}  // namespace base
@@ -1379,6 +1379,98 @@ TEST_F(FieldTrialListTest, DumpAndFetchFromSharedMemory) {
   EXPECT_EQ("value2", shm_params["key2"]);
 }
 
+TEST_F(FieldTrialListTest, IndexedTrialsAreRegisteredLazily) {
+  constexpr int kTrialCount = 100;
+  std::string save_string;
+  base::ReadOnlySharedMemoryRegion shm_region;
+  {
+    FieldTrialList field_trial_list1(nullptr);
+    for (int i = 0; i < kTrialCount; ++i) {
+      FieldTrialList::CreateFieldTrial(StringPrintf("Trial%d", i),
+                                       StringPrintf("Group%d", i));
+    }
+    FieldTrialList::FindFullName("Trial7");
+    FieldTrialList::InstantiateFieldTrialAllocatorIfNeeded();
+    FieldTrialList::UpdateFieldTrialIndexIfNeeded();
+    FieldTrialList::AllStatesToString(&save_string, false);
+    shm_region = FieldTrialList::DuplicateFieldTrialSharedMemoryForTesting();
+    ASSERT_TRUE(shm_region.IsValid());
+  }
+
+  FieldTrialList field_trial_list2(nullptr);
+  // 16 KiB is enough to hold the trials only created for this test.
+  base::ReadOnlySharedMemoryMapping shm_mapping =
+      shm_region.MapAt(0, 16 << 10);
+  ASSERT_TRUE(shm_mapping.IsValid());
+  ASSERT_TRUE(FieldTrialList::CreateTrialsFromSharedMemoryMapping(
+      std::move(shm_mapping)));
+  ASSERT_TRUE(field_trial_list2.field_trial_index_);
+
+  // Only the activated trial was registered on startup.
+  EXPECT_EQ(1u, field_trial_list2.registered_.size());
+  EXPECT_TRUE(FieldTrialList::IsTrialActive("Trial7"));
+
+  EXPECT_EQ("Group42", FieldTrialList::FindFullName("Trial42"));
+  EXPECT_FALSE(FieldTrialList::Find("Trial100"));
+  EXPECT_EQ(2u, field_trial_list2.registered_.size());
+
+  std::string check_string;
+  FieldTrialList::AllStatesToString(&check_string, false);
+  EXPECT_EQ(save_string, check_string);
+  EXPECT_EQ(static_cast<size_t>(kTrialCount),
+            FieldTrialList::GetFieldTrialCount());
+}
+
+TEST_F(FieldTrialListTest, TrialsAddedAfterIndex) {
+  std::string save_string;
+  base::ReadOnlySharedMemoryRegion shm_region;
+  {
+    FieldTrialList field_trial_list1(nullptr);
+    for (int i = 0; i < 8; ++i) {
+      FieldTrialList::CreateFieldTrial(StringPrintf("Trial%d", i),
+                                       StringPrintf("Group%d", i));
+    }
+    FieldTrialList::InstantiateFieldTrialAllocatorIfNeeded();
+    FieldTrialList::UpdateFieldTrialIndexIfNeeded();
+    EXPECT_EQ(8u, field_trial_list1.indexed_trial_count_);
+
+    // A few more trials don't warrant a new index...
+    FieldTrialList::CreateFieldTrial("Trial8", "Group8");
+    FieldTrialList::UpdateFieldTrialIndexIfNeeded();
+    EXPECT_EQ(8u, field_trial_list1.indexed_trial_count_);
+    EXPECT_EQ(1u, field_trial_list1.unindexed_trial_count_);
+
+    // ...but many do.
+    FieldTrialList::CreateFieldTrial("Trial9", "Group9");
+    FieldTrialList::CreateFieldTrial("Trial10", "Group10");
+    FieldTrialList::UpdateFieldTrialIndexIfNeeded();
+    EXPECT_EQ(11u, field_trial_list1.indexed_trial_count_);
+    EXPECT_EQ(0u, field_trial_list1.unindexed_trial_count_);
+
+    FieldTrialList::CreateFieldTrial("Trial11", "Group11");
+    FieldTrialList::AllStatesToString(&save_string, false);
+    shm_region = FieldTrialList::DuplicateFieldTrialSharedMemoryForTesting();
+    ASSERT_TRUE(shm_region.IsValid());
+  }
+
+  FieldTrialList field_trial_list2(nullptr);
+  // 4 KiB is enough to hold the trials only created for this test.
+  base::ReadOnlySharedMemoryMapping shm_mapping = shm_region.MapAt(0, 4 << 10);
+  ASSERT_TRUE(shm_mapping.IsValid());
+  ASSERT_TRUE(FieldTrialList::CreateTrialsFromSharedMemoryMapping(
+      std::move(shm_mapping)));
+
+  // The trial added after the newest index was registered on startup.
+  ASSERT_EQ(1u, field_trial_list2.registered_.size());
+  EXPECT_EQ("Trial11", field_trial_list2.registered_.begin()->first);
+  EXPECT_EQ("Group0", FieldTrialList::FindFullName("Trial0"));
+  EXPECT_EQ("Group10", FieldTrialList::FindFullName("Trial10"));
+
+  std::string check_string;
+  FieldTrialList::AllStatesToString(&check_string, false);
+  EXPECT_EQ(save_string, check_string);
+}
+
 // Shared-memory distribution of FieldTrial to child process is not implemented
 // on Fuchsia: http://crbug.com/752368.
 #if !defined(OS_NACL) && !defined(OS_IOS) && !defined(OS_FUCHSIA)
@@ -5,6 +5,11 @@
 #ifndef BASE_OBSERVER_LIST_THREADSAFE_H_
 #define BASE_OBSERVER_LIST_THREADSAFE_H_
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -12,10 +17,12 @@
 #include "base/base_export.h"
 #include "base/bind.h"
 #include "base/check_op.h"
+#include "base/containers/circular_deque.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
+#include "base/optional.h"
 #include "base/sequenced_task_runner.h"
 #include "base/stl_util.h"
 #include "base/synchronization/lock.h"
@@ -46,6 +53,21 @@
 //   will always be done via PostTask() to another sequence, whereas with the
 //   non-thread-safe observer_list, notifications happen synchronously.
 //
+// IMPLEMENTATION NOTES:
+//
+//   The set of observers is kept in an immutable, ref-counted snapshot which
+//   is replaced wholesale by AddObserver() and RemoveObserver(). Notify() only
+//   holds |lock_| long enough to take a reference to the current snapshot, so
+//   concurrent notifications don't contend on the observer map and adding or
+//   removing observers costs O(number of observers).
+//
+//   Notifications are queued per observer sequence, and each notification
+//   posts one task per sequence rather than one task per observer. A task
+//   delivers its own notification and any earlier ones left undelivered by a
+//   nested run loop, but never later ones. Notifications are thus delivered to
+//   each observer in the order in which Notify() was called, and never ahead
+//   of tasks posted to the sequence before them.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace base {
@@ -110,13 +132,35 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
            "from a task posted to a base::SequencedTaskRunner or "
            "base::SingleThreadTaskRunner.";
 
-    AutoLock auto_lock(lock_);
+    scoped_refptr<ObserverSequence> sequence;
+    {
+      AutoLock auto_lock(lock_);
 
-    // Add |observer| to the list of observers.
-    DCHECK(!Contains(observers_, observer));
-    const scoped_refptr<SequencedTaskRunner> task_runner =
-        SequencedTaskRunnerHandle::Get();
-    observers_[observer] = task_runner;
+      // Add |observer| to a copy of the current observers.
+      DCHECK(!Contains(observers_->sequences, observer));
+      const scoped_refptr<SequencedTaskRunner> task_runner =
+          SequencedTaskRunnerHandle::Get();
+      auto new_observers = MakeRefCounted<Observers>(*observers_);
+      auto it = std::find_if(new_observers->by_sequence.begin(),
+                             new_observers->by_sequence.end(),
+                             [&](const SequenceObservers& entry) {
+                               return entry.sequence->task_runner ==
+                                      task_runner;
+                             });
+      if (it == new_observers->by_sequence.end()) {
+        new_observers->by_sequence.push_back(
+            {MakeRefCounted<ObserverSequence>(task_runner),
+             MakeRefCounted<ObserverVector>()});
+        it = std::prev(new_observers->by_sequence.end());
+      }
+      std::vector<ObserverType*> sequence_observers = it->observers->data;
+      sequence_observers.push_back(observer);
+      it->observers = MakeRefCounted<ObserverVector>(
+          std::move(sequence_observers));
+      sequence = it->sequence;
+      new_observers->sequences[observer] = sequence;
+      observers_ = std::move(new_observers);
+    }
 
     // If this is called while a notification is being dispatched on this thread
     // and |policy_| is ALL, |observer| must be notified (if a notification is
@@ -127,12 +171,13 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
       const NotificationDataBase* current_notification =
           tls_current_notification_.Get().Get();
       if (current_notification && current_notification->observer_list == this) {
-        task_runner->PostTask(
-            current_notification->from_here,
-            BindOnce(
-                &ObserverListThreadSafe<ObserverType>::NotifyWrapper, this,
-                observer,
-                *static_cast<const NotificationData*>(current_notification)));
+        // Queue it behind the notifications already pending on this sequence
+        // so that |observer| sees them in order.
+        EnqueueNotification(
+            std::move(sequence),
+            *static_cast<const NotificationData*>(current_notification),
+            MakeRefCounted<ObserverVector>(
+                std::vector<ObserverType*>{observer}));
       }
     }
   }
@@ -144,14 +189,34 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
   // observer won't stop it.
   void RemoveObserver(ObserverType* observer) {
     AutoLock auto_lock(lock_);
-    observers_.erase(observer);
+    auto sequence_it = observers_->sequences.find(observer);
+    if (sequence_it == observers_->sequences.end())
+      return;
+
+    // Remove |observer| from a copy of the current observers.
+    auto new_observers = MakeRefCounted<Observers>(*observers_);
+    new_observers->sequences.erase(observer);
+    auto it = std::find_if(new_observers->by_sequence.begin(),
+                           new_observers->by_sequence.end(),
+                           [&](const SequenceObservers& entry) {
+                             return entry.sequence == sequence_it->second;
+                           });
+    DCHECK(it != new_observers->by_sequence.end());
+    std::vector<ObserverType*> sequence_observers = it->observers->data;
+    base::Erase(sequence_observers, observer);
+    if (sequence_observers.empty()) {
+      new_observers->by_sequence.erase(it);
+    } else {
+      it->observers =
+          MakeRefCounted<ObserverVector>(std::move(sequence_observers));
+    }
+    observers_ = std::move(new_observers);
   }
 
   // Verifies that the list is currently empty (i.e. there are no observers).
   void AssertEmpty() const {
 #if DCHECK_IS_ON()
-    AutoLock auto_lock(lock_);
-    DCHECK(observers_.empty());
+    DCHECK(GetObservers()->sequences.empty());
 #endif
   }
 
@@ -165,13 +230,10 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
         BindRepeating(&Dispatcher<ObserverType, Method>::Run, m,
                       std::forward<Params>(params)...);
 
-    AutoLock lock(lock_);
-    for (const auto& observer : observers_) {
-      observer.second->PostTask(
-          from_here,
-          BindOnce(&ObserverListThreadSafe<ObserverType>::NotifyWrapper, this,
-                   observer.first, NotificationData(this, from_here, method)));
-    }
+    const NotificationData notification(this, from_here, method);
+    const scoped_refptr<const Observers> observers = GetObservers();
+    for (const SequenceObservers& entry : observers->by_sequence)
+      EnqueueNotification(entry.sequence, notification, entry.observers);
   }
 
   // Like Notify() but attempts to synchronously invoke callbacks if they are
@@ -184,29 +246,18 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
         BindRepeating(&Dispatcher<ObserverType, Method>::Run, m,
                       std::forward<Params>(params)...);
 
-    // The observers may make reentrant calls (which can be a problem due to the
-    // lock), so we extract a list to call synchronously.
-    std::vector<ObserverType*> current_sequence_observers;
-
-    {
-      AutoLock lock(lock_);
-      current_sequence_observers.reserve(observers_.size());
-      for (const auto& observer : observers_) {
-        if (observer.second->RunsTasksInCurrentSequence()) {
-          current_sequence_observers.push_back(observer.first);
-        } else {
-          observer.second->PostTask(
-              from_here,
-              BindOnce(&ObserverListThreadSafe<ObserverType>::NotifyWrapper,
-                       this, observer.first,
-                       NotificationData(this, from_here, method)));
-        }
+    const NotificationData notification(this, from_here, method);
+    const scoped_refptr<const Observers> observers = GetObservers();
+    for (const SequenceObservers& entry : observers->by_sequence) {
+      if (entry.sequence->task_runner->RunsTasksInCurrentSequence()) {
+        // The snapshot isn't affected by reentrant calls made by the
+        // observers, so it's safe to iterate over it while notifying.
+        for (ObserverType* observer : entry.observers->data)
+          NotifyWrapper(observer, notification);
+      } else {
+        EnqueueNotification(entry.sequence, notification, entry.observers);
       }
     }
-
-    for (ObserverType* observer : current_sequence_observers) {
-      NotifyWrapper(observer, NotificationData(this, from_here, method));
-    }
   }
 
  private:
@@ -222,18 +273,155 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
     RepeatingCallback<void(ObserverType*)> method;
   };
 
+  using ObserverVector = RefCountedData<std::vector<ObserverType*>>;
+
+  // A notification waiting to be delivered to |observers| on an
+  // ObserverSequence. |id| orders the notifications of a sequence.
+  // |next_observer| is the index of the next observer to notify.
+  struct PendingNotification {
+    PendingNotification(uint64_t id_in,
+                        const NotificationData& notification_in,
+                        scoped_refptr<const ObserverVector> observers_in)
+        : id(id_in),
+          notification(notification_in),
+          observers(std::move(observers_in)) {}
+
+    uint64_t id;
+    NotificationData notification;
+    scoped_refptr<const ObserverVector> observers;
+    size_t next_observer = 0;
+  };
+
+  // Queue of notifications for the observers registered on one sequence.
+  class ObserverSequence : public RefCountedThreadSafe<ObserverSequence> {
+   public:
+    explicit ObserverSequence(scoped_refptr<SequencedTaskRunner> task_runner_in)
+        : task_runner(std::move(task_runner_in)) {}
+    ObserverSequence(const ObserverSequence&) = delete;
+    ObserverSequence& operator=(const ObserverSequence&) = delete;
+
+    const scoped_refptr<SequencedTaskRunner> task_runner;
+
+    Lock lock;
+    circular_deque<PendingNotification> pending GUARDED_BY(lock);
+    uint64_t next_id GUARDED_BY(lock) = 0;
+
+   private:
+    friend class RefCountedThreadSafe<ObserverSequence>;
+    ~ObserverSequence() = default;
+  };
+
+  // Owned by the task posted to deliver the notification |id| on |sequence|.
+  // If the task is destroyed without running, e.g. because the sequence is
+  // shutting down, the notification is dropped so that the queue doesn't
+  // grow. Running the task takes |sequence|, which disarms the ticket.
+  struct DispatchTicket {
+    DispatchTicket(scoped_refptr<ObserverSequence> sequence_in, uint64_t id_in)
+        : sequence(std::move(sequence_in)), id(id_in) {}
+    DispatchTicket(const DispatchTicket&) = delete;
+    DispatchTicket& operator=(const DispatchTicket&) = delete;
+    ~DispatchTicket() {
+      if (!sequence)
+        return;
+      AutoLock auto_lock(sequence->lock);
+      EraseIf(sequence->pending, [this](const PendingNotification& pending) {
+        return pending.id == id;
+      });
+    }
+
+    scoped_refptr<ObserverSequence> sequence;
+    const uint64_t id;
+  };
+
+  struct SequenceObservers {
+    scoped_refptr<ObserverSequence> sequence;
+    scoped_refptr<const ObserverVector> observers;
+  };
+
+  // Immutable snapshot of the registered observers.
+  struct Observers : public RefCountedThreadSafe<Observers> {
+    Observers() = default;
+    Observers(const Observers& other)
+        : sequences(other.sequences), by_sequence(other.by_sequence) {}
+
+    // Keys are observers. Values are the sequences on which they must be
+    // notified.
+    std::unordered_map<ObserverType*, scoped_refptr<ObserverSequence>>
+        sequences;
+    // Observers grouped by sequence.
+    std::vector<SequenceObservers> by_sequence;
+
+   private:
+    friend class RefCountedThreadSafe<Observers>;
+    ~Observers() = default;
+  };
+
   ~ObserverListThreadSafe() override = default;
 
+  scoped_refptr<const Observers> GetObservers() const {
+    AutoLock auto_lock(lock_);
+    return observers_;
+  }
+
+  // Queues |notification| for |observers| on |sequence| and posts a task to
+  // deliver it. If the task is dropped, so is the notification.
+  void EnqueueNotification(scoped_refptr<ObserverSequence> sequence,
+                           const NotificationData& notification,
+                           scoped_refptr<const ObserverVector> observers) {
+    uint64_t id;
+    {
+      AutoLock auto_lock(sequence->lock);
+      id = sequence->next_id++;
+      sequence->pending.emplace_back(id, notification, std::move(observers));
+    }
+
+    scoped_refptr<SequencedTaskRunner> task_runner = sequence->task_runner;
+    task_runner->PostTask(
+        notification.from_here,
+        BindOnce(
+            &ObserverListThreadSafe<ObserverType>::DispatchPendingNotifications,
+            this, std::make_unique<DispatchTicket>(std::move(sequence), id)));
+  }
+
+  // Delivers the notifications of |ticket|'s sequence up to and including the
+  // ticket's own. Earlier notifications still in the queue, e.g. when this task
+  // runs in a nested run loop started by an observer, are delivered first to
+  // keep each observer's notifications in order. Later notifications,
+  // including those sent by the observers, are left to their own tasks.
+  void DispatchPendingNotifications(std::unique_ptr<DispatchTicket> ticket) {
+    const scoped_refptr<ObserverSequence> sequence =
+        std::move(ticket->sequence);
+    const uint64_t last_id = ticket->id;
+    DCHECK(sequence->task_runner->RunsTasksInCurrentSequence());
+
+    while (true) {
+      ObserverType* observer;
+      Optional<NotificationData> notification;
+      {
+        AutoLock auto_lock(sequence->lock);
+        if (sequence->pending.empty() ||
+            sequence->pending.front().id > last_id) {
+          return;
+        }
+        PendingNotification& front = sequence->pending.front();
+        observer = front.observers->data[front.next_observer++];
+        notification.emplace(front.notification);
+        if (front.next_observer == front.observers->data.size())
+          sequence->pending.pop_front();
+      }
+      NotifyWrapper(observer, *notification);
+    }
+  }
+
   void NotifyWrapper(ObserverType* observer,
                      const NotificationData& notification) {
     {
-      AutoLock auto_lock(lock_);
-
       // Check whether the observer still needs a notification.
-      auto it = observers_.find(observer);
-      if (it == observers_.end())
+      const scoped_refptr<const Observers> observers = GetObservers();
+      auto it = observers->sequences.find(observer);
+      if (it == observers->sequences.end())
         return;
-      DCHECK(it->second->RunsTasksInCurrentSequence());
+      DCHECK(it->second->task_runner->RunsTasksInCurrentSequence());
     }
 
     // Keep track of the notification being dispatched on the current thread.
@@ -259,10 +447,9 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
 
   mutable Lock lock_;
 
-  // Keys are observers. Values are the SequencedTaskRunners on which they must
-  // be notified.
-  std::unordered_map<ObserverType*, scoped_refptr<SequencedTaskRunner>>
-      observers_ GUARDED_BY(lock_);
+  // Current snapshot of the observers. Replaced, never modified in place.
+  scoped_refptr<const Observers> observers_ GUARDED_BY(lock_) =
+      MakeRefCounted<Observers>();
 };
 
 }  // namespace base
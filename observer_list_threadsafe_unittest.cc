@@ -22,6 +22,7 @@
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "build/build_config.h"
@@ -456,6 +457,132 @@ TEST(ObserverListThreadSafeTest, Existing) {
   EXPECT_EQ(1, c.total);
 }
 
+namespace {
+
+class RecordingObserver : public Foo {
+ public:
+  void Observe(int x) override { values.push_back(x); }
+
+  std::vector<int> values;
+};
+
+}  // namespace
+
+// Verify that a burst of notifications is delivered to every observer in the
+// order in which Notify() was called.
+TEST(ObserverListThreadSafeTest, NotificationsDeliveredInOrder) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>();
+  RecordingObserver a;
+  RecordingObserver b;
+  observer_list->AddObserver(&a);
+  observer_list->AddObserver(&b);
+
+  std::vector<int> expected;
+  for (int i = 0; i < 100; ++i) {
+    observer_list->Notify(FROM_HERE, &Foo::Observe, i);
+    expected.push_back(i);
+  }
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(expected, a.values);
+  EXPECT_EQ(expected, b.values);
+}
+
+// Verify that notifications already queued for an observer are dropped when it
+// is removed by another observer of the same sequence.
+TEST(ObserverListThreadSafeTest, RemoveObserverWithQueuedNotifications) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>();
+  FooRemover remover(observer_list.get());
+  RecordingObserver a;
+  remover.AddFooToRemove(&a);
+  observer_list->AddObserver(&remover);
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 2);
+  RunLoop().RunUntilIdle();
+
+  // |remover| runs first for the first notification, so |a| never sees either.
+  EXPECT_TRUE(a.values.empty());
+}
+
+// Verify that notifications aren't delivered ahead of tasks posted to the
+// observer's sequence before them.
+TEST(ObserverListThreadSafeTest, NotificationsOrderedWithPostedTasks) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>();
+  RecordingObserver a;
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() { a.values.push_back(-1); }));
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 2);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(std::vector<int>({1, -1, 2}), a.values);
+}
+
+namespace {
+
+// Sends the next notification from each notification, up to |kLast|.
+class Renotifier : public RecordingObserver {
+ public:
+  static constexpr int kLast = 3;
+
+  explicit Renotifier(ObserverListThreadSafe<Foo>* list) : list_(list) {}
+
+  void Observe(int x) override {
+    RecordingObserver::Observe(x);
+    if (x < kLast)
+      list_->Notify(FROM_HERE, &Foo::Observe, x + 1);
+  }
+
+ private:
+  ObserverListThreadSafe<Foo>* const list_;
+};
+
+}  // namespace
+
+// Verify that notifications sent by an observer are delivered by later tasks,
+// so that a chain of them doesn't starve the observer's sequence.
+TEST(ObserverListThreadSafeTest, NotifyFromObserverYieldsToPostedTasks) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>();
+  Renotifier a(observer_list.get());
+  observer_list->AddObserver(&a);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 0);
+  ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() { a.values.push_back(-1); }));
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(std::vector<int>({0, -1, 1, 2, 3}), a.values);
+}
+
+// Verify that notifications for an observer whose thread is gone are dropped.
+TEST(ObserverListThreadSafeTest, NotifyAfterObserverThreadStopped) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>();
+  RecordingObserver a;
+  Thread thread("ObserverThread");
+  ASSERT_TRUE(thread.Start());
+  thread.task_runner()->PostTask(
+      FROM_HERE, BindOnce(&ObserverListThreadSafe<Foo>::AddObserver,
+                          observer_list, Unretained(&a)));
+  thread.FlushForTesting();
+  thread.Stop();
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 2);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(a.values.empty());
+  observer_list->RemoveObserver(&a);
+}
+
 TEST(ObserverListThreadSafeTest, NotifySynchronously) {
   test::TaskEnvironment task_environment;
 
@@ -5,12 +5,15 @@
 #include "base/posix/unix_domain_socket.h"
 
 #include <errno.h>
+#include <string.h>
 #include <sys/socket.h>
 #if !defined(OS_NACL_NONSFI)
 #include <sys/un.h>
 #endif
 #include <unistd.h>
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/files/scoped_file.h"
@@ -25,10 +28,157 @@
 #include <sys/uio.h>
 #endif
 
+#if (defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)) && \
+    !defined(OS_NACL)
+#include <sys/syscall.h>
+#if defined(__NR_sendmmsg) && defined(__NR_recvmmsg)
+#define HAS_SENDMMSG_AND_RECVMMSG 1
+#endif
+#endif
+
 namespace base {
 
 const size_t UnixDomainSocket::kMaxFileDescriptors = 16;
 
+namespace {
+
+// Space for the control messages of a received message.
+const size_t kRecvControlBufferSize =
+    CMSG_SPACE(sizeof(int) * UnixDomainSocket::kMaxFileDescriptors)
+#if !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
+    // The PNaCl toolchain for Non-SFI binary build and macOS do not support
+    // ucred. macOS supports xucred, but this structure is insufficient.
+    + CMSG_SPACE(sizeof(struct ucred))
+#endif  // !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
+    ;
+
+// Returns the flags for sendmsg(2) on |fd|.
+int GetSendFlags(int fd) {
+// Avoid a SIGPIPE if the other end breaks the connection.
+// Due to a bug in the Linux kernel (net/unix/af_unix.c) MSG_NOSIGNAL isn't
+// regarded for SOCK_SEQPACKET in the AF_UNIX domain, but it is mandated by
+// POSIX. On Mac MSG_NOSIGNAL is not supported, so we need to ensure that
+// SO_NOSIGPIPE is set during socket creation.
+#if defined(OS_APPLE)
+  int no_sigpipe = 0;
+  socklen_t no_sigpipe_len = sizeof(no_sigpipe);
+  DPCHECK(getsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe,
+                     &no_sigpipe_len) == 0)
+      << "Failed ot get socket option.";
+  DCHECK(no_sigpipe) << "SO_NOSIGPIPE not set on the socket.";
+  return 0;
+#else
+  return MSG_NOSIGNAL;
+#endif  // OS_APPLE
+}
+
+// Writes an SCM_RIGHTS control message with |fds| to |msg|'s control buffer,
+// which must have CMSG_SPACE(sizeof(int) * fds.size()) bytes.
+void WriteFileDescriptors(span<const int> fds, struct msghdr* msg) {
+  msg->msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+  memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+  msg->msg_controllen = cmsg->cmsg_len;
+}
+
+// Returns the number of bytes that sending |msg| writes.
+size_t GetMessageLength(const struct msghdr& msg) {
+  size_t length = 0;
+  for (size_t i = 0; i < msg.msg_iovlen; ++i)
+    length += msg.msg_iov[i].iov_len;
+  return length;
+}
+
+// Finds the file descriptors and the sender's process ID, if any, in the
+// control messages of a received |msg|.
+void ReadControlMessages(struct msghdr* msg,
+                         int** wire_fds,
+                         unsigned* wire_fds_len,
+                         ProcessId* pid) {
+  *wire_fds = nullptr;
+  *wire_fds_len = 0;
+  *pid = -1;
+  if (msg->msg_controllen == 0)
+    return;
+
+  struct cmsghdr* cmsg;
+  for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+    const unsigned payload_len = cmsg->cmsg_len - CMSG_LEN(0);
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      DCHECK_EQ(payload_len % sizeof(int), 0u);
+      DCHECK_EQ(*wire_fds, static_cast<void*>(nullptr));
+      *wire_fds = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+      *wire_fds_len = payload_len / sizeof(int);
+    }
+#if !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
+    // The PNaCl toolchain for Non-SFI binary build and macOS do not support
+    // SCM_CREDENTIALS.
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_CREDENTIALS) {
+      DCHECK_EQ(payload_len, sizeof(struct ucred));
+      DCHECK_EQ(*pid, -1);
+      *pid = reinterpret_cast<struct ucred*>(CMSG_DATA(cmsg))->pid;
+    }
+#endif  // !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
+  }
+}
+
+// Returns true if |msg| was received in full. Otherwise closes |wire_fds|.
+bool CheckNotTruncated(const struct msghdr& msg,
+                       int* wire_fds,
+                       unsigned wire_fds_len) {
+  if (!(msg.msg_flags & MSG_TRUNC) && !(msg.msg_flags & MSG_CTRUNC))
+    return true;
+  if (msg.msg_flags & MSG_CTRUNC) {
+    // Extraordinary case, not caller fixable. Log something.
+    LOG(ERROR) << "recvmsg returned MSG_CTRUNC flag, buffer len is "
+               << msg.msg_controllen;
+  }
+  for (unsigned i = 0; i < wire_fds_len; ++i)
+    close(wire_fds[i]);
+  return false;
+}
+
+}  // namespace
+
+struct UnixDomainSocket::BatchBuffers::Storage {
+#if defined(HAS_SENDMMSG_AND_RECVMMSG)
+  std::vector<struct mmsghdr> headers;
+  struct msghdr* header(size_t i) { return &headers[i].msg_hdr; }
+#else
+  std::vector<struct msghdr> headers;
+  struct msghdr* header(size_t i) { return &headers[i]; }
+#endif
+  std::vector<struct iovec> iovecs;
+  // Holds cmsghdrs, so it must be aligned like them.
+  std::vector<uint64_t> control;
+
+  char* GetControlBuffer(size_t size) {
+    control.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    return reinterpret_cast<char*>(control.data());
+  }
+};
+
+UnixDomainSocket::IncomingMessage::IncomingMessage() = default;
+
+UnixDomainSocket::IncomingMessage::IncomingMessage(span<uint8_t> buffer)
+    : buffer(buffer) {}
+
+UnixDomainSocket::IncomingMessage::IncomingMessage(IncomingMessage&& other) =
+    default;
+
+UnixDomainSocket::IncomingMessage& UnixDomainSocket::IncomingMessage::operator=(
+    IncomingMessage&& other) = default;
+
+UnixDomainSocket::IncomingMessage::~IncomingMessage() = default;
+
+UnixDomainSocket::BatchBuffers::BatchBuffers()
+    : storage_(std::make_unique<Storage>()) {}
+
+UnixDomainSocket::BatchBuffers::~BatchBuffers() = default;
+
 #if !defined(OS_NACL_NONSFI)
 bool CreateSocketPair(ScopedFD* one, ScopedFD* two) {
   int raw_socks[2];
@@ -77,42 +227,166 @@ bool UnixDomainSocket::SendMsg(int fd,
   msg.msg_iov = &iov;
   msg.msg_iovlen = 1;
 
-  char* control_buffer = nullptr;
+  // Most messages carry few descriptors, so avoid allocating for them.
+  alignas(struct cmsghdr) char
+      stack_control_buffer[CMSG_SPACE(sizeof(int) * kMaxFileDescriptors)];
+  std::unique_ptr<char[]> heap_control_buffer;
   if (fds.size()) {
-    const unsigned control_len = CMSG_SPACE(sizeof(int) * fds.size());
-    control_buffer = new char[control_len];
-
-    struct cmsghdr* cmsg;
-    msg.msg_control = control_buffer;
-    msg.msg_controllen = control_len;
-    cmsg = CMSG_FIRSTHDR(&msg);
-    cmsg->cmsg_level = SOL_SOCKET;
-    cmsg->cmsg_type = SCM_RIGHTS;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
-    memcpy(CMSG_DATA(cmsg), &fds[0], sizeof(int) * fds.size());
-    msg.msg_controllen = cmsg->cmsg_len;
+    const size_t control_len = CMSG_SPACE(sizeof(int) * fds.size());
+    if (control_len <= sizeof(stack_control_buffer)) {
+      msg.msg_control = stack_control_buffer;
+    } else {
+      heap_control_buffer.reset(new char[control_len]);
+      msg.msg_control = heap_control_buffer.get();
+    }
+    WriteFileDescriptors(fds, &msg);
   }
 
-// Avoid a SIGPIPE if the other end breaks the connection.
-// Due to a bug in the Linux kernel (net/unix/af_unix.c) MSG_NOSIGNAL isn't
-// regarded for SOCK_SEQPACKET in the AF_UNIX domain, but it is mandated by
-// POSIX. On Mac MSG_NOSIGNAL is not supported, so we need to ensure that
-// SO_NOSIGPIPE is set during socket creation.
-#if defined(OS_APPLE)
-  const int flags = 0;
-  int no_sigpipe = 0;
-  socklen_t no_sigpipe_len = sizeof(no_sigpipe);
-  DPCHECK(getsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe,
-                     &no_sigpipe_len) == 0)
-      << "Failed ot get socket option.";
-  DCHECK(no_sigpipe) << "SO_NOSIGPIPE not set on the socket.";
-#else
-  const int flags = MSG_NOSIGNAL;
-#endif  // OS_APPLE
-  const ssize_t r = HANDLE_EINTR(sendmsg(fd, &msg, flags));
-  const bool ret = static_cast<ssize_t>(length) == r;
-  delete[] control_buffer;
-  return ret;
+  const ssize_t r = HANDLE_EINTR(sendmsg(fd, &msg, GetSendFlags(fd)));
+  return static_cast<ssize_t>(length) == r;
+}
+
+// static
+ssize_t UnixDomainSocket::SendMsgs(int fd,
+                                   span<const OutgoingMessage> messages,
+                                   BatchBuffers* buffers) {
+  if (messages.empty())
+    return 0;
+
+  BatchBuffers::Storage* storage = buffers->storage_.get();
+  size_t iovec_count = 0;
+  size_t control_size = 0;
+  for (const OutgoingMessage& message : messages) {
+    iovec_count += message.buffers.size();
+    if (!message.fds.empty())
+      control_size += CMSG_SPACE(sizeof(int) * message.fds.size());
+  }
+  storage->headers.resize(messages.size());
+  storage->iovecs.resize(iovec_count);
+  char* control = storage->GetControlBuffer(control_size);
+
+  struct iovec* iov = storage->iovecs.data();
+  for (size_t i = 0; i < messages.size(); ++i) {
+    struct msghdr* msg = storage->header(i);
+    *msg = {};
+    msg->msg_iov = iov;
+    msg->msg_iovlen = messages[i].buffers.size();
+    for (span<const uint8_t> buffer : messages[i].buffers)
+      *iov++ = {const_cast<uint8_t*>(buffer.data()), buffer.size()};
+    if (!messages[i].fds.empty()) {
+      msg->msg_control = control;
+      WriteFileDescriptors(messages[i].fds, msg);
+      control += CMSG_SPACE(sizeof(int) * messages[i].fds.size());
+    }
+  }
+
+  // As in SendMsg(), a message only counts as sent if all of its bytes were
+  // accepted, which a stream socket may not do. Counting stops at the first
+  // short send.
+  const int flags = GetSendFlags(fd);
+  size_t sent = 0;
+#if defined(HAS_SENDMMSG_AND_RECVMMSG)
+  bool short_send = false;
+  // The kernel sends at most UIO_MAXIOV messages per call.
+  while (sent < messages.size() && !short_send) {
+    const long r =
+        HANDLE_EINTR(syscall(__NR_sendmmsg, fd, &storage->headers[sent],
+                             messages.size() - sent, flags));
+    if (r <= 0)
+      break;
+    for (const size_t end = sent + static_cast<size_t>(r); sent < end;
+         ++sent) {
+      if (storage->headers[sent].msg_len !=
+          GetMessageLength(*storage->header(sent))) {
+        short_send = true;
+        break;
+      }
+    }
+  }
+  if (sent || short_send || errno != ENOSYS)
+    return sent ? static_cast<ssize_t>(sent) : -1;
+  // Fall back to sendmsg(2) on kernels older than 3.0.
+#endif
+  for (; sent < messages.size(); ++sent) {
+    const ssize_t r = HANDLE_EINTR(sendmsg(fd, storage->header(sent), flags));
+    if (r != static_cast<ssize_t>(GetMessageLength(*storage->header(sent))))
+      break;
+  }
+  return sent ? static_cast<ssize_t>(sent) : -1;
+}
+
+// static
+ssize_t UnixDomainSocket::RecvMsgs(int fd,
+                                   span<IncomingMessage> messages,
+                                   BatchBuffers* buffers) {
+  if (messages.empty())
+    return 0;
+
+  BatchBuffers::Storage* storage = buffers->storage_.get();
+  storage->headers.resize(messages.size());
+  storage->iovecs.resize(messages.size());
+  char* control =
+      storage->GetControlBuffer(messages.size() * kRecvControlBufferSize);
+  for (size_t i = 0; i < messages.size(); ++i) {
+    struct msghdr* msg = storage->header(i);
+    *msg = {};
+    storage->iovecs[i] = {messages[i].buffer.data(),
+                          messages[i].buffer.size()};
+    msg->msg_iov = &storage->iovecs[i];
+    msg->msg_iovlen = 1;
+    msg->msg_control = control + i * kRecvControlBufferSize;
+    msg->msg_controllen = kRecvControlBufferSize;
+  }
+
+  size_t received = 0;
+#if defined(HAS_SENDMMSG_AND_RECVMMSG)
+  // MSG_WAITFORONE makes the call non-blocking after the first message.
+  const long r = HANDLE_EINTR(syscall(__NR_recvmmsg, fd,
+                                      storage->headers.data(), messages.size(),
+                                      MSG_WAITFORONE, nullptr));
+  if (r == 0)
+    return 0;
+  if (r > 0) {
+    received = static_cast<size_t>(r);
+    for (size_t i = 0; i < received; ++i)
+      messages[i].length = storage->headers[i].msg_len;
+  } else if (errno != ENOSYS) {
+    return -1;
+  }
+#endif
+  if (!received) {
+    // Fall back to recvmsg(2), only waiting for the first message. A
+    // zero-length read that's not the first message may be EOF, so stop there.
+    for (; received < messages.size(); ++received) {
+      const ssize_t r = HANDLE_EINTR(recvmsg(fd, storage->header(received),
+                                             received ? MSG_DONTWAIT : 0));
+      if (r == -1)
+        break;
+      messages[received].length = r;
+      if (r == 0) {
+        ++received;
+        break;
+      }
+    }
+    if (!received)
+      return -1;
+  }
+
+  for (size_t i = 0; i < received; ++i) {
+    struct msghdr* msg = storage->header(i);
+    int* wire_fds;
+    unsigned wire_fds_len;
+    ProcessId pid;
+    ReadControlMessages(msg, &wire_fds, &wire_fds_len, &pid);
+    messages[i].fds.clear();
+    if (!CheckNotTruncated(*msg, wire_fds, wire_fds_len)) {
+      messages[i].length = -1;
+      continue;
+    }
+    for (unsigned j = 0; j < wire_fds_len; ++j)
+      messages[i].fds.emplace_back(wire_fds[j]);
+  }
+  return static_cast<ssize_t>(received);
 }
 
 // static
@@ -146,15 +420,7 @@ ssize_t UnixDomainSocket::RecvMsgWithFlags(int fd,
   msg.msg_iov = &iov;
   msg.msg_iovlen = 1;
 
-  const size_t kControlBufferSize =
-      CMSG_SPACE(sizeof(int) * kMaxFileDescriptors)
-#if !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
-      // The PNaCl toolchain for Non-SFI binary build and macOS do not support
-      // ucred. macOS supports xucred, but this structure is insufficient.
-      + CMSG_SPACE(sizeof(struct ucred))
-#endif  // !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
-      ;
-  char control_buffer[kControlBufferSize];
+  alignas(struct cmsghdr) char control_buffer[kRecvControlBufferSize];
   msg.msg_control = control_buffer;
   msg.msg_controllen = sizeof(control_buffer);
 
@@ -162,41 +428,12 @@ ssize_t UnixDomainSocket::RecvMsgWithFlags(int fd,
   if (r == -1)
     return -1;
 
-  int* wire_fds = nullptr;
-  unsigned wire_fds_len = 0;
-  ProcessId pid = -1;
-
-  if (msg.msg_controllen > 0) {
-    struct cmsghdr* cmsg;
-    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
-      const unsigned payload_len = cmsg->cmsg_len - CMSG_LEN(0);
-      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
-        DCHECK_EQ(payload_len % sizeof(int), 0u);
-        DCHECK_EQ(wire_fds, static_cast<void*>(nullptr));
-        wire_fds = reinterpret_cast<int*>(CMSG_DATA(cmsg));
-        wire_fds_len = payload_len / sizeof(int);
-      }
-#if !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
-      // The PNaCl toolchain for Non-SFI binary build and macOS do not support
-      // SCM_CREDENTIALS.
-      if (cmsg->cmsg_level == SOL_SOCKET &&
-          cmsg->cmsg_type == SCM_CREDENTIALS) {
-        DCHECK_EQ(payload_len, sizeof(struct ucred));
-        DCHECK_EQ(pid, -1);
-        pid = reinterpret_cast<struct ucred*>(CMSG_DATA(cmsg))->pid;
-      }
-#endif  // !defined(OS_NACL_NONSFI) && !defined(OS_APPLE)
-    }
-  }
+  int* wire_fds;
+  unsigned wire_fds_len;
+  ProcessId pid;
+  ReadControlMessages(&msg, &wire_fds, &wire_fds_len, &pid);
 
-  if (msg.msg_flags & MSG_TRUNC || msg.msg_flags & MSG_CTRUNC) {
-    if (msg.msg_flags & MSG_CTRUNC) {
-      // Extraordinary case, not caller fixable. Log something.
-      LOG(ERROR) << "recvmsg returned MSG_CTRUNC flag, buffer len is "
-                 << msg.msg_controllen;
-    }
-    for (unsigned i = 0; i < wire_fds_len; ++i)
-      close(wire_fds[i]);
+  if (!CheckNotTruncated(msg, wire_fds, wire_fds_len)) {
     errno = EMSGSIZE;
     return -1;
   }
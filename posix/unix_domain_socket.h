@@ -8,9 +8,12 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
+
+#include <memory>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 #include "base/files/scoped_file.h"
 #include "base/process/process_handle.h"
 #include "build/build_config.h"
@@ -31,6 +34,46 @@ class BASE_EXPORT UnixDomainSocket {
   // Maximum number of file descriptors that can be read by RecvMsg().
   static const size_t kMaxFileDescriptors;
 
+  // A message for SendMsgs(): the concatenation of |buffers|, which are
+  // gathered by the kernel without copying, and |fds|.
+  struct OutgoingMessage {
+    span<const span<const uint8_t>> buffers;
+    span<const int> fds;
+  };
+
+  // A message for RecvMsgs(), received into |buffer|. On return, |length| is
+  // the size of the message, or -1 if it didn't fit (its file descriptors are
+  // closed then), and |fds| holds the received file descriptors.
+  struct BASE_EXPORT IncomingMessage {
+    IncomingMessage();
+    explicit IncomingMessage(span<uint8_t> buffer);
+    IncomingMessage(IncomingMessage&& other);
+    IncomingMessage& operator=(IncomingMessage&& other);
+    ~IncomingMessage();
+
+    span<uint8_t> buffer;
+    ssize_t length = 0;
+    std::vector<ScopedFD> fds;
+  };
+
+  // The message headers, iovecs and control message buffers of a batch.
+  // Reusing one for all batches sent or received on a socket means that
+  // SendMsgs() and RecvMsgs() only allocate memory while batches grow. Not
+  // thread-safe.
+  class BASE_EXPORT BatchBuffers {
+   public:
+    BatchBuffers();
+    BatchBuffers(const BatchBuffers&) = delete;
+    BatchBuffers& operator=(const BatchBuffers&) = delete;
+    ~BatchBuffers();
+
+   private:
+    friend class UnixDomainSocket;
+    struct Storage;
+
+    const std::unique_ptr<Storage> storage_;
+  };
+
 #if !defined(OS_NACL_NONSFI)
   // Use to enable receiving process IDs in RecvMsgWithPid.  Should be called on
   // the receiving socket (i.e., the socket passed to RecvMsgWithPid). Returns
@@ -52,6 +95,28 @@ class BASE_EXPORT UnixDomainSocket {
                          size_t length,
                          std::vector<ScopedFD>* fds);
 
+  // Sends |messages| with a single sendmmsg(2) where available (Linux, Chrome
+  // OS and Android; sandbox policies must allow it), or one sendmsg(2) per
+  // message otherwise. Returns the number of messages sent, which is less than
+  // |messages.size()| if |fd| is non-blocking and its buffer filled up, or -1
+  // if no message could be sent. A message only counts as sent if all of its
+  // bytes were. On a stream socket, some bytes of the messages after the last
+  // one counted may have been written too, so the stream is no longer framed
+  // and callers must treat a short count as an error rather than resend.
+  static ssize_t SendMsgs(int fd,
+                          span<const OutgoingMessage> messages,
+                          BatchBuffers* buffers);
+
+  // Receives up to |messages.size()| messages with a single recvmmsg(2) where
+  // available, or recvmsg(2) calls otherwise. Only waits for the first
+  // message, unless |fd| is non-blocking. Returns the number of messages
+  // received, or -1 on failure. As with RecvMsg(), a message of length 0
+  // without file descriptors may signal end-of-file, and at most
+  // |kMaxFileDescriptors| descriptors are read per message.
+  static ssize_t RecvMsgs(int fd,
+                          span<IncomingMessage> messages,
+                          BatchBuffers* buffers);
+
   // Same as RecvMsg above, but also returns the sender's process ID (as seen
   // from the caller's namespace).  However, before using this function to
   // receive process IDs, EnableReceiveProcessId() should be called on the
@@ -0,0 +1,142 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/posix/unix_domain_socket.h"
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixUnixDomainSocket[] = "UnixDomainSocket.";
+constexpr char kMetricMessagesPerSecond[] = "messages_per_second";
+constexpr char kMetricFdsPerSecond[] = "fds_per_second";
+constexpr char kStorySendMsg[] = "send_msg";
+constexpr char kStorySendMsgWithFd[] = "send_msg_with_fd";
+constexpr char kStorySendMsgs[] = "send_msgs";
+constexpr char kStorySendMsgsWithFd[] = "send_msgs_with_fd";
+
+constexpr size_t kMessageSize = 64;
+constexpr size_t kBatchSize = 32;
+constexpr int kBatchCount = 2000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixUnixDomainSocket,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricMessagesPerSecond, "messages/s");
+  reporter.RegisterImportantMetric(kMetricFdsPerSecond, "fds/s");
+  return reporter;
+}
+
+class UnixDomainSocketPerfTest : public testing::Test {
+ public:
+  void SetUp() override {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds));
+    recv_sock_.reset(fds[0]);
+    send_sock_.reset(fds[1]);
+  }
+
+  // Sends and receives |kBatchCount| batches of |kBatchSize| messages one at a
+  // time, each with one file descriptor if |with_fd|.
+  void RunSingle(bool with_fd, const char* story_name) {
+    std::vector<uint8_t> buffer(kMessageSize);
+    std::vector<int> send_fds;
+    if (with_fd)
+      send_fds.push_back(send_sock_.get());
+    std::vector<ScopedFD> recv_fds;
+
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < kBatchCount; ++i) {
+      for (size_t j = 0; j < kBatchSize; ++j) {
+        ASSERT_TRUE(UnixDomainSocket::SendMsg(send_sock_.get(), buffer.data(),
+                                              buffer.size(), send_fds));
+      }
+      for (size_t j = 0; j < kBatchSize; ++j) {
+        ASSERT_EQ(static_cast<ssize_t>(kMessageSize),
+                  UnixDomainSocket::RecvMsg(recv_sock_.get(), buffer.data(),
+                                            buffer.size(), &recv_fds));
+        ASSERT_EQ(send_fds.size(), recv_fds.size());
+      }
+    }
+    Report(TimeTicks::Now() - start, with_fd, story_name);
+  }
+
+  // Same as RunSingle(), but with SendMsgs() and RecvMsgs().
+  void RunBatched(bool with_fd, const char* story_name) {
+    std::vector<uint8_t> buffer(kMessageSize);
+    const span<const uint8_t> send_buffers[] = {buffer};
+    const int fd = send_sock_.get();
+    const span<const int> send_fds =
+        with_fd ? make_span(&fd, 1) : span<const int>();
+    std::vector<UnixDomainSocket::OutgoingMessage> outgoing(
+        kBatchSize, {send_buffers, send_fds});
+    std::vector<std::vector<uint8_t>> recv_buffers(
+        kBatchSize, std::vector<uint8_t>(kMessageSize));
+    std::vector<UnixDomainSocket::IncomingMessage> incoming;
+    for (auto& recv_buffer : recv_buffers)
+      incoming.emplace_back(recv_buffer);
+    UnixDomainSocket::BatchBuffers send_batch_buffers;
+    UnixDomainSocket::BatchBuffers recv_batch_buffers;
+
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < kBatchCount; ++i) {
+      ASSERT_EQ(static_cast<ssize_t>(kBatchSize),
+                UnixDomainSocket::SendMsgs(send_sock_.get(), outgoing,
+                                           &send_batch_buffers));
+      size_t received = 0;
+      while (received < kBatchSize) {
+        const ssize_t r = UnixDomainSocket::RecvMsgs(
+            recv_sock_.get(), make_span(incoming).subspan(received),
+            &recv_batch_buffers);
+        ASSERT_GT(r, 0);
+        received += static_cast<size_t>(r);
+      }
+    }
+    Report(TimeTicks::Now() - start, with_fd, story_name);
+  }
+
+ private:
+  void Report(TimeDelta elapsed, bool with_fd, const char* story_name) {
+    const double messages = kBatchCount * kBatchSize;
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricMessagesPerSecond,
+                       messages / elapsed.InSecondsF());
+    if (with_fd)
+      reporter.AddResult(kMetricFdsPerSecond, messages / elapsed.InSecondsF());
+  }
+
+  ScopedFD recv_sock_;
+  ScopedFD send_sock_;
+};
+
+}  // namespace
+
+TEST_F(UnixDomainSocketPerfTest, SendMsg) {
+  RunSingle(/*with_fd=*/false, kStorySendMsg);
+}
+
+TEST_F(UnixDomainSocketPerfTest, SendMsgWithFd) {
+  RunSingle(/*with_fd=*/true, kStorySendMsgWithFd);
+}
+
+TEST_F(UnixDomainSocketPerfTest, SendMsgs) {
+  RunBatched(/*with_fd=*/false, kStorySendMsgs);
+}
+
+TEST_F(UnixDomainSocketPerfTest, SendMsgsWithFd) {
+  RunBatched(/*with_fd=*/true, kStorySendMsgsWithFd);
+}
+
+}  // namespace base
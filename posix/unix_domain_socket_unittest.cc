@@ -158,7 +158,7 @@ TEST(UnixDomainSocketTest, RecvPidWithMaxDescriptors) {
 
 // Check that RecvMsgWithPid doesn't DCHECK fail when reading EOF from a
 // disconnected socket.
-TEST(UnixDomianSocketTest, RecvPidDisconnectedSocket) {
+TEST(UnixDomainSocketTest, RecvPidDisconnectedSocket) {
   int fds[2];
   ASSERT_NO_FATAL_FAILURE(CreateSocketPair(fds));
   ScopedFD recv_sock(fds[0]);
@@ -178,6 +178,112 @@ TEST(UnixDomianSocketTest, RecvPidDisconnectedSocket) {
   ASSERT_EQ(0U, recv_fds.size());
 }
 
+#if !defined(OS_APPLE)
+// Mac OS doesn't support SOCK_SEQPACKET, so message boundaries aren't kept.
+TEST(UnixDomainSocketTest, SendRecvMsgs) {
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(CreateSocketPair(fds));
+  ScopedFD recv_sock(fds[0]);
+  ScopedFD send_sock(fds[1]);
+
+  // The first message is gathered from two buffers and carries two file
+  // descriptors; the second one has neither.
+  static const uint8_t kHello[] = {'h', 'e', 'l', 'l', 'o'};
+  static const uint8_t kWorld[] = {'w', 'o', 'r', 'l', 'd'};
+  const span<const uint8_t> first_buffers[] = {kHello, kWorld};
+  const span<const uint8_t> second_buffers[] = {kWorld};
+  const int first_fds[] = {send_sock.get(), recv_sock.get()};
+  const UnixDomainSocket::OutgoingMessage outgoing[] = {
+      {first_buffers, first_fds}, {second_buffers, {}}};
+
+  UnixDomainSocket::BatchBuffers send_buffers;
+  ASSERT_EQ(2, UnixDomainSocket::SendMsgs(send_sock.get(), outgoing,
+                                          &send_buffers));
+
+  uint8_t buffers[3][16];
+  std::vector<UnixDomainSocket::IncomingMessage> incoming;
+  for (auto& buffer : buffers)
+    incoming.emplace_back(buffer);
+  UnixDomainSocket::BatchBuffers recv_buffers;
+  ASSERT_EQ(2, UnixDomainSocket::RecvMsgs(recv_sock.get(), incoming,
+                                          &recv_buffers));
+
+  ASSERT_EQ(10, incoming[0].length);
+  EXPECT_EQ(0, memcmp(buffers[0], "helloworld", 10));
+  EXPECT_EQ(2U, incoming[0].fds.size());
+  ASSERT_EQ(5, incoming[1].length);
+  EXPECT_EQ(0, memcmp(buffers[1], "world", 5));
+  EXPECT_TRUE(incoming[1].fds.empty());
+
+  // The buffers can be reused, and received descriptors are replaced.
+  ASSERT_EQ(1, UnixDomainSocket::SendMsgs(send_sock.get(),
+                                          make_span(outgoing, 1),
+                                          &send_buffers));
+  ASSERT_EQ(1, UnixDomainSocket::RecvMsgs(recv_sock.get(), incoming,
+                                          &recv_buffers));
+  EXPECT_EQ(10, incoming[0].length);
+  EXPECT_EQ(2U, incoming[0].fds.size());
+}
+
+// Truncated messages are reported with a length of -1 and their file
+// descriptors are closed, without failing the rest of the batch.
+TEST(UnixDomainSocketTest, RecvMsgsTruncated) {
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(CreateSocketPair(fds));
+  ScopedFD recv_sock(fds[0]);
+  ScopedFD send_sock(fds[1]);
+
+  static const uint8_t kLong[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  static const uint8_t kShort[] = {1, 2};
+  const span<const uint8_t> long_buffers[] = {kLong};
+  const span<const uint8_t> short_buffers[] = {kShort};
+  const int send_fds[] = {send_sock.get()};
+  const UnixDomainSocket::OutgoingMessage outgoing[] = {
+      {long_buffers, send_fds}, {short_buffers, send_fds}};
+  UnixDomainSocket::BatchBuffers buffers;
+  ASSERT_EQ(2,
+            UnixDomainSocket::SendMsgs(send_sock.get(), outgoing, &buffers));
+
+  uint8_t recv_buffers[2][4];
+  UnixDomainSocket::IncomingMessage incoming[] = {
+      UnixDomainSocket::IncomingMessage(recv_buffers[0]),
+      UnixDomainSocket::IncomingMessage(recv_buffers[1])};
+  ASSERT_EQ(2, UnixDomainSocket::RecvMsgs(recv_sock.get(), incoming,
+                                          &buffers));
+  EXPECT_EQ(-1, incoming[0].length);
+  EXPECT_TRUE(incoming[0].fds.empty());
+  EXPECT_EQ(2, incoming[1].length);
+  EXPECT_EQ(1U, incoming[1].fds.size());
+}
+#endif  // !defined(OS_APPLE)
+
+// A message that a non-blocking stream socket only accepts part of isn't
+// counted as sent, nor are the messages after it.
+TEST(UnixDomainSocketTest, SendMsgsStopsAtShortSend) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ScopedFD recv_sock(fds[0]);
+  ScopedFD send_sock(fds[1]);
+  ASSERT_TRUE(SetNonBlocking(send_sock.get()));
+#if defined(OS_APPLE)
+  int nosigpipe = 1;
+  ASSERT_EQ(0, setsockopt(send_sock.get(), SOL_SOCKET, SO_NOSIGPIPE,
+                          &nosigpipe, sizeof(nosigpipe)));
+#endif
+
+  // The second message is much larger than the socket buffers.
+  static const uint8_t kSmall[] = {1, 2, 3};
+  const std::vector<uint8_t> large(16 * 1024 * 1024);
+  const span<const uint8_t> small_buffers[] = {kSmall};
+  const span<const uint8_t> large_buffers[] = {large};
+  const UnixDomainSocket::OutgoingMessage outgoing[] = {
+      {small_buffers, {}}, {large_buffers, {}}, {small_buffers, {}}};
+
+  UnixDomainSocket::BatchBuffers buffers;
+  EXPECT_EQ(1,
+            UnixDomainSocket::SendMsgs(send_sock.get(), outgoing, &buffers));
+}
+
 }  // namespace
 
 }  // namespace base
@@ -38,6 +38,7 @@
 #include "base/process/environment_internal.h"
 #include "base/process/process.h"
 #include "base/process/process_metrics.h"
+#include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/platform_thread.h"
@@ -733,6 +734,8 @@ pid_t ForkWithFlags(unsigned long flags, pid_t* ptid, pid_t* ctid) {
   // callbacks, we explicitly clear tid cache here (normally this call is
   // done as pthread_aftork() callback).  See crbug.com/902514.
   base::internal::ClearTidCache();
+  // Likewise, make sure the child doesn't reuse its parent's random state.
+  base::internal::ReseedRandAfterFork();
 #endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
 
   return 0;
@@ -79,4 +79,44 @@ std::string RandBytesAsString(size_t length) {
   return result;
 }
 
+InsecureRandomGenerator::InsecureRandomGenerator() {
+  // The state must not be all zeros.
+  do {
+    a_ = base::RandUint64();
+    b_ = base::RandUint64();
+  } while (!a_ && !b_);
+}
+
+uint32_t InsecureRandomGenerator::RandUint32() {
+  // The upper bits of xorshift128+ output are of better quality.
+  return static_cast<uint32_t>(RandUint64() >> 32);
+}
+
+uint64_t InsecureRandomGenerator::RandUint64() {
+  uint64_t t = a_;
+  const uint64_t s = b_;
+  a_ = s;
+  t ^= t << 23;
+  t ^= t >> 17;
+  t ^= s ^ (s >> 26);
+  b_ = t;
+  return t + s;
+}
+
+double InsecureRandomGenerator::RandDouble() {
+  return BitsToOpenEndedUnitInterval(RandUint64());
+}
+
+void InsecureRandomGenerator::ReseedForTesting(uint64_t seed) {
+  // Expand |seed| with splitmix64, which never yields two zeros in a row.
+  auto splitmix64 = [&seed] {
+    uint64_t z = (seed += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+  };
+  a_ = splitmix64();
+  b_ = splitmix64();
+}
+
 }  // namespace base
@@ -69,10 +69,49 @@ void RandomShuffle(Itr first, Itr last) {
   std::shuffle(first, last, RandomBitGenerator());
 }
 
+// Fast, insecure pseudo-random number generator, for sampling decisions and
+// similar uses where the output needn't be unpredictable. It is several times
+// faster than RandUint64(), but its output can be predicted from a few values:
+// never use it for anything security sensitive, such as tokens or IDs.
+//
+// Uses the xorshift128+ algorithm, seeded from RandUint64(). Not thread-safe;
+// each user is expected to own its own generator.
+class BASE_EXPORT InsecureRandomGenerator {
+ public:
+  InsecureRandomGenerator();
+  InsecureRandomGenerator(const InsecureRandomGenerator&) = delete;
+  InsecureRandomGenerator& operator=(const InsecureRandomGenerator&) = delete;
+  ~InsecureRandomGenerator() = default;
+
+  uint32_t RandUint32();
+  uint64_t RandUint64();
+  // Returns a number in range [0, 1).
+  double RandDouble();
+
+  // Makes the sequence of numbers deterministic.
+  void ReseedForTesting(uint64_t seed);
+
+ private:
+  uint64_t a_ = 0;
+  uint64_t b_ = 0;
+};
+
 #if defined(OS_POSIX)
 BASE_EXPORT int GetUrandomFD();
 #endif
 
+#if (defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)) && \
+    !defined(OS_NACL)
+namespace internal {
+
+// RandBytes() is served from a per-thread userspace CSPRNG which is reseeded
+// in the child after fork(). This forces the reseed after a fork which didn't
+// run pthread_atfork() handlers, e.g. a raw clone().
+BASE_EXPORT void ReseedRandAfterFork();
+
+}  // namespace internal
+#endif
+
 }  // namespace base
 
 #endif  // BASE_RAND_UTIL_H_
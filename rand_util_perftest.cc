@@ -0,0 +1,81 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/rand_util.h"
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// Ask the compiler not to use a register for this variable, so that the
+// generated numbers can't be optimized away.
+volatile uint64_t g_rand_util_perf_test_sink;
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixRandUtil[] = "RandUtil.";
+constexpr char kMetricTimePerCall[] = "time_per_call";
+constexpr char kStoryRandUint64[] = "rand_uint64";
+constexpr char kStoryRandBytes16[] = "rand_bytes_16";
+constexpr char kStoryRandBytes1M[] = "rand_bytes_1m";
+constexpr char kStoryInsecureRandUint64[] = "insecure_rand_uint64";
+
+constexpr int kLaps = 1000000;
+
+void ReportTimePerCall(const std::string& story_name,
+                       TimeDelta duration,
+                       int laps) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixRandUtil, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerCall, "ns");
+  reporter.AddResult(kMetricTimePerCall,
+                     duration.InNanoseconds() / static_cast<double>(laps));
+}
+
+}  // namespace
+
+TEST(RandUtilPerfTest, RandUint64) {
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i)
+    g_rand_util_perf_test_sink = RandUint64();
+  ReportTimePerCall(kStoryRandUint64, TimeTicks::Now() - start, kLaps);
+}
+
+// The size of an UnguessableToken.
+TEST(RandUtilPerfTest, RandBytes16) {
+  uint64_t buffer[2];
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i) {
+    RandBytes(buffer, sizeof(buffer));
+    g_rand_util_perf_test_sink = buffer[0] ^ buffer[1];
+  }
+  ReportTimePerCall(kStoryRandBytes16, TimeTicks::Now() - start, kLaps);
+}
+
+TEST(RandUtilPerfTest, RandBytes1M) {
+  constexpr int kLargeLaps = 100;
+  constexpr size_t kBufferSize = 1024 * 1024;
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[kBufferSize]);
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLargeLaps; ++i) {
+    RandBytes(buffer.get(), kBufferSize);
+    g_rand_util_perf_test_sink = buffer[i];
+  }
+  ReportTimePerCall(kStoryRandBytes1M, TimeTicks::Now() - start, kLargeLaps);
+}
+
+TEST(RandUtilPerfTest, InsecureRandUint64) {
+  InsecureRandomGenerator generator;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i)
+    g_rand_util_perf_test_sink = generator.RandUint64();
+  ReportTimePerCall(kStoryInsecureRandUint64, TimeTicks::Now() - start, kLaps);
+}
+
+}  // namespace base
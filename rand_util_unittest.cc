@@ -13,8 +13,14 @@
 
 #include "base/logging.h"
 #include "base/time/time.h"
+#include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#if defined(OS_POSIX) && !defined(OS_NACL)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 const int kIntMin = std::numeric_limits<int>::min();
@@ -150,6 +156,70 @@ TEST(RandUtilTest, RandBytesLonger) {
   EXPECT_EQ(4097u, random_string2.size());
 }
 
+#if defined(OS_POSIX) && !defined(OS_NACL) && !defined(OS_IOS)
+// The child of a fork must not produce the same numbers as its parent.
+TEST(RandUtilTest, RandBytesAfterFork) {
+  // Make sure this thread's generator is seeded before forking.
+  base::RandUint64();
+
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  const uint64_t value = base::RandUint64();
+  if (pid == 0) {
+    ssize_t written = write(fds[1], &value, sizeof(value));
+    _exit(written == sizeof(value) ? 0 : 1);
+  }
+
+  uint64_t child_value = 0;
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(child_value)),
+            read(fds[0], &child_value, sizeof(child_value)));
+  int status = 0;
+  EXPECT_EQ(pid, waitpid(pid, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+  close(fds[0]);
+  close(fds[1]);
+  EXPECT_NE(value, child_value);
+}
+#endif  // defined(OS_POSIX) && !defined(OS_NACL) && !defined(OS_IOS)
+
+TEST(RandUtilTest, InsecureRandomGeneratorProducesBothValuesOfAllBits) {
+  base::InsecureRandomGenerator generator;
+  uint64_t found_ones = 0;
+  uint64_t found_zeros = ~uint64_t{0};
+  for (size_t i = 0; i < 1000; ++i) {
+    uint64_t value = generator.RandUint64();
+    found_ones |= value;
+    found_zeros &= value;
+    if (found_zeros == 0 && found_ones == ~uint64_t{0})
+      return;
+  }
+  FAIL() << "Didn't achieve all bit values in maximum number of tries.";
+}
+
+TEST(RandUtilTest, InsecureRandomGeneratorReseedForTesting) {
+  base::InsecureRandomGenerator generator1;
+  base::InsecureRandomGenerator generator2;
+  generator1.ReseedForTesting(0);
+  generator2.ReseedForTesting(0);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(generator1.RandUint64(), generator2.RandUint64());
+
+  generator2.ReseedForTesting(1);
+  EXPECT_NE(generator1.RandUint64(), generator2.RandUint64());
+}
+
+TEST(RandUtilTest, InsecureRandomGeneratorRandDouble) {
+  base::InsecureRandomGenerator generator;
+  for (int i = 0; i < 1000; ++i) {
+    volatile double number = generator.RandDouble();
+    EXPECT_GT(1.0, number);
+    EXPECT_LE(0.0, number);
+  }
+}
+
 // Benchmark test for RandBytes().  Disabled since it's intentionally slow and
 // does not test anything that isn't already tested by the existing RandBytes()
 // tests.
@@ -0,0 +1,257 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_sync_channel.h"
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kMaxCapacity = size_t{1} << 30;
+
+// Waits until |*futex| is no longer |value|, the thread is woken up, or
+// |deadline|. The futex isn't private, so that it works across processes.
+void FutexWait(std::atomic<uint32_t>* futex,
+               uint32_t value,
+               TimeTicks deadline) {
+  struct timespec timeout;
+  struct timespec* timeout_ptr = nullptr;
+  if (!deadline.is_max()) {
+    const TimeDelta remaining = deadline - TimeTicks::Now();
+    if (remaining <= TimeDelta())
+      return;
+    timeout = remaining.ToTimeSpec();
+    timeout_ptr = &timeout;
+  }
+  // EINTR, EAGAIN and ETIMEDOUT are all handled by the caller re-checking its
+  // condition.
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(futex), FUTEX_WAIT, value,
+          timeout_ptr, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* futex) {
+  // Changing the value makes a waiter which is about to call FutexWait()
+  // return right away.
+  futex->fetch_add(1, std::memory_order_seq_cst);
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(futex), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+// One direction of the channel. The positions count the bytes written to and
+// read from the ring, modulo 2^32. Each one is only changed by one side, and
+// they are on separate cache lines so that the sides don't contend.
+//
+// A side which has to wait sets its |*_waiting| flag, checks the positions
+// again and sleeps on its futex. The other side checks the flag after moving
+// its position, and only then makes the syscall to wake it. All of these are
+// sequentially consistent, so that either the waiter sees the new position or
+// the other side sees the flag.
+struct SharedMemorySyncChannel::Ring {
+  alignas(64) std::atomic<uint32_t> write_position;
+  std::atomic<uint32_t> writer_futex;
+  std::atomic<uint32_t> writer_waiting;
+  alignas(64) std::atomic<uint32_t> read_position;
+  std::atomic<uint32_t> reader_futex;
+  std::atomic<uint32_t> reader_waiting;
+};
+
+// Laid out at the start of the region, followed by the data of both rings.
+// Zero-initialized shared memory is a valid, empty header.
+struct SharedMemorySyncChannel::Header {
+  Ring rings[2];
+  alignas(64) std::atomic<uint32_t> closed;
+  // Written once by CreateRegion().
+  uint32_t capacity;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "The rings must be usable across processes");
+
+SharedMemorySyncChannel::SharedMemorySyncChannel() = default;
+
+SharedMemorySyncChannel::~SharedMemorySyncChannel() {
+  if (IsValid())
+    Close();
+}
+
+// static
+UnsafeSharedMemoryRegion SharedMemorySyncChannel::CreateRegion(
+    size_t capacity) {
+  if (!bits::IsPowerOfTwo(capacity) || capacity > kMaxCapacity)
+    return UnsafeSharedMemoryRegion();
+  UnsafeSharedMemoryRegion region =
+      UnsafeSharedMemoryRegion::Create(sizeof(Header) + 2 * capacity);
+  if (!region.IsValid())
+    return region;
+  WritableSharedMemoryMapping mapping = region.MapAt(0, sizeof(Header));
+  if (!mapping.IsValid())
+    return UnsafeSharedMemoryRegion();
+  static_cast<Header*>(mapping.memory())->capacity =
+      static_cast<uint32_t>(capacity);
+  return region;
+}
+
+bool SharedMemorySyncChannel::Initialize(
+    const UnsafeSharedMemoryRegion& region,
+    Side side) {
+  DCHECK(!IsValid());
+  if (!region.IsValid() || region.GetSize() < sizeof(Header))
+    return false;
+  WritableSharedMemoryMapping mapping = region.Map();
+  if (!mapping.IsValid())
+    return false;
+
+  // The region may come from another process, so check the capacity before
+  // relying on it.
+  Header* header = static_cast<Header*>(mapping.memory());
+  const size_t capacity = header->capacity;
+  if (!bits::IsPowerOfTwo(capacity) || capacity > kMaxCapacity ||
+      mapping.size() < sizeof(Header) + 2 * capacity) {
+    return false;
+  }
+
+  const size_t send_index = side == Side::kA ? 0 : 1;
+  const size_t receive_index = 1 - send_index;
+  uint8_t* data = static_cast<uint8_t*>(mapping.memory()) + sizeof(Header);
+  header_ = header;
+  send_ring_ = &header->rings[send_index];
+  receive_ring_ = &header->rings[receive_index];
+  send_data_ = data + send_index * capacity;
+  receive_data_ = data + receive_index * capacity;
+  capacity_ = capacity;
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+// static
+bool SharedMemorySyncChannel::CreatePair(size_t capacity,
+                                         SharedMemorySyncChannel* channel_a,
+                                         SharedMemorySyncChannel* channel_b) {
+  DCHECK_NE(channel_a, channel_b);
+  UnsafeSharedMemoryRegion region = CreateRegion(capacity);
+  return region.IsValid() && channel_a->Initialize(region, Side::kA) &&
+         channel_b->Initialize(region, Side::kB);
+}
+
+size_t SharedMemorySyncChannel::Send(const void* buffer, size_t length) {
+  DCHECK(IsValid());
+  const uint8_t* in = static_cast<const uint8_t*>(buffer);
+  const uint32_t mask = static_cast<uint32_t>(capacity_ - 1);
+  Ring* ring = send_ring_;
+  size_t sent = 0;
+  while (sent < length) {
+    const uint32_t write = ring->write_position.load(std::memory_order_relaxed);
+    const uint32_t read = ring->read_position.load(std::memory_order_acquire);
+    // Don't trust the other side to keep the positions consistent.
+    const size_t used = std::min<size_t>(write - read, capacity_);
+    const size_t space = capacity_ - used;
+    if (!space) {
+      if (header_->closed.load(std::memory_order_relaxed))
+        break;
+      ring->writer_waiting.store(1, std::memory_order_seq_cst);
+      const uint32_t generation = ring->writer_futex.load();
+      if (ring->read_position.load() == read && !header_->closed.load())
+        FutexWait(&ring->writer_futex, generation, TimeTicks::Max());
+      ring->writer_waiting.store(0, std::memory_order_relaxed);
+      continue;
+    }
+    if (header_->closed.load(std::memory_order_relaxed))
+      break;
+
+    const size_t count = std::min(space, length - sent);
+    const size_t offset = write & mask;
+    const size_t first = std::min(count, capacity_ - offset);
+    memcpy(send_data_ + offset, in + sent, first);
+    memcpy(send_data_, in + sent + first, count - first);
+    ring->write_position.store(write + static_cast<uint32_t>(count),
+                               std::memory_order_seq_cst);
+    if (ring->reader_waiting.load() &&
+        ring->reader_waiting.exchange(0, std::memory_order_relaxed)) {
+      FutexWake(&ring->reader_futex);
+    }
+    sent += count;
+  }
+  return sent;
+}
+
+size_t SharedMemorySyncChannel::Receive(void* buffer, size_t length) {
+  return ReceiveWithTimeout(buffer, length, TimeDelta::Max());
+}
+
+size_t SharedMemorySyncChannel::ReceiveWithTimeout(void* buffer,
+                                                   size_t length,
+                                                   TimeDelta timeout) {
+  DCHECK(IsValid());
+  const TimeTicks deadline =
+      timeout.is_max() ? TimeTicks::Max() : TimeTicks::Now() + timeout;
+  uint8_t* out = static_cast<uint8_t*>(buffer);
+  const uint32_t mask = static_cast<uint32_t>(capacity_ - 1);
+  Ring* ring = receive_ring_;
+  size_t received = 0;
+  while (received < length) {
+    const uint32_t read = ring->read_position.load(std::memory_order_relaxed);
+    const uint32_t write = ring->write_position.load(std::memory_order_acquire);
+    const size_t available = std::min<size_t>(write - read, capacity_);
+    if (!available) {
+      if (header_->closed.load(std::memory_order_relaxed) ||
+          (!deadline.is_max() && TimeTicks::Now() >= deadline)) {
+        break;
+      }
+      ring->reader_waiting.store(1, std::memory_order_seq_cst);
+      const uint32_t generation = ring->reader_futex.load();
+      if (ring->write_position.load() == write && !header_->closed.load())
+        FutexWait(&ring->reader_futex, generation, deadline);
+      ring->reader_waiting.store(0, std::memory_order_relaxed);
+      continue;
+    }
+
+    const size_t count = std::min(available, length - received);
+    const size_t offset = read & mask;
+    const size_t first = std::min(count, capacity_ - offset);
+    memcpy(out + received, receive_data_ + offset, first);
+    memcpy(out + received + first, receive_data_, count - first);
+    ring->read_position.store(read + static_cast<uint32_t>(count),
+                              std::memory_order_seq_cst);
+    if (ring->writer_waiting.load() &&
+        ring->writer_waiting.exchange(0, std::memory_order_relaxed)) {
+      FutexWake(&ring->writer_futex);
+    }
+    received += count;
+  }
+  return received;
+}
+
+size_t SharedMemorySyncChannel::Peek() {
+  DCHECK(IsValid());
+  const uint32_t read =
+      receive_ring_->read_position.load(std::memory_order_relaxed);
+  const uint32_t write =
+      receive_ring_->write_position.load(std::memory_order_acquire);
+  return std::min<size_t>(write - read, capacity_);
+}
+
+void SharedMemorySyncChannel::Close() {
+  DCHECK(IsValid());
+  header_->closed.store(1, std::memory_order_seq_cst);
+  for (Ring& ring : header_->rings) {
+    FutexWake(&ring.reader_futex);
+    FutexWake(&ring.writer_futex);
+  }
+}
+
+}  // namespace base
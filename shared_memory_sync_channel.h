@@ -0,0 +1,95 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SHARED_MEMORY_SYNC_CHANNEL_H_
+#define BASE_SHARED_MEMORY_SYNC_CHANNEL_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// A drop-in alternative to SyncSocket for high-rate producer/consumer
+// pipelines, such as real-time audio. Data goes through a pair of
+// single-producer, single-consumer ring buffers in shared memory, one per
+// direction, so a Send() or Receive() which doesn't have to wait makes no
+// syscalls. A side only wakes its peer with a futex when the peer is actually
+// sleeping on an empty or full ring.
+//
+// Like SyncSocket, each side may be used by one sending and one receiving
+// thread at a time. Send() and Receive() block until all of the data is
+// transferred or the channel is closed. The region can be sent to another
+// process, which maps the other side of the channel with Initialize().
+//
+// Only available on Linux, ChromeOS and Android.
+class BASE_EXPORT SharedMemorySyncChannel {
+ public:
+  enum class Side { kA, kB };
+
+  SharedMemorySyncChannel();
+  SharedMemorySyncChannel(const SharedMemorySyncChannel&) = delete;
+  SharedMemorySyncChannel& operator=(const SharedMemorySyncChannel&) = delete;
+  // Closes the channel.
+  ~SharedMemorySyncChannel();
+
+  // Creates a region for a channel with rings of |capacity| bytes each, which
+  // must be a power of two no larger than 1GiB. Returns an invalid region on
+  // failure.
+  static UnsafeSharedMemoryRegion CreateRegion(size_t capacity);
+
+  // Maps |region|, which was created with CreateRegion(), as the |side| of a
+  // channel. Returns false on failure.
+  bool Initialize(const UnsafeSharedMemoryRegion& region, Side side);
+
+  // Creates a channel with rings of |capacity| bytes and initializes both of
+  // its sides. |channel_a| and |channel_b| must not be initialized yet.
+  static bool CreatePair(size_t capacity,
+                         SharedMemorySyncChannel* channel_a,
+                         SharedMemorySyncChannel* channel_b);
+
+  // Sends |length| bytes of |buffer| to the other side, waiting for space in
+  // the ring as needed. Returns the number of bytes sent, which is less than
+  // |length| only if the channel was closed.
+  size_t Send(const void* buffer, size_t length);
+
+  // Receives |length| bytes into |buffer|, waiting for data as needed. Returns
+  // the number of bytes received, which is less than |length| only if the
+  // channel was closed.
+  size_t Receive(void* buffer, size_t length);
+
+  // Same as Receive() but only waits for data until |timeout| has elapsed.
+  size_t ReceiveWithTimeout(void* buffer, size_t length, TimeDelta timeout);
+
+  // Returns the number of bytes which can be received without waiting.
+  size_t Peek();
+
+  // Closes the channel for both sides and wakes up any waiting Send() or
+  // Receive() calls, which then return what they have transferred. May be
+  // called from any thread. Data which was already sent can still be
+  // received.
+  void Close();
+
+  bool IsValid() const { return mapping_.IsValid(); }
+
+ private:
+  struct Ring;
+  struct Header;
+
+  WritableSharedMemoryMapping mapping_;
+  Header* header_ = nullptr;
+  // The ring this side sends to, and the ring it receives from.
+  Ring* send_ring_ = nullptr;
+  Ring* receive_ring_ = nullptr;
+  uint8_t* send_data_ = nullptr;
+  uint8_t* receive_data_ = nullptr;
+  size_t capacity_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_SHARED_MEMORY_SYNC_CHANNEL_H_
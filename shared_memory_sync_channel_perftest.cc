@@ -0,0 +1,113 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_sync_channel.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/sync_socket.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixSyncChannel[] = "SyncChannel.";
+constexpr char kMetricRoundTripLatency[] = "round_trip_latency";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr char kStorySyncSocket[] = "sync_socket";
+constexpr char kStorySharedMemory[] = "shared_memory";
+
+// Roughly one buffer of 10ms audio at 48kHz in floats.
+constexpr size_t kMessageSize = 4 * 480;
+constexpr size_t kCapacity = 16 * 1024;
+constexpr int kRoundTrips = 20000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixSyncChannel,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricRoundTripLatency, "us");
+  reporter.RegisterImportantMetric(kMetricThroughput, "messages/s");
+  return reporter;
+}
+
+// Sends back every message it receives, until the channel is closed.
+template <typename Channel>
+class Echo : public DelegateSimpleThread::Delegate {
+ public:
+  explicit Echo(Channel* channel) : channel_(channel) {}
+
+  void Run() override {
+    uint8_t buffer[kMessageSize];
+    while (channel_->Receive(buffer, sizeof(buffer)) == sizeof(buffer) &&
+           channel_->Send(buffer, sizeof(buffer)) == sizeof(buffer)) {
+    }
+  }
+
+ private:
+  Channel* const channel_;
+};
+
+// Measures the round trip latency of a message between |channel| and the
+// echoing |peer|, and then the throughput of one-way messages to it.
+template <typename Channel>
+void RunTest(Channel* channel, Channel* peer, const char* story_name) {
+  Echo<Channel> echo(peer);
+  DelegateSimpleThread thread(&echo, "Echo");
+  thread.Start();
+
+  uint8_t buffer[kMessageSize] = {};
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kRoundTrips; ++i) {
+    ASSERT_EQ(sizeof(buffer), channel->Send(buffer, sizeof(buffer)));
+    ASSERT_EQ(sizeof(buffer), channel->Receive(buffer, sizeof(buffer)));
+  }
+  const TimeDelta round_trips = TimeTicks::Now() - start;
+
+  // Pipelined: keep a few messages in flight.
+  constexpr int kInFlight = 4;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kInFlight; ++i)
+    ASSERT_EQ(sizeof(buffer), channel->Send(buffer, sizeof(buffer)));
+  for (int i = kInFlight; i < kRoundTrips; ++i) {
+    ASSERT_EQ(sizeof(buffer), channel->Receive(buffer, sizeof(buffer)));
+    ASSERT_EQ(sizeof(buffer), channel->Send(buffer, sizeof(buffer)));
+  }
+  for (int i = 0; i < kInFlight; ++i)
+    ASSERT_EQ(sizeof(buffer), channel->Receive(buffer, sizeof(buffer)));
+  const TimeDelta pipelined = TimeTicks::Now() - start;
+
+  // The echoing side sees the channel closed and returns.
+  channel->Close();
+  thread.Join();
+
+  auto reporter = SetUpReporter(story_name);
+  reporter.AddResult(kMetricRoundTripLatency,
+                     round_trips.InMicrosecondsF() / kRoundTrips);
+  reporter.AddResult(kMetricThroughput, kRoundTrips / pipelined.InSecondsF());
+}
+
+}  // namespace
+
+TEST(SyncChannelPerfTest, SyncSocket) {
+  CancelableSyncSocket socket_a;
+  CancelableSyncSocket socket_b;
+  ASSERT_TRUE(CancelableSyncSocket::CreatePair(&socket_a, &socket_b));
+  RunTest(&socket_a, &socket_b, kStorySyncSocket);
+}
+
+TEST(SyncChannelPerfTest, SharedMemory) {
+  SharedMemorySyncChannel channel_a;
+  SharedMemorySyncChannel channel_b;
+  ASSERT_TRUE(
+      SharedMemorySyncChannel::CreatePair(kCapacity, &channel_a, &channel_b));
+  RunTest(&channel_a, &channel_b, kStorySharedMemory);
+}
+
+}  // namespace base
@@ -0,0 +1,168 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_sync_channel.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kCapacity = 64;
+
+std::vector<uint8_t> MakeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(i * 7);
+  return data;
+}
+
+// Sends |data| in odd-sized messages, so that the copies straddle the end of
+// the ring.
+class Sender : public DelegateSimpleThread::Delegate {
+ public:
+  Sender(SharedMemorySyncChannel* channel, const std::vector<uint8_t>& data)
+      : channel_(channel), data_(data) {}
+
+  void Run() override {
+    for (size_t i = 0; i < data_.size(); i += 13) {
+      const size_t length = std::min<size_t>(13, data_.size() - i);
+      EXPECT_EQ(length, channel_->Send(&data_[i], length));
+    }
+  }
+
+ private:
+  SharedMemorySyncChannel* const channel_;
+  const std::vector<uint8_t>& data_;
+};
+
+// Receives an int, of which only two bytes are ever sent.
+class HangingReceiver : public DelegateSimpleThread::Delegate {
+ public:
+  explicit HangingReceiver(SharedMemorySyncChannel* channel)
+      : channel_(channel) {}
+
+  void Run() override {
+    started_.Signal();
+    int data = 0;
+    EXPECT_EQ(sizeof(int16_t), channel_->Receive(&data, sizeof(data)));
+  }
+
+  WaitableEvent* started() { return &started_; }
+
+ private:
+  SharedMemorySyncChannel* const channel_;
+  WaitableEvent started_;
+};
+
+}  // namespace
+
+TEST(SharedMemorySyncChannelTest, SendReceivePeek) {
+  SharedMemorySyncChannel channel_a;
+  SharedMemorySyncChannel channel_b;
+  ASSERT_TRUE(
+      SharedMemorySyncChannel::CreatePair(kCapacity, &channel_a, &channel_b));
+
+  const int kSending = 123;
+  int received = 0;
+  EXPECT_EQ(0u, channel_a.Peek());
+  EXPECT_EQ(0u, channel_b.Peek());
+
+  EXPECT_EQ(sizeof(kSending), channel_a.Send(&kSending, sizeof(kSending)));
+  EXPECT_EQ(0u, channel_a.Peek());
+  EXPECT_EQ(sizeof(kSending), channel_b.Peek());
+  EXPECT_EQ(sizeof(received), channel_b.Receive(&received, sizeof(received)));
+  EXPECT_EQ(kSending, received);
+  EXPECT_EQ(0u, channel_b.Peek());
+
+  EXPECT_EQ(sizeof(kSending), channel_b.Send(&kSending, sizeof(kSending)));
+  received = 0;
+  EXPECT_EQ(sizeof(received), channel_a.Receive(&received, sizeof(received)));
+  EXPECT_EQ(kSending, received);
+}
+
+// Sending more than fits in the ring waits for the other side to receive.
+TEST(SharedMemorySyncChannelTest, SendWrapsAround) {
+  SharedMemorySyncChannel channel_a;
+  SharedMemorySyncChannel channel_b;
+  ASSERT_TRUE(
+      SharedMemorySyncChannel::CreatePair(kCapacity, &channel_a, &channel_b));
+
+  const std::vector<uint8_t> data = MakeData(100 * kCapacity + 3);
+  Sender sender(&channel_a, data);
+  DelegateSimpleThread thread(&sender, "Sender");
+  thread.Start();
+
+  std::vector<uint8_t> received(data.size());
+  EXPECT_EQ(received.size(),
+            channel_b.Receive(received.data(), received.size()));
+  thread.Join();
+  EXPECT_EQ(data, received);
+}
+
+TEST(SharedMemorySyncChannelTest, ReceiveWithTimeout) {
+  SharedMemorySyncChannel channel_a;
+  SharedMemorySyncChannel channel_b;
+  ASSERT_TRUE(
+      SharedMemorySyncChannel::CreatePair(kCapacity, &channel_a, &channel_b));
+
+  int received = 0;
+  const TimeTicks start = TimeTicks::Now();
+  EXPECT_EQ(0u, channel_b.ReceiveWithTimeout(
+                    &received, sizeof(received),
+                    TimeDelta::FromMilliseconds(50)));
+  EXPECT_GE(TimeTicks::Now() - start, TimeDelta::FromMilliseconds(50));
+
+  // Partial data is returned once the timeout has elapsed.
+  const int16_t kSending = 42;
+  ASSERT_EQ(sizeof(kSending), channel_a.Send(&kSending, sizeof(kSending)));
+  EXPECT_EQ(sizeof(kSending),
+            channel_b.ReceiveWithTimeout(&received, sizeof(received),
+                                         TimeDelta::FromMilliseconds(10)));
+}
+
+// Closing the channel wakes up a blocked Receive(), but data which was sent
+// before can still be received.
+TEST(SharedMemorySyncChannelTest, CloseWakesReceive) {
+  SharedMemorySyncChannel channel_a;
+  SharedMemorySyncChannel channel_b;
+  ASSERT_TRUE(
+      SharedMemorySyncChannel::CreatePair(kCapacity, &channel_a, &channel_b));
+
+  HangingReceiver receiver(&channel_b);
+  DelegateSimpleThread thread(&receiver, "Receiver");
+
+  const int16_t kSending = 42;
+  ASSERT_EQ(sizeof(kSending), channel_a.Send(&kSending, sizeof(kSending)));
+  thread.Start();
+  receiver.started()->Wait();
+  PlatformThread::Sleep(TimeDelta::FromMilliseconds(10));
+  channel_a.Close();
+  thread.Join();
+
+  EXPECT_EQ(0u, channel_a.Send(&kSending, sizeof(kSending)));
+}
+
+TEST(SharedMemorySyncChannelTest, InvalidRegions) {
+  EXPECT_FALSE(SharedMemorySyncChannel::CreateRegion(0).IsValid());
+  EXPECT_FALSE(SharedMemorySyncChannel::CreateRegion(100).IsValid());
+
+  // A region which wasn't created for a channel has no capacity.
+  SharedMemorySyncChannel channel;
+  EXPECT_FALSE(channel.Initialize(UnsafeSharedMemoryRegion::Create(4096),
+                                  SharedMemorySyncChannel::Side::kA));
+  EXPECT_FALSE(channel.IsValid());
+}
+
+}  // namespace base
@@ -25,6 +25,7 @@
 #include "base/no_destructor.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util_internal.h"
+#include "base/strings/utf8_validation.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/third_party/icu/icu_utf.h"
@@ -259,11 +260,13 @@ bool IsStringASCII(WStringPiece str) {
 #endif
 
 bool IsStringUTF8(StringPiece str) {
-  return internal::DoIsStringUTF8<IsValidCharacter>(str);
+  return internal::ValidateUTF8(str.data(), str.size(),
+                                internal::UTF8Noncharacters::kReject);
 }
 
 bool IsStringUTF8AllowingNoncharacters(StringPiece str) {
-  return internal::DoIsStringUTF8<IsValidCodepoint>(str);
+  return internal::ValidateUTF8(str.data(), str.size(),
+                                internal::UTF8Noncharacters::kAllow);
 }
 
 bool LowerCaseEqualsASCII(StringPiece str, StringPiece lowercase_ascii) {
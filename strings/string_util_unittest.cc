@@ -518,6 +518,55 @@ TEST(StringUtilTest, IsStringUTF8) {
   }
 }
 
+TEST(StringUtilTest, IsStringUTF8LongStrings) {
+  // Long strings are validated many bytes at a time, so check that errors are
+  // found wherever they are relative to the block boundaries.
+  std::string valid;
+  for (int i = 0; i < 8; ++i)
+    valid += "a\xC2\x81\xE1\x80\xBF\xF1\x80\xA0\xBF";
+  const char* const kInvalid[] = {
+      "\x80",                  // Stray continuation byte
+      "\xC0\x80",              // Overlong
+      "\xC2",                  // Truncated
+      "\xE1\x80",              // Truncated
+      "\xED\xA0\x80",          // Surrogate
+      "\xF1\x80\xA0",          // Truncated
+      "\xF4\x90\x80\x80",      // U+110000
+      "\xF8\x88\x80\x80\x80",  // 5 bytes
+  };
+  const char* const kNoncharacters[] = {
+      "\xEF\xB7\x90",      // U+FDD0
+      "\xEF\xB7\xAF",      // U+FDEF
+      "\xEF\xBF\xBE",      // U+FFFE
+      "\xF0\x9F\xBF\xBF",  // U+01FFFF
+      "\xF4\x8F\xBF\xBE",  // U+10FFFE
+  };
+
+  for (size_t padding = 0; padding <= 64; ++padding) {
+    SCOPED_TRACE(padding);
+    const std::string ascii(padding, 'a');
+    EXPECT_TRUE(IsStringUTF8(ascii + valid + ascii));
+
+    for (const char* invalid : kInvalid) {
+      SCOPED_TRACE(invalid);
+      EXPECT_FALSE(IsStringUTF8(ascii + invalid + valid));
+      EXPECT_FALSE(IsStringUTF8(valid + ascii + invalid));
+      EXPECT_FALSE(IsStringUTF8AllowingNoncharacters(ascii + invalid + valid));
+      EXPECT_FALSE(IsStringUTF8AllowingNoncharacters(valid + ascii + invalid));
+    }
+
+    for (const char* noncharacter : kNoncharacters) {
+      SCOPED_TRACE(noncharacter);
+      EXPECT_FALSE(IsStringUTF8(ascii + noncharacter + valid));
+      EXPECT_FALSE(IsStringUTF8(valid + ascii + noncharacter));
+      EXPECT_TRUE(
+          IsStringUTF8AllowingNoncharacters(ascii + noncharacter + valid));
+      EXPECT_TRUE(
+          IsStringUTF8AllowingNoncharacters(valid + ascii + noncharacter));
+    }
+  }
+}
+
 TEST(StringUtilTest, IsStringASCII) {
   static char char_ascii[] =
       "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
@@ -0,0 +1,456 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/utf8_validation.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/strings/string_util_internal.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+// The x86 kernels are compiled with function-level target attributes, so that
+// the rest of the file still runs on CPUs without the extensions. NaCl builds
+// have no base::CPU.
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL) && \
+    (defined(COMPILER_GCC) || defined(__clang__))
+#define UTF8_HAS_X86_KERNELS
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#endif
+
+// NEON is always available on ARM64.
+#if defined(ARCH_CPU_ARM64)
+#define UTF8_HAS_NEON_KERNEL
+#include <arm_neon.h>
+#endif
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Returns true if the |size| bytes at |data| are valid. The bool template
+// parameter of each kernel is whether noncharacters are rejected.
+using ValidateFunction = bool (*)(const char* data, size_t size);
+
+template <bool kRejectNoncharacters>
+bool ValidatePortable(const char* data, size_t size) {
+  const StringPiece str(data, size);
+  return kRejectNoncharacters ? DoIsStringUTF8<IsValidCharacter>(str)
+                              : DoIsStringUTF8<IsValidCodepoint>(str);
+}
+
+#if defined(UTF8_HAS_X86_KERNELS) || defined(UTF8_HAS_NEON_KERNEL)
+
+// The vector kernels look at each byte together with the one before it. The
+// errors which such a pair can be part of are looked up in three tables,
+// indexed by the high and low nibbles of the first byte and the high nibble of
+// the second. The pair is invalid if all three entries have a bit in common.
+constexpr uint8_t kTooShort = 1 << 0;   // 11______ 0_______, 11______ 11______
+constexpr uint8_t kTooLong = 1 << 1;    // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;  // 11100000 100_____
+// 11110100 1001____, 11110100 101_____, 11110101+ 1001____,
+// 11110101+ 101_____
+constexpr uint8_t kTooLarge = 1 << 3;
+constexpr uint8_t kSurrogate = 1 << 4;  // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;  // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101+ 1000____
+constexpr uint8_t kOverlong4 = 1 << 6;     // 11110000 1000____
+// Two continuation bytes in a row are only valid as the second and third, or
+// third and fourth bytes of a character. This bit is set for every such pair,
+// and cancelled out for those in the right place by looking two and three
+// bytes back for lead bytes.
+constexpr uint8_t kTwoContinuations = 1 << 7;  // 10______ 10______
+// The errors which only depend on the high nibble of the first byte.
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+alignas(16) constexpr uint8_t kFirstHighNibbleErrors[16] = {
+    // 0_______: ASCII.
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTooLong,
+    // 10______: continuation byte.
+    kTwoContinuations, kTwoContinuations, kTwoContinuations,
+    kTwoContinuations,
+    // 1100____: lead byte of a two byte character.
+    kTooShort | kOverlong2,
+    // 1101____: lead byte of a two byte character.
+    kTooShort,
+    // 1110____: lead byte of a three byte character.
+    kTooShort | kOverlong3 | kSurrogate,
+    // 1111____: lead byte of a four byte character, or invalid.
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+alignas(16) constexpr uint8_t kFirstLowNibbleErrors[16] = {
+    // ____0000
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    // ____0001
+    kCarry | kOverlong2,
+    // ____001_
+    kCarry,
+    kCarry,
+    // ____0100
+    kCarry | kTooLarge,
+    // ____0101 to ____1100
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    // ____1101
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    // ____111_
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+alignas(16) constexpr uint8_t kSecondHighNibbleErrors[16] = {
+    // 0_______: ASCII.
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort,
+    // 1000____
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 |
+        kOverlong4,
+    // 1001____
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,
+    // 101_____
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    // 11______: lead byte.
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+
+// A block is incomplete if one of its last three bytes is greater than the
+// corresponding entry here, i.e. it is the lead byte of a character which
+// continues into the next block. The 16-byte kernels use the last 16 entries.
+alignas(32) constexpr uint8_t kIncompleteLimits[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+// Bytes two and three back which are at least these must be followed by a
+// continuation byte. Subtracting them with saturation sets the top bit.
+constexpr uint8_t kThirdByteOffset = 0xE0 - 0x80;
+constexpr uint8_t kFourthByteOffset = 0xF0 - 0x80;
+
+#endif  // defined(UTF8_HAS_X86_KERNELS) || defined(UTF8_HAS_NEON_KERNEL)
+
+#if defined(UTF8_HAS_X86_KERNELS)
+
+__attribute__((target("sse4.1"), always_inline)) inline __m128i Set1Sse41(
+    uint8_t value) {
+  return _mm_set1_epi8(static_cast<char>(value));
+}
+
+// Returns a mask of the bytes of |input| which end a noncharacter, given the
+// three bytes before each.
+__attribute__((target("sse4.1"), always_inline)) inline __m128i
+FindNoncharactersSse41(__m128i input,
+                       __m128i prev1,
+                       __m128i prev2,
+                       __m128i prev3) {
+  // U+FDD0 to U+FDEF are EF B7 90 to EF B7 AF.
+  const __m128i after_ef = _mm_cmpeq_epi8(prev2, Set1Sse41(0xEF));
+  const __m128i from_90 = _mm_sub_epi8(input, Set1Sse41(0x90));
+  const __m128i fdd0 = _mm_and_si128(
+      _mm_and_si128(after_ef, _mm_cmpeq_epi8(prev1, Set1Sse41(0xB7))),
+      _mm_cmpeq_epi8(_mm_min_epu8(from_90, Set1Sse41(0x1F)), from_90));
+  // U+xFFFE and U+xFFFF end in BF BE or BF BF, after EF in the BMP, or after a
+  // ____1111 continuation byte of a four byte character.
+  const __m128i four_byte = _mm_and_si128(
+      _mm_cmpeq_epi8(_mm_max_epu8(prev3, Set1Sse41(0xF0)), prev3),
+      _mm_cmpeq_epi8(_mm_and_si128(prev2, Set1Sse41(0x0F)), Set1Sse41(0x0F)));
+  const __m128i fffe = _mm_and_si128(
+      _mm_and_si128(_mm_cmpeq_epi8(prev1, Set1Sse41(0xBF)),
+                    _mm_cmpeq_epi8(_mm_or_si128(input, Set1Sse41(0x01)),
+                                   Set1Sse41(0xBF))),
+      _mm_or_si128(after_ef, four_byte));
+  return _mm_or_si128(fdd0, fffe);
+}
+
+template <bool kRejectNoncharacters>
+__attribute__((target("sse4.1"))) bool ValidateSse41(const char* data,
+                                                     size_t size) {
+  const __m128i first_high_errors = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kFirstHighNibbleErrors));
+  const __m128i first_low_errors = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kFirstLowNibbleErrors));
+  const __m128i second_high_errors = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kSecondHighNibbleErrors));
+  const __m128i incomplete_limits = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kIncompleteLimits + 16));
+  const __m128i low_nibble = Set1Sse41(0x0F);
+
+  __m128i prev = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+  __m128i error = _mm_setzero_si128();
+  for (size_t offset = 0; offset < size; offset += 16) {
+    __m128i input;
+    if (size - offset >= 16) {
+      input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    } else {
+      // Pad the last block with NULs, which are valid.
+      alignas(16) char last_block[16] = {};
+      memcpy(last_block, data + offset, size - offset);
+      input = _mm_load_si128(reinterpret_cast<const __m128i*>(last_block));
+    }
+
+    if (!_mm_movemask_epi8(input)) {
+      // An ASCII block is valid unless the last one ended mid-character.
+      error = _mm_or_si128(error, prev_incomplete);
+    } else {
+      const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+      const __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+      const __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+      const __m128i pair_errors = _mm_and_si128(
+          _mm_and_si128(
+              _mm_shuffle_epi8(first_high_errors,
+                               _mm_and_si128(_mm_srli_epi16(prev1, 4),
+                                             low_nibble)),
+              _mm_shuffle_epi8(first_low_errors,
+                               _mm_and_si128(prev1, low_nibble))),
+          _mm_shuffle_epi8(second_high_errors,
+                           _mm_and_si128(_mm_srli_epi16(input, 4),
+                                         low_nibble)));
+      const __m128i must_continue = _mm_and_si128(
+          _mm_or_si128(_mm_subs_epu8(prev2, Set1Sse41(kThirdByteOffset)),
+                       _mm_subs_epu8(prev3, Set1Sse41(kFourthByteOffset))),
+          Set1Sse41(0x80));
+      error = _mm_or_si128(error, _mm_xor_si128(must_continue, pair_errors));
+      if (kRejectNoncharacters) {
+        error = _mm_or_si128(
+            error, FindNoncharactersSse41(input, prev1, prev2, prev3));
+      }
+      prev_incomplete = _mm_subs_epu8(input, incomplete_limits);
+      if (!_mm_testz_si128(error, error))
+        return false;
+    }
+    prev = input;
+  }
+  error = _mm_or_si128(error, prev_incomplete);
+  return _mm_testz_si128(error, error);
+}
+
+__attribute__((target("avx2"), always_inline)) inline __m256i Set1Avx2(
+    uint8_t value) {
+  return _mm256_set1_epi8(static_cast<char>(value));
+}
+
+__attribute__((target("avx2"), always_inline)) inline __m256i
+BroadcastTableAvx2(const uint8_t* table) {
+  return _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// Returns |input| shifted |N| bytes later, with the last |N| bytes of |prev|
+// shifted in.
+template <int N>
+__attribute__((target("avx2"), always_inline)) inline __m256i PrevAvx2(
+    __m256i input,
+    __m256i prev) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+// Like FindNoncharactersSse41().
+__attribute__((target("avx2"), always_inline)) inline __m256i
+FindNoncharactersAvx2(__m256i input,
+                      __m256i prev1,
+                      __m256i prev2,
+                      __m256i prev3) {
+  const __m256i after_ef = _mm256_cmpeq_epi8(prev2, Set1Avx2(0xEF));
+  const __m256i from_90 = _mm256_sub_epi8(input, Set1Avx2(0x90));
+  const __m256i fdd0 = _mm256_and_si256(
+      _mm256_and_si256(after_ef, _mm256_cmpeq_epi8(prev1, Set1Avx2(0xB7))),
+      _mm256_cmpeq_epi8(_mm256_min_epu8(from_90, Set1Avx2(0x1F)), from_90));
+  const __m256i four_byte = _mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_max_epu8(prev3, Set1Avx2(0xF0)), prev3),
+      _mm256_cmpeq_epi8(_mm256_and_si256(prev2, Set1Avx2(0x0F)),
+                        Set1Avx2(0x0F)));
+  const __m256i fffe = _mm256_and_si256(
+      _mm256_and_si256(_mm256_cmpeq_epi8(prev1, Set1Avx2(0xBF)),
+                       _mm256_cmpeq_epi8(_mm256_or_si256(input, Set1Avx2(0x01)),
+                                         Set1Avx2(0xBF))),
+      _mm256_or_si256(after_ef, four_byte));
+  return _mm256_or_si256(fdd0, fffe);
+}
+
+// Like ValidateSse41(), 32 bytes at a time.
+template <bool kRejectNoncharacters>
+__attribute__((target("avx2"))) bool ValidateAvx2(const char* data,
+                                                  size_t size) {
+  const __m256i first_high_errors = BroadcastTableAvx2(kFirstHighNibbleErrors);
+  const __m256i first_low_errors = BroadcastTableAvx2(kFirstLowNibbleErrors);
+  const __m256i second_high_errors =
+      BroadcastTableAvx2(kSecondHighNibbleErrors);
+  const __m256i incomplete_limits =
+      _mm256_load_si256(reinterpret_cast<const __m256i*>(kIncompleteLimits));
+  const __m256i low_nibble = Set1Avx2(0x0F);
+
+  __m256i prev = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+  __m256i error = _mm256_setzero_si256();
+  for (size_t offset = 0; offset < size; offset += 32) {
+    __m256i input;
+    if (size - offset >= 32) {
+      input =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+    } else {
+      alignas(32) char last_block[32] = {};
+      memcpy(last_block, data + offset, size - offset);
+      input = _mm256_load_si256(reinterpret_cast<const __m256i*>(last_block));
+    }
+
+    if (!_mm256_movemask_epi8(input)) {
+      error = _mm256_or_si256(error, prev_incomplete);
+    } else {
+      const __m256i prev1 = PrevAvx2<1>(input, prev);
+      const __m256i prev2 = PrevAvx2<2>(input, prev);
+      const __m256i prev3 = PrevAvx2<3>(input, prev);
+      const __m256i pair_errors = _mm256_and_si256(
+          _mm256_and_si256(
+              _mm256_shuffle_epi8(first_high_errors,
+                                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4),
+                                                   low_nibble)),
+              _mm256_shuffle_epi8(first_low_errors,
+                                  _mm256_and_si256(prev1, low_nibble))),
+          _mm256_shuffle_epi8(second_high_errors,
+                              _mm256_and_si256(_mm256_srli_epi16(input, 4),
+                                               low_nibble)));
+      const __m256i must_continue = _mm256_and_si256(
+          _mm256_or_si256(
+              _mm256_subs_epu8(prev2, Set1Avx2(kThirdByteOffset)),
+              _mm256_subs_epu8(prev3, Set1Avx2(kFourthByteOffset))),
+          Set1Avx2(0x80));
+      error = _mm256_or_si256(error,
+                              _mm256_xor_si256(must_continue, pair_errors));
+      if (kRejectNoncharacters) {
+        error = _mm256_or_si256(
+            error, FindNoncharactersAvx2(input, prev1, prev2, prev3));
+      }
+      prev_incomplete = _mm256_subs_epu8(input, incomplete_limits);
+      if (!_mm256_testz_si256(error, error))
+        return false;
+    }
+    prev = input;
+  }
+  error = _mm256_or_si256(error, prev_incomplete);
+  return _mm256_testz_si256(error, error);
+}
+
+#endif  // defined(UTF8_HAS_X86_KERNELS)
+
+#if defined(UTF8_HAS_NEON_KERNEL)
+
+// Like FindNoncharactersSse41().
+inline uint8x16_t FindNoncharactersNeon(uint8x16_t input,
+                                        uint8x16_t prev1,
+                                        uint8x16_t prev2,
+                                        uint8x16_t prev3) {
+  const uint8x16_t after_ef = vceqq_u8(prev2, vdupq_n_u8(0xEF));
+  const uint8x16_t fdd0 = vandq_u8(
+      vandq_u8(after_ef, vceqq_u8(prev1, vdupq_n_u8(0xB7))),
+      vcleq_u8(vsubq_u8(input, vdupq_n_u8(0x90)), vdupq_n_u8(0x1F)));
+  const uint8x16_t four_byte =
+      vandq_u8(vcgeq_u8(prev3, vdupq_n_u8(0xF0)),
+               vceqq_u8(vandq_u8(prev2, vdupq_n_u8(0x0F)), vdupq_n_u8(0x0F)));
+  const uint8x16_t fffe = vandq_u8(
+      vandq_u8(vceqq_u8(prev1, vdupq_n_u8(0xBF)),
+               vceqq_u8(vorrq_u8(input, vdupq_n_u8(0x01)), vdupq_n_u8(0xBF))),
+      vorrq_u8(after_ef, four_byte));
+  return vorrq_u8(fdd0, fffe);
+}
+
+// Like ValidateSse41().
+template <bool kRejectNoncharacters>
+bool ValidateNeon(const char* data, size_t size) {
+  const uint8x16_t first_high_errors = vld1q_u8(kFirstHighNibbleErrors);
+  const uint8x16_t first_low_errors = vld1q_u8(kFirstLowNibbleErrors);
+  const uint8x16_t second_high_errors = vld1q_u8(kSecondHighNibbleErrors);
+  const uint8x16_t incomplete_limits = vld1q_u8(kIncompleteLimits + 16);
+  const uint8x16_t low_nibble = vdupq_n_u8(0x0F);
+
+  uint8x16_t prev = vdupq_n_u8(0);
+  uint8x16_t prev_incomplete = vdupq_n_u8(0);
+  uint8x16_t error = vdupq_n_u8(0);
+  for (size_t offset = 0; offset < size; offset += 16) {
+    uint8x16_t input;
+    if (size - offset >= 16) {
+      input = vld1q_u8(reinterpret_cast<const uint8_t*>(data + offset));
+    } else {
+      uint8_t last_block[16] = {};
+      memcpy(last_block, data + offset, size - offset);
+      input = vld1q_u8(last_block);
+    }
+
+    if (vmaxvq_u8(input) < 0x80) {
+      error = vorrq_u8(error, prev_incomplete);
+    } else {
+      const uint8x16_t prev1 = vextq_u8(prev, input, 15);
+      const uint8x16_t prev2 = vextq_u8(prev, input, 14);
+      const uint8x16_t prev3 = vextq_u8(prev, input, 13);
+      const uint8x16_t pair_errors = vandq_u8(
+          vandq_u8(vqtbl1q_u8(first_high_errors, vshrq_n_u8(prev1, 4)),
+                   vqtbl1q_u8(first_low_errors, vandq_u8(prev1, low_nibble))),
+          vqtbl1q_u8(second_high_errors, vshrq_n_u8(input, 4)));
+      const uint8x16_t must_continue =
+          vandq_u8(vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(kThirdByteOffset)),
+                            vqsubq_u8(prev3, vdupq_n_u8(kFourthByteOffset))),
+                   vdupq_n_u8(0x80));
+      error = vorrq_u8(error, veorq_u8(must_continue, pair_errors));
+      if (kRejectNoncharacters) {
+        error = vorrq_u8(error,
+                         FindNoncharactersNeon(input, prev1, prev2, prev3));
+      }
+      prev_incomplete = vqsubq_u8(input, incomplete_limits);
+      if (vmaxvq_u8(error))
+        return false;
+    }
+    prev = input;
+  }
+  return !vmaxvq_u8(vorrq_u8(error, prev_incomplete));
+}
+
+#endif  // defined(UTF8_HAS_NEON_KERNEL)
+
+template <bool kRejectNoncharacters>
+ValidateFunction GetValidateFunction() {
+  static const ValidateFunction function = [] {
+#if defined(UTF8_HAS_X86_KERNELS)
+    const CPU cpu;
+    if (cpu.has_avx2())
+      return &ValidateAvx2<kRejectNoncharacters>;
+    if (cpu.has_sse41())
+      return &ValidateSse41<kRejectNoncharacters>;
+    return &ValidatePortable<kRejectNoncharacters>;
+#elif defined(UTF8_HAS_NEON_KERNEL)
+    return &ValidateNeon<kRejectNoncharacters>;
+#else
+    return &ValidatePortable<kRejectNoncharacters>;
+#endif
+  }();
+  return function;
+}
+
+}  // namespace
+
+bool ValidateUTF8(const char* data,
+                  size_t size,
+                  UTF8Noncharacters noncharacters) {
+  return noncharacters == UTF8Noncharacters::kReject
+             ? GetValidateFunction<true>()(data, size)
+             : GetValidateFunction<false>()(data, size);
+}
+
+}  // namespace internal
+}  // namespace base
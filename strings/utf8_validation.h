@@ -0,0 +1,40 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The UTF-8 validation kernel shared by base::IsStringUTF8() and
+// base::StreamingUtf8Validator. Use those instead of calling this directly.
+
+#ifndef BASE_STRINGS_UTF8_VALIDATION_H_
+#define BASE_STRINGS_UTF8_VALIDATION_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace internal {
+
+enum class UTF8Noncharacters {
+  kAllow,
+  // Also reject the noncharacters rejected by IsValidCharacter().
+  kReject,
+};
+
+// Returns true if the |size| bytes at |data| are a sequence of complete UTF-8
+// characters as defined by RFC 3629. That is, there are no overlong forms,
+// surrogates or code points above U+10FFFF, and the last character isn't
+// truncated.
+//
+// Large inputs are validated 16 or 32 bytes at a time with SIMD instructions
+// where the CPU supports them, by looking up the errors which each pair of
+// adjacent bytes could be part of (Keiser and Lemire, "Validating UTF-8 In
+// Less Than One Instruction Per Byte").
+BASE_EXPORT bool ValidateUTF8(const char* data,
+                              size_t size,
+                              UTF8Noncharacters noncharacters);
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_STRINGS_UTF8_VALIDATION_H_
@@ -103,7 +103,12 @@ class LazilyDeallocatedDeque {
   }
 
   // Assumed to be a common operation.
-  void push_back(T t) {
+  void push_back(T t) { emplace_back(std::move(t)); }
+
+  // Constructs the element directly in the ring, so large elements (e.g.
+  // Tasks) don't need to be relocated from a temporary on their way in.
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
     if (!head_) {
       DCHECK(!tail_);
       head_ = std::make_unique<Ring>(kMinimumRingSize);
@@ -123,8 +128,9 @@ class LazilyDeallocatedDeque {
       tail_ = tail_->next_.get();
     }
 
-    tail_->push_back(std::move(t));
+    T& result = tail_->emplace_back(std::forward<Args>(args)...);
     max_size_ = std::max(max_size_, ++size_);
+    return result;
   }
 
   T& front() {
@@ -262,10 +268,13 @@ class LazilyDeallocatedDeque {
       front_index_ = CircularDecrement(front_index_);
     }
 
-    void push_back(T&& t) {
+    void push_back(T&& t) { emplace_back(std::move(t)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
       back_index_ = CircularIncrement(back_index_);
       DCHECK(!empty());  // Mustn't appear to become empty.
-      new (&data_[back_index_]) T(std::move(t));
+      return *new (&data_[back_index_]) T(std::forward<Args>(args)...);
     }
 
     bool CanPop() const { return front_index_ != back_index_; }
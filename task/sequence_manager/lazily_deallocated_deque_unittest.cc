@@ -504,6 +504,53 @@ TEST_F(LazilyDeallocatedDequeTest, ExpectedNumberOfDestructorsCalled) {
   EXPECT_EQ(100, DestructorTestItem::destructor_count_);
 }
 
+namespace {
+
+class MoveCountingItem {
+ public:
+  MoveCountingItem(int v, int* move_count) : v_(v), move_count_(move_count) {}
+  MoveCountingItem(MoveCountingItem&& other)
+      : v_(other.v_), move_count_(other.move_count_) {
+    ++*move_count_;
+  }
+
+  int v_;
+  int* move_count_;
+};
+
+}  // namespace
+
+TEST_F(LazilyDeallocatedDequeTest, EmplaceBackConstructsInPlace) {
+  LazilyDeallocatedDeque<MoveCountingItem> d;
+  int move_count = 0;
+
+  for (int i = 0; i < 100; i++) {
+    MoveCountingItem& item = d.emplace_back(i, &move_count);
+    EXPECT_EQ(&item, &d.back());
+  }
+
+  // Growing the deque adds rings rather than relocating existing elements.
+  EXPECT_EQ(0, move_count);
+  EXPECT_EQ(100u, d.size());
+
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, d.front().v_);
+    d.pop_front();
+  }
+  EXPECT_EQ(0, move_count);
+}
+
+TEST_F(LazilyDeallocatedDequeTest, PushBackMovesOnce) {
+  LazilyDeallocatedDeque<MoveCountingItem> d;
+  int move_count = 0;
+
+  d.push_back(MoveCountingItem(1, &move_count));
+
+  // The temporary initializes the argument directly, which is then moved into
+  // the ring exactly once.
+  EXPECT_EQ(1, move_count);
+}
+
 }  // namespace internal
 }  // namespace sequence_manager
 }  // namespace base
@@ -50,6 +50,13 @@ SequenceManager::Settings::Builder::SetAddQueueTimeToTasks(
   return *this;
 }
 
+SequenceManager::Settings::Builder&
+SequenceManager::Settings::Builder::SetDeadlineSchedulingEnabled(
+    bool deadline_scheduling_val) {
+  settings_.deadline_scheduling = deadline_scheduling_val;
+  return *this;
+}
+
 #if DCHECK_IS_ON()
 
 SequenceManager::Settings::Builder&
@@ -95,6 +95,12 @@ class BASE_EXPORT SequenceManager {
     // If true, add the timestamp the task got queued to the task.
     bool add_queue_time_to_tasks = false;
 
+    // If true, tasks are given a deadline derived from the time they become
+    // ready to run and their queue's latency budget (see
+    // TaskQueue::SetLatencyBudget), and queues of the same priority are
+    // serviced earliest deadline first rather than oldest task first.
+    bool deadline_scheduling = false;
+
 #if DCHECK_IS_ON()
     // TODO(alexclarke): Consider adding command line flags to control these.
     enum class TaskLogging {
@@ -270,6 +276,10 @@ class BASE_EXPORT SequenceManager::Settings::Builder {
   // Whether or not queueing timestamp will be added to tasks.
   Builder& SetAddQueueTimeToTasks(bool add_queue_time_to_tasks);
 
+  // Whether or not queues of the same priority are serviced earliest deadline
+  // first.
+  Builder& SetDeadlineSchedulingEnabled(bool deadline_scheduling);
+
 #if DCHECK_IS_ON()
   // Controls task execution logging.
   Builder& SetTaskLogging(TaskLogging task_execution_logging);
@@ -656,10 +656,30 @@ Task* SequenceManagerImpl::SelectNextTaskImpl(SelectTaskOption option) {
         *main_thread_only().task_execution_stack.rbegin();
     NotifyWillProcessTask(&executing_task, &lazy_now);
 
+    if (UNLIKELY(settings_.deadline_scheduling))
+      MaybeReportDeadlineMiss(executing_task, &lazy_now);
+
     return &executing_task.pending_task;
   }
 }
 
+void SequenceManagerImpl::MaybeReportDeadlineMiss(
+    const ExecutingTask& executing_task,
+    LazyNow* time_before_task) {
+  // Tasks posted without a latency budget have their deadline set to the time
+  // they became ready, so only tasks given a budget can meaningfully miss it.
+  if (!executing_task.pending_task.has_latency_budget)
+    return;
+  const TimeDelta lateness =
+      time_before_task->Now() - executing_task.pending_task.deadline;
+  if (lateness <= TimeDelta())
+    return;
+  TRACE_EVENT_INSTANT2("sequence_manager", "DeadlineMissed",
+                       TRACE_EVENT_SCOPE_THREAD, "task_queue_name",
+                       executing_task.task_queue_name, "lateness_ms",
+                       lateness.InMillisecondsF());
+}
+
 bool SequenceManagerImpl::ShouldRunTaskOfPriority(
     TaskQueue::QueuePriority priority) const {
   return priority <= *main_thread_only().pending_native_work.begin();
@@ -341,6 +341,11 @@ class BASE_EXPORT SequenceManagerImpl
   void MoveReadyDelayedTasksToWorkQueues(LazyNow* lazy_now);
 
   void NotifyWillProcessTask(ExecutingTask* task, LazyNow* time_before_task);
+
+  // Emits a trace event if |executing_task| is starting after its deadline.
+  // Only called if deadline scheduling is enabled.
+  void MaybeReportDeadlineMiss(const ExecutingTask& executing_task,
+                               LazyNow* time_before_task);
   void NotifyDidProcessTask(ExecutingTask* task, LazyNow* time_after_task);
 
   EnqueueOrder GetNextSequenceNumber();
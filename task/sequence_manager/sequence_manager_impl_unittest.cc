@@ -3975,6 +3975,105 @@ TEST(SequenceManagerBasicTest, DefaultTaskRunnerSupport) {
   DCHECK_EQ(original_task_runner, ThreadTaskRunnerHandle::Get());
 }
 
+TEST(SequenceManagerBasicTest, DeadlineSchedulingRunsEarliestDeadlineFirst) {
+  SimpleTestTickClock clock;
+  clock.Advance(TimeDelta::FromMilliseconds(1));
+  auto manager = CreateSequenceManagerOnCurrentThreadWithPump(
+      MessagePump::Create(MessagePumpType::DEFAULT),
+      SequenceManager::Settings::Builder()
+          .SetTickClock(&clock)
+          .SetDeadlineSchedulingEnabled(true)
+          .Build());
+  auto relaxed_queue = manager->CreateTaskQueue(TaskQueue::Spec("relaxed"));
+  auto urgent_queue = manager->CreateTaskQueue(TaskQueue::Spec("urgent"));
+  relaxed_queue->SetLatencyBudget(TimeDelta::FromMilliseconds(100));
+  urgent_queue->SetLatencyBudget(TimeDelta::FromMilliseconds(10));
+
+  std::vector<EnqueueOrder> run_order;
+  relaxed_queue->task_runner()->PostTask(FROM_HERE,
+                                         BindOnce(&TestTask, 1, &run_order));
+  clock.Advance(TimeDelta::FromMilliseconds(50));
+  relaxed_queue->task_runner()->PostTask(FROM_HERE,
+                                         BindOnce(&TestTask, 2, &run_order));
+  urgent_queue->task_runner()->PostTask(FROM_HERE,
+                                        BindOnce(&TestTask, 3, &run_order));
+
+  // Deadlines are 101ms, 151ms and 61ms respectively.
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(3u, 1u, 2u));
+}
+
+TEST(SequenceManagerBasicTest, DeadlineSchedulingWithoutBudgetsIsFifo) {
+  SimpleTestTickClock clock;
+  clock.Advance(TimeDelta::FromMilliseconds(1));
+  auto manager = CreateSequenceManagerOnCurrentThreadWithPump(
+      MessagePump::Create(MessagePumpType::DEFAULT),
+      SequenceManager::Settings::Builder()
+          .SetTickClock(&clock)
+          .SetDeadlineSchedulingEnabled(true)
+          .Build());
+  auto queue_a = manager->CreateTaskQueue(TaskQueue::Spec("a"));
+  auto queue_b = manager->CreateTaskQueue(TaskQueue::Spec("b"));
+
+  std::vector<EnqueueOrder> run_order;
+  queue_a->task_runner()->PostTask(FROM_HERE,
+                                   BindOnce(&TestTask, 1, &run_order));
+  queue_b->task_runner()->PostTask(FROM_HERE,
+                                   BindOnce(&TestTask, 2, &run_order));
+  queue_b->task_runner()->PostTask(FROM_HERE,
+                                   BindOnce(&TestTask, 3, &run_order));
+  clock.Advance(TimeDelta::FromMilliseconds(1));
+  queue_a->task_runner()->PostTask(FROM_HERE,
+                                   BindOnce(&TestTask, 4, &run_order));
+
+  // With a zero budget the deadline is the posting time, so tasks run in the
+  // order they were posted, with enqueue order breaking ties.
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u, 3u, 4u));
+}
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+TEST(SequenceManagerBasicTest, DeadlineSchedulingReportsMissedDeadlines) {
+  using trace_analyzer::Query;
+
+  SimpleTestTickClock clock;
+  clock.Advance(TimeDelta::FromMilliseconds(1));
+  auto manager = CreateSequenceManagerOnCurrentThreadWithPump(
+      MessagePump::Create(MessagePumpType::DEFAULT),
+      SequenceManager::Settings::Builder()
+          .SetTickClock(&clock)
+          .SetDeadlineSchedulingEnabled(true)
+          .Build());
+  auto budgeted_queue = manager->CreateTaskQueue(TaskQueue::Spec("budgeted"));
+  auto late_budget_queue =
+      manager->CreateTaskQueue(TaskQueue::Spec("late_budget"));
+  budgeted_queue->SetLatencyBudget(TimeDelta::FromMilliseconds(10));
+
+  trace_analyzer::Start("*");
+  // The first task runs on time, then holds the thread past the 10ms budget
+  // of the second.
+  budgeted_queue->task_runner()->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() {
+        clock.Advance(TimeDelta::FromMilliseconds(20));
+      }));
+  budgeted_queue->task_runner()->PostTask(FROM_HERE, BindOnce(&NopTask));
+  RunLoop().RunUntilIdle();
+
+  // A budget set after posting doesn't apply to tasks already queued.
+  late_budget_queue->task_runner()->PostTask(FROM_HERE, BindOnce(&NopTask));
+  late_budget_queue->SetLatencyBudget(TimeDelta::FromMilliseconds(10));
+  clock.Advance(TimeDelta::FromMilliseconds(20));
+  RunLoop().RunUntilIdle();
+  auto analyzer = trace_analyzer::Stop();
+
+  trace_analyzer::TraceEventVector events;
+  analyzer->FindEvents(Query::EventNameIs("DeadlineMissed"), &events);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ("budgeted", events[0]->GetKnownArgAsString("task_queue_name"));
+  EXPECT_EQ(10.0, events[0]->GetKnownArgAsDouble("lateness_ms"));
+}
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
 TEST_P(SequenceManagerTest, CanceledTasksInQueueCantMakeOtherTasksSkipAhead) {
   auto queues = CreateTaskQueues(2u);
 
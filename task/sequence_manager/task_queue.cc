@@ -254,6 +254,13 @@ TaskQueue::QueuePriority TaskQueue::GetQueuePriority() const {
   return impl_->GetQueuePriority();
 }
 
+void TaskQueue::SetLatencyBudget(TimeDelta latency_budget) {
+  DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  if (!impl_)
+    return;
+  impl_->SetLatencyBudget(latency_budget);
+}
+
 void TaskQueue::AddTaskObserver(TaskObserver* task_observer) {
   DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   if (!impl_)
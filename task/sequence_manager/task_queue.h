@@ -263,6 +263,15 @@ class BASE_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
   // Returns the current queue priority.
   QueuePriority GetQueuePriority() const;
 
+  // Sets how long tasks posted to this queue may wait once ready to run before
+  // they are considered late. Only used if the SequenceManager was created
+  // with deadline scheduling enabled, in which case queues of the same
+  // priority are serviced in order of their front task's deadline and late
+  // tasks are reported to tracing. Defaults to zero, which orders the queue's
+  // tasks by the time they became ready. NOTE this must be called on the
+  // thread this TaskQueue was created by.
+  void SetLatencyBudget(TimeDelta latency_budget);
+
   // These functions can only be called on the same thread that the task queue
   // manager executes its tasks on.
   void AddTaskObserver(TaskObserver* task_observer);
@@ -224,7 +224,7 @@ const char* TaskQueueImpl::GetName() const {
   return name_;
 }
 
-void TaskQueueImpl::PostTask(PostedTask task) {
+void TaskQueueImpl::PostTask(PostedTask&& task) {
   CurrentThread current_thread =
       associated_thread_->IsBoundToCurrentThread()
           ? TaskQueueImpl::CurrentThread::kMainThread
@@ -270,7 +270,7 @@ void TaskQueueImpl::MaybeAdjustTaskDelay(PostedTask* task,
 #endif  // DCHECK_IS_ON()
 }
 
-void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
+void TaskQueueImpl::PostImmediateTaskImpl(PostedTask&& task,
                                           CurrentThread current_thread) {
   // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
   // for details.
@@ -295,23 +295,26 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
         any_thread_.immediate_incoming_queue.empty();
     // Delayed run time is null for an immediate task.
     base::TimeTicks delayed_run_time;
-    any_thread_.immediate_incoming_queue.push_back(Task(
-        std::move(task), delayed_run_time, sequence_number, sequence_number));
+    // Construct the Task directly in the incoming queue rather than moving it
+    // in from a temporary.
+    Task& pending_task = any_thread_.immediate_incoming_queue.emplace_back(
+        std::move(task), delayed_run_time, sequence_number, sequence_number);
 
 #if DCHECK_IS_ON()
-    any_thread_.immediate_incoming_queue.back().cross_thread_ =
+    pending_task.cross_thread_ =
         (current_thread == TaskQueueImpl::CurrentThread::kNotMainThread);
 #endif
 
-    sequence_manager_->WillQueueTask(
-        &any_thread_.immediate_incoming_queue.back(), name_);
-    MaybeReportIpcTaskQueuedFromAnyThreadLocked(
-        &any_thread_.immediate_incoming_queue.back(), name_);
-    if (!any_thread_.on_task_posted_handler.is_null()) {
-      any_thread_.on_task_posted_handler.Run(
-          any_thread_.immediate_incoming_queue.back());
+    if (sequence_manager_->settings().deadline_scheduling) {
+      pending_task.deadline = lazy_now.Now() + any_thread_.latency_budget;
+      pending_task.has_latency_budget = !any_thread_.latency_budget.is_zero();
     }
 
+    sequence_manager_->WillQueueTask(&pending_task, name_);
+    MaybeReportIpcTaskQueuedFromAnyThreadLocked(&pending_task, name_);
+    if (!any_thread_.on_task_posted_handler.is_null())
+      any_thread_.on_task_posted_handler.Run(pending_task);
+
     // If this queue was completely empty, then the SequenceManager needs to be
     // informed so it can reload the work queue and add us to the
     // TaskQueueSelector which can only be done from the main thread. In
@@ -341,7 +344,7 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
   TraceQueueSize();
 }
 
-void TaskQueueImpl::PostDelayedTaskImpl(PostedTask task,
+void TaskQueueImpl::PostDelayedTaskImpl(PostedTask&& task,
                                         CurrentThread current_thread) {
   // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
   // for details.
@@ -594,6 +597,11 @@ void TaskQueueImpl::MoveReadyDelayedTasksToWorkQueue(LazyNow* lazy_now) {
     ActivateDelayedFenceIfNeeded(GetTaskDesiredExecutionTime(*task));
     DCHECK(!task->enqueue_order_set());
     task->set_enqueue_order(sequence_manager_->GetNextSequenceNumber());
+    if (sequence_manager_->settings().deadline_scheduling) {
+      task->deadline =
+          task->delayed_run_time + main_thread_only().latency_budget;
+      task->has_latency_budget = !main_thread_only().latency_budget.is_zero();
+    }
 
     delayed_work_queue_task_pusher.Push(task);
     main_thread_only().delayed_incoming_queue.pop();
@@ -666,6 +674,17 @@ TaskQueue::QueuePriority TaskQueueImpl::GetQueuePriority() const {
   return static_cast<TaskQueue::QueuePriority>(set_index);
 }
 
+void TaskQueueImpl::SetLatencyBudget(TimeDelta latency_budget) {
+  DCHECK_GE(latency_budget, TimeDelta());
+  main_thread_only().latency_budget = latency_budget;
+  base::internal::CheckedAutoLock lock(any_thread_lock_);
+  any_thread_.latency_budget = latency_budget;
+}
+
+TimeDelta TaskQueueImpl::GetLatencyBudget() const {
+  return main_thread_only().latency_budget;
+}
+
 Value TaskQueueImpl::AsValue(TimeTicks now, bool force_verbose) const {
   base::internal::CheckedAutoLock lock(any_thread_lock_);
   Value state(Value::Type::DICTIONARY);
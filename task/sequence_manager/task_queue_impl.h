@@ -114,6 +114,8 @@ class BASE_EXPORT TaskQueueImpl {
   Optional<TimeTicks> GetNextScheduledWakeUp();
   void SetQueuePriority(TaskQueue::QueuePriority priority);
   TaskQueue::QueuePriority GetQueuePriority() const;
+  void SetLatencyBudget(TimeDelta latency_budget);
+  TimeDelta GetLatencyBudget() const;
   void AddTaskObserver(TaskObserver* task_observer);
   void RemoveTaskObserver(TaskObserver* task_observer);
   void SetTimeDomain(TimeDomain* time_domain);
@@ -356,6 +358,10 @@ class BASE_EXPORT TaskQueueImpl {
     // See description inside struct AnyThread for details.
     TimeDomain* time_domain;
 
+    // Another copy of the latency budget for lock-free access from the main
+    // thread. See description inside struct AnyThread for details.
+    TimeDelta latency_budget;
+
     TaskQueue::Observer* task_queue_observer = nullptr;
 
     std::unique_ptr<WorkQueue> delayed_work_queue;
@@ -405,10 +411,13 @@ class BASE_EXPORT TaskQueueImpl {
     bool should_report_posted_tasks_when_disabled = false;
   };
 
-  void PostTask(PostedTask task);
+  // PostedTask is taken by reference along the internal posting path so that
+  // the closure and its metadata are only moved once, into the Task that is
+  // constructed in place in the destination queue.
+  void PostTask(PostedTask&& task);
 
-  void PostImmediateTaskImpl(PostedTask task, CurrentThread current_thread);
-  void PostDelayedTaskImpl(PostedTask task, CurrentThread current_thread);
+  void PostImmediateTaskImpl(PostedTask&& task, CurrentThread current_thread);
+  void PostDelayedTaskImpl(PostedTask&& task, CurrentThread current_thread);
 
   // Push the task onto the |delayed_incoming_queue|. Lock-free main thread
   // only fast path.
@@ -504,6 +513,11 @@ class BASE_EXPORT TaskQueueImpl {
     // locked before accessing from other threads.
     TimeDomain* time_domain;
 
+    // Added to the time a task becomes ready to run to compute its deadline
+    // when deadline scheduling is enabled. Like |time_domain| this is kept in
+    // two copies and can only be changed from the main thread.
+    TimeDelta latency_budget;
+
     TaskQueue::Observer* task_queue_observer = nullptr;
 
     TaskDeque immediate_incoming_queue;
@@ -219,6 +219,15 @@ class BASE_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
       if (!delayed_queue)
         return immediate_queue;
 
+      // Deadlines are null unless deadline scheduling is enabled, in which
+      // case the earliest deadline wins and enqueue order breaks ties.
+      TimeTicks immediate_deadline = immediate_queue->GetFrontTask()->deadline;
+      TimeTicks delayed_deadline = delayed_queue->GetFrontTask()->deadline;
+      if (immediate_deadline != delayed_deadline) {
+        return immediate_deadline < delayed_deadline ? immediate_queue
+                                                     : delayed_queue;
+      }
+
       if (immediate_enqueue_order < delayed_enqueue_order) {
         return immediate_queue;
       } else {
@@ -7,7 +7,7 @@
 namespace base {
 namespace sequence_manager {
 
-Task::Task(internal::PostedTask posted_task,
+Task::Task(internal::PostedTask&& posted_task,
            TimeTicks delayed_run_time,
            EnqueueOrder sequence_order,
            EnqueueOrder enqueue_order,
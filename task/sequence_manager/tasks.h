@@ -85,7 +85,7 @@ struct DelayedWakeUp {
 
 // PendingTask with extra metadata for SequenceManager.
 struct BASE_EXPORT Task : public PendingTask {
-  Task(internal::PostedTask posted_task,
+  Task(internal::PostedTask&& posted_task,
        TimeTicks delayed_run_time,
        EnqueueOrder sequence_order,
        EnqueueOrder enqueue_order = EnqueueOrder(),
@@ -115,6 +115,18 @@ struct BASE_EXPORT Task : public PendingTask {
   // support posting back to the "current sequence".
   scoped_refptr<SequencedTaskRunner> task_runner;
 
+  // The time by which this task should start running: the time it became
+  // ready to run plus its queue's latency budget. Only set if
+  // SequenceManager::Settings::deadline_scheduling is enabled, in which case
+  // it is the primary sort key when selecting between queues of the same
+  // priority. Null otherwise.
+  TimeTicks deadline;
+
+  // Whether |deadline| included a non-zero latency budget when it was set.
+  // Only such tasks can be reported as having missed their deadline, even if
+  // the queue's budget changes while they wait.
+  bool has_latency_budget = false;
+
 #if DCHECK_IS_ON()
   bool cross_thread_;
 #endif
@@ -27,6 +27,10 @@ namespace internal {
 // TaskQueueSelector chooses to run a task a given priority).  The reason this
 // works is because std::map is a tree based associative container and all the
 // values are kept in sorted order.
+//
+// If deadline scheduling is enabled the front tasks' deadlines are compared
+// first, so the queue with the earliest deadline is the "oldest" one. Task
+// deadlines are null otherwise, which leaves the ordering unchanged.
 class BASE_EXPORT WorkQueueSets {
  public:
   class Observer {
@@ -105,10 +109,16 @@ class BASE_EXPORT WorkQueueSets {
 
  private:
   struct OldestTaskEnqueueOrder {
+    OldestTaskEnqueueOrder(EnqueueOrder key, WorkQueue* value)
+        : key(key), value(value), deadline(value->GetFrontTask()->deadline) {}
+
     EnqueueOrder key;
     WorkQueue* value;
+    TimeTicks deadline;
 
     bool operator<=(const OldestTaskEnqueueOrder& other) const {
+      if (deadline != other.deadline)
+        return deadline < other.deadline;
       return key <= other.key;
     }
 
@@ -0,0 +1,86 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/task_yield.h"
+
+#include <utility>
+
+#include "base/callback.h"
+#include "base/check_op.h"
+#include "base/lazy_instance.h"
+#include "base/notreached.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/task_source.h"
+#include "base/task/thread_pool/thread_group.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+
+namespace internal {
+
+namespace {
+
+LazyInstance<ThreadLocalPointer<const ScopedSetCurrentTaskForYield>>::Leaky
+    tls_current_task_for_yield = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ScopedSetCurrentTaskForYield::ScopedSetCurrentTaskForYield(
+    const TaskSource* task_source,
+    const TaskTraits& traits)
+    : task_source_(task_source), traits_(traits) {
+  DCHECK(task_source_);
+  DCHECK(!tls_current_task_for_yield.Get().Get());
+  tls_current_task_for_yield.Get().Set(this);
+}
+
+ScopedSetCurrentTaskForYield::~ScopedSetCurrentTaskForYield() {
+  DCHECK_EQ(this, tls_current_task_for_yield.Get().Get());
+  tls_current_task_for_yield.Get().Set(nullptr);
+}
+
+}  // namespace internal
+
+bool ShouldYieldCurrentTask() {
+  const internal::ScopedSetCurrentTaskForYield* current_task =
+      internal::tls_current_task_for_yield.Get().Get();
+  if (!current_task)
+    return false;
+
+  // Dedicated single-thread workers don't belong to a ThreadGroup and never
+  // have to share their thread with other task sources.
+  internal::ThreadGroup* thread_group =
+      internal::ThreadGroup::GetCurrentThreadGroup();
+  if (!thread_group)
+    return false;
+
+  return thread_group->ShouldYield(current_task->task_source()->GetSortKey(
+      /* disable_fair_scheduling=*/false));
+}
+
+bool PostContinuationTask(const Location& from_here,
+                          OnceClosure continuation) {
+  const internal::ScopedSetCurrentTaskForYield* current_task =
+      internal::tls_current_task_for_yield.Get().Get();
+  DCHECK(current_task)
+      << "PostContinuationTask() must be called from a ThreadPool task.";
+
+  switch (current_task->task_source()->execution_mode()) {
+    case internal::TaskSourceExecutionMode::kSequenced:
+    case internal::TaskSourceExecutionMode::kSingleThread:
+      return SequencedTaskRunnerHandle::Get()->PostTask(
+          from_here, std::move(continuation));
+    case internal::TaskSourceExecutionMode::kParallel:
+      return ThreadPool::PostTask(from_here, current_task->traits(),
+                                  std::move(continuation));
+    case internal::TaskSourceExecutionMode::kJob:
+      NOTREACHED() << "Jobs should yield through JobDelegate.";
+      return false;
+  }
+  NOTREACHED();
+  return false;
+}
+
+}  // namespace base
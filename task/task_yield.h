@@ -0,0 +1,75 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_TASK_YIELD_H_
+#define BASE_TASK_TASK_YIELD_H_
+
+#include "base/base_export.h"
+#include "base/callback_forward.h"
+#include "base/location.h"
+#include "base/task/task_traits.h"
+
+namespace base {
+
+namespace internal {
+
+class TaskSource;
+
+// Within the scope of this object, ShouldYieldCurrentTask() and
+// PostContinuationTask() refer to the task from |task_source| with |traits|.
+// Set by TaskTracker around each ThreadPool task it runs.
+class BASE_EXPORT ScopedSetCurrentTaskForYield {
+ public:
+  ScopedSetCurrentTaskForYield(const TaskSource* task_source,
+                               const TaskTraits& traits);
+  ScopedSetCurrentTaskForYield(const ScopedSetCurrentTaskForYield&) = delete;
+  ScopedSetCurrentTaskForYield& operator=(const ScopedSetCurrentTaskForYield&) =
+      delete;
+  ~ScopedSetCurrentTaskForYield();
+
+  const TaskSource* task_source() const { return task_source_; }
+  const TaskTraits& traits() const { return traits_; }
+
+ private:
+  const TaskSource* const task_source_;
+  const TaskTraits traits_;
+};
+
+}  // namespace internal
+
+// Returns true if the ThreadPool task running on the current thread should
+// return control to the scheduler as soon as possible because work of higher
+// priority is waiting for a worker of the same thread group. Long CPU-bound
+// tasks can poll this between units of work and, when it returns true, save
+// their progress and schedule the remainder with PostContinuationTask().
+//
+// Returns true at most once per waiting task source, so that only one worker
+// yields for it. Always returns false outside of ThreadPool workers and on
+// dedicated single-thread workers. Jobs should use JobDelegate::ShouldYield()
+// instead.
+//
+// Example:
+//   void ProcessItems(std::unique_ptr<WorkList> work) {
+//     while (!work->empty()) {
+//       work->ProcessNext();
+//       if (base::ShouldYieldCurrentTask()) {
+//         base::PostContinuationTask(
+//             FROM_HERE, base::BindOnce(&ProcessItems, std::move(work)));
+//         return;
+//       }
+//     }
+//   }
+BASE_EXPORT bool ShouldYieldCurrentTask();
+
+// Posts |continuation| with the same traits as the ThreadPool task running on
+// the current thread: to the current sequence for sequenced and single-thread
+// tasks, or as a new parallel task otherwise. Returns false if the task could
+// not be posted (e.g. during shutdown). Must be called from a ThreadPool task
+// that is not part of a job.
+BASE_EXPORT bool PostContinuationTask(const Location& from_here,
+                                      OnceClosure continuation);
+
+}  // namespace base
+
+#endif  // BASE_TASK_TASK_YIELD_H_
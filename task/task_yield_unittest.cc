@@ -0,0 +1,86 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/task_yield.h"
+
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_timeouts.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(TaskYieldTest, NotInThreadPoolTask) {
+  test::TaskEnvironment task_environment;
+  EXPECT_FALSE(ShouldYieldCurrentTask());
+}
+
+TEST(TaskYieldTest, NoHigherPriorityWork) {
+  test::TaskEnvironment task_environment;
+  bool should_yield = true;
+  ThreadPool::PostTask(FROM_HERE, {TaskPriority::USER_VISIBLE},
+                       BindLambdaForTesting(
+                           [&]() { should_yield = ShouldYieldCurrentTask(); }));
+  task_environment.RunUntilIdle();
+  EXPECT_FALSE(should_yield);
+}
+
+namespace {
+
+class TaskYieldSingleWorkerTest : public testing::Test {
+ protected:
+  TaskYieldSingleWorkerTest() {
+    ThreadPoolInstance::Create("TaskYieldTest");
+    ThreadPoolInstance::Get()->Start({1});
+  }
+  TaskYieldSingleWorkerTest(const TaskYieldSingleWorkerTest&) = delete;
+  TaskYieldSingleWorkerTest& operator=(const TaskYieldSingleWorkerTest&) =
+      delete;
+
+  ~TaskYieldSingleWorkerTest() override {
+    ThreadPoolInstance::Get()->JoinForTesting();
+    ThreadPoolInstance::Set(nullptr);
+  }
+};
+
+}  // namespace
+
+// Verifies that a task occupying the only worker is asked to yield once a
+// higher priority task is posted, and that its continuation runs on the same
+// sequence after the higher priority task.
+TEST_F(TaskYieldSingleWorkerTest, YieldsToHigherPriorityTask) {
+  auto task_runner =
+      ThreadPool::CreateSequencedTaskRunner({TaskPriority::USER_VISIBLE});
+  WaitableEvent continuation_ran;
+  WaitableEvent user_blocking_ran;
+  task_runner->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() {
+        EXPECT_FALSE(ShouldYieldCurrentTask());
+        ThreadPool::PostTask(
+            FROM_HERE, {TaskPriority::USER_BLOCKING},
+            BindLambdaForTesting([&]() { user_blocking_ran.Signal(); }));
+        const TimeTicks deadline =
+            TimeTicks::Now() + TestTimeouts::action_max_timeout();
+        while (!ShouldYieldCurrentTask()) {
+          ASSERT_LT(TimeTicks::Now(), deadline);
+          PlatformThread::YieldCurrentThread();
+        }
+        // Only one worker is asked to yield for a given task.
+        EXPECT_FALSE(ShouldYieldCurrentTask());
+        EXPECT_TRUE(PostContinuationTask(
+            FROM_HERE, BindLambdaForTesting([&]() {
+              EXPECT_TRUE(task_runner->RunsTasksInCurrentSequence());
+              EXPECT_TRUE(user_blocking_ran.IsSignaled());
+              continuation_ran.Signal();
+            })));
+      }));
+  continuation_ran.Wait();
+}
+
+}  // namespace base
@@ -23,6 +23,7 @@
 #include "base/synchronization/condition_variable.h"
 #include "base/task/scoped_set_task_priority_for_current_thread.h"
 #include "base/task/task_executor.h"
+#include "base/task/task_yield.h"
 #include "base/threading/sequence_local_storage_map.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
@@ -466,6 +467,8 @@ void TaskTracker::RunTask(Task task,
         scoped_set_sequence_token_for_current_thread(environment.token);
     ScopedSetTaskPriorityForCurrentThread
         scoped_set_task_priority_for_current_thread(traits.priority());
+    ScopedSetCurrentTaskForYield scoped_set_current_task_for_yield(task_source,
+                                                                   traits);
 
     // Local storage map used if none is provided by |environment|.
     Optional<SequenceLocalStorageMap> local_storage_map;
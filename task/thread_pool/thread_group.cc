@@ -27,15 +27,16 @@ namespace internal {
 namespace {
 
 // ThreadGroup that owns the current thread, if any.
-LazyInstance<ThreadLocalPointer<const ThreadGroup>>::Leaky
-    tls_current_thread_group = LAZY_INSTANCE_INITIALIZER;
+LazyInstance<ThreadLocalPointer<ThreadGroup>>::Leaky tls_current_thread_group =
+    LAZY_INSTANCE_INITIALIZER;
 
-const ThreadGroup* GetCurrentThreadGroup() {
+}  // namespace
+
+// static
+ThreadGroup* ThreadGroup::GetCurrentThreadGroup() {
   return tls_current_thread_group.Get().Get();
 }
 
-}  // namespace
-
 constexpr ThreadGroup::YieldSortKey ThreadGroup::kMaxYieldSortKey;
 
 void ThreadGroup::BaseScopedCommandsExecutor::ScheduleReleaseTaskSource(
@@ -66,6 +66,10 @@ class BASE_EXPORT ThreadGroup {
   // Returns true if the thread group is registered in TLS.
   bool IsBoundToCurrentThread() const;
 
+  // Returns the ThreadGroup bound to the current thread, or null if the
+  // current thread isn't a worker of a ThreadGroup.
+  static ThreadGroup* GetCurrentThreadGroup();
+
   // Removes |task_source| from |priority_queue_|. Returns a
   // RegisteredTaskSource that evaluats to true if successful, or false if
   // |task_source| is not currently in |priority_queue_|, such as when a worker
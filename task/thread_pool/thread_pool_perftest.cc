@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <vector>
@@ -13,8 +14,10 @@
 #include "base/callback_helpers.h"
 #include "base/optional.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/task/task_yield.h"
 #include "base/task/thread_pool.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -40,6 +43,12 @@ constexpr char kStoryPostRunNoOpManyThreads[] =
     "post_run_noop_tasks_many_threads";
 constexpr char kStoryPostRunBusyManyThreads[] =
     "post_run_busy_tasks_many_threads";
+constexpr char kMetricUserBlockingLatencyAvg[] = "user_blocking_latency_avg";
+constexpr char kMetricUserBlockingLatencyMax[] = "user_blocking_latency_max";
+constexpr char kStoryUserBlockingWithLongTasks[] =
+    "user_blocking_with_long_tasks";
+constexpr char kStoryUserBlockingWithYieldingLongTasks[] =
+    "user_blocking_with_yielding_long_tasks";
 
 perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
   perf_test::PerfResultReporter reporter(kMetricPrefixThreadPool, story_name);
@@ -49,6 +58,34 @@ perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
   return reporter;
 }
 
+perf_test::PerfResultReporter SetUpLatencyReporter(
+    const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixThreadPool, story_name);
+  reporter.RegisterImportantMetric(kMetricUserBlockingLatencyAvg, "us");
+  reporter.RegisterImportantMetric(kMetricUserBlockingLatencyMax, "us");
+  return reporter;
+}
+
+// Busy-waits for |num_chunks| chunks of |chunk_duration|. If |yield| is true,
+// checks ShouldYieldCurrentTask() between chunks and continues in a new task
+// when asked to.
+void RunChunkedBusyTask(size_t num_chunks,
+                        TimeDelta chunk_duration,
+                        bool yield) {
+  while (num_chunks > 0) {
+    const TimeTicks end_time = TimeTicks::Now() + chunk_duration;
+    while (TimeTicks::Now() < end_time) {
+    }
+    --num_chunks;
+    if (num_chunks > 0 && yield && ShouldYieldCurrentTask()) {
+      PostContinuationTask(FROM_HERE,
+                           BindOnce(&RunChunkedBusyTask, num_chunks,
+                                    chunk_duration, yield));
+      return;
+    }
+  }
+}
+
 enum class ExecutionMode {
   // Allows tasks to start running while tasks are being posted by posting
   // threads.
@@ -162,6 +199,55 @@ class ThreadPoolPerfTest : public testing::Test {
 
   void OnCompletePostingTasks() { complete_posting_tasks_.Signal(); }
 
+  // Measures the delay between posting a USER_BLOCKING task and it starting to
+  // run while all workers are busy with long USER_VISIBLE tasks, which
+  // optionally yield at chunk boundaries.
+  void BenchmarkUserBlockingLatency(const std::string& story_name,
+                                    bool yield) {
+    constexpr size_t kNumWorkers = 4;
+    constexpr size_t kNumLongTasks = 2 * kNumWorkers;
+    constexpr size_t kNumChunks = 200;
+    constexpr TimeDelta kChunkDuration = TimeDelta::FromMicroseconds(100);
+    constexpr size_t kNumSamples = 100;
+
+    ThreadPoolInstance::Get()->Start({kNumWorkers});
+    for (size_t i = 0; i < kNumLongTasks; ++i) {
+      ThreadPool::CreateSequencedTaskRunner({TaskPriority::USER_VISIBLE})
+          ->PostTask(FROM_HERE, BindOnce(&RunChunkedBusyTask, kNumChunks,
+                                         kChunkDuration, yield));
+    }
+
+    TimeDelta total_latency;
+    TimeDelta max_latency;
+    for (size_t i = 0; i < kNumSamples; ++i) {
+      WaitableEvent task_ran;
+      TimeDelta latency;
+      const TimeTicks post_time = TimeTicks::Now();
+      ThreadPool::PostTask(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                           BindOnce(
+                               [](TimeTicks post_time, TimeDelta* latency,
+                                  WaitableEvent* task_ran) {
+                                 *latency = TimeTicks::Now() - post_time;
+                                 task_ran->Signal();
+                               },
+                               post_time, Unretained(&latency),
+                               Unretained(&task_ran)));
+      task_ran.Wait();
+      total_latency += latency;
+      max_latency = std::max(max_latency, latency);
+      PlatformThread::Sleep(TimeDelta::FromMilliseconds(1));
+    }
+
+    ThreadPoolInstance::Get()->FlushForTesting();
+    ThreadPoolInstance::Get()->JoinForTesting();
+
+    auto reporter = SetUpLatencyReporter(story_name);
+    reporter.AddResult(kMetricUserBlockingLatencyAvg,
+                       (total_latency / kNumSamples).InMicrosecondsF());
+    reporter.AddResult(kMetricUserBlockingLatencyMax,
+                       max_latency.InMicrosecondsF());
+  }
+
   void Benchmark(const std::string& story_name, ExecutionMode execution_mode) {
     base::Optional<ThreadPoolInstance::ScopedExecutionFence> execution_fence;
     if (execution_mode == ExecutionMode::kPostThenRun) {
@@ -266,5 +352,15 @@ TEST_F(ThreadPoolPerfTest, PostRunBusyTasksManyThreads) {
   Benchmark(kStoryPostRunBusyManyThreads, ExecutionMode::kPostAndRun);
 }
 
+TEST_F(ThreadPoolPerfTest, UserBlockingLatencyWithLongTasks) {
+  BenchmarkUserBlockingLatency(kStoryUserBlockingWithLongTasks,
+                               /*yield=*/false);
+}
+
+TEST_F(ThreadPoolPerfTest, UserBlockingLatencyWithYieldingLongTasks) {
+  BenchmarkUserBlockingLatency(kStoryUserBlockingWithYieldingLongTasks,
+                               /*yield=*/true);
+}
+
 }  // namespace internal
 }  // namespace base
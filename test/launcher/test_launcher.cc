@@ -22,6 +22,7 @@
 #include "base/files/scoped_file.h"
 #include "base/format_macros.h"
 #include "base/hash/hash.h"
+#include "base/json/json_reader.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -53,6 +54,7 @@
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -645,23 +647,82 @@ std::vector<std::string> ExtractTestsFromFilter(const std::string& filter,
   return tests;
 }
 
+// Reads the duration of each test from |path|, a summary written by an earlier
+// run with --test-launcher-summary-output, into |durations|. Takes the longest
+// of the recorded runs of each test. Returns false if |path| isn't a summary.
+bool LoadTestDurations(const FilePath& path,
+                       std::unordered_map<std::string, TimeDelta>* durations) {
+  std::string json;
+  if (!ReadFileToString(path, &json))
+    return false;
+  Optional<Value> summary = JSONReader::Read(json);
+  if (!summary || !summary->is_dict())
+    return false;
+  const Value* iterations = summary->FindListKey("per_iteration_data");
+  if (!iterations)
+    return false;
+
+  for (const Value& iteration : iterations->GetList()) {
+    if (!iteration.is_dict())
+      continue;
+    for (const auto& test : iteration.DictItems()) {
+      if (!test.second.is_list())
+        continue;
+      for (const Value& result : test.second.GetList()) {
+        Optional<int> elapsed_time_ms =
+            result.is_dict() ? result.FindIntKey("elapsed_time_ms") : nullopt;
+        if (!elapsed_time_ms)
+          continue;
+        TimeDelta& duration = (*durations)[test.first];
+        duration = std::max(duration,
+                            TimeDelta::FromMilliseconds(*elapsed_time_ms));
+      }
+    }
+  }
+  return true;
+}
+
 // A test runner object to run tests across a number of sequence runners,
 // and control running pre tests in sequence.
 class TestRunner {
  public:
-  explicit TestRunner(TestLauncher* launcher,
-                      size_t runner_count = 1u,
-                      size_t batch_size = 1u)
+  // If |test_durations| is not null, tests are run longest first, and batches
+  // are limited to a share of the remaining duration.
+  explicit TestRunner(
+      TestLauncher* launcher,
+      size_t runner_count = 1u,
+      size_t batch_size = 1u,
+      const std::unordered_map<std::string, TimeDelta>* test_durations =
+          nullptr)
       : launcher_(launcher),
         runner_count_(runner_count),
-        batch_size_(batch_size) {}
+        batch_size_(batch_size),
+        test_durations_(test_durations) {}
 
-  // Sets |test_names| to be run, with |batch_size| tests per process.
+  // Sets |test_names| to be run |repeats| times, with |batch_size| tests per
+  // process. Each repeat runs after all tests of the previous one were
+  // started, so copies of a test are spread out rather than run together.
   // Posts LaunchNextTask |runner_count| number of times, each with a separate
   // task runner.
-  void Run(const std::vector<std::string>& test_names);
+  void Run(const std::vector<std::string>& test_names, size_t repeats = 1u);
 
  private:
+  // Orders |tests_to_run_| longest first, keeping PRE_ tests just before the
+  // tests which depend on them, and fills |durations_to_run_|. Tests without a
+  // recorded duration are assumed to take the mean recorded duration.
+  void SortTestsLongestFirst();
+
+  // Returns the number of tests for the next batch. With test durations, that
+  // is as many tests as fit in the share of one runner of the remaining
+  // duration, and at least one. So batches shrink as the remaining tests run
+  // out, and runners which go idle split the remaining work between them
+  // rather than wait for one long batch.
+  size_t GetNextBatchSize() const;
+
+  // Prints how much of the time each runner spent running tests, when there
+  // is more than one.
+  void PrintJobUtilization() const;
+
   // Called to check if the next batch has to run on the same
   // sequence task runner and using the same temporary directory.
   static bool ShouldReuseStateFromLastBatch(
@@ -670,20 +731,22 @@ class TestRunner {
            test_names.front().find(kPreTestPrefix) != std::string::npos;
   }
 
-  // Launches the next child process on |task_runner| and clears
-  // |last_task_temp_dir| from the previous task.
-  void LaunchNextTask(scoped_refptr<TaskRunner> task_runner,
+  // Launches the next child process on |task_runner|, the runner at
+  // |runner_index|, and clears |last_task_temp_dir| from the previous task.
+  void LaunchNextTask(size_t runner_index,
+                      scoped_refptr<TaskRunner> task_runner,
                       const FilePath& last_task_temp_dir);
 
   // Forwards |last_task_temp_dir| and launches the next task on main thread.
   // The method is called on |task_runner|.
   void ClearAndLaunchNext(scoped_refptr<TaskRunner> main_thread_runner,
+                          size_t runner_index,
                           scoped_refptr<TaskRunner> task_runner,
                           const FilePath& last_task_temp_dir) {
     main_thread_runner->PostTask(
         FROM_HERE,
         BindOnce(&TestRunner::LaunchNextTask, weak_ptr_factory_.GetWeakPtr(),
-                 task_runner, last_task_temp_dir));
+                 runner_index, task_runner, last_task_temp_dir));
   }
 
   ThreadChecker thread_checker_;
@@ -697,34 +760,167 @@ class TestRunner {
   size_t runners_done_ = 0;
   // Number of tests per process, 0 is special case for all tests.
   const size_t batch_size_;
+  // Recorded test durations, if tests are scheduled by duration.
+  const std::unordered_map<std::string, TimeDelta>* const test_durations_;
+  // Durations of |tests_to_run_|, in the same order, and their sum. Empty
+  // unless tests are scheduled by duration.
+  std::vector<TimeDelta> durations_to_run_;
+  TimeDelta remaining_duration_;
+  // When the runs started, when the batch of each runner started, or null if
+  // the runner is idle, and how long each runner was busy.
+  TimeTicks run_start_time_;
+  std::vector<TimeTicks> batch_start_times_;
+  std::vector<TimeDelta> busy_times_;
   RunLoop run_loop_;
 
   base::WeakPtrFactory<TestRunner> weak_ptr_factory_{this};
 };
 
-void TestRunner::Run(const std::vector<std::string>& test_names) {
+void TestRunner::Run(const std::vector<std::string>& test_names,
+                     size_t repeats) {
   DCHECK(thread_checker_.CalledOnValidThread());
   // No sequence runners, fail immediately.
   CHECK_GT(runner_count_, 0u);
   tests_to_run_ = test_names;
+  durations_to_run_.clear();
+  remaining_duration_ = TimeDelta();
+  if (test_durations_)
+    SortTestsLongestFirst();
+  // Repeat the sorted order, rather than sort the repeated tests, which would
+  // put the copies of a test next to each other.
+  const size_t test_count = tests_to_run_.size();
+  const size_t duration_count = durations_to_run_.size();
+  tests_to_run_.reserve(test_count * repeats);
+  durations_to_run_.reserve(duration_count * repeats);
+  for (size_t i = 1; i < repeats; ++i) {
+    for (size_t j = 0; j < test_count; ++j)
+      tests_to_run_.push_back(tests_to_run_[j]);
+    for (size_t j = 0; j < duration_count; ++j)
+      durations_to_run_.push_back(durations_to_run_[j]);
+  }
+  remaining_duration_ *= repeats;
   // Reverse test order to avoid coping the whole vector when removing tests.
   ranges::reverse(tests_to_run_);
+  ranges::reverse(durations_to_run_);
   runners_done_ = 0;
   task_runners_.clear();
+  run_start_time_ = TimeTicks::Now();
+  batch_start_times_.assign(runner_count_, TimeTicks());
+  busy_times_.assign(runner_count_, TimeDelta());
   for (size_t i = 0; i < runner_count_; i++) {
     task_runners_.push_back(ThreadPool::CreateSequencedTaskRunner(
         {MayBlock(), TaskShutdownBehavior::BLOCK_SHUTDOWN}));
     ThreadTaskRunnerHandle::Get()->PostTask(
         FROM_HERE,
         BindOnce(&TestRunner::LaunchNextTask, weak_ptr_factory_.GetWeakPtr(),
-                 task_runners_.back(), FilePath()));
+                 i, task_runners_.back(), FilePath()));
   }
   run_loop_.Run();
+  PrintJobUtilization();
+}
+
+void TestRunner::SortTestsLongestFirst() {
+  TimeDelta recorded_duration;
+  size_t recorded_count = 0;
+  for (const std::string& test_name : tests_to_run_) {
+    auto it = test_durations_->find(test_name);
+    if (it != test_durations_->end()) {
+      recorded_duration += it->second;
+      ++recorded_count;
+    }
+  }
+  const TimeDelta mean_duration =
+      recorded_count ? recorded_duration / recorded_count : TimeDelta();
+  std::vector<TimeDelta> durations;
+  durations.reserve(tests_to_run_.size());
+  for (const std::string& test_name : tests_to_run_) {
+    auto it = test_durations_->find(test_name);
+    durations.push_back(it != test_durations_->end() ? it->second
+                                                     : mean_duration);
+  }
+
+  // Tests [begin, end) of |tests_to_run_|: a test and the PRE_ tests which
+  // run before it.
+  struct Unit {
+    size_t begin;
+    size_t end;
+    TimeDelta duration;
+  };
+  std::vector<Unit> units;
+  Unit unit = {0, 0, TimeDelta()};
+  for (size_t i = 0; i < tests_to_run_.size(); ++i) {
+    unit.duration += durations[i];
+    unit.end = i + 1;
+    if (tests_to_run_[i].find(kPreTestPrefix) != std::string::npos &&
+        unit.end < tests_to_run_.size()) {
+      continue;
+    }
+    units.push_back(unit);
+    unit = {unit.end, unit.end, TimeDelta()};
+  }
+  std::stable_sort(units.begin(), units.end(),
+                   [](const Unit& lhs, const Unit& rhs) {
+                     return lhs.duration > rhs.duration;
+                   });
+
+  std::vector<std::string> sorted_tests;
+  sorted_tests.reserve(tests_to_run_.size());
+  durations_to_run_.reserve(tests_to_run_.size());
+  for (const Unit& sorted_unit : units) {
+    for (size_t i = sorted_unit.begin; i < sorted_unit.end; ++i) {
+      sorted_tests.push_back(std::move(tests_to_run_[i]));
+      durations_to_run_.push_back(durations[i]);
+    }
+    remaining_duration_ += sorted_unit.duration;
+  }
+  tests_to_run_ = std::move(sorted_tests);
+}
+
+size_t TestRunner::GetNextBatchSize() const {
+  const size_t max_size = (batch_size_ == 0)
+                              ? tests_to_run_.size()
+                              : std::min(batch_size_, tests_to_run_.size());
+  if (durations_to_run_.empty())
+    return max_size;
+
+  // |durations_to_run_| is reversed like |tests_to_run_|.
+  const TimeDelta share = remaining_duration_ / runner_count_;
+  auto next = durations_to_run_.rbegin();
+  TimeDelta duration = *next++;
+  size_t size = 1;
+  while (size < max_size && duration + *next <= share) {
+    duration += *next++;
+    ++size;
+  }
+  return size;
+}
+
+void TestRunner::PrintJobUtilization() const {
+  const TimeDelta elapsed_time = TimeTicks::Now() - run_start_time_;
+  if (runner_count_ < 2 || elapsed_time.is_zero())
+    return;
+  TimeDelta busy_time;
+  std::string per_job;
+  for (TimeDelta runner_busy_time : busy_times_) {
+    busy_time += runner_busy_time;
+    per_job += StringPrintf(" %.0f%%", 100 * (runner_busy_time / elapsed_time));
+  }
+  fprintf(stdout, "Job utilization: %.0f%% (per job:%s)\n",
+          100 * (busy_time / elapsed_time) / runner_count_, per_job.c_str());
+  fflush(stdout);
 }
 
-void TestRunner::LaunchNextTask(scoped_refptr<TaskRunner> task_runner,
+void TestRunner::LaunchNextTask(size_t runner_index,
+                                scoped_refptr<TaskRunner> task_runner,
                                 const FilePath& last_task_temp_dir) {
   DCHECK(thread_checker_.CalledOnValidThread());
+  // The runner is idle until it is given another batch.
+  if (!batch_start_times_[runner_index].is_null()) {
+    busy_times_[runner_index] +=
+        TimeTicks::Now() - batch_start_times_[runner_index];
+    batch_start_times_[runner_index] = TimeTicks();
+  }
+
   // delete previous temporary directory
   if (!last_task_temp_dir.empty() &&
       !DeletePathRecursively(last_task_temp_dir)) {
@@ -749,14 +945,22 @@ void TestRunner::LaunchNextTask(scoped_refptr<TaskRunner> task_runner,
   base::FilePath task_temp_dir;
   CHECK(CreateNewTempDirectory(FilePath::StringType(), &task_temp_dir));
   bool post_to_current_runner = true;
-  size_t batch_size = (batch_size_ == 0) ? tests_to_run_.size() : batch_size_;
+  batch_start_times_[runner_index] = TimeTicks::Now();
 
   int child_index = 0;
   while (post_to_current_runner && !tests_to_run_.empty()) {
-    batch_size = std::min(batch_size, tests_to_run_.size());
+    const size_t batch_size = GetNextBatchSize();
     std::vector<std::string> batch(tests_to_run_.rbegin(),
                                    tests_to_run_.rbegin() + batch_size);
     tests_to_run_.erase(tests_to_run_.end() - batch_size, tests_to_run_.end());
+    if (!durations_to_run_.empty()) {
+      for (auto it = durations_to_run_.end() - batch_size;
+           it != durations_to_run_.end(); ++it) {
+        remaining_duration_ -= *it;
+      }
+      durations_to_run_.erase(durations_to_run_.end() - batch_size,
+                              durations_to_run_.end());
+    }
     task_runner->PostTask(
         FROM_HERE,
         BindOnce(&TestLauncher::LaunchChildGTestProcess, Unretained(launcher_),
@@ -765,9 +969,9 @@ void TestRunner::LaunchNextTask(scoped_refptr<TaskRunner> task_runner,
     post_to_current_runner = ShouldReuseStateFromLastBatch(batch);
   }
   task_runner->PostTask(
-      FROM_HERE,
-      BindOnce(&TestRunner::ClearAndLaunchNext, Unretained(this),
-               ThreadTaskRunnerHandle::Get(), task_runner, task_temp_dir));
+      FROM_HERE, BindOnce(&TestRunner::ClearAndLaunchNext, Unretained(this),
+                          ThreadTaskRunnerHandle::Get(), runner_index,
+                          task_runner, task_temp_dir));
 }
 
 // Returns the number of files and directories in |dir|, or 0 if |dir| is empty.
@@ -1388,6 +1592,20 @@ bool TestLauncher::Init(CommandLine* command_line) {
   fprintf(stdout, "Using %zu parallel jobs.\n", parallel_jobs_);
   fflush(stdout);
 
+  if (command_line->HasSwitch(switches::kTestLauncherTimings)) {
+    FilePath timings_path =
+        command_line->GetSwitchValuePath(switches::kTestLauncherTimings);
+    if (LoadTestDurations(timings_path, &test_durations_)) {
+      fprintf(stdout, "Scheduling tests by %zu recorded test durations.\n",
+              test_durations_.size());
+      fflush(stdout);
+    } else {
+      // Not fatal, since there are no timings before the first run.
+      LOG(WARNING) << "Couldn't read test durations from "
+                   << timings_path.AsUTF8Unsafe();
+    }
+  }
+
   CreateAndStartThreadPool(static_cast<int>(parallel_jobs_));
 
   std::vector<std::string> positive_file_filter;
@@ -1765,17 +1983,11 @@ std::vector<std::string> TestLauncher::CollectTests() {
 }
 
 void TestLauncher::RunTests() {
-  std::vector<std::string> original_test_names = CollectTests();
-
-  std::vector<std::string> test_names;
-  for (int i = 0; i < repeats_per_iteration_; ++i) {
-    test_names.insert(test_names.end(), original_test_names.begin(),
-                      original_test_names.end());
-  }
+  std::vector<std::string> test_names = CollectTests();
 
   broken_threshold_ = std::max(static_cast<size_t>(20), tests_.size() / 10);
 
-  test_started_count_ = test_names.size();
+  test_started_count_ = test_names.size() * repeats_per_iteration_;
 
   // If there are no matching tests, warn and notify of any matches against
   // *<filter>*.
@@ -1795,8 +2007,10 @@ void TestLauncher::RunTests() {
   size_t batch_size =
       repeats_per_iteration_ > 1 ? 1U : launcher_delegate_->GetBatchSize();
 
-  TestRunner test_runner(this, parallel_jobs_, batch_size);
-  test_runner.Run(test_names);
+  TestRunner test_runner(
+      this, parallel_jobs_, batch_size,
+      test_durations_.empty() ? nullptr : &test_durations_);
+  test_runner.Run(test_names, repeats_per_iteration_);
 }
 
 void TestLauncher::PrintFuzzyMatchingTestNames() {
@@ -11,6 +11,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/command_line.h"
@@ -290,6 +291,10 @@ class TestLauncher {
   // Tests to retry in this iteration.
   std::unordered_set<std::string> tests_to_retry_;
 
+  // Test durations recorded by an earlier run, by full test name. Empty unless
+  // they are passed with --test-launcher-timings.
+  std::unordered_map<std::string, TimeDelta> test_durations_;
+
   TestResultsTracker results_tracker_;
 
   // Watchdog timer to make sure we do not go without output for too long.
@@ -9,6 +9,7 @@
 #include "base/command_line.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
 #include "base/process/launch.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
@@ -100,9 +101,11 @@ class MockTestLauncherDelegate : public TestLauncherDelegate {
 // Test TestLauncher filters, and command line switches setup.
 class TestLauncherTest : public testing::Test {
  protected:
-  TestLauncherTest()
+  TestLauncherTest() : TestLauncherTest(10) {}
+
+  explicit TestLauncherTest(size_t parallel_jobs)
       : command_line(new CommandLine(CommandLine::NO_PROGRAM)),
-        test_launcher(&delegate, 10),
+        test_launcher(&delegate, parallel_jobs),
         task_environment(base::test::TaskEnvironment::MainThreadType::IO) {}
 
   // Adds tests to be returned by the delegate.
@@ -163,6 +166,17 @@ ACTION_P2(OnTestResult, launcher, result) {
                                      Unretained(launcher), result));
 }
 
+// Action to mock delegate invoking OnTestFinish on test launcher, with a
+// successful result for each test of the batch.
+ACTION_P(OnTestSuccesses, launcher) {
+  for (const std::string& test_name : arg1) {
+    arg0->PostTask(
+        FROM_HERE,
+        BindOnce(&TestLauncher::OnTestFinished, Unretained(launcher),
+                 GenerateTestResult(test_name, TestResult::TEST_SUCCESS)));
+  }
+}
+
 // A test and a disabled test cannot share a name.
 TEST_F(TestLauncherTest, TestNameSharedWithDisabledTest) {
   AddMockedTests("Test", {"firstTest", "DISABLED_firstTest"});
@@ -670,6 +684,128 @@ TEST_F(TestLauncherTest, TestChildTempDir) {
   EXPECT_FALSE(DirectoryExists(task_temp));
 }
 
+// Using MockTestLauncher with two jobs, to test scheduling by test durations.
+class TestLauncherTimingsTest : public TestLauncherTest {
+ protected:
+  TestLauncherTimingsTest() : TestLauncherTest(2) {}
+
+  // Passes the launcher a summary which records |durations_ms|.
+  void SetUpTimings(
+      const std::vector<std::pair<std::string, int>>& durations_ms) {
+    Value iteration(Value::Type::DICTIONARY);
+    for (const auto& duration_ms : durations_ms) {
+      Value result(Value::Type::DICTIONARY);
+      result.SetStringKey("status", "SUCCESS");
+      result.SetIntKey("elapsed_time_ms", duration_ms.second);
+      Value results(Value::Type::LIST);
+      results.Append(std::move(result));
+      iteration.SetKey(duration_ms.first, std::move(results));
+    }
+    Value iterations(Value::Type::LIST);
+    iterations.Append(std::move(iteration));
+    Value summary(Value::Type::DICTIONARY);
+    summary.SetKey("per_iteration_data", std::move(iterations));
+
+    std::string json;
+    ASSERT_TRUE(JSONWriter::Write(summary, &json));
+    ASSERT_TRUE(dir.CreateUniqueTempDir());
+    FilePath path = dir.GetPath().AppendASCII("timings.json");
+    ASSERT_TRUE(WriteFile(path, json));
+    command_line->AppendSwitchPath("test-launcher-timings", path);
+  }
+};
+
+// The longest tests run first, with PRE_ tests just before the tests which
+// depend on them. Tests without a recorded duration take the mean duration.
+TEST_F(TestLauncherTimingsTest, LongestTestsFirst) {
+  AddMockedTests("Test", {"fast", "PRE_slow", "slow", "medium", "unknown"});
+  SetUpExpectCalls();
+  SetUpTimings({{"Test.fast", 10},
+                {"Test.PRE_slow", 500},
+                {"Test.slow", 600},
+                {"Test.medium", 100}});
+
+  // Each batch takes at most half the remaining duration, or one test. The
+  // first runner runs PRE_slow and then slow.
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  for (const char* test_name : {"Test.PRE_slow", "Test.slow", "Test.unknown",
+                                "Test.medium", "Test.fast"}) {
+    EXPECT_CALL(test_launcher,
+                LaunchChildGTestProcess(_, ElementsAre(test_name), _, _))
+        .WillOnce(OnTestSuccesses(&test_launcher));
+  }
+  EXPECT_TRUE(test_launcher.Run(command_line.get()));
+}
+
+// Batches shrink as the remaining tests run out, so that both jobs finish
+// together.
+TEST_F(TestLauncherTimingsTest, SplitRemainingTests) {
+  AddMockedTests("Test", {"a", "b", "c", "d", "e", "f"});
+  SetUpExpectCalls();
+  SetUpTimings({{"Test.a", 400},
+                {"Test.b", 10},
+                {"Test.c", 10},
+                {"Test.d", 10},
+                {"Test.e", 10},
+                {"Test.f", 10}});
+
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  EXPECT_CALL(test_launcher,
+              LaunchChildGTestProcess(_, ElementsAre("Test.a"), _, _))
+      .WillOnce(OnTestSuccesses(&test_launcher));
+  EXPECT_CALL(test_launcher, LaunchChildGTestProcess(
+                                 _, ElementsAre("Test.b", "Test.c"), _, _))
+      .WillOnce(OnTestSuccesses(&test_launcher));
+  for (const char* test_name : {"Test.d", "Test.e", "Test.f"}) {
+    EXPECT_CALL(test_launcher,
+                LaunchChildGTestProcess(_, ElementsAre(test_name), _, _))
+        .WillOnce(OnTestSuccesses(&test_launcher));
+  }
+  EXPECT_TRUE(test_launcher.Run(command_line.get()));
+}
+
+// Repeats run the sorted tests again, rather than run the copies of each test
+// next to each other.
+TEST_F(TestLauncherTimingsTest, RepeatsKeepCopiesApart) {
+  AddMockedTests("Test", {"a", "b", "c"});
+  SetUpExpectCalls();
+  SetUpTimings({{"Test.a", 100}, {"Test.b", 10}, {"Test.c", 50}});
+  command_line->AppendSwitchASCII("gtest_repeat", "2");
+  // Run the tests one at a time, so that they're launched in order.
+  command_line->AppendSwitchASCII("test-launcher-jobs", "1");
+
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  ::testing::InSequence sequence;
+  for (const char* test_name :
+       {"Test.a", "Test.c", "Test.b", "Test.a", "Test.c", "Test.b"}) {
+    EXPECT_CALL(test_launcher,
+                LaunchChildGTestProcess(_, ElementsAre(test_name), _, _))
+        .WillOnce(OnTestSuccesses(&test_launcher));
+  }
+  EXPECT_TRUE(test_launcher.Run(command_line.get()));
+}
+
+// Without recorded durations, tests run in order in batches of the batch size.
+TEST_F(TestLauncherTimingsTest, MissingTimings) {
+  AddMockedTests("Test", {"a", "b", "c"});
+  SetUpExpectCalls(2);
+  command_line->AppendSwitchPath("test-launcher-timings",
+                                 FilePath(FILE_PATH_LITERAL("missing.json")));
+
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  EXPECT_CALL(test_launcher, LaunchChildGTestProcess(
+                                 _, ElementsAre("Test.a", "Test.b"), _, _))
+      .WillOnce(OnTestSuccesses(&test_launcher));
+  EXPECT_CALL(test_launcher,
+              LaunchChildGTestProcess(_, ElementsAre("Test.c"), _, _))
+      .WillOnce(OnTestSuccesses(&test_launcher));
+  EXPECT_TRUE(test_launcher.Run(command_line.get()));
+}
+
 // Unit tests to validate UnitTestLauncherDelegate implementation.
 class UnitTestLauncherDelegateTester : public testing::Test {
  protected:
@@ -99,6 +99,11 @@ const char switches::kTestLauncherTotalShards[] =
 // Time (in milliseconds) that the tests should wait before timing out.
 const char switches::kTestLauncherTimeout[] = "test-launcher-timeout";
 
+// Path to a test results summary written by an earlier run with
+// --test-launcher-summary-output. The recorded test durations are used to run
+// the longest tests first, and to size batches so that they finish together.
+const char switches::kTestLauncherTimings[] = "test-launcher-timings";
+
 // Path where to save a trace of test launcher's execution.
 const char switches::kTestLauncherTrace[] = "test-launcher-trace";
 
@@ -34,6 +34,7 @@ extern const char kTestLauncherSummaryOutput[];
 extern const char kTestLauncherTestPartResultsLimit[];
 extern const char kTestLauncherTotalShards[];
 extern const char kTestLauncherTimeout[];
+extern const char kTestLauncherTimings[];
 extern const char kTestLauncherTrace[];
 extern const char kTestTinyTimeout[];
 extern const char kUiTestActionMaxTimeout[];
@@ -0,0 +1,23 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/coarse_tick_clock.h"
+
+#include "base/no_destructor.h"
+
+namespace base {
+
+CoarseTickClock::~CoarseTickClock() = default;
+
+TimeTicks CoarseTickClock::NowTicks() const {
+  return TimeTicks::NowCoarse();
+}
+
+// static
+const CoarseTickClock* CoarseTickClock::GetInstance() {
+  static const base::NoDestructor<CoarseTickClock> coarse_tick_clock;
+  return coarse_tick_clock.get();
+}
+
+}  // namespace base
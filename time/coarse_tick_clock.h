@@ -0,0 +1,30 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TIME_COARSE_TICK_CLOCK_H_
+#define BASE_TIME_COARSE_TICK_CLOCK_H_
+
+#include "base/base_export.h"
+#include "base/time/tick_clock.h"
+
+namespace base {
+
+// CoarseTickClock is a TickClock implementation that uses
+// TimeTicks::NowCoarse(). Components which timestamp many events but only need
+// millisecond accuracy, e.g. a SequenceManager recording task queueing times,
+// can opt into it instead of DefaultTickClock.
+class BASE_EXPORT CoarseTickClock : public TickClock {
+ public:
+  ~CoarseTickClock() override;
+
+  // Simply returns TimeTicks::NowCoarse().
+  TimeTicks NowTicks() const override;
+
+  // Returns a shared instance of CoarseTickClock. This is thread-safe.
+  static const CoarseTickClock* GetInstance();
+};
+
+}  // namespace base
+
+#endif  // BASE_TIME_COARSE_TICK_CLOCK_H_
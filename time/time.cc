@@ -136,6 +136,9 @@ TimeNowFunction g_time_now_from_system_time_function =
 TimeTicksNowFunction g_time_ticks_now_function =
     &subtle::TimeTicksNowIgnoringOverride;
 
+TimeTicksNowFunction g_time_ticks_now_coarse_function =
+    &subtle::TimeTicksNowCoarseIgnoringOverride;
+
 ThreadTicksNowFunction g_thread_ticks_now_function =
     &subtle::ThreadTicksNowIgnoringOverride;
 
@@ -477,6 +480,11 @@ TimeTicks TimeTicks::Now() {
   return internal::g_time_ticks_now_function();
 }
 
+// static
+TimeTicks TimeTicks::NowCoarse() {
+  return internal::g_time_ticks_now_coarse_function();
+}
+
 // static
 TimeTicks TimeTicks::UnixEpoch() {
   static const NoDestructor<TimeTicks> epoch([]() {
@@ -953,6 +953,14 @@ class BASE_EXPORT TimeTicks : public time_internal::TimeBase<TimeTicks> {
   // microsecond.
   static TimeTicks Now();
 
+  // Like Now(), but trades resolution for speed where the platform has a
+  // cheaper clock. On Linux and Android this reads CLOCK_MONOTONIC_COARSE,
+  // which the vDSO serves without reading the hardware counter and which
+  // advances once per scheduler tick (typically 1-4ms). Values share Now()'s
+  // origin, but may lag it by up to one tick. Elsewhere this is Now(). Use it
+  // for timestamps which only need millisecond accuracy on hot paths.
+  static TimeTicks NowCoarse();
+
   // Returns true if the high resolution clock is working on this system and
   // Now() will return high resolution values. Note that, on systems where the
   // high resolution clock works but is deemed inefficient, the low resolution
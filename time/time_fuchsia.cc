@@ -37,6 +37,10 @@ TimeTicks TimeTicksNowIgnoringOverride() {
   CHECK_NE(0, nanos_since_boot);
   return TimeTicks::FromZxTime(nanos_since_boot);
 }
+
+TimeTicks TimeTicksNowCoarseIgnoringOverride() {
+  return TimeTicksNowIgnoringOverride();
+}
 }  // namespace subtle
 
 // static
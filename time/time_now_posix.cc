@@ -98,6 +98,20 @@ TimeTicks TimeTicksNowIgnoringOverride() {
   return TimeTicks() + TimeDelta::FromMicroseconds(ClockNow(CLOCK_MONOTONIC));
 }
 
+TimeTicks TimeTicksNowCoarseIgnoringOverride() {
+#if defined(CLOCK_MONOTONIC_COARSE)
+  // Shares CLOCK_MONOTONIC's origin, but is read from the vDSO's last tick
+  // update instead of the clock source. Not supported by very old kernels.
+  static const bool coarse_clock_supported =
+      MaybeClockNow(CLOCK_MONOTONIC_COARSE).has_value();
+  if (coarse_clock_supported) {
+    return TimeTicks() +
+           TimeDelta::FromMicroseconds(ClockNow(CLOCK_MONOTONIC_COARSE));
+  }
+#endif
+  return TimeTicksNowIgnoringOverride();
+}
+
 base::Optional<TimeTicks> MaybeTimeTicksNowIgnoringOverride() {
   base::Optional<int64_t> now = MaybeClockNow(CLOCK_MONOTONIC);
   if (now.has_value())
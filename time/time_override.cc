@@ -20,8 +20,10 @@ ScopedTimeClockOverrides::ScopedTimeClockOverrides(
     internal::g_time_now_function = time_override;
     internal::g_time_now_from_system_time_function = time_override;
   }
-  if (time_ticks_override)
+  if (time_ticks_override) {
     internal::g_time_ticks_now_function = time_ticks_override;
+    internal::g_time_ticks_now_coarse_function = time_ticks_override;
+  }
   if (thread_ticks_override)
     internal::g_thread_ticks_now_function = thread_ticks_override;
 }
@@ -31,6 +33,8 @@ ScopedTimeClockOverrides::~ScopedTimeClockOverrides() {
   internal::g_time_now_from_system_time_function =
       &TimeNowFromSystemTimeIgnoringOverride;
   internal::g_time_ticks_now_function = &TimeTicksNowIgnoringOverride;
+  internal::g_time_ticks_now_coarse_function =
+      &TimeTicksNowCoarseIgnoringOverride;
   internal::g_thread_ticks_now_function = &ThreadTicksNowIgnoringOverride;
   overrides_active_ = false;
 }
@@ -22,10 +22,11 @@ using ThreadTicksNowFunction = decltype(&ThreadTicks::Now);
 namespace subtle {
 
 // Override the return value of Time::Now and Time::NowFromSystemTime /
-// TimeTicks::Now / ThreadTicks::Now to emulate time, e.g. for tests or to
-// modify progression of time. Note that the override should be set while
-// single-threaded and before the first call to Now() to avoid threading issues
-// and inconsistencies in returned values. Nested overrides are not allowed.
+// TimeTicks::Now and TimeTicks::NowCoarse / ThreadTicks::Now to emulate time,
+// e.g. for tests or to modify progression of time. Note that the override
+// should be set while single-threaded and before the first call to Now() to
+// avoid threading issues and inconsistencies in returned values. Nested
+// overrides are not allowed.
 class BASE_EXPORT ScopedTimeClockOverrides {
  public:
   // Pass |nullptr| for any override if it shouldn't be overriden.
@@ -52,6 +53,7 @@ class BASE_EXPORT ScopedTimeClockOverrides {
 BASE_EXPORT Time TimeNowIgnoringOverride();
 BASE_EXPORT Time TimeNowFromSystemTimeIgnoringOverride();
 BASE_EXPORT TimeTicks TimeTicksNowIgnoringOverride();
+BASE_EXPORT TimeTicks TimeTicksNowCoarseIgnoringOverride();
 BASE_EXPORT ThreadTicks ThreadTicksNowIgnoringOverride();
 
 #if defined(OS_POSIX)
@@ -74,6 +76,7 @@ namespace internal {
 extern TimeNowFunction g_time_now_function;
 extern TimeNowFunction g_time_now_from_system_time_function;
 extern TimeTicksNowFunction g_time_ticks_now_function;
+extern TimeTicksNowFunction g_time_ticks_now_coarse_function;
 extern ThreadTicksNowFunction g_thread_ticks_now_function;
 
 }  // namespace internal
@@ -0,0 +1,73 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/time.h"
+
+#include <string>
+
+#include "base/time/tsc_tick_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixTime[] = "Time.";
+constexpr char kMetricTimePerCall[] = "time_per_call";
+constexpr char kStoryTimeNow[] = "time_now";
+constexpr char kStoryTimeTicksNow[] = "time_ticks_now";
+constexpr char kStoryTimeTicksNowCoarse[] = "time_ticks_now_coarse";
+constexpr char kStoryTscTickClock[] = "tsc_tick_clock";
+constexpr char kStoryThreadTicksNow[] = "thread_ticks_now";
+
+constexpr int kLaps = 1000000;
+
+void ReportTimePerCall(const std::string& story_name, TimeDelta duration) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixTime, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerCall, "ns");
+  reporter.AddResult(kMetricTimePerCall,
+                     duration.InNanoseconds() / static_cast<double>(kLaps));
+}
+
+// Calls |now| kLaps times and reports the average cost of a call. The results
+// are summed so that the calls can't be optimized away.
+template <typename NowFunction>
+void MeasureNow(const std::string& story_name, NowFunction now) {
+  TimeDelta sum;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kLaps; ++i)
+    sum += now().since_origin();
+  ReportTimePerCall(story_name, TimeTicks::Now() - start);
+  EXPECT_FALSE(sum.is_zero());
+}
+
+}  // namespace
+
+TEST(TimePerfTest, TimeNow) {
+  MeasureNow(kStoryTimeNow, &Time::Now);
+}
+
+TEST(TimePerfTest, TimeTicksNow) {
+  MeasureNow(kStoryTimeTicksNow, &TimeTicks::Now);
+}
+
+TEST(TimePerfTest, TimeTicksNowCoarse) {
+  MeasureNow(kStoryTimeTicksNowCoarse, &TimeTicks::NowCoarse);
+}
+
+TEST(TimePerfTest, TscTickClock) {
+  if (!TscTickClock::IsSupported())
+    return;
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  MeasureNow(kStoryTscTickClock, [clock] { return clock->NowTicks(); });
+}
+
+TEST(TimePerfTest, ThreadTicksNow) {
+  if (!ThreadTicks::IsSupported())
+    return;
+  MeasureNow(kStoryThreadTicksNow, &ThreadTicks::Now);
+}
+
+}  // namespace base
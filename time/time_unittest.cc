@@ -1294,6 +1294,21 @@ TEST(TimeTicks, HighRes) {
   HighResClockTest(&TimeTicks::Now);
 }
 
+TEST(TimeTicks, NowCoarse) {
+  TimeTicks last_coarse = TimeTicks::NowCoarse();
+  for (int i = 0; i < 1000; ++i) {
+    const TimeTicks before = TimeTicks::Now();
+    const TimeTicks coarse = TimeTicks::NowCoarse();
+    const TimeTicks after = TimeTicks::Now();
+    // The coarse clock shares Now()'s origin but may lag it by a tick, which
+    // is at most 10ms with the lowest common kernel HZ setting.
+    EXPECT_LE(coarse, after);
+    EXPECT_LT(before - coarse, TimeDelta::FromMilliseconds(50));
+    EXPECT_LE(last_coarse, coarse);
+    last_coarse = coarse;
+  }
+}
+
 class TimeTicksOverride {
  public:
   static TimeTicks Now() {
@@ -1332,6 +1347,10 @@ TEST(TimeTicks, NowOverride) {
 
     // IgnoringOverride methods didn't call NowOverrideTickClock::NowTicks().
     EXPECT_EQ(TimeTicks::Min() + TimeDelta::FromSeconds(3), TimeTicks::Now());
+
+    // NowCoarse() is overridden too.
+    EXPECT_EQ(TimeTicks::Min() + TimeDelta::FromSeconds(4),
+              TimeTicks::NowCoarse());
   }
 
   // All methods return real ticks again.
@@ -600,6 +600,10 @@ namespace subtle {
 TimeTicks TimeTicksNowIgnoringOverride() {
   return g_time_ticks_now_ignoring_override_function();
 }
+
+TimeTicks TimeTicksNowCoarseIgnoringOverride() {
+  return g_time_ticks_now_ignoring_override_function();
+}
 }  // namespace subtle
 
 // static
@@ -0,0 +1,129 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/tsc_tick_clock.h"
+
+#include <stdint.h>
+
+#include "base/no_destructor.h"
+#include "base/time/time_override.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && (defined(OS_LINUX) || defined(OS_CHROMEOS))
+#define TSC_TICK_CLOCK_SUPPORTED
+#endif
+
+#if defined(TSC_TICK_CLOCK_SUPPORTED)
+#include <time.h>
+#include <x86intrin.h>
+
+#include "base/check.h"
+#include "base/cpu.h"
+#endif
+
+namespace base {
+
+namespace {
+
+#if defined(TSC_TICK_CLOCK_SUPPORTED)
+
+// How long to measure the TSC rate for. The error of both clocks' readings is
+// in the tens of nanoseconds, so this gives a rate accurate to a few ppm.
+constexpr int64_t kCalibrationNanoseconds = 10 * 1000 * 1000;
+
+int64_t MonotonicNanoseconds() {
+  struct timespec ts;
+  CHECK_EQ(0, clock_gettime(CLOCK_MONOTONIC, &ts));
+  return static_cast<int64_t>(ts.tv_sec) * Time::kNanosecondsPerSecond +
+         ts.tv_nsec;
+}
+
+struct Calibration {
+  bool supported = false;
+  uint64_t tsc_origin = 0;
+  int64_t nanoseconds_origin = 0;
+  double nanoseconds_per_tsc_tick = 0;
+};
+
+// Reads CLOCK_MONOTONIC and the TSC value at the middle of the read.
+void Sample(int64_t* nanoseconds, uint64_t* tsc) {
+  const uint64_t before = __rdtsc();
+  *nanoseconds = MonotonicNanoseconds();
+  const uint64_t after = __rdtsc();
+  *tsc = before + (after - before) / 2;
+}
+
+Calibration Calibrate() {
+  Calibration calibration;
+  if (!CPU().has_non_stop_time_stamp_counter())
+    return calibration;
+
+  int64_t start_nanoseconds;
+  uint64_t start_tsc;
+  Sample(&start_nanoseconds, &start_tsc);
+  int64_t end_nanoseconds;
+  uint64_t end_tsc;
+  do {
+    Sample(&end_nanoseconds, &end_tsc);
+  } while (end_nanoseconds - start_nanoseconds < kCalibrationNanoseconds);
+  // Don't trust a TSC which didn't advance, e.g. in a misconfigured VM.
+  if (end_tsc <= start_tsc)
+    return calibration;
+
+  calibration.supported = true;
+  calibration.tsc_origin = end_tsc;
+  calibration.nanoseconds_origin = end_nanoseconds;
+  calibration.nanoseconds_per_tsc_tick =
+      static_cast<double>(end_nanoseconds - start_nanoseconds) /
+      static_cast<double>(end_tsc - start_tsc);
+  return calibration;
+}
+
+const Calibration& GetCalibration() {
+  static const NoDestructor<Calibration> calibration(Calibrate());
+  return *calibration;
+}
+
+#endif  // defined(TSC_TICK_CLOCK_SUPPORTED)
+
+}  // namespace
+
+TscTickClock::~TscTickClock() = default;
+
+TimeTicks TscTickClock::NowTicks() const {
+#if defined(TSC_TICK_CLOCK_SUPPORTED)
+  const Calibration& calibration = GetCalibration();
+  if (calibration.supported &&
+      internal::g_time_ticks_now_function ==
+          &subtle::TimeTicksNowIgnoringOverride) {
+    // Signed, in case another core's TSC is slightly behind the one which was
+    // calibrated.
+    const int64_t elapsed_ticks =
+        static_cast<int64_t>(__rdtsc() - calibration.tsc_origin);
+    const int64_t nanoseconds =
+        calibration.nanoseconds_origin +
+        static_cast<int64_t>(static_cast<double>(elapsed_ticks) *
+                             calibration.nanoseconds_per_tsc_tick);
+    return TimeTicks() + TimeDelta::FromNanoseconds(nanoseconds);
+  }
+#endif  // defined(TSC_TICK_CLOCK_SUPPORTED)
+  return TimeTicks::Now();
+}
+
+// static
+bool TscTickClock::IsSupported() {
+#if defined(TSC_TICK_CLOCK_SUPPORTED)
+  return GetCalibration().supported;
+#else
+  return false;
+#endif
+}
+
+// static
+const TscTickClock* TscTickClock::GetInstance() {
+  static const base::NoDestructor<TscTickClock> tsc_tick_clock;
+  return tsc_tick_clock.get();
+}
+
+}  // namespace base
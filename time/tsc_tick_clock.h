@@ -0,0 +1,41 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TIME_TSC_TICK_CLOCK_H_
+#define BASE_TIME_TSC_TICK_CLOCK_H_
+
+#include "base/base_export.h"
+#include "base/time/tick_clock.h"
+
+namespace base {
+
+// TscTickClock is a TickClock implementation which reads the CPU's time stamp
+// counter directly, without going through the kernel or the vDSO. It's only
+// used on x86 Linux and ChromeOS with an invariant TSC, i.e. one which ticks at
+// a constant rate in all power states and is synchronized across cores;
+// elsewhere, and while TimeTicks::Now() is overridden, it returns
+// TimeTicks::Now().
+//
+// The TSC frequency is calibrated against TimeTicks::Now() on first use, which
+// blocks for about 10ms. Values start out close to TimeTicks::Now() but may
+// drift from it by a few microseconds per second, so use this clock to measure
+// intervals on hot paths, and don't compare its values with those of other
+// clocks. Values are not consistent across processes.
+class BASE_EXPORT TscTickClock : public TickClock {
+ public:
+  ~TscTickClock() override;
+
+  TimeTicks NowTicks() const override;
+
+  // Returns true if NowTicks() reads the TSC. This calibrates the clock if
+  // that wasn't done yet.
+  static bool IsSupported();
+
+  // Returns a shared instance of TscTickClock. This is thread-safe.
+  static const TscTickClock* GetInstance();
+};
+
+}  // namespace base
+
+#endif  // BASE_TIME_TSC_TICK_CLOCK_H_
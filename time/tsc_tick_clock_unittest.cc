@@ -0,0 +1,55 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/tsc_tick_clock.h"
+
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/time/time_override.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+TimeTicks OverriddenNow() {
+  return TimeTicks() + TimeDelta::FromSeconds(42);
+}
+
+}  // namespace
+
+TEST(TscTickClockTest, IsMonotonic) {
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  TimeTicks last = clock->NowTicks();
+  for (int i = 0; i < 10000; ++i) {
+    const TimeTicks now = clock->NowTicks();
+    EXPECT_LE(last, now);
+    last = now;
+  }
+}
+
+// Intervals measured with the TSC match those measured with TimeTicks::Now().
+TEST(TscTickClockTest, MatchesNow) {
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  // Calibrate the clock first, so that it isn't timed below.
+  TscTickClock::IsSupported();
+  const TimeTicks start = TimeTicks::Now();
+  const TimeTicks tsc_start = clock->NowTicks();
+  PlatformThread::Sleep(TimeDelta::FromMilliseconds(50));
+  const TimeDelta tsc_elapsed = clock->NowTicks() - tsc_start;
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_GE(tsc_elapsed, TimeDelta::FromMilliseconds(50));
+  EXPECT_LT((tsc_elapsed - elapsed).magnitude(),
+            TimeDelta::FromMilliseconds(1));
+  // The calibration anchors the clock to TimeTicks::Now().
+  EXPECT_LT((tsc_start - start).magnitude(), TimeDelta::FromSeconds(1));
+}
+
+TEST(TscTickClockTest, HonorsOverride) {
+  subtle::ScopedTimeClockOverrides overrides(nullptr, &OverriddenNow, nullptr);
+  EXPECT_EQ(OverriddenNow(), TscTickClock::GetInstance()->NowTicks());
+}
+
+}  // namespace base
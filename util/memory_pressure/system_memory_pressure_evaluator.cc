@@ -24,8 +24,11 @@
 namespace util {
 
 #if defined(OS_WIN)
-constexpr base::Feature kUseWinOSMemoryPressureSignals{
+const base::Feature kUseWinOSMemoryPressureSignals{
     "UseWinOSMemoryPressureSignals", base::FEATURE_DISABLED_BY_DEFAULT};
+#elif defined(OS_LINUX) || BUILDFLAG(IS_CHROMEOS_LACROS)
+const base::Feature kUseLinuxPsiMemoryPressureSignals{
+    "UseLinuxPsiMemoryPressureSignals", base::FEATURE_DISABLED_BY_DEFAULT};
 #endif
 
 // static
@@ -51,8 +54,14 @@ SystemMemoryPressureEvaluator::CreateDefaultSystemEvaluator(
 // TODO(crbug.com/1052397): Revisit the macro expression once build flag switch
 // of lacros-chrome is complete.
 #elif defined(OS_LINUX) || BUILDFLAG(IS_CHROMEOS_LACROS)
-  return std::make_unique<util::os_linux::SystemMemoryPressureEvaluator>(
-      monitor->CreateVoter());
+  auto evaluator =
+      std::make_unique<util::os_linux::SystemMemoryPressureEvaluator>(
+          monitor->CreateVoter());
+  // Also subscribe to the kernel's memory stall notifications if the feature
+  // is enabled. Polling continues if they're unavailable.
+  if (base::FeatureList::IsEnabled(kUseLinuxPsiMemoryPressureSignals))
+    evaluator->CreatePsiPressureEvaluator(monitor->CreateVoter());
+  return evaluator;
 #endif
   return nullptr;
 }
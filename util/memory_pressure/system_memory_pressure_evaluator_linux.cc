@@ -4,20 +4,49 @@
 
 #include "base/util/memory_pressure/system_memory_pressure_evaluator_linux.h"
 
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/files/file_descriptor_watcher_posix.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_file.h"
+#include "base/logging.h"
+#include "base/memory/weak_ptr.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/process/process_metrics.h"
-#include "base/single_thread_task_runner.h"
-#include "base/task/post_task.h"
+#include "base/sequence_checker.h"
+#include "base/sequenced_task_runner.h"
+#include "base/stl_util.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/task_traits.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "base/threading/sequence_bound.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/time/time.h"
-#include "base/util/memory_pressure/multi_source_memory_pressure_monitor.h"
 
 namespace {
 
 constexpr int kKiBperMiB = 1024;
 
+constexpr char kProcSelfCgroupPath[] = "/proc/self/cgroup";
+constexpr char kProcPressureMemoryPath[] = "/proc/pressure/memory";
+constexpr char kCgroupV2EntryPrefix[] = "0::/";
+constexpr char kCgroupV2Root[] = "/sys/fs/cgroup";
+constexpr char kCgroupMemoryPressureFile[] = "memory.pressure";
+
 int GetAvailableSystemMemoryMiB(const base::SystemMemoryInfoKB& mem_info) {
   // Use 'available' metric if is is present,
   // if no (kernels < 3.14), let's make a rough evaluation using free physical
@@ -41,6 +70,299 @@ const base::TimeDelta SystemMemoryPressureEvaluator::kModeratePressureCooldown =
 const int SystemMemoryPressureEvaluator::kDefaultModerateThresholdPc = 75;
 const int SystemMemoryPressureEvaluator::kDefaultCriticalThresholdPc = 85;
 
+// Unprivileged processes may only register triggers with a window that is a
+// multiple of 2 seconds.
+const base::TimeDelta SystemMemoryPressureEvaluator::kPsiWindow =
+    base::TimeDelta::FromSeconds(2);
+const base::TimeDelta SystemMemoryPressureEvaluator::kPsiModerateStall =
+    base::TimeDelta::FromMilliseconds(150);
+const base::TimeDelta SystemMemoryPressureEvaluator::kPsiCriticalStall =
+    base::TimeDelta::FromMilliseconds(150);
+const base::TimeDelta SystemMemoryPressureEvaluator::kPsiEventDecay =
+    2 * SystemMemoryPressureEvaluator::kPsiWindow;
+
+namespace {
+
+using MemoryPressureLevel = base::MemoryPressureListener::MemoryPressureLevel;
+
+// Registers the PSI triggers and watches them. Lives on a ThreadPool sequence
+// that may block, and posts the events to the sequence it was created from.
+class PsiTriggerWatcher {
+ public:
+  using EventCallback = base::RepeatingCallback<void(MemoryPressureLevel)>;
+
+  PsiTriggerWatcher(scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
+                    EventCallback on_event,
+                    base::OnceCallback<void(bool)> on_started)
+      : reply_task_runner_(std::move(reply_task_runner)),
+        on_event_(std::move(on_event)) {
+    std::move(on_started).Run(Start());
+  }
+  PsiTriggerWatcher(const PsiTriggerWatcher&) = delete;
+  PsiTriggerWatcher& operator=(const PsiTriggerWatcher&) = delete;
+  ~PsiTriggerWatcher() = default;
+
+ private:
+  struct Trigger {
+    MemoryPressureLevel level;
+    base::ScopedFD psi_fd;
+    base::ScopedFD epoll_fd;
+    std::unique_ptr<base::FileDescriptorWatcher::Controller> controller;
+  };
+
+  // Registers the triggers on the cgroup v2 memory.pressure file if there is
+  // one, falling back to the system-wide file. Returns false if neither
+  // accepts the triggers.
+  bool Start() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    base::ScopedBlockingCall scoped_blocking_call(
+        FROM_HERE, base::BlockingType::MAY_BLOCK);
+
+    std::vector<base::FilePath> paths;
+    std::string proc_self_cgroup;
+    if (base::ReadFileToString(base::FilePath(kProcSelfCgroupPath),
+                               &proc_self_cgroup)) {
+      base::FilePath cgroup_path =
+          SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+              proc_self_cgroup);
+      if (!cgroup_path.empty())
+        paths.push_back(std::move(cgroup_path));
+    }
+    paths.push_back(base::FilePath(kProcPressureMemoryPath));
+
+    // Moderate pressure when some tasks stall on memory, critical pressure
+    // when all non-idle tasks do.
+    using Evaluator = SystemMemoryPressureEvaluator;
+    for (const base::FilePath& path : paths) {
+      if (AddTrigger(path, base::MemoryPressureListener::
+                               MEMORY_PRESSURE_LEVEL_MODERATE,
+                     "some", Evaluator::kPsiModerateStall) &&
+          AddTrigger(path, base::MemoryPressureListener::
+                               MEMORY_PRESSURE_LEVEL_CRITICAL,
+                     "full", Evaluator::kPsiCriticalStall)) {
+        return true;
+      }
+      triggers_.clear();
+    }
+    return false;
+  }
+
+  bool AddTrigger(const base::FilePath& path,
+                  MemoryPressureLevel level,
+                  const char* stall_type,
+                  base::TimeDelta stall) {
+    auto trigger = std::make_unique<Trigger>();
+    trigger->level = level;
+    trigger->psi_fd.reset(HANDLE_EINTR(
+        open(path.value().c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC)));
+    if (!trigger->psi_fd.is_valid())
+      return false;
+
+    // The kernel expects "<some|full> <stall us> <window us>", including the
+    // terminating NUL.
+    const std::string config = base::StringPrintf(
+        "%s %" PRId64 " %" PRId64, stall_type, stall.InMicroseconds(),
+        SystemMemoryPressureEvaluator::kPsiWindow.InMicroseconds());
+    if (HANDLE_EINTR(write(trigger->psi_fd.get(), config.c_str(),
+                           config.size() + 1)) < 0) {
+      DPLOG(WARNING) << "Unable to register PSI trigger on " << path;
+      return false;
+    }
+
+    // PSI events are signaled with POLLPRI, which FileDescriptorWatcher can't
+    // wait for. An epoll instance watching for EPOLLPRI becomes readable when
+    // the trigger fires, so watch that instead.
+    trigger->epoll_fd.reset(epoll_create1(EPOLL_CLOEXEC));
+    if (!trigger->epoll_fd.is_valid())
+      return false;
+    epoll_event event = {};
+    event.events = EPOLLPRI;
+    if (epoll_ctl(trigger->epoll_fd.get(), EPOLL_CTL_ADD,
+                  trigger->psi_fd.get(), &event) != 0) {
+      return false;
+    }
+
+    trigger->controller = base::FileDescriptorWatcher::WatchReadable(
+        trigger->epoll_fd.get(),
+        base::BindRepeating(&PsiTriggerWatcher::OnTriggerReadable,
+                            base::Unretained(this),
+                            base::Unretained(trigger.get())));
+    triggers_.push_back(std::move(trigger));
+    return true;
+  }
+
+  void OnTriggerReadable(Trigger* trigger) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    // Consume the event so that the epoll instance stops being readable. It
+    // may already have been consumed while polling the epoll instance itself,
+    // in which case this returns nothing but the trigger did fire.
+    epoll_event event = {};
+    const int num_events =
+        HANDLE_EINTR(epoll_wait(trigger->epoll_fd.get(), &event, 1, 0));
+    if (num_events > 0 && (event.events & EPOLLERR)) {
+      // The trigger is gone, e.g. because its cgroup was removed.
+      trigger->controller.reset();
+      return;
+    }
+
+    reply_task_runner_->PostTask(FROM_HERE,
+                                 base::BindOnce(on_event_, trigger->level));
+  }
+
+  const scoped_refptr<base::SequencedTaskRunner> reply_task_runner_;
+  const EventCallback on_event_;
+  std::vector<std::unique_ptr<Trigger>> triggers_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace
+
+// Votes based on the PSI triggers. Lives on the SystemMemoryPressureEvaluator's
+// sequence.
+class SystemMemoryPressureEvaluator::PsiMemoryPressureEvaluator {
+ public:
+  explicit PsiMemoryPressureEvaluator(
+      std::unique_ptr<MemoryPressureVoter> voter)
+      : voter_(std::move(voter)) {}
+  PsiMemoryPressureEvaluator(const PsiMemoryPressureEvaluator&) = delete;
+  PsiMemoryPressureEvaluator& operator=(const PsiMemoryPressureEvaluator&) =
+      delete;
+  ~PsiMemoryPressureEvaluator() = default;
+
+  // Registers the triggers on a ThreadPool sequence, then runs |on_started| if
+  // that succeeded.
+  void Start(base::OnceClosure on_started) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    // Highest priority: the point of PSI is to react before the system starts
+    // thrashing.
+    watcher_ = base::SequenceBound<PsiTriggerWatcher>(
+        base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN}),
+        base::SequencedTaskRunnerHandle::Get(),
+        base::BindRepeating(&PsiMemoryPressureEvaluator::OnPsiEvent,
+                            weak_ptr_factory_.GetWeakPtr()),
+        base::BindPostTask(
+            base::SequencedTaskRunnerHandle::Get(),
+            base::BindOnce(&PsiMemoryPressureEvaluator::OnStarted,
+                           weak_ptr_factory_.GetWeakPtr(),
+                           std::move(on_started))));
+  }
+
+  // Unregisters the triggers and withdraws the vote.
+  void Stop() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    // Drop the events and the start notification which are still in flight.
+    weak_ptr_factory_.InvalidateWeakPtrs();
+    watcher_.Reset();
+    decay_timer_.Stop();
+    last_moderate_event_ = base::TimeTicks();
+    last_critical_event_ = base::TimeTicks();
+    current_vote_ = base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE;
+    voter_->SetVote(current_vote_, false);
+  }
+
+  // Called when the trigger for |level| fires.
+  void OnPsiEvent(MemoryPressureLevel level) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    const bool critical_event =
+        level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+    if (critical_event) {
+      last_critical_event_ = base::TimeTicks::Now();
+    } else {
+      DCHECK_EQ(level,
+                base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+      last_moderate_event_ = base::TimeTicks::Now();
+    }
+    UpdateVote(critical_event);
+  }
+
+ private:
+  void OnStarted(base::OnceClosure on_started, bool success) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (success) {
+      std::move(on_started).Run();
+    } else {
+      DVLOG(1) << "PSI triggers unavailable, polling /proc/meminfo instead.";
+      watcher_.Reset();
+    }
+  }
+
+  // Returns the highest level whose trigger fired within |kPsiEventDecay|.
+  MemoryPressureLevel GetLevel(base::TimeTicks now) const {
+    if (!last_critical_event_.is_null() &&
+        now - last_critical_event_ < kPsiEventDecay) {
+      return base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+    }
+    if (!last_moderate_event_.is_null() &&
+        now - last_moderate_event_ < kPsiEventDecay) {
+      return base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE;
+    }
+    return base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE;
+  }
+
+  // Recomputes the vote. The notification policy matches the /proc/meminfo
+  // based evaluator, except that critical pressure is re-notified on each
+  // critical trigger event rather than on each poll.
+  void UpdateVote(bool critical_event) {
+    const base::TimeTicks now = base::TimeTicks::Now();
+    const MemoryPressureLevel old_vote = current_vote_;
+    current_vote_ = GetLevel(now);
+
+    bool notify = false;
+    switch (current_vote_) {
+      case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+        break;
+
+      case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+        if (old_vote != current_vote_ ||
+            now - last_moderate_notification_ >= kModeratePressureCooldown) {
+          last_moderate_notification_ = now;
+          notify = true;
+        }
+        break;
+
+      case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+        notify = critical_event;
+        break;
+    }
+    voter_->SetVote(current_vote_, notify);
+
+    // The kernel doesn't report the end of a stall, so lower the vote once the
+    // events for the current level stop.
+    if (current_vote_ ==
+        base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+      decay_timer_.Stop();
+      return;
+    }
+    const base::TimeTicks last_event =
+        current_vote_ ==
+                base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL
+            ? last_critical_event_
+            : last_moderate_event_;
+    decay_timer_.Start(FROM_HERE, last_event + kPsiEventDecay - now,
+                       base::BindOnce(&PsiMemoryPressureEvaluator::UpdateVote,
+                                      base::Unretained(this),
+                                      /* critical_event=*/false));
+  }
+
+  std::unique_ptr<MemoryPressureVoter> voter_;
+  base::SequenceBound<PsiTriggerWatcher> watcher_;
+
+  MemoryPressureLevel current_vote_ =
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE;
+  base::TimeTicks last_moderate_event_;
+  base::TimeTicks last_critical_event_;
+  base::TimeTicks last_moderate_notification_;
+  base::OneShotTimer decay_timer_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<PsiMemoryPressureEvaluator> weak_ptr_factory_{this};
+};
+
 SystemMemoryPressureEvaluator::SystemMemoryPressureEvaluator(
     std::unique_ptr<MemoryPressureVoter> voter)
     : util::SystemMemoryPressureEvaluator(std::move(voter)),
@@ -62,6 +384,69 @@ SystemMemoryPressureEvaluator::SystemMemoryPressureEvaluator(
   StartObserving();
 }
 
+SystemMemoryPressureEvaluator::~SystemMemoryPressureEvaluator() = default;
+
+void SystemMemoryPressureEvaluator::CreatePsiPressureEvaluator(
+    std::unique_ptr<MemoryPressureVoter> voter) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!base::ThreadPoolInstance::Get())
+    return;
+  psi_evaluator_ =
+      std::make_unique<PsiMemoryPressureEvaluator>(std::move(voter));
+  // Only stop polling once the triggers are registered; StopObserving() would
+  // also stop the triggers. Unretained is safe because |this| owns
+  // |psi_evaluator_|, which doesn't run the callback after it's destroyed.
+  psi_evaluator_->Start(
+      base::BindOnce(&SystemMemoryPressureEvaluator::OnPsiTriggersRegistered,
+                     base::Unretained(this)));
+}
+
+void SystemMemoryPressureEvaluator::OnPsiTriggersRegistered() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Nothing updates the polling vote from now on, so withdraw it rather than
+  // leave it in the aggregate.
+  timer_.Stop();
+  moderate_pressure_repeat_count_ = 0;
+  SetCurrentVote(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE);
+  SendCurrentVote(false);
+}
+
+void SystemMemoryPressureEvaluator::CreatePsiPressureEvaluatorForTesting(
+    std::unique_ptr<MemoryPressureVoter> voter) {
+  psi_evaluator_ =
+      std::make_unique<PsiMemoryPressureEvaluator>(std::move(voter));
+}
+
+void SystemMemoryPressureEvaluator::SimulatePsiTriggersRegisteredForTesting() {
+  OnPsiTriggersRegistered();
+}
+
+void SystemMemoryPressureEvaluator::SimulatePsiEventForTesting(
+    MemoryPressureLevel level) {
+  psi_evaluator_->OnPsiEvent(level);
+}
+
+// static
+base::FilePath SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+    base::StringPiece proc_self_cgroup) {
+  for (base::StringPiece line :
+       base::SplitStringPiece(proc_self_cgroup, "\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    // The cgroup v2 entry is "0::<path relative to the cgroup2 mount>".
+    if (!base::StartsWith(line, kCgroupV2EntryPrefix))
+      continue;
+    base::StringPiece cgroup =
+        line.substr(base::size(kCgroupV2EntryPrefix) - 1);
+    // The root cgroup has no memory.pressure file.
+    if (cgroup.empty())
+      return base::FilePath();
+    return base::FilePath(kCgroupV2Root)
+        .Append(cgroup)
+        .Append(kCgroupMemoryPressureFile);
+  }
+  return base::FilePath();
+}
+
 void SystemMemoryPressureEvaluator::StartObserving() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   timer_.Start(
@@ -74,6 +459,8 @@ void SystemMemoryPressureEvaluator::StopObserving() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   // If StartObserving failed, StopObserving will still get called.
   timer_.Stop();
+  if (psi_evaluator_)
+    psi_evaluator_->Stop();
 }
 
 bool SystemMemoryPressureEvaluator::GetSystemMemoryInfo(
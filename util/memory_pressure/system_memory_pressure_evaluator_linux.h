@@ -5,8 +5,12 @@
 #ifndef BASE_UTIL_MEMORY_PRESSURE_SYSTEM_MEMORY_PRESSURE_EVALUATOR_LINUX_H_
 #define BASE_UTIL_MEMORY_PRESSURE_SYSTEM_MEMORY_PRESSURE_EVALUATOR_LINUX_H_
 
+#include <memory>
+
+#include "base/files/file_path.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/process/process_metrics.h"
+#include "base/strings/string_piece.h"
 #include "base/sequence_checker.h"
 #include "base/timer/timer.h"
 #include "base/util/memory_pressure/memory_pressure_voter.h"
@@ -15,10 +19,11 @@
 namespace util {
 namespace os_linux {
 
-// Linux memory pressure voter. Because there is no OS provided signal this
-// polls at a low frequency, and applies internal hysteresis.
-// TODO(https://crbug.com/1119396): use Pressure Stall Information (PSI) on
-// kernels >4.20.
+// Linux memory pressure voter. By default this polls /proc/meminfo at a low
+// frequency, and applies internal hysteresis. On kernels with Pressure Stall
+// Information (PSI) triggers (5.2+), CreatePsiPressureEvaluator() replaces the
+// polling with a second voter that reacts to memory stalls as soon as the
+// kernel reports them.
 class SystemMemoryPressureEvaluator
     : public util::SystemMemoryPressureEvaluator {
  public:
@@ -44,7 +49,7 @@ class SystemMemoryPressureEvaluator
                                 int critical_threshold_mb,
                                 std::unique_ptr<MemoryPressureVoter> voter);
 
-  ~SystemMemoryPressureEvaluator() override = default;
+  ~SystemMemoryPressureEvaluator() override;
 
   SystemMemoryPressureEvaluator(const SystemMemoryPressureEvaluator&) = delete;
   SystemMemoryPressureEvaluator& operator=(
@@ -56,6 +61,36 @@ class SystemMemoryPressureEvaluator
   // Returns the critical pressure level free memory threshold, in MB.
   int critical_threshold_mb() const { return critical_threshold_mb_; }
 
+  // Creates an evaluator which votes through |voter| based on PSI triggers
+  // registered on the memory.pressure file of the current cgroup (v2), or on
+  // /proc/pressure/memory. Once the triggers are registered the /proc/meminfo
+  // polling stops; if PSI is unavailable polling simply continues. Triggers
+  // are watched from a ThreadPool sequence, so this does nothing if there is
+  // no ThreadPool.
+  void CreatePsiPressureEvaluator(std::unique_ptr<MemoryPressureVoter> voter);
+
+  // Testing seams for the PSI evaluator. The first creates it without
+  // registering any trigger, the second behaves as if its triggers had just
+  // been registered, and the last as if the trigger for |level| had fired.
+  void CreatePsiPressureEvaluatorForTesting(
+      std::unique_ptr<MemoryPressureVoter> voter);
+  void SimulatePsiTriggersRegisteredForTesting();
+  void SimulatePsiEventForTesting(MemoryPressureLevel level);
+
+  // PSI trigger parameters. The kernel reports at most one event per window
+  // while the stall persists, and the vote decays once no event was received
+  // for |kPsiEventDecay|.
+  static const base::TimeDelta kPsiWindow;
+  static const base::TimeDelta kPsiModerateStall;
+  static const base::TimeDelta kPsiCriticalStall;
+  static const base::TimeDelta kPsiEventDecay;
+
+  // Returns the memory.pressure file of the cgroup v2 hierarchy entry in
+  // |proc_self_cgroup| (the contents of /proc/self/cgroup), or an empty path if
+  // the process isn't in a non-root cgroup v2.
+  static base::FilePath GetCgroupMemoryPressurePath(
+      base::StringPiece proc_self_cgroup);
+
  protected:
   // Internals are exposed for unittests.
 
@@ -63,7 +98,8 @@ class SystemMemoryPressureEvaluator
   // always be matched with calls to StopObserving.
   void StartObserving();
 
-  // Stop observing the memory fill level. May be safely called if
+  // Stop observing the memory fill level. This also unregisters the PSI
+  // triggers, if any, and resets their vote. May be safely called if
   // StartObserving has not been called. Must be called from the same thread on
   // which the monitor was instantiated.
   void StopObserving();
@@ -89,6 +125,12 @@ class SystemMemoryPressureEvaluator
   virtual bool GetSystemMemoryInfo(base::SystemMemoryInfoKB* mem_info);
 
  private:
+  class PsiMemoryPressureEvaluator;
+
+  // Called once the PSI triggers are registered. Stops the /proc/meminfo
+  // polling and withdraws its vote.
+  void OnPsiTriggersRegistered();
+
   // Threshold amounts of available memory that trigger pressure levels
   int moderate_threshold_mb_;
   int critical_threshold_mb_;
@@ -102,6 +144,10 @@ class SystemMemoryPressureEvaluator
   // |CalculateCurrentPressureLevel|.
   int moderate_pressure_repeat_count_;
 
+  // Optional PSI-based evaluator with its own voter, created by
+  // |CreatePsiPressureEvaluator|.
+  std::unique_ptr<PsiMemoryPressureEvaluator> psi_evaluator_;
+
   // Ensures that this object is used from a single sequence.
   SEQUENCE_CHECKER(sequence_checker_);
 };
@@ -5,6 +5,7 @@
 #include "base/util/memory_pressure/system_memory_pressure_evaluator_linux.h"
 
 #include "base/bind.h"
+#include "base/files/file_path.h"
 #include "base/run_loop.h"
 #include "base/test/task_environment.h"
 #include "base/util/memory_pressure/multi_source_memory_pressure_monitor.h"
@@ -30,6 +31,7 @@ class TestSystemMemoryPressureEvaluator : public SystemMemoryPressureEvaluator {
  public:
   using SystemMemoryPressureEvaluator::CalculateCurrentPressureLevel;
   using SystemMemoryPressureEvaluator::CheckMemoryPressure;
+  using SystemMemoryPressureEvaluator::StopObserving;
 
   static const unsigned long kKiBperMiB = 1024;
   static const unsigned long kMemoryTotalMb = 4096;
@@ -257,5 +259,183 @@ TEST_F(LinuxSystemMemoryPressureEvaluatorTest, CheckMemoryPressure) {
   testing::Mock::VerifyAndClearExpectations(&evaluator);
 }
 
+TEST(LinuxSystemMemoryPressureEvaluatorPsiTest, GetCgroupMemoryPressurePath) {
+  EXPECT_EQ(base::FilePath("/sys/fs/cgroup/user.slice/foo.scope/"
+                           "memory.pressure"),
+            SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+                "0::/user.slice/foo.scope\n"));
+  EXPECT_EQ(base::FilePath("/sys/fs/cgroup/app/memory.pressure"),
+            SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+                "12:memory:/legacy\n0::/app\n"));
+
+  // The root cgroup has no memory.pressure file.
+  EXPECT_TRUE(SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+                  "0::/\n")
+                  .empty());
+  // Neither does a process which is only in cgroup v1 hierarchies.
+  EXPECT_TRUE(SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath(
+                  "12:memory:/foo\n11:cpu,cpuacct:/foo\n")
+                  .empty());
+  EXPECT_TRUE(
+      SystemMemoryPressureEvaluator::GetCgroupMemoryPressurePath("").empty());
+}
+
+// Tests the votes and notifications produced by PSI trigger events, and that
+// the vote decays once the events stop.
+TEST(LinuxSystemMemoryPressureEvaluatorPsiTest, PsiEvents) {
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::TaskEnvironment::MainThreadType::UI,
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  MultiSourceMemoryPressureMonitor monitor;
+  monitor.ResetSystemEvaluatorForTesting();
+
+  testing::StrictMock<TestSystemMemoryPressureEvaluator> evaluator(
+      true, monitor.CreateVoter());
+  evaluator.CreatePsiPressureEvaluatorForTesting(monitor.CreateVoter());
+
+  base::MemoryPressureListener listener(
+      FROM_HERE,
+      base::BindRepeating(&TestSystemMemoryPressureEvaluator::OnMemoryPressure,
+                          base::Unretained(&evaluator)));
+
+  // A moderate stall is notified immediately.
+  EXPECT_CALL(
+      evaluator,
+      OnMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE));
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // Further moderate events within the cooldown aren't notified again.
+  task_environment.FastForwardBy(SystemMemoryPressureEvaluator::kPsiWindow);
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  base::RunLoop().RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // Each critical event is notified.
+  EXPECT_CALL(
+      evaluator,
+      OnMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL))
+      .Times(2);
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  base::RunLoop().RunUntilIdle();
+  task_environment.FastForwardBy(SystemMemoryPressureEvaluator::kPsiWindow);
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // A moderate event while the vote is critical isn't notified.
+  task_environment.FastForwardBy(SystemMemoryPressureEvaluator::kPsiWindow);
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // Once the critical events stop the vote drops back to moderate, which is
+  // notified.
+  EXPECT_CALL(
+      evaluator,
+      OnMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE));
+  task_environment.FastForwardBy(
+      SystemMemoryPressureEvaluator::kPsiEventDecay -
+      SystemMemoryPressureEvaluator::kPsiWindow);
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // Going down to no pressure should not produce a notification.
+  task_environment.FastForwardBy(SystemMemoryPressureEvaluator::kPsiEventDecay);
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+}
+
+// Tests that stopping the evaluator withdraws the PSI vote.
+TEST(LinuxSystemMemoryPressureEvaluatorPsiTest, StopObservingResetsPsiVote) {
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::TaskEnvironment::MainThreadType::UI,
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  MultiSourceMemoryPressureMonitor monitor;
+  monitor.ResetSystemEvaluatorForTesting();
+
+  testing::StrictMock<TestSystemMemoryPressureEvaluator> evaluator(
+      true, monitor.CreateVoter());
+  evaluator.CreatePsiPressureEvaluatorForTesting(monitor.CreateVoter());
+
+  base::MemoryPressureListener listener(
+      FROM_HERE,
+      base::BindRepeating(&TestSystemMemoryPressureEvaluator::OnMemoryPressure,
+                          base::Unretained(&evaluator)));
+
+  EXPECT_CALL(
+      evaluator,
+      OnMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL));
+  evaluator.SimulatePsiEventForTesting(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // The vote is withdrawn right away, without a notification or a decay.
+  evaluator.StopObserving();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE,
+            monitor.GetCurrentPressureLevel());
+  task_environment.FastForwardBy(SystemMemoryPressureEvaluator::kPsiEventDecay);
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE,
+            monitor.GetCurrentPressureLevel());
+}
+
+// Tests that registering the PSI triggers withdraws the vote of the
+// /proc/meminfo polling, which nothing would update anymore.
+TEST(LinuxSystemMemoryPressureEvaluatorPsiTest,
+     PsiTriggersWithdrawPollingVote) {
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::TaskEnvironment::MainThreadType::UI,
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  MultiSourceMemoryPressureMonitor monitor;
+  monitor.ResetSystemEvaluatorForTesting();
+
+  testing::StrictMock<TestSystemMemoryPressureEvaluator> evaluator(
+      true, monitor.CreateVoter());
+
+  base::MemoryPressureListener listener(
+      FROM_HERE,
+      base::BindRepeating(&TestSystemMemoryPressureEvaluator::OnMemoryPressure,
+                          base::Unretained(&evaluator)));
+
+  EXPECT_CALL(
+      evaluator,
+      OnMemoryPressure(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL));
+  evaluator.SetCritical();
+  evaluator.CheckMemoryPressure();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+            monitor.GetCurrentPressureLevel());
+  testing::Mock::VerifyAndClearExpectations(&evaluator);
+
+  // The vote is withdrawn right away, without a notification.
+  evaluator.CreatePsiPressureEvaluatorForTesting(monitor.CreateVoter());
+  evaluator.SimulatePsiTriggersRegisteredForTesting();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE,
+            monitor.GetCurrentPressureLevel());
+}
+
 }  // namespace os_linux
 }  // namespace util
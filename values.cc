@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include <cmath>
+#include <limits>
 #include <new>
 #include <ostream>
 #include <utility>
@@ -14,6 +15,7 @@
 #include "base/bit_cast.h"
 #include "base/check_op.h"
 #include "base/containers/checked_iterators.h"
+#include "base/hash/hash.h"
 #include "base/json/json_writer.h"
 #include "base/memory/ptr_util.h"
 #include "base/notreached.h"
@@ -35,6 +37,10 @@ namespace base {
 
 namespace {
 
+// Below this size, a binary search over the sorted storage is about as fast
+// as a hash lookup, and an index isn't worth its memory.
+constexpr size_t kDictIndexThreshold = 128;
+
 const char* const kTypeNames[] = {"null",   "boolean", "integer",    "double",
                                   "string", "binary",  "dictionary", "list"};
 static_assert(base::size(kTypeNames) ==
@@ -124,6 +130,124 @@ class PathSplitter {
 
 }  // namespace
 
+// An open addressing hash table, with linear probing, of the positions of the
+// keys in the sorted storage of a dictionary. Referring to the entries by
+// position keeps the index valid when the unique_ptrs in the storage are
+// replaced, and avoids a copy of the keys. Adding or erasing a key in the
+// middle of the storage shifts the positions after it, which is a linear scan
+// of |positions_|, like the storage's own shifting of its entries. Appending
+// a key doesn't shift anything.
+class Value::DictIndex {
+ public:
+  explicit DictIndex(const LegacyDictStorage& storage) { Rebuild(storage); }
+  DictIndex(const DictIndex&) = delete;
+  DictIndex& operator=(const DictIndex&) = delete;
+  ~DictIndex() = default;
+
+  // Returns the position of |key| in |storage|, or storage.size() if it isn't
+  // there.
+  size_t Find(const LegacyDictStorage& storage, StringPiece key) const {
+    const uint32_t hash = Hash(key);
+    for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+      const uint32_t position = positions_[i];
+      if (position == kEmpty)
+        return storage.size();
+      if (hashes_[i] == hash && storage.begin()[position].first == key)
+        return position;
+    }
+  }
+
+  // Updates the index after a key was added to |storage| at |position|.
+  void OnAdded(const LegacyDictStorage& storage, size_t position) {
+    if (4 * storage.size() > 3 * positions_.size()) {
+      Rebuild(storage);
+      return;
+    }
+    if (position + 1 < storage.size())
+      ShiftPositions(position, 1);
+    Add(Hash(storage.begin()[position].first), position);
+  }
+
+  // Updates the index before the key at |position| is erased from |storage|.
+  void OnErase(const LegacyDictStorage& storage, size_t position) {
+    size_t i = Hash(storage.begin()[position].first) & mask_;
+    while (positions_[i] != position)
+      i = (i + 1) & mask_;
+    // Move later slots of the same probe sequence back, so that the sequence
+    // doesn't have a hole. A slot can fill the hole at |i| if its ideal slot
+    // isn't in (i, j], cyclically.
+    for (size_t j = (i + 1) & mask_; positions_[j] != kEmpty;
+         j = (j + 1) & mask_) {
+      const size_t ideal = hashes_[j] & mask_;
+      if (((j - ideal) & mask_) >= ((j - i) & mask_)) {
+        hashes_[i] = hashes_[j];
+        positions_[i] = positions_[j];
+        i = j;
+      }
+    }
+    positions_[i] = kEmpty;
+    if (position + 1 < storage.size())
+      ShiftPositions(position + 1, -1);
+  }
+
+  size_t EstimateMemoryUsage() const {
+    return sizeof(*this) +
+           (hashes_.capacity() + positions_.capacity()) * sizeof(uint32_t);
+  }
+
+ private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  static uint32_t Hash(StringPiece key) {
+    return static_cast<uint32_t>(FastHash(key));
+  }
+
+  // Sizes the table for a load factor of at most 1/2, and fills it. It is
+  // rebuilt when the load factor goes over 3/4.
+  void Rebuild(const LegacyDictStorage& storage) {
+    CHECK_LT(storage.size(), size_t{kEmpty});
+    size_t capacity = 16;
+    while (capacity < 2 * storage.size())
+      capacity *= 2;
+    hashes_.assign(capacity, 0);
+    positions_.assign(capacity, kEmpty);
+    mask_ = capacity - 1;
+    for (size_t i = 0; i < storage.size(); ++i)
+      Add(Hash(storage.begin()[i].first), i);
+  }
+
+  void Add(uint32_t hash, size_t position) {
+    size_t i = hash & mask_;
+    while (positions_[i] != kEmpty)
+      i = (i + 1) & mask_;
+    hashes_[i] = hash;
+    positions_[i] = static_cast<uint32_t>(position);
+  }
+
+  // Adds |delta| to the positions of the keys at |from| and after it. Empty
+  // slots are left alone, as kEmpty is larger than any position. This is a
+  // single unsigned comparison per slot, so that the loop vectorizes.
+  void ShiftPositions(size_t from, int delta) {
+    const uint32_t start = static_cast<uint32_t>(from);
+    const uint32_t count = kEmpty - start;
+    const uint32_t increment = static_cast<uint32_t>(delta);
+    for (uint32_t& position : positions_)
+      position += (position - start < count) ? increment : 0;
+  }
+
+  // The hash and the position of the key in each slot. Empty slots have a
+  // position of kEmpty.
+  std::vector<uint32_t> hashes_;
+  std::vector<uint32_t> positions_;
+  size_t mask_ = 0;
+};
+
+Value::IndexedDict::IndexedDict(LegacyDictStorage in_storage)
+    : storage(std::move(in_storage)),
+      index(std::make_unique<DictIndex>(storage)) {}
+
+Value::IndexedDict::~IndexedDict() = default;
+
 // static
 Value Value::FromUniquePtrValue(std::unique_ptr<Value> val) {
   return std::move(*val);
@@ -165,7 +289,7 @@ Value::Value(Type type) : type_(type) {
       int_value_ = 0;
       return;
     case Type::DOUBLE:
-      double_value_ = 0.0;
+      double_value_ = bit_cast<DoubleStorage>(0.0);
       return;
     case Type::STRING:
       new (&string_value_) std::string();
@@ -193,11 +317,12 @@ Value::Value(bool in_bool) : type_(Type::BOOLEAN), bool_value_(in_bool) {}
 
 Value::Value(int in_int) : type_(Type::INTEGER), int_value_(in_int) {}
 
-Value::Value(double in_double) : type_(Type::DOUBLE), double_value_(in_double) {
+Value::Value(double in_double)
+    : type_(Type::DOUBLE), double_value_(bit_cast<DoubleStorage>(in_double)) {
   if (!std::isfinite(in_double)) {
     NOTREACHED() << "Non-finite (i.e. NaN or positive/negative infinity) "
                  << "values cannot be represented in JSON";
-    double_value_ = 0.0;
+    double_value_ = bit_cast<DoubleStorage>(0.0);
   }
 }
 
@@ -230,6 +355,7 @@ Value::Value(const DictStorage& in_dict)
     dict().try_emplace(dict().end(), it.first,
                        std::make_unique<Value>(it.second.Clone()));
   }
+  IndexDictIfLarge();
 }
 
 Value::Value(DictStorage&& in_dict) noexcept
@@ -239,6 +365,7 @@ Value::Value(DictStorage&& in_dict) noexcept
     dict().try_emplace(dict().end(), std::move(it.first),
                        std::make_unique<Value>(std::move(it.second)));
   }
+  IndexDictIfLarge();
 }
 
 Value::Value(span<const Value> in_list)
@@ -264,13 +391,16 @@ Value::Value(const LegacyDictStorage& storage)
     dict().try_emplace(dict().end(), it.first,
                        std::make_unique<Value>(it.second->Clone()));
   }
+  IndexDictIfLarge();
 }
 
 Value::Value(LegacyDictStorage&& storage) noexcept
-    : type_(Type::DICTIONARY), dict_(std::move(storage)) {}
+    : type_(Type::DICTIONARY), dict_(std::move(storage)) {
+  IndexDictIfLarge();
+}
 
 double Value::AsDoubleInternal() const {
-  return double_value_;
+  return bit_cast<double>(double_value_);
 }
 
 Value Value::Clone() const {
@@ -288,7 +418,7 @@ Value Value::Clone() const {
     case Type::BINARY:
       return Value(binary_value_);
     case Type::DICTIONARY:
-      return Value(dict_);
+      return Value(dict());
     case Type::LIST:
       return Value(list_);
       // TODO(crbug.com/859477): Remove after root cause is found.
@@ -444,7 +574,7 @@ Value* Value::FindKey(StringPiece key) {
 
 const Value* Value::FindKey(StringPiece key) const {
   CHECK(is_dict());
-  auto found = dict().find(key);
+  auto found = FindInDictInternal(key);
   if (found == dict().end())
     return nullptr;
   return found->second.get();
@@ -516,10 +646,11 @@ Value* Value::SetKey(StringPiece key, Value&& value) {
 
 Value* Value::SetKey(std::string&& key, Value&& value) {
   CHECK(is_dict());
-  return dict()
-      .insert_or_assign(std::move(key),
-                        std::make_unique<Value>(std::move(value)))
-      .first->second.get();
+  auto result = dict().insert_or_assign(
+      std::move(key), std::make_unique<Value>(std::move(value)));
+  if (result.second)
+    OnKeyAddedToDictInternal(result.first);
+  return result.first->second.get();
 }
 
 Value* Value::SetKey(const char* key, Value&& value) {
@@ -556,17 +687,22 @@ Value* Value::SetStringKey(StringPiece key, std::string&& value) {
 
 bool Value::RemoveKey(StringPiece key) {
   CHECK(is_dict());
-  return dict().erase(key) != 0;
+  auto found = FindInDictInternal(key);
+  if (found == dict().end())
+    return false;
+
+  EraseFromDictInternal(found);
+  return true;
 }
 
 Optional<Value> Value::ExtractKey(StringPiece key) {
   CHECK(is_dict());
-  auto found = dict().find(key);
+  auto found = FindInDictInternal(key);
   if (found == dict().end())
     return nullopt;
 
   Value value = std::move(*found->second);
-  dict().erase(found);
+  EraseFromDictInternal(found);
   return std::move(value);
 }
 
@@ -700,13 +836,13 @@ Optional<Value> Value::ExtractPath(StringPiece path) {
   if (pos == path.npos)
     return ExtractKey(path);
 
-  auto found = dict().find(path.substr(0, pos));
+  auto found = FindInDictInternal(path.substr(0, pos));
   if (found == dict().end() || !found->second->is_dict())
     return nullopt;
 
   Optional<Value> extracted = found->second->ExtractPath(path.substr(pos + 1));
   if (extracted && found->second->dict().empty())
-    dict().erase(found);
+    EraseFromDictInternal(found);
 
   return extracted;
 }
@@ -780,7 +916,9 @@ Value* Value::SetPath(span<const StringPiece> path, Value&& value) {
       // No key found, insert one.
       auto inserted = cur->dict().try_emplace(
           found, path_component, std::make_unique<Value>(Type::DICTIONARY));
-      cur = inserted->second.get();
+      Value* child = inserted->second.get();
+      cur->OnKeyAddedToDictInternal(inserted);
+      cur = child;
     } else {
       cur = found->second.get();
     }
@@ -811,7 +949,7 @@ Value::DictStorage Value::TakeDict() {
                         std::move(*pair.second));
   }
 
-  dict().clear();
+  DictClear();
   return storage;
 }
 
@@ -827,6 +965,12 @@ bool Value::DictEmpty() const {
 
 void Value::DictClear() {
   CHECK(is_dict());
+  if (dict_is_indexed_) {
+    delete indexed_dict_;
+    dict_is_indexed_ = false;
+    new (&dict_) LegacyDictStorage();
+    return;
+  }
   dict().clear();
 }
 
@@ -838,7 +982,7 @@ void Value::MergeDictionary(const Value* dictionary) {
     const auto& val = pair.second;
     // Check whether we have to merge dictionaries.
     if (val->is_dict()) {
-      auto found = dict().find(key);
+      auto found = FindInDictInternal(key);
       if (found != dict().end() && found->second->is_dict()) {
         found->second->MergeDictionary(val.get());
         continue;
@@ -1056,7 +1200,10 @@ size_t Value::EstimateMemoryUsage() const {
     case Type::BINARY:
       return base::trace_event::EstimateMemoryUsage(GetBlob());
     case Type::DICTIONARY:
-      return base::trace_event::EstimateMemoryUsage(dict());
+      return base::trace_event::EstimateMemoryUsage(dict()) +
+             (dict_is_indexed_ ? sizeof(IndexedDict) +
+                                     indexed_dict_->index->EstimateMemoryUsage()
+                               : 0);
     case Type::LIST:
       return base::trace_event::EstimateMemoryUsage(list());
 #endif  // BUILDFLAG(ENABLE_BASE_TRACING)
@@ -1087,6 +1234,15 @@ void Value::InternalMoveConstructFrom(Value&& that) {
       new (&binary_value_) BlobStorage(std::move(that.binary_value_));
       return;
     case Type::DICTIONARY:
+      if (that.dict_is_indexed_) {
+        // Leave |that| with an empty dictionary, as moving a
+        // LegacyDictStorage would.
+        indexed_dict_ = that.indexed_dict_;
+        dict_is_indexed_ = true;
+        that.dict_is_indexed_ = false;
+        new (&that.dict_) LegacyDictStorage();
+        return;
+      }
       new (&dict_) LegacyDictStorage(std::move(that.dict_));
       return;
     case Type::LIST:
@@ -1118,6 +1274,11 @@ void Value::InternalCleanup() {
       binary_value_.~BlobStorage();
       return;
     case Type::DICTIONARY:
+      if (dict_is_indexed_) {
+        delete indexed_dict_;
+        dict_is_indexed_ = false;
+        return;
+      }
       dict_.~LegacyDictStorage();
       return;
     case Type::LIST:
@@ -1139,13 +1300,55 @@ std::string Value::DebugString() const {
   return json;
 }
 
+void Value::IndexDictIfLarge() {
+  DCHECK(is_dict());
+  if (dict_is_indexed_ || dict_.size() <= kDictIndexThreshold)
+    return;
+  IndexedDict* indexed_dict = new IndexedDict(std::move(dict_));
+  dict_.~LegacyDictStorage();
+  indexed_dict_ = indexed_dict;
+  dict_is_indexed_ = true;
+}
+
+Value::LegacyDictStorage::iterator Value::FindInDictInternal(StringPiece key) {
+  auto found = as_const(*this).FindInDictInternal(key);
+  return dict().begin() + (found - dict().cbegin());
+}
+
+Value::LegacyDictStorage::const_iterator Value::FindInDictInternal(
+    StringPiece key) const {
+  if (!dict_is_indexed_)
+    return dict_.find(key);
+  const LegacyDictStorage& storage = indexed_dict_->storage;
+  return storage.begin() + indexed_dict_->index->Find(storage, key);
+}
+
+void Value::OnKeyAddedToDictInternal(LegacyDictStorage::const_iterator it) {
+  if (!dict_is_indexed_) {
+    IndexDictIfLarge();
+    return;
+  }
+  const LegacyDictStorage& storage = indexed_dict_->storage;
+  indexed_dict_->index->OnAdded(storage, it - storage.begin());
+}
+
+void Value::EraseFromDictInternal(LegacyDictStorage::const_iterator it) {
+  if (dict_is_indexed_) {
+    LegacyDictStorage& storage = indexed_dict_->storage;
+    indexed_dict_->index->OnErase(storage, it - storage.cbegin());
+  }
+  dict().erase(it);
+}
+
 Value* Value::SetKeyInternal(StringPiece key,
                              std::unique_ptr<Value>&& val_ptr) {
   CHECK(is_dict());
   // NOTE: We can't use |insert_or_assign| here, as only |try_emplace| does
   // an explicit conversion from StringPiece to std::string if necessary.
   auto result = dict().try_emplace(key, std::move(val_ptr));
-  if (!result.second) {
+  if (result.second) {
+    OnKeyAddedToDictInternal(result.first);
+  } else {
     // val_ptr is guaranteed to be still intact at this point.
     result.first->second = std::move(val_ptr);
   }
@@ -1170,7 +1373,9 @@ Value* Value::SetPathInternal(StringPiece path,
       // No key found, insert one.
       auto inserted = cur->dict().try_emplace(
           found, path_component, std::make_unique<Value>(Type::DICTIONARY));
-      cur = inserted->second.get();
+      Value* child = inserted->second.get();
+      cur->OnKeyAddedToDictInternal(inserted);
+      cur = child;
     } else {
       cur = found->second.get();
     }
@@ -1206,7 +1411,7 @@ DictionaryValue::DictionaryValue(LegacyDictStorage&& storage) noexcept
 
 bool DictionaryValue::HasKey(StringPiece key) const {
   DCHECK(IsStringUTF8AllowingNoncharacters(key));
-  auto current_entry = dict().find(key);
+  auto current_entry = FindInDictInternal(key);
   DCHECK((current_entry == dict().end()) || current_entry->second);
   return current_entry != dict().end();
 }
@@ -1282,7 +1487,9 @@ Value* DictionaryValue::SetWithoutPathExpansion(
   // NOTE: We can't use |insert_or_assign| here, as only |try_emplace| does
   // an explicit conversion from StringPiece to std::string if necessary.
   auto result = dict().try_emplace(key, std::move(in_value));
-  if (!result.second) {
+  if (result.second) {
+    OnKeyAddedToDictInternal(result.first);
+  } else {
     // in_value is guaranteed to be still intact at this point.
     result.first->second = std::move(in_value);
   }
@@ -1416,7 +1623,7 @@ bool DictionaryValue::GetList(StringPiece path, ListValue** out_value) {
 bool DictionaryValue::GetWithoutPathExpansion(StringPiece key,
                                               const Value** out_value) const {
   DCHECK(IsStringUTF8AllowingNoncharacters(key));
-  auto entry_iterator = dict().find(key);
+  auto entry_iterator = FindInDictInternal(key);
   if (entry_iterator == dict().end())
     return false;
 
@@ -1539,13 +1746,13 @@ bool DictionaryValue::RemoveWithoutPathExpansion(
     StringPiece key,
     std::unique_ptr<Value>* out_value) {
   DCHECK(IsStringUTF8AllowingNoncharacters(key));
-  auto entry_iterator = dict().find(key);
+  auto entry_iterator = FindInDictInternal(key);
   if (entry_iterator == dict().end())
     return false;
 
   if (out_value)
     *out_value = std::move(entry_iterator->second);
-  dict().erase(entry_iterator);
+  EraseFromDictInternal(entry_iterator);
   return true;
 }
 
@@ -1579,7 +1786,8 @@ std::unique_ptr<DictionaryValue> DictionaryValue::DeepCopyWithoutEmptyChildren()
 
 void DictionaryValue::Swap(DictionaryValue* other) {
   CHECK(other->is_dict());
-  dict().swap(other->dict());
+  // Swap the whole Values, so that indexed dictionaries keep their index.
+  std::swap(static_cast<Value&>(*this), static_cast<Value&>(*other));
 }
 
 DictionaryValue::Iterator::Iterator(const DictionaryValue& target)
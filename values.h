@@ -109,6 +109,12 @@ class BASE_EXPORT Value {
   // stability of pointers anymore.
   using LegacyDictStorage = flat_map<std::string, std::unique_ptr<Value>>;
 
+  // Doubles are 8-byte aligned on some 32-bit platforms. Storing one as a
+  // double member would make the whole union 8-byte aligned, and add 4 bytes
+  // of padding after |type_| in every Value. Store the bits in a 4-byte
+  // aligned array instead, and bit_cast them when reading or writing.
+  using DoubleStorage = struct { alignas(4) char v[sizeof(double)]; };
+
   using ListView = CheckedContiguousRange<ListStorage>;
   using ConstListView = CheckedContiguousConstRange<ListStorage>;
 
@@ -555,8 +561,12 @@ class BASE_EXPORT Value {
 
  protected:
   // Checked convenience accessors for dict and list.
-  const LegacyDictStorage& dict() const { return dict_; }
-  LegacyDictStorage& dict() { return dict_; }
+  const LegacyDictStorage& dict() const {
+    return dict_is_indexed_ ? indexed_dict_->storage : dict_;
+  }
+  LegacyDictStorage& dict() {
+    return dict_is_indexed_ ? indexed_dict_->storage : dict_;
+  }
   const ListStorage& list() const { return list_; }
   ListStorage& list() { return list_; }
 
@@ -564,11 +574,41 @@ class BASE_EXPORT Value {
   explicit Value(const LegacyDictStorage& storage);
   explicit Value(LegacyDictStorage&& storage) noexcept;
 
+  // Looks up |key| in the dictionary, using its hash index if it has one.
+  // Returns dict().end() if |key| isn't there.
+  LegacyDictStorage::iterator FindInDictInternal(StringPiece key);
+  LegacyDictStorage::const_iterator FindInDictInternal(StringPiece key) const;
+
+  // Must be called after adding a key to the dictionary and instead of
+  // erasing one directly, to keep its hash index in sync.
+  void OnKeyAddedToDictInternal(LegacyDictStorage::const_iterator it);
+  void EraseFromDictInternal(LegacyDictStorage::const_iterator it);
+
  private:
+  // Dictionaries with more than kDictIndexThreshold keys move their storage
+  // out of line, next to a hash index of the keys, so that lookups don't need
+  // a binary search and Value doesn't grow. The storage stays sorted, so
+  // iteration order doesn't change. The index is only dropped when the
+  // dictionary is cleared.
+  // The trade-off is that adding or erasing a key stays O(n), as for the
+  // sorted storage, and must also shift the index's positions of the keys
+  // after it. So adding many keys one at a time in random order is about 1.4x
+  // slower for a large dictionary; adding them in order, or constructing the
+  // dictionary from a DictStorage, avoids this.
+  class DictIndex;
+  struct IndexedDict {
+    explicit IndexedDict(LegacyDictStorage in_storage);
+    ~IndexedDict();
+
+    LegacyDictStorage storage;
+    std::unique_ptr<DictIndex> index;
+  };
+
   friend class ValuesTest_SizeOfValue_Test;
   double AsDoubleInternal() const;
   void InternalMoveConstructFrom(Value&& that);
   void InternalCleanup();
+  void IndexDictIfLarge();
 
   // NOTE: Using a movable reference here is done for performance (it avoids
   // creating + moving + destroying a temporary unique ptr).
@@ -576,14 +616,17 @@ class BASE_EXPORT Value {
   Value* SetPathInternal(StringPiece path, std::unique_ptr<Value>&& value_ptr);
 
   Type type_ = Type::NONE;
+  // Whether the dictionary is held by |indexed_dict_| instead of |dict_|.
+  bool dict_is_indexed_ = false;
 
   union {
     bool bool_value_;
     int int_value_;
-    double double_value_;
+    DoubleStorage double_value_;
     std::string string_value_;
     BlobStorage binary_value_;
     LegacyDictStorage dict_;
+    IndexedDict* indexed_dict_;
     ListStorage list_;
   };
 };
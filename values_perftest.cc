@@ -0,0 +1,178 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/values.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/tracing_buildflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixValue[] = "Value.";
+constexpr char kMetricTimePerBuild[] = "time_per_build";
+constexpr char kMetricTimePerLookup[] = "time_per_lookup";
+constexpr char kMetricTimePerSerialize[] = "time_per_serialize";
+constexpr char kMetricSizeOfValue[] = "sizeof_value";
+constexpr char kMetricBytesPerEntry[] = "bytes_per_entry";
+constexpr char kStoryConfigTree[] = "config_tree";
+
+// The shape of the tree built by MakeConfigTree(): |kSections| dictionaries
+// of |kEntriesPerSection| scalars each.
+constexpr int kSections = 100;
+constexpr int kEntriesPerSection = 100;
+constexpr int kBuildLaps = 20;
+constexpr int kLookupLaps = 1000000;
+
+// The dictionary sizes of the build, lookup and serialize benchmarks.
+constexpr int kDictSizes[] = {8, 64, 1024, 16384, 65536};
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixValue, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerBuild, "us");
+  reporter.RegisterImportantMetric(kMetricTimePerLookup, "ns");
+  reporter.RegisterImportantMetric(kMetricTimePerSerialize, "us");
+  reporter.RegisterImportantMetric(kMetricSizeOfValue, "bytes");
+  reporter.RegisterImportantMetric(kMetricBytesPerEntry, "bytes");
+  return reporter;
+}
+
+std::string GetKey(int i) {
+  return "key_" + NumberToString(i);
+}
+
+// Returns a dictionary like those of large configuration files, with a mix
+// of short strings, integers, doubles and booleans.
+Value MakeConfigTree() {
+  Value root(Value::Type::DICTIONARY);
+  for (int i = 0; i < kSections; ++i) {
+    Value section(Value::Type::DICTIONARY);
+    for (int j = 0; j < kEntriesPerSection; ++j) {
+      switch (j % 4) {
+        case 0:
+          section.SetStringKey(GetKey(j), "value " + NumberToString(j));
+          break;
+        case 1:
+          section.SetIntKey(GetKey(j), j);
+          break;
+        case 2:
+          section.SetDoubleKey(GetKey(j), j / 8.0);
+          break;
+        case 3:
+          section.SetBoolKey(GetKey(j), j % 8 == 3);
+          break;
+      }
+    }
+    root.SetKey("section_" + NumberToString(i), std::move(section));
+  }
+  return root;
+}
+
+// Returns the keys of a dictionary of |size| entries made by MakeDict(),
+// followed by one which isn't in it.
+std::vector<std::string> GetLookupKeys(int size) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 64; ++i)
+    keys.push_back(GetKey(i * size / 64));
+  keys.push_back("not_a_key");
+  return keys;
+}
+
+// Builds a dictionary of |size| integers with SetIntKey(), adding the keys in
+// an order which inserts most of them in the middle.
+Value MakeDict(int size) {
+  Value dict(Value::Type::DICTIONARY);
+  for (int i = 0; i < size; ++i)
+    dict.SetIntKey(GetKey(static_cast<int>(i * 7919LL % size)), i);
+  return dict;
+}
+
+std::string GetSizeStory(const char* name, int size) {
+  return name + NumberToString(size) + "_keys";
+}
+
+}  // namespace
+
+TEST(ValuePerfTest, Build) {
+  TimeDelta elapsed;
+  for (int i = 0; i < kBuildLaps; ++i) {
+    const TimeTicks start = TimeTicks::Now();
+    Value tree = MakeConfigTree();
+    elapsed += TimeTicks::Now() - start;
+    ASSERT_EQ(static_cast<size_t>(kSections), tree.DictSize());
+  }
+  SetUpReporter(kStoryConfigTree)
+      .AddResult(kMetricTimePerBuild, elapsed.InMicrosecondsF() / kBuildLaps);
+}
+
+TEST(ValuePerfTest, BuildDict) {
+  for (int size : kDictSizes) {
+    const int laps = std::max(1, (1 << 16) / size);
+    TimeDelta elapsed;
+    for (int i = 0; i < laps; ++i) {
+      const TimeTicks start = TimeTicks::Now();
+      Value dict = MakeDict(size);
+      elapsed += TimeTicks::Now() - start;
+      ASSERT_EQ(static_cast<size_t>(size), dict.DictSize());
+    }
+    SetUpReporter(GetSizeStory("build_", size))
+        .AddResult(kMetricTimePerBuild, elapsed.InMicrosecondsF() / laps);
+  }
+}
+
+TEST(ValuePerfTest, Memory) {
+  perf_test::PerfResultReporter reporter = SetUpReporter(kStoryConfigTree);
+  reporter.AddResult(kMetricSizeOfValue, sizeof(Value));
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  const Value tree = MakeConfigTree();
+  const size_t bytes = tree.EstimateMemoryUsage();
+  reporter.AddResult(kMetricBytesPerEntry,
+                     static_cast<double>(bytes) /
+                         (kSections * (kEntriesPerSection + 1)));
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+TEST(ValuePerfTest, FindKey) {
+  for (int size : kDictSizes) {
+    const Value dict = MakeDict(size);
+    const std::vector<std::string> keys = GetLookupKeys(size);
+
+    size_t found = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < kLookupLaps; ++i)
+      found += dict.FindKey(keys[i % keys.size()]) != nullptr;
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+    EXPECT_GT(found, 0u);
+
+    SetUpReporter(GetSizeStory("find_key_", size))
+        .AddResult(kMetricTimePerLookup,
+                   elapsed.InNanoseconds() / static_cast<double>(kLookupLaps));
+  }
+}
+
+TEST(ValuePerfTest, Serialize) {
+  for (int size : kDictSizes) {
+    const Value dict = MakeDict(size);
+    const int laps = std::max(1, (1 << 18) / size);
+    std::string json;
+    const TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < laps; ++i)
+      ASSERT_TRUE(JSONWriter::Write(dict, &json));
+    const TimeDelta elapsed = TimeTicks::Now() - start;
+
+    SetUpReporter(GetSizeStory("serialize_", size))
+        .AddResult(kMetricTimePerSerialize, elapsed.InMicrosecondsF() / laps);
+  }
+}
+
+}  // namespace base
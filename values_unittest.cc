@@ -19,6 +19,7 @@
 #include "base/containers/adapters.h"
 #include "base/logging.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -1245,6 +1246,79 @@ TEST(ValuesTest, ExtractKey) {
   EXPECT_EQ(nullopt, root.ExtractKey("one"));
 }
 
+// Large dictionaries are looked up through a hash index, which must stay in
+// sync with every way of adding and removing keys.
+TEST(ValuesTest, LargeDict) {
+  constexpr int kSize = 1000;
+  auto key = [](int i) { return "key" + NumberToString(i); };
+  DictionaryValue dict;
+  // Add keys in an order which inserts most of them in the middle.
+  for (int i = 0; i < kSize; ++i) {
+    const int k = i * 7 % kSize;
+    switch (i % 3) {
+      case 0:
+        dict.SetIntKey(key(k), k);
+        break;
+      case 1:
+        dict.SetKey(key(k), Value(k));
+        break;
+      case 2:
+        dict.SetWithoutPathExpansion(key(k), std::make_unique<Value>(k));
+        break;
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(kSize), dict.DictSize());
+  for (int i = 0; i < kSize; ++i)
+    EXPECT_EQ(i, dict.FindIntKey(key(i)));
+  EXPECT_EQ(nullptr, dict.FindKey("key"));
+
+  // Replacing a value keeps the key in place.
+  dict.SetIntKey(key(500), -1);
+  EXPECT_EQ(-1, dict.FindIntKey(key(500)));
+
+  // Remove every other key, in different ways.
+  for (int i = 0; i < kSize; i += 2) {
+    switch (i % 3) {
+      case 0:
+        EXPECT_TRUE(dict.RemoveKey(key(i)));
+        break;
+      case 1:
+        EXPECT_TRUE(dict.ExtractKey(key(i)));
+        break;
+      case 2:
+        EXPECT_TRUE(dict.RemoveWithoutPathExpansion(key(i), nullptr));
+        break;
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(kSize / 2), dict.DictSize());
+  for (int i = 0; i < kSize; ++i)
+    EXPECT_EQ(i % 2 == 1, dict.HasKey(key(i))) << i;
+
+  // Iteration is still in key order.
+  std::string previous;
+  for (const auto& item : dict.DictItems()) {
+    EXPECT_LT(previous, item.first);
+    previous = item.first;
+  }
+
+  // Copies, moves and swaps keep working lookups.
+  Value copy = dict.Clone();
+  EXPECT_EQ(dict, copy);
+  Value moved = std::move(copy);
+  EXPECT_EQ(1, moved.FindIntKey(key(1)));
+  DictionaryValue other;
+  other.SetIntKey("other", 1);
+  dict.Swap(&other);
+  EXPECT_EQ(1, dict.FindIntKey("other"));
+  EXPECT_EQ(nullptr, dict.FindKey(key(1)));
+  EXPECT_EQ(1, other.FindIntKey(key(1)));
+
+  other.DictClear();
+  EXPECT_EQ(nullptr, other.FindKey(key(1)));
+  other.SetIntKey(key(1), 1);
+  EXPECT_EQ(1, other.FindIntKey(key(1)));
+}
+
 TEST(ValuesTest, RemovePath) {
   Value root(Value::Type::DICTIONARY);
   root.SetPath("one.two.three", Value(123));